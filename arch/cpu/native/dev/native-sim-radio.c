@@ -0,0 +1,469 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         802.15.4 radio driver for the native simulated medium.
+ *
+ *         Frames from other nodes are kept while they are on the air. A
+ *         frame is received if the radio was on and tuned to its channel
+ *         for the whole frame, did not transmit meanwhile, and no other
+ *         frame overlapped it on the same channel. The driver has no
+ *         address filtering or auto-ACK: it is meant for TSCH, which
+ *         handles both in software.
+ */
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/netstack.h"
+#include "sys/energest.h"
+#include "dev/native-sim-radio.h"
+
+#include <string.h>
+
+/*---------------------------------------------------------------------------*/
+#define MIN_CHANNEL 11
+#define MAX_CHANNEL 26
+#define MAX_PAYLOAD_LEN 125
+#define RSSI_NO_SIGNAL -100
+#define LQI_MAX 105
+
+/* Frames from other nodes that may still be on the air */
+#ifdef NATIVE_SIM_RADIO_CONF_MAX_FRAMES
+#define MAX_FRAMES NATIVE_SIM_RADIO_CONF_MAX_FRAMES
+#else
+#define MAX_FRAMES 8
+#endif
+
+struct air_frame {
+  uint64_t start;
+  uint64_t end;
+  uint8_t in_use;
+  uint8_t channel;
+  uint8_t receiving; /* Our receiver follows this frame */
+  uint8_t collided;
+  int8_t rssi;
+  uint8_t len;
+  uint8_t payload[NATIVE_SIM_MAX_FRAME_LEN];
+};
+
+static struct air_frame air[MAX_FRAMES];
+
+static uint8_t rx_buf[MAX_PAYLOAD_LEN];
+static uint8_t rx_len;
+static rtimer_clock_t rx_timestamp;
+static int8_t last_rssi = RSSI_NO_SIGNAL;
+
+static uint8_t tx_buf[MAX_PAYLOAD_LEN];
+static uint64_t tx_end;
+
+static uint8_t radio_is_on;
+static uint8_t channel = MAX_CHANNEL;
+static uint8_t poll_mode;
+static uint8_t send_on_cca;
+
+PROCESS(native_sim_radio_process, "native sim radio process");
+/*---------------------------------------------------------------------------*/
+/* Move frames that are over out of the air, keeping the last good one */
+static void
+update(void)
+{
+  uint64_t now = native_sim_now();
+  int i;
+
+  for(i = 0; i < MAX_FRAMES; i++) {
+    struct air_frame *f = &air[i];
+    if(f->in_use && f->end <= now) {
+      if(f->receiving && !f->collided && f->len <= MAX_PAYLOAD_LEN) {
+        memcpy(rx_buf, f->payload, f->len);
+        rx_len = f->len;
+        rx_timestamp = f->start;
+        last_rssi = f->rssi;
+        if(!poll_mode) {
+          process_poll(&native_sim_radio_process);
+        }
+      }
+      f->in_use = 0;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The receiver was turned off or retuned: frames in progress are lost */
+static void
+stop_receiving(void)
+{
+  int i;
+
+  update();
+  for(i = 0; i < MAX_FRAMES; i++) {
+    air[i].receiving = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+signal_strength(void)
+{
+  uint64_t now = native_sim_now();
+  int rssi = RSSI_NO_SIGNAL;
+  int i;
+
+  update();
+  for(i = 0; i < MAX_FRAMES; i++) {
+    if(air[i].in_use && air[i].channel == channel
+       && air[i].start <= now && air[i].rssi > rssi) {
+      rssi = air[i].rssi;
+    }
+  }
+  return rssi;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_radio_input(const struct native_sim_msg *msg)
+{
+  struct air_frame *f = NULL;
+  int i;
+
+  update();
+  for(i = 0; i < MAX_FRAMES; i++) {
+    if(!air[i].in_use) {
+      f = &air[i];
+      break;
+    }
+  }
+  if(f == NULL) {
+    return;
+  }
+
+  f->in_use = 1;
+  f->start = msg->time;
+  f->end = msg->time + msg->duration;
+  f->channel = msg->channel;
+  f->rssi = msg->rssi;
+  f->len = msg->len;
+  memcpy(f->payload, msg->payload, msg->len);
+  f->collided = 0;
+  f->receiving = radio_is_on && channel == msg->channel
+    && tx_end <= msg->time && !(msg->flags & NATIVE_SIM_FRAME_LOST);
+
+  /* Overlapping frames on the same channel corrupt each other */
+  for(i = 0; i < MAX_FRAMES; i++) {
+    if(&air[i] != f && air[i].in_use && air[i].channel == f->channel) {
+      air[i].collided = 1;
+      f->collided = 1;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_radio_poll(void)
+{
+  update();
+}
+/*---------------------------------------------------------------------------*/
+static int
+init(void)
+{
+  process_start(&native_sim_radio_process, NULL);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+prepare(const void *payload, unsigned short payload_len)
+{
+  if(payload_len > MAX_PAYLOAD_LEN) {
+    return RADIO_TX_ERR;
+  }
+  memcpy(tx_buf, payload, payload_len);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+channel_clear(void)
+{
+  return signal_strength() == RSSI_NO_SIGNAL;
+}
+/*---------------------------------------------------------------------------*/
+static int
+transmit(unsigned short transmit_len)
+{
+  if(transmit_len == 0 || transmit_len > MAX_PAYLOAD_LEN) {
+    return RADIO_TX_ERR;
+  }
+  if(send_on_cca && !channel_clear()) {
+    return RADIO_TX_COLLISION;
+  }
+
+  /* Half-duplex: whatever we were receiving is lost */
+  stop_receiving();
+  tx_end = native_sim_now()
+    + (uint64_t)(transmit_len + RADIO_PHY_OVERHEAD) * RADIO_BYTE_AIR_TIME;
+
+  if(radio_is_on) {
+    ENERGEST_SWITCH(ENERGEST_TYPE_LISTEN, ENERGEST_TYPE_TRANSMIT);
+  } else {
+    ENERGEST_ON(ENERGEST_TYPE_TRANSMIT);
+  }
+
+  native_sim_transmit(channel, tx_buf, transmit_len,
+                      tx_end - native_sim_now());
+  while(native_sim_now() < tx_end) {
+    native_sim_wait(tx_end);
+  }
+
+  if(radio_is_on) {
+    ENERGEST_SWITCH(ENERGEST_TYPE_TRANSMIT, ENERGEST_TYPE_LISTEN);
+  } else {
+    ENERGEST_OFF(ENERGEST_TYPE_TRANSMIT);
+  }
+  return RADIO_TX_OK;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send(const void *payload, unsigned short payload_len)
+{
+  if(prepare(payload, payload_len) != 0) {
+    return RADIO_TX_ERR;
+  }
+  return transmit(payload_len);
+}
+/*---------------------------------------------------------------------------*/
+static int
+radio_read(void *buf, unsigned short buf_len)
+{
+  int len;
+
+  update();
+  len = rx_len;
+  rx_len = 0;
+  if(len == 0 || len > buf_len) {
+    return 0;
+  }
+  memcpy(buf, rx_buf, len);
+  if(!poll_mode) {
+    packetbuf_set_attr(PACKETBUF_ATTR_RSSI, last_rssi);
+    packetbuf_set_attr(PACKETBUF_ATTR_LINK_QUALITY, LQI_MAX);
+  }
+  return len;
+}
+/*---------------------------------------------------------------------------*/
+static int
+receiving_packet(void)
+{
+  uint64_t now = native_sim_now();
+  int i;
+
+  update();
+  for(i = 0; i < MAX_FRAMES; i++) {
+    if(air[i].in_use && air[i].receiving && air[i].start <= now) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+pending_packet(void)
+{
+  update();
+  return rx_len > 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+on(void)
+{
+  if(!radio_is_on) {
+    radio_is_on = 1;
+    ENERGEST_ON(ENERGEST_TYPE_LISTEN);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+off(void)
+{
+  if(radio_is_on) {
+    stop_receiving();
+    radio_is_on = 0;
+    ENERGEST_OFF(ENERGEST_TYPE_LISTEN);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_value(radio_param_t param, radio_value_t *value)
+{
+  if(!value) {
+    return RADIO_RESULT_INVALID_VALUE;
+  }
+
+  switch(param) {
+  case RADIO_PARAM_POWER_MODE:
+    *value = radio_is_on ? RADIO_POWER_MODE_ON : RADIO_POWER_MODE_OFF;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_RX_MODE:
+    *value = poll_mode ? RADIO_RX_MODE_POLL_MODE : 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_TX_MODE:
+    *value = send_on_cca ? RADIO_TX_MODE_SEND_ON_CCA : 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_CHANNEL:
+    *value = channel;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_RSSI:
+    *value = signal_strength();
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_LAST_RSSI:
+    *value = last_rssi;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_LAST_LINK_QUALITY:
+    *value = LQI_MAX;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_CHANNEL_MIN:
+    *value = MIN_CHANNEL;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_CHANNEL_MAX:
+    *value = MAX_CHANNEL;
+    return RADIO_RESULT_OK;
+  case RADIO_CONST_MAX_PAYLOAD_LEN:
+    *value = MAX_PAYLOAD_LEN;
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_value(radio_param_t param, radio_value_t value)
+{
+  switch(param) {
+  case RADIO_PARAM_POWER_MODE:
+    if(value == RADIO_POWER_MODE_ON) {
+      on();
+      return RADIO_RESULT_OK;
+    }
+    if(value == RADIO_POWER_MODE_OFF) {
+      off();
+      return RADIO_RESULT_OK;
+    }
+    return RADIO_RESULT_INVALID_VALUE;
+  case RADIO_PARAM_RX_MODE:
+    if(value & ~(RADIO_RX_MODE_ADDRESS_FILTER |
+                 RADIO_RX_MODE_AUTOACK | RADIO_RX_MODE_POLL_MODE)) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    /* Only disabling is acceptable for address filtering and auto-ACK */
+    if(value & (RADIO_RX_MODE_ADDRESS_FILTER | RADIO_RX_MODE_AUTOACK)) {
+      return RADIO_RESULT_NOT_SUPPORTED;
+    }
+    poll_mode = (value & RADIO_RX_MODE_POLL_MODE) != 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_TX_MODE:
+    if(value & ~RADIO_TX_MODE_SEND_ON_CCA) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    send_on_cca = (value & RADIO_TX_MODE_SEND_ON_CCA) != 0;
+    return RADIO_RESULT_OK;
+  case RADIO_PARAM_CHANNEL:
+    if(value < MIN_CHANNEL || value > MAX_CHANNEL) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    if(value != channel) {
+      stop_receiving();
+      channel = value;
+    }
+    return RADIO_RESULT_OK;
+  default:
+    return RADIO_RESULT_NOT_SUPPORTED;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+get_object(radio_param_t param, void *dest, size_t size)
+{
+  if(param == RADIO_PARAM_LAST_PACKET_TIMESTAMP) {
+    if(size != sizeof(rtimer_clock_t) || !dest) {
+      return RADIO_RESULT_INVALID_VALUE;
+    }
+    *(rtimer_clock_t *)dest = rx_timestamp;
+    return RADIO_RESULT_OK;
+  }
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+static radio_result_t
+set_object(radio_param_t param, const void *src, size_t size)
+{
+  return RADIO_RESULT_NOT_SUPPORTED;
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(native_sim_radio_process, ev, data)
+{
+  int len;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    PROCESS_YIELD_UNTIL(ev == PROCESS_EVENT_POLL);
+    if(poll_mode) {
+      continue;
+    }
+
+    packetbuf_clear();
+    len = radio_read(packetbuf_dataptr(), PACKETBUF_SIZE);
+    if(len > 0) {
+      packetbuf_set_datalen(len);
+      NETSTACK_MAC.input();
+    }
+  }
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
+const struct radio_driver native_sim_radio_driver = {
+  init,
+  prepare,
+  transmit,
+  send,
+  radio_read,
+  channel_clear,
+  receiving_packet,
+  pending_packet,
+  on,
+  off,
+  get_value,
+  set_value,
+  get_object,
+  set_object
+};
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -35,5 +35,15 @@
 #define GPIO_HAL_CONF_ARCH_SW_TOGGLE     1
 #define GPIO_HAL_CONF_PORT_PIN_NUMBERING 0
 /*---------------------------------------------------------------------------*/
+/*
+ * Run against a simulated 802.15.4 medium in virtual time instead of the
+ * host clock. Set by the build system for TSCH builds (NATIVE_SIM=1).
+ */
+#ifdef NATIVE_CONF_SIM
+#define NATIVE_SIM NATIVE_CONF_SIM
+#else
+#define NATIVE_SIM 0
+#endif
+/*---------------------------------------------------------------------------*/
 #endif /* NATIVE_DEF_H_ */
 /*---------------------------------------------------------------------------*/
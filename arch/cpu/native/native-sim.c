@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         Virtual time and medium client for the native platform
+ */
+
+#include "contiki.h"
+#include "sys/rtimer.h"
+#include "native-sim.h"
+#include "dev/native-sim-radio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/*---------------------------------------------------------------------------*/
+static uint64_t now;
+static uint16_t node_id;
+static int medium_fd = -1;
+
+static uint64_t rtimer_time;
+static uint8_t rtimer_armed;
+static uint8_t in_rtimer;
+/*---------------------------------------------------------------------------*/
+static void
+send_msg(struct native_sim_msg *msg)
+{
+  const uint8_t *p = (const uint8_t *)msg;
+  size_t left = sizeof(*msg);
+
+  msg->node_id = node_id;
+  while(left > 0) {
+    ssize_t n = write(medium_fd, p, left);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      perror("native-sim: write");
+      exit(1);
+    }
+    p += n;
+    left -= n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+recv_msg(struct native_sim_msg *msg)
+{
+  uint8_t *p = (uint8_t *)msg;
+  size_t left = sizeof(*msg);
+
+  while(left > 0) {
+    ssize_t n = read(medium_fd, p, left);
+    if(n < 0 && errno == EINTR) {
+      continue;
+    }
+    if(n <= 0) {
+      /* The medium closes the connection when the simulation ends */
+      exit(0);
+    }
+    p += n;
+    left -= n;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Block until the medium wakes us up, feeding frames to the radio */
+static void
+wait_for_wake(void)
+{
+  struct native_sim_msg msg;
+
+  while(1) {
+    recv_msg(&msg);
+    if(msg.time > now) {
+      now = msg.time;
+    }
+    if(msg.type == NATIVE_SIM_MSG_WAKE) {
+      break;
+    }
+    if(msg.type == NATIVE_SIM_MSG_FRAME) {
+      native_sim_radio_input(&msg);
+    }
+  }
+  native_sim_radio_poll();
+}
+/*---------------------------------------------------------------------------*/
+static void
+run_rtimers(void)
+{
+  while(rtimer_armed && rtimer_time <= now) {
+    rtimer_armed = 0;
+    in_rtimer = 1;
+    rtimer_run_next();
+    in_rtimer = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_init(int *argc, char **argv)
+{
+  const char *medium = NULL;
+  struct sockaddr_un addr;
+  struct native_sim_msg msg;
+  int i, j;
+
+  for(i = 1, j = 1; i < *argc; i++) {
+    if(strncmp(argv[i], "--node-id=", 10) == 0) {
+      node_id = atoi(argv[i] + 10);
+    } else if(strncmp(argv[i], "--medium=", 9) == 0) {
+      medium = argv[i] + 9;
+    } else {
+      argv[j++] = argv[i];
+    }
+  }
+  *argc = j;
+  argv[j] = NULL;
+
+  /* Output goes to the medium's log in simulation order */
+  setvbuf(stdout, (char *)NULL, _IONBF, 0);
+
+  if(medium == NULL) {
+    return;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, medium, sizeof(addr.sun_path) - 1);
+  medium_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if(medium_fd < 0 ||
+     connect(medium_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+    perror("native-sim: connect");
+    exit(1);
+  }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.type = NATIVE_SIM_MSG_HELLO;
+  send_msg(&msg);
+  wait_for_wake();
+}
+/*---------------------------------------------------------------------------*/
+uint16_t
+native_sim_node_id(void)
+{
+  return node_id;
+}
+/*---------------------------------------------------------------------------*/
+uint64_t
+native_sim_now(void)
+{
+  return now;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_set_rtimer(uint64_t t)
+{
+  rtimer_time = t;
+  rtimer_armed = 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_wait(uint64_t until)
+{
+  struct native_sim_msg msg;
+
+  /* Outside of rtimer context, the rtimer interrupts the wait */
+  if(!in_rtimer && rtimer_armed && rtimer_time < until) {
+    until = rtimer_time;
+  }
+
+  if(until > now) {
+    if(medium_fd >= 0) {
+      memset(&msg, 0, sizeof(msg));
+      msg.type = NATIVE_SIM_MSG_WAIT;
+      msg.time = until;
+      send_msg(&msg);
+      wait_for_wake();
+    } else if(until != NATIVE_SIM_FOREVER) {
+      /* Alone: nothing can happen before until */
+      now = until;
+      native_sim_radio_poll();
+    } else {
+      /* Alone and with nothing left to do */
+      pause();
+    }
+  }
+
+  if(!in_rtimer) {
+    run_rtimers();
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+native_sim_transmit(uint8_t channel, const void *payload, uint8_t len,
+                    uint64_t duration)
+{
+  struct native_sim_msg msg;
+
+  if(medium_fd < 0) {
+    return;
+  }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.type = NATIVE_SIM_MSG_TX;
+  msg.time = now;
+  msg.duration = duration;
+  msg.channel = channel;
+  msg.len = len;
+  memcpy(msg.payload, payload, len);
+  send_msg(&msg);
+}
+/*---------------------------------------------------------------------------*/
+/** @} */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \addtogroup native_platform
+ * @{
+ *
+ * \file
+ *         Virtual time and simulated radio medium for the native platform.
+ *
+ *         In a NATIVE_SIM build, time does not follow the host clock.
+ *         Every node connects to a medium process (tools/native-medium)
+ *         over a UNIX socket, and the medium lets exactly one node run at
+ *         a time, always the one with the earliest pending event. Radio
+ *         frames are exchanged through the medium, timestamped in virtual
+ *         time, so a run is deterministic and independent of host load.
+ */
+
+#ifndef NATIVE_SIM_H_
+#define NATIVE_SIM_H_
+
+#include <stdint.h>
+
+/** Number of virtual time ticks (microseconds) per second */
+#define NATIVE_SIM_SECOND             UINT64_C(1000000)
+/** Wait time meaning "until the next medium event" */
+#define NATIVE_SIM_FOREVER            UINT64_MAX
+/** Largest 802.15.4 frame carried by the medium, including the FCS */
+#define NATIVE_SIM_MAX_FRAME_LEN      127
+
+/** \name Messages exchanged between a node and the medium
+ * @{
+ */
+enum {
+  NATIVE_SIM_MSG_HELLO, /**< node -> medium: node_id set, waits for a WAKE */
+  NATIVE_SIM_MSG_WAIT,  /**< node -> medium: sleep until time */
+  NATIVE_SIM_MSG_TX,    /**< node -> medium: frame starts now, lasts duration */
+  NATIVE_SIM_MSG_FRAME, /**< medium -> node: a frame started at time */
+  NATIVE_SIM_MSG_WAKE,  /**< medium -> node: run, the current time is time */
+};
+
+/** FRAME flag: the frame is on the air but too weak to be received */
+#define NATIVE_SIM_FRAME_LOST         0x01
+
+struct native_sim_msg {
+  uint64_t time;
+  uint64_t duration;
+  uint16_t node_id;
+  uint8_t type;
+  uint8_t channel;
+  uint8_t flags;
+  int8_t rssi;
+  uint8_t len;
+  uint8_t payload[NATIVE_SIM_MAX_FRAME_LEN];
+};
+/** @} */
+
+/**
+ * \brief Parse and strip the simulation arguments
+ *
+ * Recognizes --node-id=N and --medium=PATH. Without --medium the node
+ * runs alone, advancing its virtual clock as fast as it can.
+ */
+void native_sim_init(int *argc, char **argv);
+
+/** \brief The node ID given on the command line, or 0 */
+uint16_t native_sim_node_id(void);
+
+/** \brief The current virtual time, in microseconds */
+uint64_t native_sim_now(void);
+
+/** \brief Arm the (single) virtual rtimer */
+void native_sim_set_rtimer(uint64_t t);
+
+/**
+ * \brief Let virtual time advance
+ * \param until Latest time to return at
+ *
+ * Blocks until \p until or until the next event from the medium,
+ * whichever comes first. Outside of rtimer context, the wait also ends
+ * at the next rtimer, which is then run as an interrupt would be.
+ */
+void native_sim_wait(uint64_t until);
+
+/** \brief Put a frame on the air, starting now */
+void native_sim_transmit(uint8_t channel, const void *payload, uint8_t len,
+                         uint64_t duration);
+
+#endif /* NATIVE_SIM_H_ */
+/** @} */
@@ -55,6 +55,19 @@
 #endif
 
 /*---------------------------------------------------------------------------*/
+#if NATIVE_SIM
+void
+rtimer_arch_init(void)
+{
+}
+/*---------------------------------------------------------------------------*/
+void
+rtimer_arch_schedule(rtimer_clock_t t)
+{
+  native_sim_set_rtimer(t);
+}
+/*---------------------------------------------------------------------------*/
+#else /* NATIVE_SIM */
 static void
 interrupt(int sig)
 {
@@ -90,3 +103,4 @@ rtimer_arch_schedule(rtimer_clock_t t)
 #endif /* !_WIN32 */
 }
 /*---------------------------------------------------------------------------*/
+#endif /* NATIVE_SIM */
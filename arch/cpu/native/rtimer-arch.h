@@ -42,8 +42,32 @@
 
 #include "contiki.h"
 
+#if NATIVE_SIM
+#include "native-sim.h"
+
+/* Virtual time, in microseconds */
+#define RTIMER_ARCH_SECOND NATIVE_SIM_SECOND
+
+#define US_TO_RTIMERTICKS(US)   (US)
+#define RTIMERTICKS_TO_US(T)    (T)
+#define RTIMERTICKS_TO_US_64(T) (T)
+
+#define rtimer_arch_now() ((rtimer_clock_t)native_sim_now())
+
+/** \brief Busy-waiting lets virtual time advance to the deadline, or to
+ * the next event from the medium if it may change the condition. */
+#define RTIMER_BUSYWAIT_UNTIL_ABS(cond, t0, max_time) \
+  ({                                                                \
+    bool c;                                                         \
+    while(!(c = cond) && RTIMER_CLOCK_LT(RTIMER_NOW(), (t0) + (max_time))) { \
+      native_sim_wait((t0) + (max_time));                           \
+    }                                                               \
+    c;                                                              \
+  })
+#else /* NATIVE_SIM */
 #define RTIMER_ARCH_SECOND CLOCK_CONF_SECOND
 
 #define rtimer_arch_now() clock_time()
+#endif /* NATIVE_SIM */
 
 #endif /* RTIMER_ARCH_H_ */
@@ -37,16 +37,22 @@
  *         Adam Dunkels <adam@sics.se>
  */
 
+#include "contiki.h"
 #include "sys/clock.h"
 #include <time.h>
 #include <sys/time.h>
 
+#if NATIVE_SIM
+#include "native-sim.h"
+#endif /* NATIVE_SIM */
+
 /*---------------------------------------------------------------------------*/
 typedef struct clock_timespec_s {
   time_t  tv_sec;
   long  tv_nsec;
 } clock_timespec_t;
 /*---------------------------------------------------------------------------*/
+#if !NATIVE_SIM
 static void
 get_time(clock_timespec_t *spec)
 {
@@ -66,25 +72,34 @@ get_time(clock_timespec_t *spec)
   spec->tv_nsec = tv.tv_usec * 1000;
 #endif
 }
+#endif /* !NATIVE_SIM */
 /*---------------------------------------------------------------------------*/
 clock_time_t
 clock_time(void)
 {
+#if NATIVE_SIM
+  return native_sim_now() / (NATIVE_SIM_SECOND / CLOCK_SECOND);
+#else /* NATIVE_SIM */
   clock_timespec_t ts;
 
   get_time(&ts);
 
   return ts.tv_sec * CLOCK_SECOND + ts.tv_nsec / (1000000000 / CLOCK_SECOND);
+#endif /* NATIVE_SIM */
 }
 /*---------------------------------------------------------------------------*/
 unsigned long
 clock_seconds(void)
 {
+#if NATIVE_SIM
+  return native_sim_now() / NATIVE_SIM_SECOND;
+#else /* NATIVE_SIM */
   clock_timespec_t ts;
 
   get_time(&ts);
 
   return ts.tv_sec;
+#endif /* NATIVE_SIM */
 }
 /*---------------------------------------------------------------------------*/
 void
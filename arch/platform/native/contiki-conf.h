@@ -64,8 +64,25 @@ typedef unsigned int uip_stats_t;
 #define UIP_CONF_BYTE_ORDER      UIP_LITTLE_ENDIAN
 #endif
 
+#if NATIVE_SIM
+/* Nodes talk 802.15.4 over the simulated medium, in virtual time */
+#ifndef NETSTACK_CONF_RADIO
+#define NETSTACK_CONF_RADIO   native_sim_radio_driver
+#endif /* NETSTACK_CONF_RADIO */
+
+#define RTIMER_CONF_CLOCK_SIZE 8
+
+/* 2.4 GHz O-QPSK: 32 us per byte, preamble + SFD + length on top */
+#define RADIO_PHY_OVERHEAD         3
+#define RADIO_BYTE_AIR_TIME       32
+#define RADIO_DELAY_BEFORE_TX      0
+#define RADIO_DELAY_BEFORE_RX      0
+#define RADIO_DELAY_BEFORE_DETECT  0
+#endif /* NATIVE_SIM */
+
 #if NETSTACK_CONF_WITH_IPV6
 
+#if !NATIVE_SIM
 #ifndef NETSTACK_CONF_NETWORK
 #define NETSTACK_CONF_NETWORK    tun6_net_driver
 #endif
@@ -73,6 +90,7 @@ typedef unsigned int uip_stats_t;
 #ifndef NETSTACK_CONF_RADIO
 #define NETSTACK_CONF_RADIO   nullradio_driver
 #endif /* NETSTACK_CONF_RADIO */
+#endif /* !NATIVE_SIM */
 
 #define NETSTACK_CONF_LINUXRADIO_DEV "wpan0"
 
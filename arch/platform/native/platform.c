@@ -68,6 +68,11 @@
 #include "net/ipv6/uip-ds6.h"
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
+#if NATIVE_SIM
+#include "native-sim.h"
+#include "lib/random.h"
+#endif /* NATIVE_SIM */
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "Native"
@@ -102,11 +107,12 @@
 
 /*
  * Adds the STDIN file descriptor to the list of monitored file descriptors.
+ * Simulated nodes have no file descriptors to monitor.
  */
 #ifdef SELECT_CONF_STDIN
 #define SELECT_STDIN SELECT_CONF_STDIN
 #else
-#define SELECT_STDIN 1
+#define SELECT_STDIN (!NATIVE_SIM)
 #endif
 /** @} */
 /*---------------------------------------------------------------------------*/
@@ -188,6 +194,13 @@ set_lladdr(void)
   linkaddr_t addr;
 
   memset(&addr, 0, sizeof(linkaddr_t));
+#if NATIVE_SIM
+  /* Simulated nodes are told apart by their node ID */
+  if(native_sim_node_id() != 0) {
+    mac_addr[6] = native_sim_node_id() >> 8;
+    mac_addr[7] = native_sim_node_id() & 0xff;
+  }
+#endif /* NATIVE_SIM */
 #if NETSTACK_CONF_WITH_IPV6
   memcpy(addr.u8, mac_addr, sizeof(addr.u8));
 #else
@@ -199,7 +212,7 @@ set_lladdr(void)
   linkaddr_set_node_addr(&addr);
 }
 /*---------------------------------------------------------------------------*/
-#if NETSTACK_CONF_WITH_IPV6
+#if NETSTACK_CONF_WITH_IPV6 && !NATIVE_SIM
 static void
 set_global_address(void)
 {
@@ -231,6 +244,10 @@ char **contiki_argv;
 void
 platform_process_args(int argc, char **argv)
 {
+#if NATIVE_SIM
+  native_sim_init(&argc, argv);
+#endif /* NATIVE_SIM */
+
   /* crappy way of remembering and accessing argc/v */
   contiki_argc = argc;
   contiki_argv = argv;
@@ -263,6 +280,10 @@ platform_init_stage_two()
   set_lladdr();
   serial_line_init();
 
+#if NATIVE_SIM
+  random_init(native_sim_node_id());
+#endif /* NATIVE_SIM */
+
 #if SELECT_STDIN
   if(NULL == input_handler) {
     native_uart_set_input(serial_line_input_byte);
@@ -278,7 +299,9 @@ platform_init_stage_three()
   process_start(&wpcap_process, NULL);
 #endif
 
+#if !NATIVE_SIM
   set_global_address();
+#endif /* !NATIVE_SIM */
 
 #endif /* NETSTACK_CONF_WITH_IPV6 */
 
@@ -286,6 +309,27 @@ platform_init_stage_three()
   setvbuf(stdout, (char *)NULL, _IONBF, 0);
 }
 /*---------------------------------------------------------------------------*/
+#if NATIVE_SIM
+void
+platform_main_loop()
+{
+  uint64_t next;
+
+  /* No file descriptors: only the medium lets virtual time advance */
+  while(1) {
+    while(process_run() > 0);
+
+    next = NATIVE_SIM_FOREVER;
+    if(etimer_pending()) {
+      next = (uint64_t)etimer_next_expiration_time()
+        * (NATIVE_SIM_SECOND / CLOCK_SECOND);
+    }
+    native_sim_wait(next);
+
+    etimer_request_poll();
+  }
+}
+#else /* NATIVE_SIM */
 void
 platform_main_loop()
 {
@@ -331,6 +375,7 @@ platform_main_loop()
     etimer_request_poll();
   }
 }
+#endif /* NATIVE_SIM */
 /*---------------------------------------------------------------------------*/
 void
 log_message(char *m1, char *m2)
@@ -43,10 +43,78 @@
 #include "net/ipv6/uip-sr.h"
 #include "net/mac/tsch/tsch.h"
 #include "net/routing/routing.h"
+#if WITH_BURSTY_TRAFFIC
+#include "net/ipv6/simple-udp.h"
+#include <string.h>
+#endif /* WITH_BURSTY_TRAFFIC */
 
 #define DEBUG DEBUG_PRINT
 #include "net/ipv6/uip-debug.h"
 
+#if WITH_BURSTY_TRAFFIC
+/* All nodes send a burst of packets to the root at the same time, every
+ * BURST_INTERVAL of network uptime. The root prints the latency of each
+ * packet, which is meaningful as the network uptime is shared by all nodes. */
+#define BURST_PORT     5678
+#define BURST_SIZE     6
+#define BURST_INTERVAL (20 * CLOCK_SECOND)
+
+struct burst_msg {
+  uint32_t seqno;
+  uint32_t sent; /* network uptime, in clock ticks */
+};
+
+static struct simple_udp_connection burst_conn;
+/*---------------------------------------------------------------------------*/
+static void
+burst_rx_callback(struct simple_udp_connection *c,
+                  const uip_ipaddr_t *sender_addr, uint16_t sender_port,
+                  const uip_ipaddr_t *receiver_addr, uint16_t receiver_port,
+                  const uint8_t *data, uint16_t datalen)
+{
+  struct burst_msg msg;
+  if(datalen == sizeof(msg)) {
+    memcpy(&msg, data, sizeof(msg));
+    PRINTF("Burst rx from %u seqno %lu latency %lu ms\n",
+           sender_addr->u8[15], (unsigned long)msg.seqno,
+           (unsigned long)(((uint32_t)tsch_get_network_uptime_ticks() - msg.sent)
+                           * 1000 / CLOCK_SECOND));
+  }
+}
+#endif /* WITH_BURSTY_TRAFFIC */
+
+#if WITH_PERIODIC_REJOIN
+#include "lib/random.h"
+/* Non-root nodes leave the TSCH network at a random time in every
+ * REJOIN_INTERVAL, as if they had lost their time source. The TSCH logs
+ * tell how long they take to rejoin. */
+#define REJOIN_INTERVAL (60 * CLOCK_SECOND)
+
+PROCESS(rejoin_process, "Rejoin");
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rejoin_process, ev, data)
+{
+  static struct etimer et;
+  static clock_time_t offset;
+
+  PROCESS_BEGIN();
+
+  while(1) {
+    offset = random_rand() % REJOIN_INTERVAL;
+    etimer_set(&et, offset);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    if(tsch_is_associated) {
+      PRINTF("Leaving the TSCH network\n");
+      tsch_disassociate();
+    }
+    etimer_set(&et, REJOIN_INTERVAL - offset);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  PROCESS_END();
+}
+#endif /* WITH_PERIODIC_REJOIN */
+
 /*---------------------------------------------------------------------------*/
 PROCESS(node_process, "RPL Node");
 AUTOSTART_PROCESSES(&node_process);
@@ -60,7 +128,7 @@ PROCESS_THREAD(node_process, ev, data)
 
   is_coordinator = 0;
 
-#if CONTIKI_TARGET_COOJA || CONTIKI_TARGET_Z1
+#if CONTIKI_TARGET_COOJA || CONTIKI_TARGET_Z1 || CONTIKI_TARGET_NATIVE
   is_coordinator = (node_id == 1);
 #endif
 
@@ -69,6 +137,12 @@ PROCESS_THREAD(node_process, ev, data)
   }
   NETSTACK_MAC.on();
 
+#if WITH_PERIODIC_REJOIN
+  if(!is_coordinator) {
+    process_start(&rejoin_process, NULL);
+  }
+#endif /* WITH_PERIODIC_REJOIN */
+
 #if WITH_PERIODIC_ROUTES_PRINT
   {
     static struct etimer et;
@@ -88,6 +162,42 @@ PROCESS_THREAD(node_process, ev, data)
   }
 #endif /* WITH_PERIODIC_ROUTES_PRINT */
 
+#if WITH_BURSTY_TRAFFIC
+  simple_udp_register(&burst_conn, BURST_PORT, NULL, BURST_PORT, burst_rx_callback);
+  if(!is_coordinator) {
+    static struct etimer et;
+    static struct burst_msg msg;
+    static uint64_t next_burst;
+    uip_ipaddr_t root_addr;
+    int i;
+
+    while(1) {
+      /* Wait for the next burst, aligned on the network uptime */
+      if(tsch_is_associated) {
+        uint64_t now = tsch_get_network_uptime_ticks();
+        if(next_burst <= now) {
+          next_burst = (now / BURST_INTERVAL + 1) * BURST_INTERVAL;
+        }
+        etimer_set(&et, next_burst - now);
+      } else {
+        etimer_set(&et, BURST_INTERVAL);
+      }
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+      /* Do not send twice should we wake up slightly early */
+      next_burst += BURST_INTERVAL;
+      if(NETSTACK_ROUTING.node_is_reachable()
+         && NETSTACK_ROUTING.get_root_ipaddr(&root_addr)) {
+        for(i = 0; i < BURST_SIZE; i++) {
+          msg.seqno++;
+          msg.sent = (uint32_t)tsch_get_network_uptime_ticks();
+          simple_udp_sendto(&burst_conn, &msg, sizeof(msg), &root_addr);
+        }
+        PRINTF("Burst tx seqno %lu\n", (unsigned long)msg.seqno);
+      }
+    }
+  }
+#endif /* WITH_BURSTY_TRAFFIC */
+
   PROCESS_END();
 }
 /*---------------------------------------------------------------------------*/
@@ -58,6 +58,22 @@
  * Larger values result in less frequent active slots: reduces capacity and saves energy. */
 #define TSCH_SCHEDULE_CONF_DEFAULT_LENGTH 3
 
+#if WITH_ADAPTIVE_ORCHESTRA
+/* The adaptive Orchestra rule may negotiate cells with several neighbors
+ * at once */
+#define SIXTOP_CONF_MAX_TRANSACTIONS 4
+#endif /* WITH_ADAPTIVE_ORCHESTRA */
+
+#if WITH_FAST_JOIN
+/* Follow the network after leaving it, and solicit EBs */
+#define TSCH_CONF_WITH_FAST_JOIN 1
+#define TSCH_CONF_WITH_EB_SOLICITATION 1
+#if CONTIKI_TARGET_NATIVE
+/* Remember the network across reboots */
+#define TSCH_CONF_FAST_JOIN_WITH_CFS 1
+#endif /* CONTIKI_TARGET_NATIVE */
+#endif /* WITH_FAST_JOIN */
+
 #if WITH_SECURITY
 
 /* Enable security */
@@ -82,4 +98,13 @@
 #endif
 #define TSCH_LOG_CONF_PER_SLOT                     1
 
+#if CONTIKI_TARGET_NATIVE
+/* Simulated runs: print the slot operation profile every minute, and
+ * the per-channel TSCH statistics at debug level */
+#define TSCH_STATS_CONF_ON                         1
+#define TSCH_STATS_CONF_SAMPLE_NOISE_RSSI          1
+#define TSCH_STATS_CONF_PROFILE                    1
+#define TSCH_STATS_CONF_DECAY_INTERVAL             (60 * CLOCK_SECOND)
+#endif /* CONTIKI_TARGET_NATIVE */
+
 #endif /* PROJECT_CONF_H_ */
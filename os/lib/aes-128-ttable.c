@@ -0,0 +1,333 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-128 encryption with 32-bit T-tables and cached key
+ *         schedules. A single table is used; the other three are
+ *         rotations of it.
+ */
+
+#include "lib/aes-128-ttable.h"
+#include <string.h>
+
+#if AES_128_TTABLE_WITH_AESNI
+#include <wmmintrin.h>
+#endif /* AES_128_TTABLE_WITH_AESNI */
+
+#define ROUNDS 10
+#define SCHEDULE_WORDS (4 * (ROUNDS + 1))
+
+#define GETU32(p) (((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                   ((uint32_t)(p)[2] << 8) | (uint32_t)(p)[3])
+#define PUTU32(p, v) do {                                               \
+    (p)[0] = (uint8_t)((v) >> 24); (p)[1] = (uint8_t)((v) >> 16);       \
+    (p)[2] = (uint8_t)((v) >> 8); (p)[3] = (uint8_t)(v);                \
+  } while(0)
+#define ROTR(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+
+/* Te0[x] = { 2 * S[x], S[x], S[x], 3 * S[x] } */
+static const uint32_t te0[256] = {
+  0xc66363a5, 0xf87c7c84, 0xee777799, 0xf67b7b8d, 0xfff2f20d, 0xd66b6bbd,
+  0xde6f6fb1, 0x91c5c554, 0x60303050, 0x02010103, 0xce6767a9, 0x562b2b7d,
+  0xe7fefe19, 0xb5d7d762, 0x4dababe6, 0xec76769a, 0x8fcaca45, 0x1f82829d,
+  0x89c9c940, 0xfa7d7d87, 0xeffafa15, 0xb25959eb, 0x8e4747c9, 0xfbf0f00b,
+  0x41adadec, 0xb3d4d467, 0x5fa2a2fd, 0x45afafea, 0x239c9cbf, 0x53a4a4f7,
+  0xe4727296, 0x9bc0c05b, 0x75b7b7c2, 0xe1fdfd1c, 0x3d9393ae, 0x4c26266a,
+  0x6c36365a, 0x7e3f3f41, 0xf5f7f702, 0x83cccc4f, 0x6834345c, 0x51a5a5f4,
+  0xd1e5e534, 0xf9f1f108, 0xe2717193, 0xabd8d873, 0x62313153, 0x2a15153f,
+  0x0804040c, 0x95c7c752, 0x46232365, 0x9dc3c35e, 0x30181828, 0x379696a1,
+  0x0a05050f, 0x2f9a9ab5, 0x0e070709, 0x24121236, 0x1b80809b, 0xdfe2e23d,
+  0xcdebeb26, 0x4e272769, 0x7fb2b2cd, 0xea75759f, 0x1209091b, 0x1d83839e,
+  0x582c2c74, 0x341a1a2e, 0x361b1b2d, 0xdc6e6eb2, 0xb45a5aee, 0x5ba0a0fb,
+  0xa45252f6, 0x763b3b4d, 0xb7d6d661, 0x7db3b3ce, 0x5229297b, 0xdde3e33e,
+  0x5e2f2f71, 0x13848497, 0xa65353f5, 0xb9d1d168, 0x00000000, 0xc1eded2c,
+  0x40202060, 0xe3fcfc1f, 0x79b1b1c8, 0xb65b5bed, 0xd46a6abe, 0x8dcbcb46,
+  0x67bebed9, 0x7239394b, 0x944a4ade, 0x984c4cd4, 0xb05858e8, 0x85cfcf4a,
+  0xbbd0d06b, 0xc5efef2a, 0x4faaaae5, 0xedfbfb16, 0x864343c5, 0x9a4d4dd7,
+  0x66333355, 0x11858594, 0x8a4545cf, 0xe9f9f910, 0x04020206, 0xfe7f7f81,
+  0xa05050f0, 0x783c3c44, 0x259f9fba, 0x4ba8a8e3, 0xa25151f3, 0x5da3a3fe,
+  0x804040c0, 0x058f8f8a, 0x3f9292ad, 0x219d9dbc, 0x70383848, 0xf1f5f504,
+  0x63bcbcdf, 0x77b6b6c1, 0xafdada75, 0x42212163, 0x20101030, 0xe5ffff1a,
+  0xfdf3f30e, 0xbfd2d26d, 0x81cdcd4c, 0x180c0c14, 0x26131335, 0xc3ecec2f,
+  0xbe5f5fe1, 0x359797a2, 0x884444cc, 0x2e171739, 0x93c4c457, 0x55a7a7f2,
+  0xfc7e7e82, 0x7a3d3d47, 0xc86464ac, 0xba5d5de7, 0x3219192b, 0xe6737395,
+  0xc06060a0, 0x19818198, 0x9e4f4fd1, 0xa3dcdc7f, 0x44222266, 0x542a2a7e,
+  0x3b9090ab, 0x0b888883, 0x8c4646ca, 0xc7eeee29, 0x6bb8b8d3, 0x2814143c,
+  0xa7dede79, 0xbc5e5ee2, 0x160b0b1d, 0xaddbdb76, 0xdbe0e03b, 0x64323256,
+  0x743a3a4e, 0x140a0a1e, 0x924949db, 0x0c06060a, 0x4824246c, 0xb85c5ce4,
+  0x9fc2c25d, 0xbdd3d36e, 0x43acacef, 0xc46262a6, 0x399191a8, 0x319595a4,
+  0xd3e4e437, 0xf279798b, 0xd5e7e732, 0x8bc8c843, 0x6e373759, 0xda6d6db7,
+  0x018d8d8c, 0xb1d5d564, 0x9c4e4ed2, 0x49a9a9e0, 0xd86c6cb4, 0xac5656fa,
+  0xf3f4f407, 0xcfeaea25, 0xca6565af, 0xf47a7a8e, 0x47aeaee9, 0x10080818,
+  0x6fbabad5, 0xf0787888, 0x4a25256f, 0x5c2e2e72, 0x381c1c24, 0x57a6a6f1,
+  0x73b4b4c7, 0x97c6c651, 0xcbe8e823, 0xa1dddd7c, 0xe874749c, 0x3e1f1f21,
+  0x964b4bdd, 0x61bdbddc, 0x0d8b8b86, 0x0f8a8a85, 0xe0707090, 0x7c3e3e42,
+  0x71b5b5c4, 0xcc6666aa, 0x904848d8, 0x06030305, 0xf7f6f601, 0x1c0e0e12,
+  0xc26161a3, 0x6a35355f, 0xae5757f9, 0x69b9b9d0, 0x17868691, 0x99c1c158,
+  0x3a1d1d27, 0x279e9eb9, 0xd9e1e138, 0xebf8f813, 0x2b9898b3, 0x22111133,
+  0xd26969bb, 0xa9d9d970, 0x078e8e89, 0x339494a7, 0x2d9b9bb6, 0x3c1e1e22,
+  0x15878792, 0xc9e9e920, 0x87cece49, 0xaa5555ff, 0x50282878, 0xa5dfdf7a,
+  0x038c8c8f, 0x59a1a1f8, 0x09898980, 0x1a0d0d17, 0x65bfbfda, 0xd7e6e631,
+  0x844242c6, 0xd06868b8, 0x824141c3, 0x299999b0, 0x5a2d2d77, 0x1e0f0f11,
+  0x7bb0b0cb, 0xa85454fc, 0x6dbbbbd6, 0x2c16163a,
+};
+#define SBOX(x) ((uint8_t)(te0[(x)] >> 16))
+#define TE0(x) te0[(x)]
+#define TE1(x) ROTR(te0[(x)], 8)
+#define TE2(x) ROTR(te0[(x)], 16)
+#define TE3(x) ROTR(te0[(x)], 24)
+
+struct key_schedule {
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t valid;
+  union {
+    /* Round keys as big-endian words for the table implementation */
+    uint32_t w[SCHEDULE_WORDS];
+    /* ... or as bytes for AES-NI */
+    uint8_t b[SCHEDULE_WORDS * 4];
+  } rk;
+};
+
+static struct key_schedule cache[AES_128_TTABLE_KEY_CACHE_SIZE];
+static struct key_schedule *current = &cache[0];
+static uint8_t next_victim;
+
+#if AES_128_TTABLE_WITH_AESNI
+/* 0: not checked yet, 1: not available, 2: available */
+static uint8_t aesni_state;
+#define USE_AESNI() (aesni_state == 2)
+#else /* AES_128_TTABLE_WITH_AESNI */
+#define USE_AESNI() 0
+#endif /* AES_128_TTABLE_WITH_AESNI */
+
+/*---------------------------------------------------------------------------*/
+static void
+expand_key(struct key_schedule *ks, const uint8_t *key)
+{
+  uint32_t *rk;
+  uint32_t t;
+  uint8_t rcon;
+  int i;
+
+  rk = ks->rk.w;
+  for(i = 0; i < 4; i++) {
+    rk[i] = GETU32(key + 4 * i);
+  }
+  rcon = 0x01;
+  for(i = 4; i < SCHEDULE_WORDS; i++) {
+    t = rk[i - 1];
+    if((i & 3) == 0) {
+      t = ((uint32_t)(SBOX((t >> 16) & 0xff) ^ rcon) << 24) |
+        ((uint32_t)SBOX((t >> 8) & 0xff) << 16) |
+        ((uint32_t)SBOX(t & 0xff) << 8) |
+        (uint32_t)SBOX(t >> 24);
+      rcon = (rcon << 1) ^ ((rcon >> 7) * 0x1b);
+    }
+    rk[i] = rk[i - 4] ^ t;
+  }
+
+  if(USE_AESNI()) {
+    /* Store the words in place as bytes, in the order AES-NI wants */
+    for(i = 0; i < SCHEDULE_WORDS; i++) {
+      t = rk[i];
+      PUTU32(ks->rk.b + 4 * i, t);
+    }
+  }
+
+  memcpy(ks->key, key, AES_128_KEY_LENGTH);
+  ks->valid = 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  int i;
+
+#if AES_128_TTABLE_WITH_AESNI
+  if(aesni_state == 0) {
+    __builtin_cpu_init();
+    aesni_state = __builtin_cpu_supports("aes") ? 2 : 1;
+  }
+#endif /* AES_128_TTABLE_WITH_AESNI */
+
+  if(current->valid && !memcmp(current->key, key, AES_128_KEY_LENGTH)) {
+    return;
+  }
+  for(i = 0; i < AES_128_TTABLE_KEY_CACHE_SIZE; i++) {
+    if(cache[i].valid && !memcmp(cache[i].key, key, AES_128_KEY_LENGTH)) {
+      current = &cache[i];
+      return;
+    }
+  }
+
+  current = &cache[next_victim];
+  next_victim = (next_victim + 1) % AES_128_TTABLE_KEY_CACHE_SIZE;
+  expand_key(current, key);
+}
+/*---------------------------------------------------------------------------*/
+#if AES_128_TTABLE_WITH_AESNI
+__attribute__((target("aes,sse2")))
+static void
+encrypt_aesni(uint8_t *state)
+{
+  const __m128i *rk;
+  __m128i s;
+  int round;
+
+  rk = (const __m128i *)current->rk.b;
+  s = _mm_xor_si128(_mm_loadu_si128((const __m128i *)state),
+                    _mm_loadu_si128(rk));
+  for(round = 1; round < ROUNDS; round++) {
+    s = _mm_aesenc_si128(s, _mm_loadu_si128(rk + round));
+  }
+  s = _mm_aesenclast_si128(s, _mm_loadu_si128(rk + ROUNDS));
+  _mm_storeu_si128((__m128i *)state, s);
+}
+/*---------------------------------------------------------------------------*/
+/* Up to four blocks at a time, so that their rounds overlap */
+__attribute__((target("aes,sse2")))
+static void
+encrypt_blocks_aesni(uint8_t *blocks, uint8_t n)
+{
+  const __m128i *rk;
+  __m128i *p;
+  __m128i s[4];
+  __m128i k;
+  int round;
+  int i;
+  int count;
+
+  rk = (const __m128i *)current->rk.b;
+  p = (__m128i *)blocks;
+  while(n > 0) {
+    count = MIN(n, 4);
+    k = _mm_loadu_si128(rk);
+    for(i = 0; i < count; i++) {
+      s[i] = _mm_xor_si128(_mm_loadu_si128(p + i), k);
+    }
+    for(round = 1; round < ROUNDS; round++) {
+      k = _mm_loadu_si128(rk + round);
+      for(i = 0; i < count; i++) {
+        s[i] = _mm_aesenc_si128(s[i], k);
+      }
+    }
+    k = _mm_loadu_si128(rk + ROUNDS);
+    for(i = 0; i < count; i++) {
+      _mm_storeu_si128(p + i, _mm_aesenclast_si128(s[i], k));
+    }
+    p += count;
+    n -= count;
+  }
+}
+#endif /* AES_128_TTABLE_WITH_AESNI */
+/*---------------------------------------------------------------------------*/
+static void
+encrypt(uint8_t *state)
+{
+  const uint32_t *rk;
+  uint32_t s0, s1, s2, s3;
+  uint32_t t0, t1, t2, t3;
+  int round;
+
+#if AES_128_TTABLE_WITH_AESNI
+  if(USE_AESNI()) {
+    encrypt_aesni(state);
+    return;
+  }
+#endif /* AES_128_TTABLE_WITH_AESNI */
+
+  rk = current->rk.w;
+  s0 = GETU32(state) ^ rk[0];
+  s1 = GETU32(state + 4) ^ rk[1];
+  s2 = GETU32(state + 8) ^ rk[2];
+  s3 = GETU32(state + 12) ^ rk[3];
+
+  for(round = 1; round < ROUNDS; round++) {
+    rk += 4;
+    t0 = TE0(s0 >> 24) ^ TE1((s1 >> 16) & 0xff) ^
+      TE2((s2 >> 8) & 0xff) ^ TE3(s3 & 0xff) ^ rk[0];
+    t1 = TE0(s1 >> 24) ^ TE1((s2 >> 16) & 0xff) ^
+      TE2((s3 >> 8) & 0xff) ^ TE3(s0 & 0xff) ^ rk[1];
+    t2 = TE0(s2 >> 24) ^ TE1((s3 >> 16) & 0xff) ^
+      TE2((s0 >> 8) & 0xff) ^ TE3(s1 & 0xff) ^ rk[2];
+    t3 = TE0(s3 >> 24) ^ TE1((s0 >> 16) & 0xff) ^
+      TE2((s1 >> 8) & 0xff) ^ TE3(s2 & 0xff) ^ rk[3];
+    s0 = t0;
+    s1 = t1;
+    s2 = t2;
+    s3 = t3;
+  }
+
+  /* The last round has no MixColumns */
+  rk += 4;
+  t0 = ((uint32_t)SBOX(s0 >> 24) << 24) ^
+    ((uint32_t)SBOX((s1 >> 16) & 0xff) << 16) ^
+    ((uint32_t)SBOX((s2 >> 8) & 0xff) << 8) ^
+    (uint32_t)SBOX(s3 & 0xff) ^ rk[0];
+  t1 = ((uint32_t)SBOX(s1 >> 24) << 24) ^
+    ((uint32_t)SBOX((s2 >> 16) & 0xff) << 16) ^
+    ((uint32_t)SBOX((s3 >> 8) & 0xff) << 8) ^
+    (uint32_t)SBOX(s0 & 0xff) ^ rk[1];
+  t2 = ((uint32_t)SBOX(s2 >> 24) << 24) ^
+    ((uint32_t)SBOX((s3 >> 16) & 0xff) << 16) ^
+    ((uint32_t)SBOX((s0 >> 8) & 0xff) << 8) ^
+    (uint32_t)SBOX(s1 & 0xff) ^ rk[2];
+  t3 = ((uint32_t)SBOX(s3 >> 24) << 24) ^
+    ((uint32_t)SBOX((s0 >> 16) & 0xff) << 16) ^
+    ((uint32_t)SBOX((s1 >> 8) & 0xff) << 8) ^
+    (uint32_t)SBOX(s2 & 0xff) ^ rk[3];
+  PUTU32(state, t0);
+  PUTU32(state + 4, t1);
+  PUTU32(state + 8, t2);
+  PUTU32(state + 12, t3);
+}
+/*---------------------------------------------------------------------------*/
+static void
+encrypt_blocks(uint8_t *blocks, uint8_t n)
+{
+#if AES_128_TTABLE_WITH_AESNI
+  if(USE_AESNI()) {
+    encrypt_blocks_aesni(blocks, n);
+    return;
+  }
+#endif /* AES_128_TTABLE_WITH_AESNI */
+
+  for(; n > 0; n--) {
+    encrypt(blocks);
+    blocks += AES_128_BLOCK_SIZE;
+  }
+}
+/*---------------------------------------------------------------------------*/
+const struct aes_128_driver aes_128_ttable_driver = {
+  set_key,
+  encrypt,
+  encrypt_blocks
+};
+/*---------------------------------------------------------------------------*/
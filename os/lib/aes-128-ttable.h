@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES-128 software driver using 32-bit lookup tables. Expanded
+ *         key schedules are cached, so that switching between a few
+ *         keys (per neighbor or per key index) does not redo the key
+ *         expansion. On x86 hosts, AES-NI is used when the CPU has it.
+ */
+
+#ifndef AES_128_TTABLE_H_
+#define AES_128_TTABLE_H_
+
+#include "lib/aes-128.h"
+
+/* Number of expanded key schedules kept */
+#ifdef AES_128_TTABLE_CONF_KEY_CACHE_SIZE
+#define AES_128_TTABLE_KEY_CACHE_SIZE AES_128_TTABLE_CONF_KEY_CACHE_SIZE
+#else /* AES_128_TTABLE_CONF_KEY_CACHE_SIZE */
+#define AES_128_TTABLE_KEY_CACHE_SIZE 4
+#endif /* AES_128_TTABLE_CONF_KEY_CACHE_SIZE */
+
+/* Use AES-NI instructions if the CPU supports them (x86 with GCC or clang) */
+#ifdef AES_128_TTABLE_CONF_WITH_AESNI
+#define AES_128_TTABLE_WITH_AESNI AES_128_TTABLE_CONF_WITH_AESNI
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define AES_128_TTABLE_WITH_AESNI 1
+#else
+#define AES_128_TTABLE_WITH_AESNI 0
+#endif
+
+extern const struct aes_128_driver aes_128_ttable_driver;
+
+#endif /* AES_128_TTABLE_H_ */
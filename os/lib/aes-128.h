@@ -65,6 +65,13 @@ struct aes_128_driver {
    * \brief Encrypts.
    */
   void (* encrypt)(uint8_t *plaintext_and_result);
+
+  /**
+   * \brief Encrypts n consecutive blocks independently of each other.
+   *        Optional (may be NULL); drivers that can overlap the work
+   *        on several blocks should provide it.
+   */
+  void (* encrypt_blocks)(uint8_t *plaintexts_and_results, uint8_t n);
 };
 
 extern const struct aes_128_driver AES_128;
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         AES_128-based CCM* implementation, single pass.
+ */
+
+#include "lib/ccm-star-single-pass.h"
+#include "lib/aes-128.h"
+#include <string.h>
+
+/* As per RFC 3610. L == 2 (m_len is two bytes long). */
+#define CCM_STAR_AUTH_FLAGS(AUTH, MICLEN) (((AUTH) ? (1u << 6) : 0) | ((((MICLEN) - 2u) >> 1) << 3) | 1u)
+#define CCM_STAR_ENCRYPTION_FLAGS     1
+/* The auth data can have a variable length, but this implementation supports
+ * only the case of 0 < l(a) < (2^16 - 2^8) */
+#define MAX_A_LEN 0xfeff
+/* Valid values are 4, 6, 8, 10, 12, 14, and 16 octets */
+#define MIC_LEN_VALID(x) ((x) >= 4 && (x) <= 16 && (x) % 2 == 0)
+
+typedef union {
+  uint8_t u8[AES_128_BLOCK_SIZE];
+  uint32_t u32[AES_128_BLOCK_SIZE / 4];
+} block_t;
+
+/* The CBC-MAC state and a CTR block, encrypted together */
+#define CBC 0
+#define CTR 1
+
+/*---------------------------------------------------------------------------*/
+static void
+encrypt_blocks(block_t *blocks, uint8_t n)
+{
+  uint8_t i;
+
+  if(AES_128.encrypt_blocks) {
+    AES_128.encrypt_blocks(blocks[0].u8, n);
+  } else {
+    for(i = 0; i < n; i++) {
+      AES_128.encrypt(blocks[i].u8);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* dst ^= src, a word at a time for full blocks */
+static void
+xor_block(uint8_t *dst, const uint8_t *src, uint8_t len)
+{
+  uint32_t d;
+  uint32_t s;
+  uint8_t i;
+
+  if(len == AES_128_BLOCK_SIZE) {
+    for(i = 0; i < AES_128_BLOCK_SIZE; i += 4) {
+      memcpy(&d, dst + i, 4);
+      memcpy(&s, src + i, 4);
+      d ^= s;
+      memcpy(dst + i, &d, 4);
+    }
+  } else {
+    for(i = 0; i < len; i++) {
+      dst[i] ^= src[i];
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_counter(block_t *block, const block_t *a0, uint16_t counter)
+{
+  *block = *a0;
+  block->u8[14] = counter >> 8;
+  block->u8[15] = counter;
+}
+/*---------------------------------------------------------------------------*/
+static void
+set_key(const uint8_t *key)
+{
+  AES_128.set_key(key);
+}
+/*---------------------------------------------------------------------------*/
+static void
+aead(const uint8_t* nonce,
+    uint8_t* m, uint16_t m_len,
+    const uint8_t* a, uint16_t a_len,
+    uint8_t *result, uint8_t mic_len,
+    int forward)
+{
+  block_t b[2];
+  block_t a0;
+  uint32_t pos; /* 32-bits as can need to exceed the lengths to end loops */
+  uint16_t counter;
+  uint8_t len;
+
+  if(a_len > MAX_A_LEN || !MIC_LEN_VALID(mic_len)) {
+    return;
+  }
+
+  /* A_0; A_i only differ in the counter */
+  a0.u8[0] = CCM_STAR_ENCRYPTION_FLAGS;
+  memcpy(a0.u8 + 1, nonce, CCM_STAR_NONCE_LENGTH);
+  a0.u8[14] = 0;
+  a0.u8[15] = 0;
+
+  /* B_0. Throughout, b[CBC] holds the next CBC-MAC input, not yet
+     encrypted. */
+  b[CBC].u8[0] = CCM_STAR_AUTH_FLAGS(a_len > 0, mic_len);
+  memcpy(b[CBC].u8 + 1, nonce, CCM_STAR_NONCE_LENGTH);
+  b[CBC].u8[14] = m_len >> 8;
+  b[CBC].u8[15] = m_len;
+
+  if(a_len) {
+    AES_128.encrypt(b[CBC].u8);
+    b[CBC].u8[0] ^= a_len >> 8;
+    b[CBC].u8[1] ^= a_len;
+    len = MIN(a_len, AES_128_BLOCK_SIZE - 2);
+    xor_block(b[CBC].u8 + 2, a, len);
+    for(pos = len; pos < a_len; pos += AES_128_BLOCK_SIZE) {
+      AES_128.encrypt(b[CBC].u8);
+      len = MIN(a_len - pos, AES_128_BLOCK_SIZE);
+      xor_block(b[CBC].u8, a + pos, len);
+    }
+  }
+
+  /* Each CBC-MAC block goes with the CTR block of the message block
+     that follows it */
+  counter = 1;
+  for(pos = 0; pos < m_len; pos += AES_128_BLOCK_SIZE) {
+    len = MIN(m_len - pos, AES_128_BLOCK_SIZE);
+    set_counter(&b[CTR], &a0, counter++);
+    encrypt_blocks(b, 2);
+    if(forward) {
+      xor_block(b[CBC].u8, m + pos, len);
+      xor_block(m + pos, b[CTR].u8, len);
+    } else {
+      xor_block(m + pos, b[CTR].u8, len);
+      xor_block(b[CBC].u8, m + pos, len);
+    }
+  }
+
+  /* The last CBC-MAC block gives T, and A_0 gives the key stream for
+     the MIC */
+  b[CTR] = a0;
+  encrypt_blocks(b, 2);
+  xor_block(b[CBC].u8, b[CTR].u8, AES_128_BLOCK_SIZE);
+  memcpy(result, b[CBC].u8, mic_len);
+}
+/*---------------------------------------------------------------------------*/
+const struct ccm_star_driver ccm_star_single_pass_driver = {
+  set_key,
+  aead
+};
+/*---------------------------------------------------------------------------*/
@@ -55,6 +55,28 @@
 #ifndef CRC16_H_
 #define CRC16_H_
 
+/**
+ * Implementations of crc16_data(), selected with CRC16_CONF_IMPL.
+ *
+ * The bitwise implementation needs no tables. The table-driven one
+ * uses a 512-byte table, and slice-by-4 and slice-by-8 use four and
+ * eight such tables to handle as many bytes per step. The carry-less
+ * multiplication one is slice-by-8 that, on x86 CPUs with PCLMULQDQ,
+ * folds 16 bytes per step for blocks of 32 bytes and more.
+ * crc16_add() is always the bitwise implementation.
+ */
+#define CRC16_IMPL_BITWISE 0
+#define CRC16_IMPL_TABLE   1
+#define CRC16_IMPL_SLICE4  2
+#define CRC16_IMPL_SLICE8  3
+#define CRC16_IMPL_CLMUL   4
+
+#ifdef CRC16_CONF_IMPL
+#define CRC16_IMPL CRC16_CONF_IMPL
+#else /* CRC16_CONF_IMPL */
+#define CRC16_IMPL CRC16_IMPL_BITWISE
+#endif /* CRC16_CONF_IMPL */
+
 /**
  * \brief      Update an accumulated CRC16 checksum with one byte.
  * \param b    The byte to be added to the checksum
@@ -82,10 +104,10 @@ unsigned short crc16_add(unsigned char b, unsigned short crc);
  *
  *             This function calculates the CRC16 checksum of a data area.
  *
- *             \note The algorithm used in this implementation is
- *             tailored for a running checksum and does not perform as
- *             well as a table-driven algorithm when checksumming an
- *             entire data block.
+ *             \note With the default CRC16_IMPL_BITWISE, the algorithm
+ *             is the one of crc16_add(), which does not perform as well
+ *             as a table-driven algorithm when checksumming an entire
+ *             data block. See CRC16_CONF_IMPL.
  */
 unsigned short crc16_data(const unsigned char *data, int datalen,
 			  unsigned short acc);
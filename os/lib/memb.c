@@ -47,12 +47,45 @@
 #include "contiki.h"
 #include "lib/memb.h"
 
+#if MEMB_WITH_STATS
+static struct memb *stats_head;
+/*---------------------------------------------------------------------------*/
+static void
+stats_register(struct memb *m)
+{
+  if(!m->registered) {
+    m->registered = true;
+    m->next = stats_head;
+    stats_head = m;
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct memb *
+memb_stats_head(void)
+{
+  return stats_head;
+}
+/*---------------------------------------------------------------------------*/
+void
+memb_stats_reset(void)
+{
+  struct memb *m;
+
+  for(m = stats_head; m != NULL; m = m->next) {
+    m->max_count = m->count;
+  }
+}
+#endif /* MEMB_WITH_STATS */
 /*---------------------------------------------------------------------------*/
 void
 memb_init(struct memb *m)
 {
   memset(m->used, 0, m->num);
   memset(m->mem, 0, m->size * m->num);
+#if MEMB_WITH_STATS
+  m->count = 0;
+  stats_register(m);
+#endif /* MEMB_WITH_STATS */
 }
 /*---------------------------------------------------------------------------*/
 void *
@@ -65,6 +98,12 @@ memb_alloc(struct memb *m)
       /* If this block was unused, we set the used flag on
 	 and return a pointer to the memory block. */
       m->used[i] = true;
+#if MEMB_WITH_STATS
+      stats_register(m);
+      if(++m->count > m->max_count) {
+        m->max_count = m->count;
+      }
+#endif /* MEMB_WITH_STATS */
       return (void *)((char *)m->mem + (i * m->size));
     }
   }
@@ -90,6 +129,9 @@ memb_free(struct memb *m, void *ptr)
       if (m->used[i] == false)
         return -1;
       m->used[i] = false;
+#if MEMB_WITH_STATS
+      m->count--;
+#endif /* MEMB_WITH_STATS */
       return 0;
     }
     ptr2 += m->size;
@@ -67,6 +67,17 @@
 #include <stdlib.h>
 #include "sys/cc.h"
 
+/**
+ * With MEMB_CONF_WITH_STATS, every memory block keeps its name and the
+ * high-water mark of blocks in use. Memory blocks are listed, for
+ * memb_stats_head(), once they are initialized or first allocated from.
+ */
+#ifdef MEMB_CONF_WITH_STATS
+#define MEMB_WITH_STATS MEMB_CONF_WITH_STATS
+#else /* MEMB_CONF_WITH_STATS */
+#define MEMB_WITH_STATS 0
+#endif /* MEMB_CONF_WITH_STATS */
+
 /**
  * Declare a memory block.
  *
@@ -88,18 +99,36 @@ MEMB(connections, struct connection, 16);
  * \param num The total number of memory chunks in the block.
  *
  */
+#if MEMB_WITH_STATS
+#define MEMB(name, structure, num) \
+        static bool CC_CONCAT(name,_memb_used)[num]; \
+        static structure CC_CONCAT(name,_memb_mem)[num]; \
+        static struct memb name = {sizeof(structure), num, \
+                                          CC_CONCAT(name,_memb_used), \
+                                          (void *)CC_CONCAT(name,_memb_mem), \
+                                          #name}
+#else /* MEMB_WITH_STATS */
 #define MEMB(name, structure, num) \
         static bool CC_CONCAT(name,_memb_used)[num]; \
         static structure CC_CONCAT(name,_memb_mem)[num]; \
         static struct memb name = {sizeof(structure), num, \
                                           CC_CONCAT(name,_memb_used), \
                                           (void *)CC_CONCAT(name,_memb_mem)}
+#endif /* MEMB_WITH_STATS */
 
 struct memb {
   unsigned short size;
   unsigned short num;
   bool *used;
   void *mem;
+#if MEMB_WITH_STATS
+  const char *name;
+  /* Blocks in use, and the most that have been in use at once */
+  unsigned short count;
+  unsigned short max_count;
+  bool registered;
+  struct memb *next;
+#endif /* MEMB_WITH_STATS */
 };
 
 /**
@@ -150,6 +179,20 @@ int memb_inmemb(struct memb *m, void *ptr);
  */
 size_t memb_numfree(struct memb *m);
 
+#if MEMB_WITH_STATS
+/**
+ * Get the first of the memory blocks in use; the others follow through
+ * their next field.
+ */
+struct memb *memb_stats_head(void);
+
+/**
+ * Restart the high-water marks of all memory blocks from the number of
+ * blocks in use now.
+ */
+void memb_stats_reset(void);
+#endif /* MEMB_WITH_STATS */
+
 /** @} */
 /** @} */
 
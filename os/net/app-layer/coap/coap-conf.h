@@ -112,5 +112,13 @@
 #define COAP_OBSERVER_URL_LEN 20
 #endif
 
+/* Number of buckets (a power of two) in the table that resolves a
+   Uri-Path to its resource. Set to 1 for a single chain. */
+#ifdef COAP_CONF_RESOURCE_HASH_SIZE
+#define COAP_RESOURCE_HASH_SIZE COAP_CONF_RESOURCE_HASH_SIZE
+#else
+#define COAP_RESOURCE_HASH_SIZE 16
+#endif
+
 #endif /* COAP_CONF_H_ */
 /** @} */
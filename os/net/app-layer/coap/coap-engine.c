@@ -72,6 +72,16 @@ LIST(coap_handlers);
 LIST(coap_resource_services);
 static uint8_t is_initialized = 0;
 
+/* Resources hashed on their full URL. The hash is computed
+   incrementally, so a single pass over a Uri-Path yields the bucket of
+   every parent path as well. */
+static coap_resource_t *resource_hash[COAP_RESOURCE_HASH_SIZE];
+static uint16_t resource_order;
+
+#define URL_HASH_INIT       5381
+#define URL_HASH_STEP(h, c) ((uint16_t)((h) * 33 + (uint8_t)(c)))
+#define URL_HASH_BUCKET(h)  ((h) & (COAP_RESOURCE_HASH_SIZE - 1))
+
 /*---------------------------------------------------------------------------*/
 /*- CoAP service handlers---------------------------------------------------*/
 /*---------------------------------------------------------------------------*/
@@ -386,6 +396,18 @@ coap_engine_init(void)
   coap_init_connection();
 }
 /*---------------------------------------------------------------------------*/
+static coap_resource_t **
+url_bucket(const char *url, int url_len)
+{
+  uint16_t h = URL_HASH_INIT;
+  int i;
+
+  for(i = 0; i < url_len; i++) {
+    h = URL_HASH_STEP(h, url[i]);
+  }
+  return &resource_hash[URL_HASH_BUCKET(h)];
+}
+/*---------------------------------------------------------------------------*/
 /**
  * \brief Makes a resource available under the given URI path
  *
@@ -397,7 +419,25 @@ void
 coap_activate_resource(coap_resource_t *resource, const char *path)
 {
   coap_periodic_resource_t *periodic;
+  coap_resource_t **r;
+
+  if(resource->url != NULL) {
+    /* Activated before: unlink it from the bucket of its old path */
+    for(r = url_bucket(resource->url, resource->url_len); *r != NULL;
+        r = &(*r)->hash_next) {
+      if(*r == resource) {
+        *r = resource->hash_next;
+        break;
+      }
+    }
+  }
+
   resource->url = path;
+  resource->url_len = strlen(path);
+  resource->order = resource_order++;
+  r = url_bucket(path, resource->url_len);
+  resource->hash_next = *r;
+  *r = resource;
   list_add(coap_resource_services, resource);
 
   LOG_INFO("Activating: %s\n", resource->url);
@@ -430,6 +470,35 @@ coap_get_next_resource(coap_resource_t *resource)
   return list_item_next(resource);
 }
 /*---------------------------------------------------------------------------*/
+coap_resource_t *
+coap_get_resource_by_path(const char *url, int url_len)
+{
+  coap_resource_t *best = NULL;
+  coap_resource_t *resource;
+  uint16_t h = URL_HASH_INIT;
+  int i;
+
+  /* Look up the full path, and every prefix that ends at a '/' for a
+     parent resource */
+  for(i = 0; i <= url_len; i++) {
+    if(i == url_len || url[i] == '/') {
+      for(resource = resource_hash[URL_HASH_BUCKET(h)];
+          resource != NULL; resource = resource->hash_next) {
+        if(resource->url_len == i
+           && (i == url_len || (resource->flags & HAS_SUB_RESOURCES))
+           && (best == NULL || resource->order < best->order)
+           && (i == 0 || memcmp(resource->url, url, i) == 0)) {
+          best = resource;
+        }
+      }
+    }
+    if(i < url_len) {
+      h = URL_HASH_STEP(h, url[i]);
+    }
+  }
+  return best;
+}
+/*---------------------------------------------------------------------------*/
 static int
 invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
                              uint8_t *buffer, uint16_t buffer_size,
@@ -440,44 +509,35 @@ invoke_coap_resource_service(coap_message_t *request, coap_message_t *response,
 
   coap_resource_t *resource = NULL;
   const char *url = NULL;
-  int url_len, res_url_len;
+  int url_len;
 
   url_len = coap_get_header_uri_path(request, &url);
-  for(resource = list_head(coap_resource_services);
-      resource; resource = resource->next) {
-
+  resource = coap_get_resource_by_path(url, url_len);
+  if(resource != NULL) {
     /* if the web service handles that kind of requests and urls matches */
-    res_url_len = strlen(resource->url);
-    if((url_len == res_url_len
-        || (url_len > res_url_len
-            && (resource->flags & HAS_SUB_RESOURCES)
-            && url[res_url_len] == '/'))
-       && strncmp(resource->url, url, res_url_len) == 0) {
-      coap_resource_flags_t method = coap_get_method_type(request);
-      found = 1;
-
-      LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
-               (uint16_t)method, resource->flags);
-
-      if((method & METHOD_GET) && resource->get_handler != NULL) {
-        /* call handler function */
-        resource->get_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_POST) && resource->post_handler != NULL) {
-        /* call handler function */
-        resource->post_handler(request, response, buffer, buffer_size,
+    coap_resource_flags_t method = coap_get_method_type(request);
+    found = 1;
+
+    LOG_INFO("/%s, method %u, resource->flags %u\n", resource->url,
+             (uint16_t)method, resource->flags);
+
+    if((method & METHOD_GET) && resource->get_handler != NULL) {
+      /* call handler function */
+      resource->get_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_POST) && resource->post_handler != NULL) {
+      /* call handler function */
+      resource->post_handler(request, response, buffer, buffer_size,
+                             offset);
+    } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
+      /* call handler function */
+      resource->put_handler(request, response, buffer, buffer_size, offset);
+    } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
+      /* call handler function */
+      resource->delete_handler(request, response, buffer, buffer_size,
                                offset);
-      } else if((method & METHOD_PUT) && resource->put_handler != NULL) {
-        /* call handler function */
-        resource->put_handler(request, response, buffer, buffer_size, offset);
-      } else if((method & METHOD_DELETE) && resource->delete_handler != NULL) {
-        /* call handler function */
-        resource->delete_handler(request, response, buffer, buffer_size,
-                                 offset);
-      } else {
-        allowed = 0;
-        coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
-      }
-      break;
+    } else {
+      allowed = 0;
+      coap_set_status_code(response, METHOD_NOT_ALLOWED_4_05);
     }
   }
   if(!found) {
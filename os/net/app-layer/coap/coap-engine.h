@@ -111,6 +111,9 @@ struct coap_resource_s {
     coap_resource_trigger_handler_t trigger;
     coap_resource_trigger_handler_t resume;
   };
+  coap_resource_t *hash_next;       /* next resource in the same URL hash bucket */
+  uint16_t url_len;                 /* cached strlen(url) */
+  uint16_t order;                   /* activation order, the earliest match wins */
 };
 
 struct coap_periodic_resource_s {
@@ -167,6 +170,16 @@ coap_resource_t *coap_get_first_resource(void);
  */
 coap_resource_t *coap_get_next_resource(coap_resource_t *resource);
 /*---------------------------------------------------------------------------*/
+/**
+ * \brief      Finds the resource that handles a URI path.
+ * \param url  The URI path, without leading slash and not null-terminated
+ * \param url_len The length of the URI path
+ * \return     The resource activated at exactly that path, or at a parent
+ *             path if it has sub-resources. If several match, the one
+ *             activated first. NULL if none matches.
+ */
+coap_resource_t *coap_get_resource_by_path(const char *url, int url_len);
+/*---------------------------------------------------------------------------*/
 
 #include "coap-transactions.h"
 #include "coap-observe.h"
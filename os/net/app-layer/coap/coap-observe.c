@@ -199,7 +199,7 @@ coap_notify_observers_sub(coap_resource_t *resource, const char *subpath)
   uint8_t sub_ok = 0;
 
   if(resource != NULL) {
-    url_len = strlen(resource->url);
+    url_len = resource->url_len;
     strncpy(url, resource->url, COAP_OBSERVER_URL_LEN - 1);
     if(url_len < COAP_OBSERVER_URL_LEN - 1 && subpath != NULL) {
       strncpy(&url[url_len], subpath, COAP_OBSERVER_URL_LEN - url_len - 1);
@@ -308,6 +308,14 @@ in()
   }
 
   UIP_MCAST6_STATS_ADD(mcast_in_all);
+
+  /* A datagram we have already forwarded or delivered */
+  if(uip_mcast6_route_is_dup()) {
+    UIP_MCAST6_STATS_ADD(mcast_in_dup);
+    PRINTF("ESMRF: Duplicate, dropping\n");
+    return UIP_MCAST6_DROP;
+  }
+
   UIP_MCAST6_STATS_ADD(mcast_in_unique);
 
   /* If we have an entry in the mcast routing table, something with
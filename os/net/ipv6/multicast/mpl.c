@@ -52,6 +52,8 @@
 #include "os/lib/trickle-timer.h"
 #include "os/lib/list.h"
 #include "sys/ctimer.h"
+#include "lib/random.h"
+#include <stddef.h>
 #include <string.h>
 
 #include "sys/log.h"
@@ -77,6 +79,16 @@
 #if MPL_SEED_ID_TYPE == 2 && MPL_SEED_ID_H > 0x00
 #warning MPL Seed ID upper 64 bits set yet not used due to Seed ID type setting
 #endif
+/* Hash tables */
+#if MPL_DOMAIN_SET_HASH_SIZE & (MPL_DOMAIN_SET_HASH_SIZE - 1)
+#error MPL_DOMAIN_SET_HASH_SIZE must be a power of two
+#endif
+#if MPL_SEED_SET_HASH_SIZE & (MPL_SEED_SET_HASH_SIZE - 1)
+#error MPL_SEED_SET_HASH_SIZE must be a power of two
+#endif
+#if MPL_BUFFERED_MESSAGE_HASH_SIZE & (MPL_BUFFERED_MESSAGE_HASH_SIZE - 1)
+#error MPL_BUFFERED_MESSAGE_HASH_SIZE must be a power of two
+#endif
 /*---------------------------------------------------------------------------*/
 /* Data Representation */
 /*---------------------------------------------------------------------------*/
@@ -148,15 +160,27 @@ typedef struct seed_id_s {
 /* Buffered message set
  *  This is implemented as a linked list since the majority of operations
  *  involve finding the minimum sequence number and iterating up the list.
+ *  Messages are also kept in a hash table keyed on seed and sequence number,
+ *  so that a given message can be found without walking the list.
+ *  Each message runs its own trickle timer, but the timers of all messages
+ *  are driven by a single ctimer (see data_timer_expiration()), so only
+ *  the trickle state is kept here, along with the message's place in the
+ *  heap of running timers.
  */
 struct mpl_msg {
   struct mpl_msg *next; /* Next message in the set, or NULL if this is largest */
+  struct mpl_msg *hash_next; /* Next message in the same hash bucket */
   struct mpl_seed *seed; /* The seed set this message belongs to */
-  struct trickle_timer tt; /* The trickle timer associated with this msg */
   uip_ip6addr_t srcipaddr; /* The original ip this message was sent from */
+  clock_time_t i_start; /* Start of the current trickle interval */
+  clock_time_t i_cur; /* Current trickle interval, 0 if the timer is stopped */
+  clock_time_t t; /* When the trickle timer next needs handling */
+  uint16_t timer_pos; /* 1 + position in data_timer_heap, 0 if not in it */
   uint16_t size; /* Side of the data stored above */
   uint8_t seq; /* The sequence number of the message */
   uint8_t e; /* Expiration count for trickle timer */
+  uint8_t c; /* Trickle redundancy counter */
+  uint8_t fired; /* The trickle timer has fired in the current interval */
   uint8_t data[UIP_BUFSIZE]; /* Message payload */
 };
 /**
@@ -181,8 +205,8 @@ struct mpl_msg {
 #define SEQ_VAL_IS_LT(i1, i2) \
   ( \
     ((i1) != (i2)) && \
-    ((((i1) < (i2)) && ((int16_t)((i2) - (i1)) < 0x100)) || \
-     (((i1) > (i2)) && ((int16_t)((i1) - (i2)) > 0x100))) \
+    ((((i1) < (i2)) && ((int16_t)((i2) - (i1)) < 0x80)) || \
+     (((i1) > (i2)) && ((int16_t)((i1) - (i2)) > 0x80))) \
   )
 
 /**
@@ -191,8 +215,8 @@ struct mpl_msg {
 #define SEQ_VAL_IS_GT(i1, i2) \
   ( \
     ((i1) != (i2)) && \
-    ((((i1) < (i2)) && ((int16_t)((i2) - (i1)) > 0x100)) || \
-     (((i1) > (i2)) && ((int16_t)((i1) - (i2)) < 0x100))) \
+    ((((i1) < (i2)) && ((int16_t)((i2) - (i1)) > 0x80)) || \
+     (((i1) > (i2)) && ((int16_t)((i1) - (i2)) < 0x80))) \
   )
 
 /**
@@ -202,10 +226,13 @@ struct mpl_msg {
 /*---------------------------------------------------------------------------*/
 /* Seed Set */
 struct mpl_seed {
+  struct mpl_seed *hash_next; /* Next seed in the same hash bucket */
   seed_id_t seed_id;
   uint8_t min_seqno; /* Used when the seed set is empty */
   uint8_t lifetime; /* Decrements by one every minute */
   uint8_t count; /* Only used for determining largest msg set during reclaim */
+  uint8_t in_remote; /* Seen in the control message being processed */
+  uint8_t buffered[32]; /* Bit vector of the buffered sequence numbers */
   LIST_STRUCT(min_seq); /* Pointer to the first msg in this seed's set */
   struct mpl_domain *domain; /* The domain this seed belongs to */
 };
@@ -222,6 +249,7 @@ struct mpl_seed {
 /*---------------------------------------------------------------------------*/
 /* Domain Set */
 struct mpl_domain {
+  struct mpl_domain *hash_next; /* Next domain in the same hash bucket */
   uip_ip6addr_t data_addr; /* Data address for this MPL domain */
   uip_ip6addr_t ctrl_addr; /* Link-local scoped version of data address */
   struct trickle_timer tt;
@@ -399,12 +427,24 @@ static struct mpl_stats stats;
 static struct mpl_msg buffered_message_set[MPL_BUFFERED_MESSAGE_SET_SIZE];
 static struct mpl_seed seed_set[MPL_SEED_SET_SIZE];
 static struct mpl_domain domain_set[MPL_DOMAIN_SET_SIZE];
+static struct mpl_domain *domain_hash[MPL_DOMAIN_SET_HASH_SIZE];
+static struct mpl_seed *seed_hash[MPL_SEED_SET_HASH_SIZE];
+static struct mpl_msg *msg_hash[MPL_BUFFERED_MESSAGE_HASH_SIZE];
+static struct mpl_msg *free_msgs; /* Unused messages, chained through next */
 static uint16_t last_seq;
 static seed_id_t local_seed_id;
 #if MPL_SUB_TO_ALL_FORWARDERS
 static uip_ip6addr_t all_forwarders;
 #endif
 static struct ctimer lifetime_timer;
+/* Trickle parameters of the data message timers, validated by the trickle library */
+static struct trickle_timer data_trickle;
+/* The one ctimer driving the trickle timers of all buffered messages */
+static struct ctimer data_timer;
+static clock_time_t data_timer_next; /* When data_timer expires, if it is set */
+/* The messages whose trickle timer is running, in a binary min-heap on t */
+static struct mpl_msg *data_timer_heap[MPL_BUFFERED_MESSAGE_SET_SIZE];
+static uint16_t data_timer_count;
 /*---------------------------------------------------------------------------*/
 /* Temporary Stores */
 /*---------------------------------------------------------------------------*/
@@ -429,10 +469,10 @@ extern uint16_t uip_slen;
  */
 #define mpl_control_trickle_timer_start(t) { (t)->e = 0; trickle_timer_set(&(t)->tt, control_message_expiration, (t)); }
 /**
- * \brief Start the trickle timer for a data message
- * t: Pointer to set that should be reset
+ * \brief Is the trickle timer of a buffered message running
+ * m: Pointer to the message
  */
-#define mpl_data_trickle_timer_start(t) { (t)->e = 0; trickle_timer_set(&(t)->tt, data_message_expiration, (t)); }
+#define DATA_TIMER_IS_RUNNING(m) ((m)->i_cur != TRICKLE_TIMER_IS_STOPPED)
 /**
  * \brief Call inconsistency on the provided timer
  * t: Pointer to set that should be reset
@@ -455,6 +495,18 @@ extern uint16_t uip_slen;
  * b: The 0-indexed bit to get
  */
 #define BIT_VECTOR_GET_BIT(v, b) ((v[b / 8] & (0x80 >> b % 8)) == (0x80 >> b % 8))
+/**
+ * \brief Clear a single bit within a bit vector that spans multiple bytes
+ * v: The bit vector
+ * b: The 0-indexed bit to clear
+ */
+#define BIT_VECTOR_CLR_BIT(v, b) (v[b / 8] &= ~(0x80 >> b % 8))
+/**
+ * \brief Hash bucket of a buffered message
+ * s: Pointer to the seed set entry of the message
+ * q: Sequence number of the message
+ */
+#define MSG_HASH(s, q) ((((s) - seed_set) * 37 + (q)) & (MPL_BUFFERED_MESSAGE_HASH_SIZE - 1))
 /**
  * \brief Modify an ipv6 address to give it link local scope
  * a: uip_ip6addr_t address to modify
@@ -465,25 +517,136 @@ extern uint16_t uip_slen;
 /*---------------------------------------------------------------------------*/
 static void icmp_in(void);
 UIP_ICMP6_HANDLER(mpl_icmp_handler, ICMP6_MPL, 0, icmp_in);
+/*---------------------------------------------------------------------------*/
+/* Hash Tables */
+/*---------------------------------------------------------------------------*/
+/* The data and control addresses of a domain only differ in scope, so the
+ * scope is left out and both addresses hash to the same bucket. */
+static uint8_t
+domain_hash_index(const uip_ip6addr_t *addr)
+{
+  static uint8_t i;
+  uint16_t h;
+
+  h = addr->u8[1] & 0xF0;
+  for(i = 2; i < 16; i++) {
+    h = h * 31 + addr->u8[i];
+  }
+  return h & (MPL_DOMAIN_SET_HASH_SIZE - 1);
+}
+static uint8_t
+seed_hash_index(const seed_id_t *seed_id, const struct mpl_domain *domain)
+{
+  static uint8_t i;
+  uint16_t h;
+
+  h = domain - domain_set;
+  for(i = 0; i < 16; i++) {
+    h = h * 31 + seed_id->id[i];
+  }
+  return h & (MPL_SEED_SET_HASH_SIZE - 1);
+}
+static void
+domain_hash_remove(struct mpl_domain *domain)
+{
+  static struct mpl_domain **dp;
+
+  for(dp = &domain_hash[domain_hash_index(&domain->data_addr)]; *dp != NULL; dp = &(*dp)->hash_next) {
+    if(*dp == domain) {
+      *dp = domain->hash_next;
+      return;
+    }
+  }
+}
+static void
+seed_hash_remove(struct mpl_seed *seed)
+{
+  static struct mpl_seed **sp;
 
+  for(sp = &seed_hash[seed_hash_index(&seed->seed_id, seed->domain)]; *sp != NULL; sp = &(*sp)->hash_next) {
+    if(*sp == seed) {
+      *sp = seed->hash_next;
+      return;
+    }
+  }
+}
+static void
+msg_hash_remove(struct mpl_msg *msg)
+{
+  static struct mpl_msg **mp;
+
+  for(mp = &msg_hash[MSG_HASH(msg->seed, msg->seq)]; *mp != NULL; mp = &(*mp)->hash_next) {
+    if(*mp == msg) {
+      *mp = msg->hash_next;
+      return;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Set Management */
+/*---------------------------------------------------------------------------*/
 static struct mpl_msg *
 buffer_allocate(void)
 {
-  for(locmmptr = &buffered_message_set[MPL_BUFFERED_MESSAGE_SET_SIZE - 1]; locmmptr >= buffered_message_set; locmmptr--) {
-    if(!MSG_SET_IS_USED(locmmptr)) {
-      memset(locmmptr, 0, sizeof(struct mpl_msg));
-      return locmmptr;
+  locmmptr = free_msgs;
+  if(locmmptr != NULL) {
+    free_msgs = locmmptr->next;
+    /* The payload is overwritten by the caller, only clear the header */
+    memset(locmmptr, 0, offsetof(struct mpl_msg, data));
+  }
+  return locmmptr;
+}
+/* Find the buffered message with sequence number seq from a seed */
+static struct mpl_msg *
+buffer_lookup(struct mpl_seed *seed, uint8_t seq)
+{
+  static struct mpl_msg *msg;
+
+  if(!BIT_VECTOR_GET_BIT(seed->buffered, seq)) {
+    return NULL;
+  }
+  for(msg = msg_hash[MSG_HASH(seed, seq)]; msg != NULL; msg = msg->hash_next) {
+    if(msg->seed == seed && msg->seq == seq) {
+      return msg;
     }
   }
   return NULL;
 }
+/* Find the buffered message from a seed with the largest sequence number
+ * below seq, which is the message a message with seq is inserted after.
+ * The search wraps around, and ends at the seed's smallest buffered
+ * sequence number. */
+static struct mpl_msg *
+buffer_lookup_prev(struct mpl_seed *seed, uint8_t seq)
+{
+  static uint8_t b;
+
+  if(list_head(seed->min_seq) == NULL || !SEQ_VAL_IS_GT(seq, seed->min_seqno)) {
+    return NULL;
+  }
+  b = seq;
+  do {
+    b--;
+    if(seed->buffered[b / 8] == 0) {
+      /* Skip the rest of an empty byte, which cannot hold min_seqno */
+      b -= b % 8;
+    } else if(BIT_VECTOR_GET_BIT(seed->buffered, b)) {
+      return buffer_lookup(seed, b);
+    }
+  } while(b != seed->min_seqno);
+  return NULL;
+}
+static void data_timer_stop(struct mpl_msg *msg);
+/* Release a message that has already been removed from its seed's list */
 static void
 buffer_free(struct mpl_msg *msg)
 {
-  if(trickle_timer_is_running(&msg->tt)) {
-    trickle_timer_stop(&msg->tt);
-  }
+  msg_hash_remove(msg);
+  BIT_VECTOR_CLR_BIT(msg->seed->buffered, msg->seq);
+  data_timer_stop(msg);
   MSG_SET_CLEAR_USED(msg);
+  msg->next = free_msgs;
+  free_msgs = msg;
 }
 static struct mpl_msg *
 buffer_reclaim(void)
@@ -494,8 +657,7 @@ buffer_reclaim(void)
 
   /* Reclaim the message with min_seq in the largest seed set */
   largest = NULL;
-  reclaim = NULL;
-  for(ssptr = &seed_set[MPL_SEED_SET_SIZE]; ssptr >= seed_set; ssptr--) {
+  for(ssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; ssptr >= seed_set; ssptr--) {
     if(SEED_SET_IS_USED(ssptr) && (largest == NULL || ssptr->count > largest->count)) {
       largest = ssptr;
     }
@@ -508,21 +670,21 @@ buffer_reclaim(void)
    *   order messages are sent.
    * We've already worked out what this new value is.
    */
-  if(largest != NULL) {
-    reclaim = list_pop(largest->min_seq);
-    largest->min_seqno = list_item_next(reclaim) == NULL ? reclaim->seq : ((struct mpl_msg *)list_item_next(reclaim))->seq;
-    largest->count--;
-    trickle_timer_stop(&reclaim->tt);
-    mpl_trickle_timer_reset(reclaim->seed->domain);
-    memset(reclaim, 0, sizeof(struct mpl_msg));
-  }
-  return reclaim;
+  if(largest == NULL || (reclaim = list_pop(largest->min_seq)) == NULL) {
+    return NULL;
+  }
+  largest->min_seqno = list_item_next(reclaim) == NULL ? reclaim->seq : ((struct mpl_msg *)list_item_next(reclaim))->seq;
+  largest->count--;
+  mpl_trickle_timer_reset(largest->domain);
+  buffer_free(reclaim);
+  return buffer_allocate();
 }
 static struct mpl_domain *
 domain_set_allocate(uip_ip6addr_t *address)
 {
   uip_ip6addr_t data_addr;
   uip_ip6addr_t ctrl_addr;
+  uint8_t h;
   /* Determine the two addresses for this domain */
   if(uip_mcast6_get_address_scope(address) == UIP_MCAST6_SCOPE_LINK_LOCAL) {
     LOG_DBG("Domain Set Allocate has a local scoped address\n");
@@ -564,6 +726,9 @@ domain_set_allocate(uip_ip6addr_t *address)
         DOMAIN_SET_CLEAR_USED(locdsptr);
         return NULL;
       }
+      h = domain_hash_index(&data_addr);
+      locdsptr->hash_next = domain_hash[h];
+      domain_hash[h] = locdsptr;
       return locdsptr;
     }
   }
@@ -573,20 +738,27 @@ domain_set_allocate(uip_ip6addr_t *address)
 static struct mpl_seed *
 seed_set_lookup(seed_id_t *seed_id, struct mpl_domain *domain)
 {
-  for(locssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; locssptr >= seed_set; locssptr--) {
-    if(SEED_SET_IS_USED(locssptr) && seed_id_cmp(seed_id, &locssptr->seed_id) && locssptr->domain == domain) {
+  for(locssptr = seed_hash[seed_hash_index(seed_id, domain)]; locssptr != NULL; locssptr = locssptr->hash_next) {
+    if(locssptr->domain == domain && seed_id_cmp(seed_id, &locssptr->seed_id)) {
       return locssptr;
     }
   }
   return NULL;
 }
 static struct mpl_seed *
-seed_set_allocate(void)
+seed_set_allocate(seed_id_t *seed_id, struct mpl_domain *domain)
 {
+  uint8_t h;
+
   for(locssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; locssptr >= seed_set; locssptr--) {
     if(!SEED_SET_IS_USED(locssptr)) {
-      locssptr->count = 0;
+      memset(locssptr, 0, sizeof(struct mpl_seed));
       LIST_STRUCT_INIT(locssptr, min_seq);
+      seed_id_cpy(&locssptr->seed_id, seed_id);
+      locssptr->domain = domain;
+      h = seed_hash_index(seed_id, domain);
+      locssptr->hash_next = seed_hash[h];
+      seed_hash[h] = locssptr;
       return locssptr;
     }
   }
@@ -598,17 +770,16 @@ seed_set_free(struct mpl_seed *s)
   while((locmmptr = list_pop(s->min_seq)) != NULL) {
     buffer_free(locmmptr);
   }
+  seed_hash_remove(s);
   SEED_SET_CLEAR_USED(s);
 }
 static struct mpl_domain *
 domain_set_lookup(uip_ip6addr_t *domain)
 {
-  for(locdsptr = &domain_set[MPL_DOMAIN_SET_SIZE - 1]; locdsptr >= domain_set; locdsptr--) {
-    if(DOMAIN_SET_IS_USED(locdsptr)) {
-      if(uip_ip6addr_cmp(domain, &locdsptr->data_addr)
-         || uip_ip6addr_cmp(domain, &locdsptr->ctrl_addr)) {
-        return locdsptr;
-      }
+  for(locdsptr = domain_hash[domain_hash_index(domain)]; locdsptr != NULL; locdsptr = locdsptr->hash_next) {
+    if(uip_ip6addr_cmp(domain, &locdsptr->data_addr)
+       || uip_ip6addr_cmp(domain, &locdsptr->ctrl_addr)) {
+      return locdsptr;
     }
   }
   return NULL;
@@ -618,7 +789,7 @@ domain_set_free(struct mpl_domain *domain)
 {
   uip_ds6_maddr_t *addr;
   /* Must include freeing seeds otherwise we leak memory */
-  for(locssptr = &seed_set[MPL_SEED_SET_SIZE]; locssptr >= seed_set; locssptr--) {
+  for(locssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; locssptr >= seed_set; locssptr--) {
     if(SEED_SET_IS_USED(locssptr) && locssptr->domain == domain) {
       seed_set_free(locssptr);
     }
@@ -634,6 +805,7 @@ domain_set_free(struct mpl_domain *domain)
   if(trickle_timer_is_running(&domain->tt)) {
     trickle_timer_stop(&domain->tt);
   }
+  domain_hash_remove(domain);
   DOMAIN_SET_CLEAR_USED(domain);
 }
 static void
@@ -657,8 +829,8 @@ seed_id_net_to_host(seed_id_t *dst, void *src, uint8_t s)
   case 1:
     /* 16 bit seed ID */
     dst->s = 1;
-    for(i = 2; i < 15; i++) {
-      /* Clear the first 13 bytes in the id */
+    for(i = 2; i < 16; i++) {
+      /* Clear the upper 14 bytes in the id */
       dst->id[i] = 0;
     }
     dst->id[0] = ptr[1];
@@ -908,7 +1080,7 @@ data_message_expiration(void *ptr, uint8_t suppress)
   locmmptr = ((struct mpl_msg *)ptr);
   if(locmmptr->e > MPL_DATA_MESSAGE_TIMER_EXPIRATIONS) {
     /* Terminate the trickle timer here if we've already expired enough times */
-    trickle_timer_stop(&locmmptr->tt);
+    data_timer_stop(locmmptr);
     return;
   }
   if(suppress == TRICKLE_TIMER_TX_OK) { /* Only transmit if not suppressed */
@@ -988,6 +1160,172 @@ data_message_expiration(void *ptr, uint8_t suppress)
 
   locmmptr->e++;
 }
+/*---------------------------------------------------------------------------*/
+/* Data Message Timers
+ *  Every buffered message runs the trickle algorithm of RFC 6206 with the
+ *  parameters of data_trickle. Rather than giving each message its own
+ *  ctimer, the running messages are kept in a heap on the point at which
+ *  they next need handling. data_timer is set for the top of the heap, and
+ *  handles the messages that are due when it expires.
+ */
+/*---------------------------------------------------------------------------*/
+/* Time left until t, or 0 if t has passed */
+static clock_time_t
+data_timer_left(clock_time_t t, clock_time_t now)
+{
+  t -= now;
+  return t > (TRICKLE_TIMER_CLOCK_MAX >> 1) ? 0 : t;
+}
+/* Is message a due before message b */
+#define DATA_TIMER_BEFORE(a, b) \
+  ((clock_time_t)((a)->t - (b)->t) > (TRICKLE_TIMER_CLOCK_MAX >> 1))
+static void
+data_timer_heap_set(uint16_t pos, struct mpl_msg *msg)
+{
+  data_timer_heap[pos] = msg;
+  msg->timer_pos = pos + 1;
+}
+/* Put a message in the heap, or move it after its t has changed */
+static void
+data_timer_heap_fix(struct mpl_msg *msg)
+{
+  uint16_t pos;
+  uint16_t child;
+
+  if(msg->timer_pos == 0) {
+    msg->timer_pos = ++data_timer_count;
+  }
+  pos = msg->timer_pos - 1;
+  /* Up */
+  while(pos > 0 && DATA_TIMER_BEFORE(msg, data_timer_heap[(pos - 1) / 2])) {
+    data_timer_heap_set(pos, data_timer_heap[(pos - 1) / 2]);
+    pos = (pos - 1) / 2;
+  }
+  /* Down */
+  while((child = 2 * pos + 1) < data_timer_count) {
+    if(child + 1 < data_timer_count
+       && DATA_TIMER_BEFORE(data_timer_heap[child + 1], data_timer_heap[child])) {
+      child++;
+    }
+    if(!DATA_TIMER_BEFORE(data_timer_heap[child], msg)) {
+      break;
+    }
+    data_timer_heap_set(pos, data_timer_heap[child]);
+    pos = child;
+  }
+  data_timer_heap_set(pos, msg);
+}
+/* Stop the trickle timer of a message */
+static void
+data_timer_stop(struct mpl_msg *msg)
+{
+  struct mpl_msg *last;
+  uint16_t pos;
+
+  msg->i_cur = TRICKLE_TIMER_IS_STOPPED;
+  if(msg->timer_pos == 0) {
+    return;
+  }
+  pos = msg->timer_pos - 1;
+  msg->timer_pos = 0;
+  last = data_timer_heap[--data_timer_count];
+  if(last != msg) {
+    data_timer_heap_set(pos, last);
+    data_timer_heap_fix(last);
+  }
+}
+/* Pick the transmission point t in [I/2, I) of the current interval */
+static void
+data_timer_new_interval(struct mpl_msg *msg, clock_time_t i_start)
+{
+  clock_time_t half;
+
+  half = msg->i_cur >> 1;
+  msg->i_start = i_start;
+  msg->c = 0;
+  msg->fired = 0;
+  msg->t = i_start + half + ((uint32_t)random_rand() << 16 | random_rand()) % half;
+}
+static void data_timer_expiration(void *ptr);
+/* Make sure data_timer expires no later than t */
+static void
+data_timer_schedule(clock_time_t t)
+{
+  clock_time_t now;
+
+  now = clock_time();
+  if(ctimer_expired(&data_timer)
+     || data_timer_left(t, now) < data_timer_left(data_timer_next, now)) {
+    data_timer_next = t;
+    ctimer_set(&data_timer, data_timer_left(t, now), data_timer_expiration, NULL);
+  }
+}
+static void
+data_timer_start(struct mpl_msg *msg)
+{
+  clock_time_t range;
+
+  range = TRICKLE_TIMER_INTERVAL_MAX(&data_trickle) - data_trickle.i_min + 1;
+  msg->e = 0;
+  msg->i_cur = data_trickle.i_min + ((uint32_t)random_rand() << 16 | random_rand()) % range;
+  data_timer_new_interval(msg, clock_time());
+  data_timer_heap_fix(msg);
+  data_timer_schedule(msg->t);
+}
+static void
+data_timer_inconsistency(struct mpl_msg *msg)
+{
+  msg->e = 0;
+  if(DATA_TIMER_IS_RUNNING(msg) && msg->i_cur != data_trickle.i_min) {
+    msg->i_cur = data_trickle.i_min;
+    data_timer_new_interval(msg, clock_time());
+    data_timer_heap_fix(msg);
+    data_timer_schedule(msg->t);
+  }
+}
+static void
+data_timer_consistency(struct mpl_msg *msg)
+{
+  if(msg->c < 0xFF) {
+    msg->c++;
+  }
+}
+static void
+data_timer_expiration(void *ptr)
+{
+  static struct mpl_msg *msg;
+  clock_time_t now;
+
+  now = clock_time();
+  while(data_timer_count > 0 && data_timer_left(data_timer_heap[0]->t, now) == 0) {
+    msg = data_timer_heap[0];
+    if(!msg->fired) {
+      /* Transmission point: transmit unless suppressed, then wait for the end of the interval */
+      msg->fired = 1;
+      msg->t = msg->i_start + msg->i_cur;
+      data_message_expiration(msg, (data_trickle.k == TRICKLE_TIMER_INFINITE_REDUNDANCY
+                                    || msg->c < data_trickle.k) ? TRICKLE_TIMER_TX_OK : TRICKLE_TIMER_TX_SUPPRESS);
+      if(!DATA_TIMER_IS_RUNNING(msg)) {
+        /* Stopped, and out of the heap */
+        continue;
+      }
+    } else {
+      /* End of the interval: double it and start the next one where this one ended */
+      if(msg->i_cur <= TRICKLE_TIMER_INTERVAL_MAX(&data_trickle) >> 1) {
+        msg->i_cur <<= 1;
+      } else {
+        msg->i_cur = TRICKLE_TIMER_INTERVAL_MAX(&data_trickle);
+      }
+      data_timer_new_interval(msg, msg->t);
+    }
+    data_timer_heap_fix(msg);
+  }
+  if(data_timer_count > 0) {
+    data_timer_next = data_timer_heap[0]->t;
+    ctimer_set(&data_timer, data_timer_left(data_timer_next, now), data_timer_expiration, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
 static void
 control_message_expiration(void *ptr, uint8_t suppress)
 {
@@ -1038,7 +1376,7 @@ lifetime_timer_expiration(void *ptr)
       /* Check no timers are running */
       locmmptr = list_head(locssptr->min_seq);
       while(locmmptr != NULL) {
-        if(trickle_timer_is_running(&locmmptr->tt)) {
+        if(DATA_TIMER_IS_RUNNING(locmmptr)) {
           /* We must keep this seed */
           break;
         }
@@ -1063,9 +1401,10 @@ static void
 icmp_in(void)
 {
   static seed_id_t seed_id;
-  static uint8_t r;
+  static uint16_t r;
+  static uint8_t seq;
   static uint8_t *vector;
-  static uint8_t vector_len;
+  static uint16_t vector_len;
   static uint8_t r_missing;
   static uint8_t l_missing;
 
@@ -1115,7 +1454,7 @@ icmp_in(void)
     locdsptr = domain_set_allocate(&UIP_IP_BUF->destipaddr);
     if(!locdsptr) {
       LOG_ERR("Couldn't allocate new domain. Dropping.\n");
-      UIP_MCAST6_STATS_ADD(icmp_bad);
+      MPL_STATS_ADD(icmp_bad);
       goto discard;
     }
     mpl_control_trickle_timer_start(locdsptr);
@@ -1123,65 +1462,9 @@ icmp_in(void)
   l_missing = 0;
   r_missing = 0;
 
-  /* Iterate over our seed set and check all are present in the remote seed sed */
-  locsiptr = (struct seed_info *)UIP_ICMP_PAYLOAD;
+  /* Seeds of this domain not marked while going through the remote seed info are missing from the remote */
   for(locssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; locssptr >= seed_set; locssptr--) {
-    if(SEED_SET_IS_USED(locssptr) && locssptr->domain == locdsptr) {
-      LOG_DBG("Checking remote for seed ");
-      LOG_DBG_SEED(locssptr->seed_id);
-      LOG_DBG_("\n");
-      while(locsiptr <
-            (struct seed_info *)((void *)UIP_ICMP_PAYLOAD + uip_len - uip_l3_icmp_hdr_len)) {
-        switch(SEED_INFO_GET_S(locsiptr)) {
-        case 0:
-          seed_id_net_to_host(&seed_id, &UIP_IP_BUF->srcipaddr, 0);
-          locsiptr = ((void *)locsiptr) + sizeof(struct seed_info) + SEED_INFO_GET_LEN(locsiptr);
-          if(seed_id_cmp(&seed_id, &locssptr->seed_id)) {
-            goto seed_present;
-          }
-          break;
-        case 1:
-          seed_id_net_to_host(&seed_id, &((struct seed_info_s1 *)locsiptr)->seed_id, 1);
-          locsiptr = ((void *)locsiptr) + sizeof(struct seed_info_s1) + SEED_INFO_GET_LEN(locsiptr);
-          if(seed_id_cmp(&seed_id, &locssptr->seed_id)) {
-            goto seed_present;
-          }
-          break;
-        case 2:
-          seed_id_net_to_host(&seed_id, &((struct seed_info_s2 *)locsiptr)->seed_id, 2);
-          locsiptr = ((void *)locsiptr) + sizeof(struct seed_info_s2) + SEED_INFO_GET_LEN(locsiptr);
-          if(seed_id_cmp(&seed_id, &locssptr->seed_id)) {
-            goto seed_present;
-          }
-          break;
-        case 3:
-          seed_id_net_to_host(&seed_id, &((struct seed_info_s3 *)locsiptr)->seed_id, 3);
-          locsiptr = ((void *)locsiptr) + sizeof(struct seed_info_s3) + SEED_INFO_GET_LEN(locsiptr);
-          if(seed_id_cmp(&seed_id, &locssptr->seed_id)) {
-            goto seed_present;
-          }
-          break;
-        }
-      }
-      /* If we made it this far, the seed is missing from the remote. Reset all message timers */
-      LOG_DBG("Remote is missing seed ");
-      LOG_DBG_SEED(locssptr->seed_id);
-      LOG_DBG_("\n");
-      r_missing = 1;
-      if(list_head(locssptr->min_seq) != NULL) {
-        for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
-          LOG_DBG("Resetting timer for messages\n");
-          if(!trickle_timer_is_running(&locmmptr->tt)) {
-            LOG_DBG("Starting timer for messages\n");
-            mpl_data_trickle_timer_start(locmmptr);
-          }
-          mpl_trickle_timer_inconsistency(locmmptr);
-        }
-      }
-      /* Otherwise we jump here and continute */
-seed_present:
-      continue;
-    }
+    locssptr->in_remote = 0;
   }
 
   /* Iterate over remote seed info and they're present locally. Additionally check messages match */
@@ -1208,6 +1491,7 @@ seed_present:
       l_missing = 1;
       goto next;
     }
+    locssptr->in_remote = 1;
 
     /* Work out where remote bit vector starts */
     vector_len = SEED_INFO_GET_LEN(locsiptr) * 8;
@@ -1226,130 +1510,42 @@ seed_present:
       break;
     }
 
-    /* Potential quick resolution here */
-    locmmptr = list_head(locssptr->min_seq);
-    if(locmmptr == NULL) {
-      /* We have nothing! */
-      if(vector[0] > 0) {
-        /* They have something! */
-        l_missing = 1;
-      }
-      goto next;
-    }
-    /**
-     * Work out what offset the local or remote message set need so that the
-     * sequence numbers match up
-     */
-    r = 0;
-    if(locmmptr->seq != locsiptr->min_seqno) {
-      if(SEQ_VAL_IS_GT(locmmptr->seq, locsiptr->min_seqno)) {
-        while(locmmptr->seq != SEQ_VAL_ADD(locsiptr->min_seqno, r) && r <= vector_len) {
-          r++;
-        }
-      } else {
-        while(locmmptr != NULL && locmmptr->seq != locsiptr->min_seqno) {
-          locmmptr = list_item_next(locmmptr);
-        }
-      }
-
-      /* There is no overlap in message sets */
-      if(r > vector_len || locmmptr == NULL) {
-        LOG_WARN("Seed sets of local and remote have no overlap.\n");
-        /* Work out who is behind who */
-        locmmptr = list_head(locssptr->min_seq);
-        while(list_item_next(locmmptr) != NULL) {
-          locmmptr = list_item_next(locmmptr);
-        }
-        r = vector_len;
-        while(!BIT_VECTOR_GET_BIT(vector, r)) {
-          r--;
-        }
-        if(SEQ_VAL_IS_GT(locmmptr->seq, SEQ_VAL_ADD(locsiptr->min_seqno, r))) {
-          /* Our max sequence number is greater than their max sequence number */
-          LOG_DBG("Our max sequence number is greater than their max sequence number\n");
-          r_missing = 1;
-          /* Additionally all data message timers in set if r is behind us */
-          if(list_head(locssptr->min_seq) != NULL) {
-            for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
-              if(!trickle_timer_is_running(&locmmptr->tt)) {
-                mpl_data_trickle_timer_start(locmmptr);
-              }
-              mpl_trickle_timer_inconsistency(locmmptr);
-            }
-          }
-        } else {
-          l_missing = 1;
-        }
-        goto next;
-      }
-    }
-
     /**
-     * If we've made it this far, our sets overlap and we can work out specific
-     *   messages that may be missing from each set.
+     * Bit r of the remote vector stands for sequence number min_seqno + r.
+     * Any message we buffer from the remote's min_seqno upwards, whose bit is
+     *  not set, is missing from the remote.
      */
-    do {
-      /* This won't occur on first iteration */
-      /* Resyncronise our pointers to local and remote messages after previous iteration */
-      while(locmmptr->seq != SEQ_VAL_ADD(locsiptr->min_seqno, r)) {
-        /**
-         * If we enter this loop it means there is a gap in local sequence numbers.
-         *  Check that same gap exists in the remote set.
-         */
-        if(BIT_VECTOR_GET_BIT(vector, r)) {
-          /* We are missing a message. Reset timer */
-          LOG_DBG("We are missing seq=%u\n", SEQ_VAL_ADD(locsiptr->min_seqno, r));
-          l_missing = 1;
-        }
-        r++;
+    for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
+      if(SEQ_VAL_IS_LT(locmmptr->seq, locsiptr->min_seqno)) {
+        continue;
       }
-      /* At this point the local pointer and remote pointer will be in sync */
-
-      /* Check whether the remote is missing the current message */
-      if(!BIT_VECTOR_GET_BIT(vector, r)) {
+      r = SEQ_VAL_ADD(locmmptr->seq, 0x100 - locsiptr->min_seqno);
+      if(r >= vector_len || !BIT_VECTOR_GET_BIT(vector, r)) {
         /* Local message is missing from remote set. Reset control and data timers */
         LOG_DBG("Remote is missing seq=%u\n", locmmptr->seq);
         r_missing = 1;
-        if(!trickle_timer_is_running(&locmmptr->tt)) {
-          mpl_data_trickle_timer_start(locmmptr);
+        if(!DATA_TIMER_IS_RUNNING(locmmptr)) {
+          data_timer_start(locmmptr);
         }
-        mpl_trickle_timer_inconsistency(locmmptr);
+        data_timer_inconsistency(locmmptr);
       }
+    }
 
-      /* Now increment our pointers */
-      r++;
-      locmmptr = list_item_next(locmmptr);
-      /* These are then resyncronised at the top of the loop */
-    } while(locmmptr != NULL && r <= vector_len);
-
-    /* If we have stopped short of either message set then we may have inconsistencies */
-    if(locmmptr != NULL || r < vector_len) {
-      /**
-       * We have reached the end of local set, the remainder of the remote set should
-       *  be zero else local is missing a message.
-       */
-      while(r < vector_len) {
-        if(BIT_VECTOR_GET_BIT(vector, r)) {
-          /* We are missing a message */
-          LOG_DBG("We are missing seq=%u which is greater than our max seq number\n", SEQ_VAL_ADD(locsiptr->min_seqno, r));
-          l_missing = 1;
-        }
-        r++;
-      }
-    } else if(r >= vector_len && locmmptr != NULL) {
-      /* We have reached the end of the remote set.
-       *  Any remaining messages are missing and should be reset.
-       */
-      while(locmmptr != NULL) {
-        LOG_DBG("Remote is missing all above seq=%u\n", locmmptr->seq);
-        if(!trickle_timer_is_running(&locmmptr->tt)) {
-          mpl_data_trickle_timer_start(locmmptr);
-        }
-        mpl_trickle_timer_inconsistency(locmmptr);
-        r_missing = 1;
-        locmmptr = list_item_next(locmmptr);
+    /**
+     * Any message the remote has, that is not too old for us to accept, and
+     *  that we don't buffer, is missing locally. Our bit vector is indexed by
+     *  sequence number, so this is a test per remote bit.
+     */
+    for(r = 0; r < vector_len && !l_missing; r++) {
+      seq = SEQ_VAL_ADD(locsiptr->min_seqno, r);
+      if(BIT_VECTOR_GET_BIT(vector, r)
+         && !SEQ_VAL_IS_LT(seq, locssptr->min_seqno)
+         && !BIT_VECTOR_GET_BIT(locssptr->buffered, seq)) {
+        LOG_DBG("We are missing seq=%u\n", seq);
+        l_missing = 1;
       }
     }
+
     /* Now point to next seed info */
 next:
     switch(SEED_INFO_GET_S(locsiptr)) {
@@ -1368,6 +1564,25 @@ next:
     }
   }
 
+  /* Check all our seeds were present in the remote seed set */
+  for(locssptr = &seed_set[MPL_SEED_SET_SIZE - 1]; locssptr >= seed_set; locssptr--) {
+    if(SEED_SET_IS_USED(locssptr) && locssptr->domain == locdsptr && !locssptr->in_remote) {
+      /* The seed is missing from the remote. Reset all message timers */
+      LOG_DBG("Remote is missing seed ");
+      LOG_DBG_SEED(locssptr->seed_id);
+      LOG_DBG_("\n");
+      r_missing = 1;
+      for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
+        LOG_DBG("Resetting timer for messages\n");
+        if(!DATA_TIMER_IS_RUNNING(locmmptr)) {
+          LOG_DBG("Starting timer for messages\n");
+          data_timer_start(locmmptr);
+        }
+        data_timer_inconsistency(locmmptr);
+      }
+    }
+  }
+
   /* Now sort out control message timers */
   if(l_missing && !trickle_timer_is_running(&locdsptr->tt)) {
     mpl_control_trickle_timer_start(locdsptr);
@@ -1509,27 +1724,24 @@ accept(uint8_t in)
       UIP_MCAST6_STATS_ADD(mcast_dropped);
       return UIP_MCAST6_DROP;
     }
-    if(list_head(locssptr->min_seq) != NULL) {
-      for(locmmptr = list_head(locssptr->min_seq); locmmptr != NULL; locmmptr = list_item_next(locmmptr)) {
-        if(SEQ_VAL_IS_EQ(seq_val, locmmptr->seq)) {
-          /* Seen before , drop */
-          LOG_INFO("Seen before\n");
-          if(HBH_GET_M(lochbhmptr) && list_item_next(locmmptr) != NULL) {
-            mpl_trickle_timer_inconsistency(locmmptr);
-          } else {
-            trickle_timer_consistency(&locmmptr->tt);
-          }
-          UIP_MCAST6_STATS_ADD(mcast_dropped);
-          return UIP_MCAST6_DROP;
-        }
+    locmmptr = buffer_lookup(locssptr, seq_val);
+    if(locmmptr != NULL) {
+      /* Seen before , drop */
+      LOG_INFO("Seen before\n");
+      if(HBH_GET_M(lochbhmptr) && list_item_next(locmmptr) != NULL) {
+        data_timer_inconsistency(locmmptr);
+      } else {
+        data_timer_consistency(locmmptr);
       }
+      UIP_MCAST6_STATS_ADD(mcast_dropped);
+      return UIP_MCAST6_DROP;
     }
   }
   /* We have not seen this message before */
 
   /* Allocate a seed set if we have to */
   if(!locssptr) {
-    locssptr = seed_set_allocate();
+    locssptr = seed_set_allocate(&seed_id, locdsptr);
     LOG_INFO("New seed\n");
     if(!locssptr) {
       /* Couldn't allocate seed set, drop */
@@ -1537,10 +1749,12 @@ accept(uint8_t in)
       UIP_MCAST6_STATS_ADD(mcast_dropped);
       return UIP_MCAST6_DROP;
     }
-    memset(locssptr, 0, sizeof(struct mpl_seed));
-    LIST_STRUCT_INIT(locssptr, min_seq);
-    seed_id_cpy(&locssptr->seed_id, &seed_id);
-    locssptr->domain = locdsptr;
+  }
+
+  if(data_trickle.i_min == 0) {
+    LOG_ERR("No trickle timer for data messages. Dropping...\n");
+    UIP_MCAST6_STATS_ADD(mcast_dropped);
+    return UIP_MCAST6_DROP;
   }
 
   /* Allocate a buffer */
@@ -1579,33 +1793,28 @@ accept(uint8_t in)
   memcpy(&locmmptr->data, hptr, locmmptr->size);
   locmmptr->seq = seq_val;
   locmmptr->seed = locssptr;
-  if(!trickle_timer_config(&locmmptr->tt,
-                           MPL_DATA_MESSAGE_IMIN,
-                           MPL_DATA_MESSAGE_IMAX,
-                           MPL_DATA_MESSAGE_K)) {
-    LOG_ERR("Failed to configure timer for message. Dropping...\n");
-    buffer_free(locmmptr);
-    return UIP_MCAST6_DROP;
-  }
 
-  /* Place the message into the buffered message linked list */
-  if(list_head(locssptr->min_seq) == NULL) {
+  /**
+   * Place the message into the buffered message linked list, after the
+   *  message with the next lower sequence number. That message is found
+   *  through the seed's bit vector rather than by walking the list.
+   */
+  mmiterptr = buffer_lookup_prev(locssptr, seq_val);
+  if(mmiterptr == NULL) {
     list_push(locssptr->min_seq, locmmptr);
     locssptr->min_seqno = locmmptr->seq;
   } else {
-    for(mmiterptr = list_head(locssptr->min_seq); mmiterptr != NULL; mmiterptr = list_item_next(mmiterptr)) {
-      if(list_item_next(mmiterptr) == NULL
-         || (SEQ_VAL_IS_GT(locmmptr->seq, mmiterptr->seq) && SEQ_VAL_IS_LT(locmmptr->seq, ((struct mpl_msg *)list_item_next(mmiterptr))->seq))) {
-        list_insert(locssptr->min_seq, mmiterptr, locmmptr);
-        break;
-      }
-    }
+    locmmptr->next = mmiterptr->next;
+    mmiterptr->next = locmmptr;
   }
+  BIT_VECTOR_SET_BIT(locssptr->buffered, seq_val);
+  locmmptr->hash_next = msg_hash[MSG_HASH(locssptr, seq_val)];
+  msg_hash[MSG_HASH(locssptr, seq_val)] = locmmptr;
   locssptr->count++;
 
 #if MPL_PROACTIVE_FORWARDING
   /* Start Forwarding the message */
-  mpl_data_trickle_timer_start(locmmptr);
+  data_timer_start(locmmptr);
 #endif
 
   LOG_INFO("Min Seq Number=%u, %u values\n", locssptr->min_seqno, locssptr->count);
@@ -1632,10 +1841,10 @@ accept(uint8_t in)
 #if MPL_PROACTIVE_FORWARDING
   if(HBH_GET_M(lochbhmptr) == 1 && list_item_next(locmmptr) != NULL) {
     LOG_DBG("MPL Domain is inconsistent\n");
-    mpl_trickle_timer_inconsistency(locmmptr);
+    data_timer_inconsistency(locmmptr);
   } else {
     LOG_DBG("MPL Domain is consistent\n");
-    trickle_timer_consistency(&locmmptr->tt);
+    data_timer_consistency(locmmptr);
   }
 #endif
 
@@ -1772,6 +1981,23 @@ init(void)
   memset(domain_set, 0, sizeof(struct mpl_domain) * MPL_DOMAIN_SET_SIZE);
   memset(seed_set, 0, sizeof(struct mpl_seed) * MPL_SEED_SET_SIZE);
   memset(buffered_message_set, 0, sizeof(struct mpl_msg) * MPL_BUFFERED_MESSAGE_SET_SIZE);
+  memset(domain_hash, 0, sizeof(domain_hash));
+  memset(seed_hash, 0, sizeof(seed_hash));
+  memset(msg_hash, 0, sizeof(msg_hash));
+  free_msgs = NULL;
+  data_timer_count = 0;
+  for(locmmptr = &buffered_message_set[MPL_BUFFERED_MESSAGE_SET_SIZE - 1]; locmmptr >= buffered_message_set; locmmptr--) {
+    locmmptr->next = free_msgs;
+    free_msgs = locmmptr;
+  }
+
+  /* All data message trickle timers share these parameters */
+  if(!trickle_timer_config(&data_trickle,
+                           MPL_DATA_MESSAGE_IMIN,
+                           MPL_DATA_MESSAGE_IMAX,
+                           MPL_DATA_MESSAGE_K)) {
+    LOG_ERR("Unable to configure trickle timer for data messages\n");
+  }
 
   /* Register the ICMPv6 input handler */
   uip_icmp6_register_input_handler(&mpl_icmp_handler);
@@ -90,7 +90,7 @@
 #ifndef MPL_CONF_DATA_MESSAGE_K
 #define MPL_DATA_MESSAGE_K                  1
 #else
-#define MPL_CONF_DATA_MESSAGE_K MPL_DATA_MESSAGE_K
+#define MPL_DATA_MESSAGE_K MPL_CONF_DATA_MESSAGE_K
 #endif
 
 #ifndef MPL_CONF_CONTROL_MESSAGE_IMIN
@@ -216,6 +216,40 @@
 #define MPL_BUFFERED_MESSAGE_SET_SIZE MPL_CONF_BUFFERED_MESSAGE_SET_SIZE
 #endif
 /*---------------------------------------------------------------------------*/
+/**
+ * Domain Set Hash Size
+ * Domains are looked up by their data or control address in a hash table
+ * with this many buckets. Must be a power of two.
+ */
+#ifndef MPL_CONF_DOMAIN_SET_HASH_SIZE
+#define MPL_DOMAIN_SET_HASH_SIZE            4
+#else
+#define MPL_DOMAIN_SET_HASH_SIZE MPL_CONF_DOMAIN_SET_HASH_SIZE
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * Seed Set Hash Size
+ * Seeds are looked up by seed ID and domain in a hash table with this many
+ * buckets. Must be a power of two.
+ */
+#ifndef MPL_CONF_SEED_SET_HASH_SIZE
+#define MPL_SEED_SET_HASH_SIZE              8
+#else
+#define MPL_SEED_SET_HASH_SIZE MPL_CONF_SEED_SET_HASH_SIZE
+#endif
+/*---------------------------------------------------------------------------*/
+/**
+ * Buffered Message Hash Size
+ * Buffered messages are looked up by seed and sequence number in a hash
+ * table with this many buckets. Must be a power of two, and should be in
+ * the order of the Buffered Message Set Size.
+ */
+#ifndef MPL_CONF_BUFFERED_MESSAGE_HASH_SIZE
+#define MPL_BUFFERED_MESSAGE_HASH_SIZE      8
+#else
+#define MPL_BUFFERED_MESSAGE_HASH_SIZE MPL_CONF_BUFFERED_MESSAGE_HASH_SIZE
+#endif
+/*---------------------------------------------------------------------------*/
 /**
  * MPL Forwarding Strategy
  * Two forwarding strategies are defined for MPL. With Proactive forwarding
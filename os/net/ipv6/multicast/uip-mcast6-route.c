@@ -44,6 +44,7 @@
 #include "lib/list.h"
 #include "lib/memb.h"
 #include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
 #include "net/ipv6/multicast/uip-mcast6-route.h"
 
 #include <stdint.h>
@@ -56,19 +57,76 @@
 #else
 #define UIP_MCAST6_ROUTE_ROUTES 1
 #endif /* UIP_CONF_DS6_MCAST_ROUTES */
+
+/* Number of buckets in the route hash table. Must be a power of two */
+#ifdef UIP_MCAST6_ROUTE_CONF_HASH_SIZE
+#define UIP_MCAST6_ROUTE_HASH_SIZE UIP_MCAST6_ROUTE_CONF_HASH_SIZE
+#else
+#define UIP_MCAST6_ROUTE_HASH_SIZE 4
+#endif
+
+#if UIP_MCAST6_ROUTE_HASH_SIZE & (UIP_MCAST6_ROUTE_HASH_SIZE - 1)
+#error UIP_MCAST6_ROUTE_HASH_SIZE must be a power of two
+#endif
+
+/* Size of the duplicate datagram cache, 0 to disable it */
+#ifdef UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE
+#define UIP_MCAST6_ROUTE_DUP_CACHE_SIZE UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE
+#else
+#define UIP_MCAST6_ROUTE_DUP_CACHE_SIZE 0
+#endif
+
+/* For how long a datagram is remembered in the duplicate cache */
+#ifdef UIP_MCAST6_ROUTE_CONF_DUP_LIFETIME
+#define UIP_MCAST6_ROUTE_DUP_LIFETIME UIP_MCAST6_ROUTE_CONF_DUP_LIFETIME
+#else
+#define UIP_MCAST6_ROUTE_DUP_LIFETIME (2 * CLOCK_SECOND)
+#endif
+
+/* Bytes of the upper-layer header that identify a datagram */
+#define DUP_HDR_BYTES 8
 /*---------------------------------------------------------------------------*/
 LIST(mcast_route_list);
 MEMB(mcast_route_memb, uip_mcast6_route_t, UIP_MCAST6_ROUTE_ROUTES);
+static uip_mcast6_route_t *route_hash[UIP_MCAST6_ROUTE_HASH_SIZE];
 
 static uip_mcast6_route_t *locmcastrt;
+
+#if UIP_MCAST6_ROUTE_DUP_CACHE_SIZE
+/* What identifies a datagram, zero-padded so that keys compare with memcmp */
+struct dup_key {
+  uip_ipaddr_t src;
+  uip_ipaddr_t dst;
+  uint16_t len;
+  uint8_t proto;
+  uint8_t hdr[DUP_HDR_BYTES];
+};
+/* A datagram seen recently */
+struct dup_entry {
+  struct dup_key key;
+  clock_time_t seen;
+};
+static struct dup_entry dup_cache[UIP_MCAST6_ROUTE_DUP_CACHE_SIZE];
+static uint8_t dup_next; /* The entry to be replaced next */
+#endif /* UIP_MCAST6_ROUTE_DUP_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
+static uip_mcast6_route_t **
+route_bucket(const uip_ipaddr_t *group)
+{
+  uint16_t h;
+
+  /* Groups mostly differ in their last bytes, and in their scope */
+  h = group->u16[0] ^ group->u16[5] ^ group->u16[6] ^ group->u16[7];
+  h ^= h >> 8;
+  return &route_hash[h & (UIP_MCAST6_ROUTE_HASH_SIZE - 1)];
+}
 /*---------------------------------------------------------------------------*/
 uip_mcast6_route_t *
 uip_mcast6_route_lookup(uip_ipaddr_t *group)
 {
-  locmcastrt = NULL;
-  for(locmcastrt = list_head(mcast_route_list);
+  for(locmcastrt = *route_bucket(group);
       locmcastrt != NULL;
-      locmcastrt = list_item_next(locmcastrt)) {
+      locmcastrt = locmcastrt->hash_next) {
     if(uip_ipaddr_cmp(&locmcastrt->group, group)) {
       return locmcastrt;
     }
@@ -89,23 +147,27 @@ uip_mcast6_route_add(uip_ipaddr_t *group)
       return NULL;
     }
     list_add(mcast_route_list, locmcastrt);
+    uip_ipaddr_copy(&(locmcastrt->group), group);
+    locmcastrt->hash_next = *route_bucket(group);
+    *route_bucket(group) = locmcastrt;
   }
 
   /* Reaching here means we either found the prefix or allocated a new one */
 
-  uip_ipaddr_copy(&(locmcastrt->group), group);
-
   return locmcastrt;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_mcast6_route_rm(uip_mcast6_route_t *route)
 {
-  /* Make sure it's actually in the list */
-  for(locmcastrt = list_head(mcast_route_list);
-      locmcastrt != NULL;
-      locmcastrt = list_item_next(locmcastrt)) {
-    if(locmcastrt == route) {
+  uip_mcast6_route_t **bucket;
+
+  /* Make sure it's actually in the table */
+  for(bucket = route_bucket(&route->group);
+      *bucket != NULL;
+      bucket = &(*bucket)->hash_next) {
+    if(*bucket == route) {
+      *bucket = route->hash_next;
       list_remove(mcast_route_list, route);
       memb_free(&mcast_route_memb, route);
       return;
@@ -125,11 +187,55 @@ uip_mcast6_route_count(void)
   return list_length(mcast_route_list);
 }
 /*---------------------------------------------------------------------------*/
+int
+uip_mcast6_route_is_dup(void)
+{
+#if UIP_MCAST6_ROUTE_DUP_CACHE_SIZE
+  struct dup_entry *e;
+  struct dup_key key;
+  uint8_t *hdr;
+  uint8_t proto;
+  clock_time_t now;
+
+  hdr = uipbuf_get_last_header(uip_buf, uip_len, &proto);
+  if(hdr == NULL) {
+    return 0;
+  }
+
+  memset(&key, 0, sizeof(key));
+  uip_ipaddr_copy(&key.src, &UIP_IP_BUF->srcipaddr);
+  uip_ipaddr_copy(&key.dst, &UIP_IP_BUF->destipaddr);
+  key.len = uip_len - (hdr - uip_buf);
+  key.proto = proto;
+  memcpy(key.hdr, hdr, MIN(key.len, DUP_HDR_BYTES));
+
+  now = clock_time();
+  for(e = dup_cache; e < &dup_cache[UIP_MCAST6_ROUTE_DUP_CACHE_SIZE]; e++) {
+    if((clock_time_t)(now - e->seen) < UIP_MCAST6_ROUTE_DUP_LIFETIME
+       && memcmp(&e->key, &key, sizeof(key)) == 0) {
+      return 1;
+    }
+  }
+
+  /* Remember it in place of the oldest entry */
+  e = &dup_cache[dup_next];
+  dup_next = (dup_next + 1) % UIP_MCAST6_ROUTE_DUP_CACHE_SIZE;
+  memcpy(&e->key, &key, sizeof(key));
+  e->seen = now;
+#endif /* UIP_MCAST6_ROUTE_DUP_CACHE_SIZE */
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
 void
 uip_mcast6_route_init()
 {
   memb_init(&mcast_route_memb);
   list_init(mcast_route_list);
+  memset(route_hash, 0, sizeof(route_hash));
+#if UIP_MCAST6_ROUTE_DUP_CACHE_SIZE
+  memset(dup_cache, 0, sizeof(dup_cache));
+  dup_next = 0;
+#endif /* UIP_MCAST6_ROUTE_DUP_CACHE_SIZE */
 }
 /*---------------------------------------------------------------------------*/
 /** @} */
@@ -50,6 +50,7 @@
 /** \brief An entry in the multicast routing table */
 typedef struct uip_mcast6_route {
   struct uip_mcast6_route *next; /**< Routes are arranged in a linked list */
+  struct uip_mcast6_route *hash_next; /**< Next route in the same hash bucket */
   uip_ipaddr_t group; /**< The multicast group */
   uint32_t lifetime; /**< Entry lifetime seconds */
   void *dag; /**< Pointer to an rpl_dag_t struct */
@@ -105,6 +106,26 @@ uip_mcast6_route_t *uip_mcast6_route_list_head(void);
  */
 void uip_mcast6_route_init(void);
 /** @} */
+/*---------------------------------------------------------------------------*/
+/** \name Duplicate Suppression */
+/** @{ */
+
+/**
+ * \brief Check whether the datagram in uip_buf was seen recently
+ * \return 1 if the datagram is a duplicate, 0 otherwise
+ *
+ *        A datagram is identified by its source address, its destination,
+ *        its upper-layer length and the start of its upper-layer header,
+ *        which includes the UDP, TCP or ICMPv6 checksum. Copies of a
+ *        datagram only differ in their hop limit, so they all match.
+ *        Datagrams that are not duplicates are remembered for
+ *        UIP_MCAST6_ROUTE_DUP_LIFETIME in a cache of
+ *        UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE entries, of about 48 bytes
+ *        each. The cache is off by default: with a cache size of 0, this
+ *        function always returns 0.
+ */
+int uip_mcast6_route_is_dup(void);
+/** @} */
 
 #endif /* UIP_MCAST6_ROUTE_H_ */
 /** @} */
@@ -72,6 +72,9 @@ typedef struct uip_mcast6_stats {
   /** Count of all datagrams received */
   UIP_MCAST6_STATS_DATATYPE mcast_in_all;
 
+  /** Count of datagrams received again, and suppressed as duplicates */
+  UIP_MCAST6_STATS_DATATYPE mcast_in_dup;
+
   /** Count of datagrams received for a group that we have joined */
   UIP_MCAST6_STATS_DATATYPE mcast_in_ours;
 
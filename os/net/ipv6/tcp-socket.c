@@ -63,6 +63,25 @@ senddata(struct tcp_socket *s)
 {
   int len = MIN(s->output_data_max_seg, uip_mss());
 
+#if UIP_TCP_SLIDING_WINDOW
+  if(uip_sliding_window(uip_conn)) {
+    /* Retransmissions start with the oldest unacknowledged byte, while
+       new data follows the data already in flight. */
+    uint16_t offset = uip_rexmit() ? 0 : uip_outstanding(uip_conn);
+
+    if(s->output_data_len > offset) {
+      len = MIN(s->output_data_len - offset, len);
+      uip_send(&s->output_data_ptr[offset], len);
+      if(!uip_rexmit() && s->output_data_len > offset + len) {
+        /* Come back for the next segment; uIP stops polling when the
+           window is full. */
+        tcpip_poll_tcp(uip_conn);
+      }
+    }
+    return;
+  }
+#endif /* UIP_TCP_SLIDING_WINDOW */
+
   if(s->output_senddata_len > 0) {
     len = MIN(s->output_senddata_len, len);
     s->output_data_send_nxt = len;
@@ -73,6 +92,22 @@ senddata(struct tcp_socket *s)
 static void
 acked(struct tcp_socket *s)
 {
+#if UIP_TCP_SLIDING_WINDOW
+  if(uip_sliding_window(uip_conn)) {
+    uint16_t len = MIN(uip_ackedlen(), s->output_data_len);
+
+    if(len > 0) {
+      memmove(&s->output_data_ptr[0], &s->output_data_ptr[len],
+              s->output_data_len - len);
+      s->output_data_len -= len;
+      s->output_senddata_len = s->output_data_len;
+      s->output_data_send_nxt = 0;
+      call_event(s, TCP_SOCKET_DATA_SENT);
+    }
+    return;
+  }
+#endif /* UIP_TCP_SLIDING_WINDOW */
+
   if(s->output_senddata_len > 0) {
     /* Copy the data in the outputbuf down and update outputbufptr and
        outputbuf_lastsent */
@@ -165,6 +200,9 @@ appcall(void *state)
 	   s->listen_port == uip_htons(uip_conn->lport)) {
 	  s->flags &= ~TCP_SOCKET_FLAGS_LISTENING;
           s->output_data_max_seg = uip_mss();
+#if UIP_TCP_SLIDING_WINDOW
+          uip_set_sliding_window(uip_conn);
+#endif /* UIP_TCP_SLIDING_WINDOW */
 	  tcp_markconn(uip_conn, s);
 	  call_event(s, TCP_SOCKET_CONNECTED);
 	  break;
@@ -172,6 +210,9 @@ appcall(void *state)
       }
     } else {
       s->output_data_max_seg = uip_mss();
+#if UIP_TCP_SLIDING_WINDOW
+      uip_set_sliding_window(uip_conn);
+#endif /* UIP_TCP_SLIDING_WINDOW */
       call_event(s, TCP_SOCKET_CONNECTED);
     }
 
@@ -379,6 +420,13 @@ tcp_socket_close(struct tcp_socket *s)
   }
 
   s->flags |= TCP_SOCKET_FLAGS_CLOSING;
+#if UIP_TCP_CTIMER
+  if(s->c != NULL) {
+    /* Established connections are not polled periodically, so ask
+       for the poll that closes the connection */
+    tcpip_poll_tcp(s->c);
+  }
+#endif /* UIP_TCP_CTIMER */
   return 1;
 }
 /*---------------------------------------------------------------------------*/
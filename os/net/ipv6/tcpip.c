@@ -64,8 +64,10 @@ process_event_t tcpip_event;
 process_event_t tcpip_icmp6_event;
 #endif /* UIP_CONF_ICMP6 */
 
+#if UIP_TCP && !UIP_TCP_CTIMER
 /* Periodic check of active connections. */
 static struct etimer periodic;
+#endif /* UIP_TCP && !UIP_TCP_CTIMER */
 
 #if UIP_CONF_IPV6_REASSEMBLY
 /* Timer for reassembly. */
@@ -137,16 +139,18 @@ PROCESS(tcpip_process, "TCP/IP stack");
 static void
 start_periodic_tcp_timer(void)
 {
+#if !UIP_TCP_CTIMER
   if(etimer_expired(&periodic)) {
     etimer_restart(&periodic);
   }
+#endif /* !UIP_TCP_CTIMER */
 }
 #endif /* UIP_TCP */
 /*---------------------------------------------------------------------------*/
 static void
 check_for_tcp_syn(void)
 {
-#if UIP_TCP
+#if UIP_TCP && !UIP_TCP_CTIMER
   /* This is a hack that is needed to start the periodic TCP timer if
      an incoming packet contains a SYN: since uIP does not inform the
      application if a SYN arrives, we have no other way of starting
@@ -157,7 +161,7 @@ check_for_tcp_syn(void)
      (UIP_TCP_BUF->flags & TCP_SYN) == TCP_SYN) {
     start_periodic_tcp_timer();
   }
-#endif /* UIP_TCP */
+#endif /* UIP_TCP && !UIP_TCP_CTIMER */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -355,7 +359,7 @@ eventhandler(process_event_t ev, process_data_t data)
       for(cptr = &uip_udp_conns[0];
           cptr < &uip_udp_conns[UIP_UDP_CONNS]; ++cptr) {
         if(cptr->appstate.p == p) {
-          cptr->lport = 0;
+          uip_udp_remove(cptr);
         }
       }
     }
@@ -367,9 +371,9 @@ eventhandler(process_event_t ev, process_data_t data)
   {
     /* Check the clock so see if we should call the periodic uIP
            processing. */
+#if UIP_TCP && !UIP_TCP_CTIMER
     if(data == &periodic &&
         etimer_expired(&periodic)) {
-#if UIP_TCP
       for(i = 0; i < UIP_TCP_CONNS; ++i) {
         if(uip_conn_active(i)) {
           /* Only restart the timer if there are active
@@ -379,8 +383,8 @@ eventhandler(process_event_t ev, process_data_t data)
           tcpip_ipv6_output();
         }
       }
-#endif /* UIP_TCP */
     }
+#endif /* UIP_TCP && !UIP_TCP_CTIMER */
 
 #if UIP_CONF_IPV6_REASSEMBLY
     /*
@@ -561,19 +565,21 @@ queue_packet(uip_ds6_nbr_t *nbr)
 {
   /* Copy outgoing pkt in the queuing buffer for later transmit. */
 #if UIP_CONF_IPV6_QUEUE_PKT
-  if(uip_packetqueue_alloc(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME) != NULL) {
-    memcpy(uip_packetqueue_buf(&nbr->packethandle), UIP_IP_BUF, uip_len);
-    uip_packetqueue_set_buflen(&nbr->packethandle, uip_len);
+  if(uip_packetqueue_add(&nbr->packethandle, UIP_DS6_NBR_PACKET_LIFETIME,
+                         (uint8_t *)UIP_IP_BUF, uip_len) != NULL) {
     return 0;
   }
+  LOG_WARN("output: no room to queue packet for ");
+  LOG_WARN_6ADDR(&nbr->ipaddr);
+  LOG_WARN_("\n");
 #endif
 
   return 1;
 }
 #endif
 /*---------------------------------------------------------------------------*/
-static void
-send_queued(uip_ds6_nbr_t *nbr)
+void
+tcpip_send_queued(uip_ds6_nbr_t *nbr)
 {
 #if UIP_CONF_IPV6_QUEUE_PKT
   /*
@@ -581,8 +587,10 @@ send_queued(uip_ds6_nbr_t *nbr)
    * This happens in a few cases, for example when instead of receiving a
    * NA after sendiong a NS, you receive a NS with SLLAO: the entry moves
    * to STALE, and you must both send a NA and the queued packet.
+   * All packets queued during address resolution are released, oldest
+   * first.
    */
-  if(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
+  while(uip_packetqueue_buflen(&nbr->packethandle) != 0) {
     uip_len = uip_packetqueue_buflen(&nbr->packethandle);
     memcpy(UIP_IP_BUF, uip_packetqueue_buf(&nbr->packethandle), uip_len);
     uip_packetqueue_free(&nbr->packethandle);
@@ -737,7 +745,7 @@ send_packet:
   tcpip_output(linkaddr);
 
   if(nbr) {
-    send_queued(nbr);
+    tcpip_send_queued(nbr);
   }
 
 exit:
@@ -819,7 +827,9 @@ PROCESS_THREAD(tcpip_process, ev, data)
 #if UIP_CONF_ICMP6
   tcpip_icmp6_event = process_alloc_event();
 #endif /* UIP_CONF_ICMP6 */
+#if UIP_TCP && !UIP_TCP_CTIMER
   etimer_set(&periodic, CLOCK_SECOND / 2);
+#endif /* UIP_TCP && !UIP_TCP_CTIMER */
 
   uip_init();
 #ifdef UIP_FALLBACK_INTERFACE
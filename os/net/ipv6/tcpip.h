@@ -175,6 +175,10 @@ struct uip_conn *tcp_connect(const uip_ipaddr_t *ripaddr, uint16_t port,
  * immediately and do not wish to wait for the periodic uIP polling
  * mechanism.
  *
+ * With UIP_CONF_TCP_CTIMER there is no periodic polling of
+ * established connections, and this function is the only way to have
+ * uIP poll them.
+ *
  * \param conn A pointer to the TCP connection that should be polled.
  *
  */
@@ -347,6 +351,14 @@ uint8_t tcpip_output(const uip_lladdr_t *);
  */
 void tcpip_ipv6_output(void);
 
+struct uip_ds6_nbr;
+
+/**
+ * \brief Send all packets queued for a neighbor during address
+ * resolution, oldest first. Overwrites uip_buf.
+ */
+void tcpip_send_queued(struct uip_ds6_nbr *nbr);
+
 /**
  * \brief Is forwarding generally enabled?
  */
@@ -257,7 +257,7 @@ free_uip_ds6_nbr(uip_ds6_nbr_t *nbr)
     return;
   }
 #if UIP_CONF_IPV6_QUEUE_PKT
-  uip_packetqueue_free(&nbr->packethandle);
+  uip_packetqueue_flush(&nbr->packethandle);
 #endif /* UIP_CONF_IPV6_QUEUE_PKT */
   NETSTACK_ROUTING.neighbor_state_changed(nbr);
   assert(nbr->nbr_entry != NULL);
@@ -303,7 +303,7 @@ uip_ds6_nbr_rm(uip_ds6_nbr_t *nbr)
 #else /* UIP_DS6_NBR_MULTI_IPV6_ADDRS */
   if(nbr != NULL) {
 #if UIP_CONF_IPV6_QUEUE_PKT
-    uip_packetqueue_free(&nbr->packethandle);
+    uip_packetqueue_flush(&nbr->packethandle);
 #endif /* UIP_CONF_IPV6_QUEUE_PKT */
     NETSTACK_ROUTING.neighbor_state_changed(nbr);
     return nbr_table_remove(ds6_neighbors, nbr);
@@ -364,8 +364,17 @@ uip_ds6_nbr_update_ll(uip_ds6_nbr_t **nbr_pp, const uip_lladdr_t *new_ll_addr)
   }
 
   memcpy(&nbr_backup, *nbr_pp, sizeof(uip_ds6_nbr_t));
+#if UIP_CONF_IPV6_QUEUE_PKT
+  /* Keep the packets queued for the neighbor, which would otherwise be
+     freed along with the old entry */
+  uip_packetqueue_new(&nbr_backup.packethandle);
+  uip_packetqueue_move(&nbr_backup.packethandle, &(*nbr_pp)->packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
   if(uip_ds6_nbr_rm(*nbr_pp) == 0) {
     LOG_ERR("%s: input nbr cannot be removed\n", __func__);
+#if UIP_CONF_IPV6_QUEUE_PKT
+    uip_packetqueue_move(&(*nbr_pp)->packethandle, &nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
     return -1;
   }
 
@@ -373,9 +382,16 @@ uip_ds6_nbr_update_ll(uip_ds6_nbr_t **nbr_pp, const uip_lladdr_t *new_ll_addr)
                                 nbr_backup.isrouter, nbr_backup.state,
                                 NBR_TABLE_REASON_IPV6_ND, NULL)) == NULL) {
     LOG_ERR("%s: cannot allocate a new nbr for new_ll_addr\n", __func__);
+#if UIP_CONF_IPV6_QUEUE_PKT
+    uip_packetqueue_flush(&nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
     return -1;
   }
   memcpy(*nbr_pp, &nbr_backup, sizeof(uip_ds6_nbr_t));
+#if UIP_CONF_IPV6_QUEUE_PKT
+  uip_packetqueue_new(&(*nbr_pp)->packethandle);
+  uip_packetqueue_move(&(*nbr_pp)->packethandle, &nbr_backup.packethandle);
+#endif /* UIP_CONF_IPV6_QUEUE_PKT */
 #endif /* UIP_DS6_NBR_MULTI_IPV6_ADDRS */
 
   return 0;
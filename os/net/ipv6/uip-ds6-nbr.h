@@ -117,7 +117,7 @@ typedef struct uip_ds6_nbr {
 #endif /* UIP_ND6_SEND_NS || UIP_ND6_SEND_RA */
 #if UIP_CONF_IPV6_QUEUE_PKT
   struct uip_packetqueue_handle packethandle;
-#define UIP_DS6_NBR_PACKET_LIFETIME CLOCK_SECOND * 4
+#define UIP_DS6_NBR_PACKET_LIFETIME UIP_CONF_IPV6_QUEUE_PKT_LIFETIME
 #endif                          /*UIP_CONF_QUEUE_PKT */
 } uip_ds6_nbr_t;
 
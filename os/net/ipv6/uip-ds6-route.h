@@ -119,6 +119,7 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
 #define RPL_ROUTE_ENTRY_NOPATH_RECEIVED   0x01
 #define RPL_ROUTE_ENTRY_DAO_PENDING       0x02
 #define RPL_ROUTE_ENTRY_DAO_NACK          0x04
+#define RPL_ROUTE_ENTRY_DAO_FWD           0x08
 
 #define RPL_ROUTE_IS_NOPATH_RECEIVED(route)                             \
   (((route)->state.state_flags & RPL_ROUTE_ENTRY_NOPATH_RECEIVED) != 0)
@@ -147,6 +148,15 @@ void uip_ds6_notification_rm(struct uip_ds6_notification *n);
     (route)->state.state_flags &= ~RPL_ROUTE_ENTRY_DAO_NACK;            \
   } while(0)
 
+#define RPL_ROUTE_IS_DAO_FWD(route)                                     \
+  (((route)->state.state_flags & RPL_ROUTE_ENTRY_DAO_FWD) != 0)
+#define RPL_ROUTE_SET_DAO_FWD(route) do {                               \
+    (route)->state.state_flags |= RPL_ROUTE_ENTRY_DAO_FWD;              \
+  } while(0)
+#define RPL_ROUTE_CLEAR_DAO_FWD(route) do {                             \
+    (route)->state.state_flags &= ~RPL_ROUTE_ENTRY_DAO_FWD;             \
+  } while(0)
+
 #define RPL_ROUTE_CLEAR_DAO(route) do {                                 \
     (route)->state.state_flags &= ~(RPL_ROUTE_ENTRY_DAO_NACK|RPL_ROUTE_ENTRY_DAO_PENDING); \
   } while(0)
@@ -158,6 +168,11 @@ typedef struct rpl_route_entry {
   uint8_t dao_seqno_out;
   uint8_t dao_seqno_in;
   uint8_t state_flags;
+#if RPL_CONF_DAO_MAX_TARGETS > 1
+  /* RPL_DAO_MAX_TARGETS > 1: the DAO lifetime to send the route with.
+     RPL_DAO_MAX_TARGETS itself may not be defined yet here. */
+  uint8_t dao_lifetime;
+#endif /* RPL_CONF_DAO_MAX_TARGETS > 1 */
 } rpl_route_entry_t;
 #endif /* UIP_DS6_ROUTE_STATE_TYPE */
 
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <string.h>
 
 #include "net/ipv6/uip.h"
 
@@ -6,7 +7,18 @@
 
 #include "net/ipv6/uip-packetqueue.h"
 
+#ifdef UIP_CONF_IPV6_QUEUE_PKT_POOL_SIZE
+#define MAX_NUM_QUEUED_PACKETS UIP_CONF_IPV6_QUEUE_PKT_POOL_SIZE
+#else
 #define MAX_NUM_QUEUED_PACKETS 2
+#endif
+
+#ifdef UIP_CONF_IPV6_QUEUE_PKT_DEPTH
+#define MAX_QUEUED_PER_HANDLE UIP_CONF_IPV6_QUEUE_PKT_DEPTH
+#else
+#define MAX_QUEUED_PER_HANDLE 1
+#endif
+
 MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
 
 #define DEBUG 0
@@ -17,70 +29,125 @@ MEMB(packets_memb, struct uip_packetqueue_packet, MAX_NUM_QUEUED_PACKETS);
 #define PRINTF(...)
 #endif
 
+/*---------------------------------------------------------------------------*/
+static void
+remove_packet(struct uip_packetqueue_handle *h,
+              struct uip_packetqueue_packet *p)
+{
+  ctimer_stop(&p->lifetimer);
+  list_remove(h->packets, p);
+  memb_free(&packets_memb, p);
+  h->count--;
+}
 /*---------------------------------------------------------------------------*/
 static void
 packet_timedout(void *ptr)
 {
-  struct uip_packetqueue_handle *h = ptr;
+  struct uip_packetqueue_packet *p = ptr;
 
-  PRINTF("uip_packetqueue_free timed out %p\n", h);
-  memb_free(&packets_memb, h->packet);
-  h->packet = NULL;
+  PRINTF("uip_packetqueue_free timed out %p\n", p->handle);
+  UIP_STAT(++uip_stat.nd6.queue_expired);
+  remove_packet(p->handle, p);
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_new(struct uip_packetqueue_handle *handle)
 {
   PRINTF("uip_packetqueue_new %p\n", handle);
-  handle->packet = NULL;
+  LIST_STRUCT_INIT(handle, packets);
+  handle->count = 0;
 }
 /*---------------------------------------------------------------------------*/
 struct uip_packetqueue_packet *
-uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime)
+uip_packetqueue_add(struct uip_packetqueue_handle *handle,
+                    clock_time_t lifetime, const uint8_t *buf, uint16_t len)
 {
-  PRINTF("uip_packetqueue_alloc %p\n", handle);
-  if(handle->packet != NULL) {
-    PRINTF("alloced\n");
+  struct uip_packetqueue_packet *p;
+
+  PRINTF("uip_packetqueue_add %p\n", handle);
+  if(len > UIP_BUFSIZE) {
     return NULL;
   }
-  handle->packet = memb_alloc(&packets_memb);
-  if(handle->packet != NULL) {
-    ctimer_set(&handle->packet->lifetimer, lifetime,
-               packet_timedout, handle);
-  } else {
-    PRINTF("uip_packetqueue_alloc failed\n");
+
+  if(handle->count >= MAX_QUEUED_PER_HANDLE) {
+    /* Queue full: the new packet replaces the oldest one */
+    PRINTF("queue full, dropping oldest\n");
+    UIP_STAT(++uip_stat.nd6.queue_overflow);
+    remove_packet(handle, list_head(handle->packets));
+  }
+
+  p = memb_alloc(&packets_memb);
+  if(p == NULL) {
+    PRINTF("uip_packetqueue_add failed\n");
+    UIP_STAT(++uip_stat.nd6.queue_nomem);
+    return NULL;
   }
-  return handle->packet;
+
+  memcpy(p->queue_buf, buf, len);
+  p->queue_buf_len = len;
+  p->handle = handle;
+  list_add(handle->packets, p);
+  handle->count++;
+  ctimer_set(&p->lifetimer, lifetime, packet_timedout, p);
+  UIP_STAT(++uip_stat.nd6.queued);
+  return p;
 }
 /*---------------------------------------------------------------------------*/
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle)
 {
+  struct uip_packetqueue_packet *p;
+
   PRINTF("uip_packetqueue_free %p\n", handle);
-  if(handle->packet != NULL) {
-    ctimer_stop(&handle->packet->lifetimer);
-    memb_free(&packets_memb, handle->packet);
-    handle->packet = NULL;
+  p = list_head(handle->packets);
+  if(p != NULL) {
+    remove_packet(handle, p);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_flush(struct uip_packetqueue_handle *handle)
+{
+  struct uip_packetqueue_packet *p;
+
+  PRINTF("uip_packetqueue_flush %p\n", handle);
+  while((p = list_head(handle->packets)) != NULL) {
+    remove_packet(handle, p);
   }
 }
 /*---------------------------------------------------------------------------*/
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *dst,
+                     struct uip_packetqueue_handle *src)
+{
+  struct uip_packetqueue_packet *p;
+
+  PRINTF("uip_packetqueue_move %p to %p\n", src, dst);
+  while((p = list_pop(src->packets)) != NULL) {
+    p->handle = dst;
+    list_add(dst->packets, p);
+  }
+  dst->count += src->count;
+  src->count = 0;
+}
+/*---------------------------------------------------------------------------*/
 uint8_t *
 uip_packetqueue_buf(struct uip_packetqueue_handle *h)
 {
-  return h->packet != NULL? h->packet->queue_buf: NULL;
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+  return p != NULL ? p->queue_buf : NULL;
 }
 /*---------------------------------------------------------------------------*/
 uint16_t
 uip_packetqueue_buflen(struct uip_packetqueue_handle *h)
 {
-  return h->packet != NULL? h->packet->queue_buf_len: 0;
+  struct uip_packetqueue_packet *p = list_head(h->packets);
+  return p != NULL ? p->queue_buf_len : 0;
 }
 /*---------------------------------------------------------------------------*/
-void
-uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len)
+uint8_t
+uip_packetqueue_count(struct uip_packetqueue_handle *h)
 {
-  if(h->packet != NULL) {
-    h->packet->queue_buf_len = len;
-  }
+  return h->count;
 }
 /*---------------------------------------------------------------------------*/
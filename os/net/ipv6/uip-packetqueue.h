@@ -2,11 +2,21 @@
 #define UIP_PACKETQUEUE_H
 
 #include "sys/ctimer.h"
+#include "lib/list.h"
+
+/*
+ * Per-neighbor packet queue used while address resolution is in
+ * progress. Queued packets are taken from a pool shared by all
+ * neighbors (UIP_CONF_IPV6_QUEUE_PKT_POOL_SIZE entries), each neighbor
+ * may hold at most UIP_CONF_IPV6_QUEUE_PKT_DEPTH of them, and every
+ * packet is discarded when its lifetime expires. When the per-neighbor
+ * depth is exceeded, the oldest packet is replaced (RFC 4861, 7.2.2).
+ */
 
 struct uip_packetqueue_handle;
 
 struct uip_packetqueue_packet {
-  struct uip_ds6_queued_packet *next;
+  struct uip_packetqueue_packet *next;
   uint8_t queue_buf[UIP_BUFSIZE];
   uint16_t queue_buf_len;
   struct ctimer lifetimer;
@@ -14,22 +24,42 @@ struct uip_packetqueue_packet {
 };
 
 struct uip_packetqueue_handle {
-  struct uip_packetqueue_packet *packet;
+  LIST_STRUCT(packets);
+  uint8_t count;
 };
 
 void uip_packetqueue_new(struct uip_packetqueue_handle *handle);
 
-
+/**
+ * \brief Append a copy of a packet to the tail of a queue
+ * \param handle The queue
+ * \param lifetime How long the packet may stay in the queue
+ * \param buf The packet to copy
+ * \param len The length of the packet
+ * \return The queued packet, or NULL if the shared pool is exhausted
+ */
 struct uip_packetqueue_packet *
-uip_packetqueue_alloc(struct uip_packetqueue_handle *handle, clock_time_t lifetime);
-
+uip_packetqueue_add(struct uip_packetqueue_handle *handle,
+                    clock_time_t lifetime, const uint8_t *buf, uint16_t len);
 
+/** \brief Free the packet at the head of a queue */
 void
 uip_packetqueue_free(struct uip_packetqueue_handle *handle);
 
+/** \brief Free all packets in a queue */
+void
+uip_packetqueue_flush(struct uip_packetqueue_handle *handle);
+
+/** \brief Move all packets of queue src to the empty queue dst */
+void
+uip_packetqueue_move(struct uip_packetqueue_handle *dst,
+                     struct uip_packetqueue_handle *src);
+
+/* Accessors for the packet at the head of a queue (the oldest one) */
 uint8_t *uip_packetqueue_buf(struct uip_packetqueue_handle *h);
 uint16_t uip_packetqueue_buflen(struct uip_packetqueue_handle *h);
-void uip_packetqueue_set_buflen(struct uip_packetqueue_handle *h, uint16_t len);
 
+/** \brief The number of packets currently in a queue */
+uint8_t uip_packetqueue_count(struct uip_packetqueue_handle *h);
 
 #endif /* UIP_PACKETQUEUE_H */
@@ -54,6 +54,9 @@
 /* Total number of nodes */
 static int num_nodes;
 
+/* Changes with the topology of the graph */
+static uint32_t version;
+
 /* Every known node in the network */
 LIST(nodelist);
 MEMB(nodememb, uip_sr_node_t, UIP_SR_LINK_NUM);
@@ -65,6 +68,12 @@ uip_sr_num_nodes(void)
   return num_nodes;
 }
 /*---------------------------------------------------------------------------*/
+uint32_t
+uip_sr_version(void)
+{
+  return version;
+}
+/*---------------------------------------------------------------------------*/
 static int
 node_matches_address(const void *graph, const uip_sr_node_t *node,
                      const uip_ipaddr_t *addr)
@@ -155,16 +164,20 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
     child_node->parent = NULL;
     list_add(nodelist, child_node);
     num_nodes++;
+    version++;
   }
 
   /* Initialize node */
+  old_parent_node = child_node->parent;
+  if(child_node->graph != graph) {
+    version++;
+  }
   child_node->graph = graph;
   child_node->lifetime = lifetime;
   memcpy(child_node->link_identifier, ((const unsigned char *)child) + 8, 8);
 
   /* Is the node reachable before the update? */
   if(uip_sr_is_addr_reachable(graph, child)) {
-    old_parent_node = child_node->parent;
     /* Update node */
     child_node->parent = parent_node;
     /* Has the node become unreachable? May happen if we create a loop. */
@@ -177,6 +190,9 @@ uip_sr_update_node(void *graph, const uip_ipaddr_t *child,
   } else {
     child_node->parent = parent_node;
   }
+  if(child_node->parent != old_parent_node) {
+    version++;
+  }
 
   LOG_INFO("NS: updating link, child ");
   LOG_INFO_6ADDR(child);
@@ -191,6 +207,7 @@ void
 uip_sr_init(void)
 {
   num_nodes = 0;
+  version++;
   memb_init(&nodememb);
   list_init(nodelist);
 }
@@ -237,6 +254,7 @@ uip_sr_periodic(unsigned seconds)
         list_remove(nodelist, l);
         memb_free(&nodememb, l);
         num_nodes--;
+        version++;
       }
     } else if(l->lifetime != UIP_SR_INFINITE_LIFETIME) {
       l->lifetime = l->lifetime > seconds ? l->lifetime - seconds : 0;
@@ -255,6 +273,7 @@ uip_sr_free_all(void)
     memb_free(&nodememb, l);
     num_nodes--;
   }
+  version++;
 }
 /*---------------------------------------------------------------------------*/
 int
@@ -109,6 +109,15 @@ typedef struct uip_sr_node {
  */
 int uip_sr_num_nodes(void);
 
+/**
+ * Tells the version of the graph, which changes whenever a node is
+ * added or removed, or gets a new parent. Source routes built from the
+ * graph are valid as long as the version is unchanged.
+ *
+ * \return The current version
+ */
+uint32_t uip_sr_version(void);
+
 /**
  * Expires a given child-parent link
  *
@@ -554,6 +554,40 @@ struct uip_conn *uip_connect(const uip_ipaddr_t *ripaddr, uint16_t port);
  */
 #define uip_outstanding(conn) ((conn)->len)
 
+#if UIP_TCP_SLIDING_WINDOW
+/**
+ * Let a connection have several unacknowledged segments in flight.
+ *
+ * An application that enables this must be able to send new data
+ * while older data is still unacknowledged: new data is taken from
+ * uip_outstanding() bytes into its send buffer, and a retransmission
+ * always starts at the beginning of the unacknowledged data. When
+ * uip_acked() is true, uip_ackedlen() tells how many bytes were
+ * acknowledged.
+ *
+ * \param conn A pointer to the uip_conn structure for the connection.
+ *
+ * \hideinitializer
+ */
+#define uip_set_sliding_window(conn) ((conn)->sliding_window = 1)
+
+/**
+ * Check if a connection uses sliding-window mode.
+ *
+ * \hideinitializer
+ */
+#define uip_sliding_window(conn) ((conn)->sliding_window)
+
+/**
+ * The number of bytes acknowledged by the incoming segment, in
+ * sliding-window mode.
+ *
+ * \hideinitializer
+ */
+#define uip_ackedlen() (uip_acked_len)
+extern uint16_t uip_acked_len;
+#endif /* UIP_TCP_SLIDING_WINDOW */
+
 /**
  * Send data on the current connection.
  *
@@ -815,7 +849,11 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH
+#define uip_udp_remove(conn) uip_udp_set_lport(conn, 0)
+#else /* UIP_CONN_HASH */
 #define uip_udp_remove(conn) (conn)->lport = 0
+#endif /* UIP_CONN_HASH */
 
 /**
  * Bind a UDP connection to a local port.
@@ -827,7 +865,26 @@ struct uip_udp_conn *uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport);
  *
  * \hideinitializer
  */
+#if UIP_CONN_HASH
+#define uip_udp_bind(conn, port) uip_udp_set_lport(conn, port)
+#else /* UIP_CONN_HASH */
 #define uip_udp_bind(conn, port) (conn)->lport = port
+#endif /* UIP_CONN_HASH */
+
+/**
+ * Set the local port of a UDP connection and update the connection
+ * hash index accordingly.
+ *
+ * Use uip_udp_bind() and uip_udp_remove() rather than calling this
+ * function directly.
+ *
+ * \param conn A pointer to the uip_udp_conn structure for the
+ * connection.
+ *
+ * \param port The local port number in network byte order, or 0 to
+ * free the connection.
+ */
+void uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port);
 
 /**
  * Send a UDP datagram of length len on the current connection.
@@ -1245,6 +1302,23 @@ extern uint8_t uip_last_proto;
 extern uint16_t uip_urglen, uip_surglen;
 #endif /* UIP_URGDATA > 0 */
 
+#if UIP_TCP_SLIDING_WINDOW
+/**
+ * A TCP segment in flight on a sliding-window connection.
+ */
+struct uip_tcp_seg {
+  uint16_t end;          /**< The offset of the end of the segment,
+                              counted from the first unacknowledged
+                              byte. */
+#if UIP_TCP_CTIMER
+  clock_time_t sent;     /**< When the segment was sent. */
+#else /* UIP_TCP_CTIMER */
+  uint8_t age;           /**< Timer pulses since the segment was sent. */
+#endif /* UIP_TCP_CTIMER */
+  uint8_t rexmit;        /**< Non-zero if the segment was retransmitted. */
+};
+#endif /* UIP_TCP_SLIDING_WINDOW */
+
 /**
  * Representation of a uIP TCP connection.
  *
@@ -1268,13 +1342,32 @@ struct uip_conn {
   uint16_t len;          /**< Length of the data that was previously sent. */
   uint16_t mss;          /**< Current maximum segment size for the connection. */
   uint16_t initialmss;   /**< Initial maximum segment size for the connection. */
+#if UIP_TCP_CTIMER
+  clock_time_t sa;       /**< The smoothed RTT, scaled by 8, in clock ticks. */
+  clock_time_t sv;       /**< The RTT variation, scaled by 4, in clock ticks. */
+  clock_time_t rto;      /**< Retransmission time-out, in clock ticks. */
+  uint8_t tcpstateflags; /**< TCP state and flags. */
+  struct ctimer timer;   /**< The retransmission, FIN_WAIT_2 and
+                              TIME_WAIT timer. */
+#else /* UIP_TCP_CTIMER */
   uint8_t sa;            /**< Retransmission time-out calculation state variable. */
   uint8_t sv;            /**< Retransmission time-out calculation state variable. */
   uint8_t rto;           /**< Retransmission time-out. */
   uint8_t tcpstateflags; /**< TCP state and flags. */
   uint8_t timer;         /**< The retransmission timer. */
+#endif /* UIP_TCP_CTIMER */
   uint8_t nrtx;          /**< The number of retransmissions for the last
                               segment sent. */
+#if UIP_TCP_SLIDING_WINDOW
+  uint16_t snd_wnd;      /**< The window advertised by the remote host. */
+  uint8_t sliding_window; /**< Non-zero if the application accepts several
+                               segments in flight. */
+  uint8_t nsegs;         /**< The number of segments in flight. */
+  uint8_t dupacks;       /**< The number of duplicate ACKs received. */
+  struct uip_tcp_seg segs[UIP_TCP_MAX_SEGMENTS]; /**< The segments in
+                                                     flight, oldest
+                                                     first. */
+#endif /* UIP_TCP_SLIDING_WINDOW */
   uip_tcp_appstate_t appstate; /** The application state. */
 };
 
@@ -1395,6 +1488,9 @@ struct uip_stats {
                                connections were available. */
     uip_stats_t synrst;   /**< Number of SYNs for closed ports,
                                triggering a RST. */
+#if UIP_TCP_SLIDING_WINDOW
+    uip_stats_t fastrexmit; /**< Number of fast retransmissions. */
+#endif /* UIP_TCP_SLIDING_WINDOW */
   } tcp;                  /**< TCP statistics. */
 #endif
 #if UIP_UDP
@@ -1410,7 +1506,21 @@ struct uip_stats {
     uip_stats_t drop;     /**< Number of dropped ND6 packets. */
     uip_stats_t recv;     /**< Number of recived ND6 packets */
     uip_stats_t sent;     /**< Number of sent ND6 packets */
+    uip_stats_t queued;   /**< Number of packets queued during address
+                               resolution. */
+    uip_stats_t queue_overflow; /**< Number of queued packets replaced
+                                     because a neighbor queue was full. */
+    uip_stats_t queue_nomem; /**< Number of packets not queued because
+                                  the shared queue pool was exhausted. */
+    uip_stats_t queue_expired; /**< Number of queued packets that timed
+                                    out before being sent. */
   } nd6;
+  struct {
+    uip_stats_t hit;      /**< Number of source routing headers copied
+                               from the cache. */
+    uip_stats_t miss;     /**< Number of source routing headers built
+                               from the graph. */
+  } sr;                   /**< Source routing statistics. */
 };
 
 
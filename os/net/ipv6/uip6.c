@@ -217,6 +217,11 @@ static uint8_t iss[4];
 
 /* Temporary variables. */
 uint8_t uip_acc32[4];
+
+#if UIP_TCP_SLIDING_WINDOW
+/* The number of bytes acknowledged by the current segment. */
+uint16_t uip_acked_len;
+#endif /* UIP_TCP_SLIDING_WINDOW */
 #endif /* UIP_TCP */
 /** @} */
 
@@ -232,6 +237,503 @@ struct uip_udp_conn uip_udp_conns[UIP_UDP_CONNS];
 #endif /* UIP_UDP */
 /** @} */
 
+/*---------------------------------------------------------------------------*/
+/**
+ * \name Connection hash index
+ * @{
+ */
+/*---------------------------------------------------------------------------*/
+#if UIP_CONN_HASH
+#if (UIP_CONN_HASH_SIZE & (UIP_CONN_HASH_SIZE - 1)) != 0
+#error "UIP_CONN_HASH_SIZE must be a power of two"
+#endif
+#if UIP_UDP_CONNS >= 0xff || UIP_TCP_CONNS >= 0xff || UIP_LISTENPORTS >= 0xff
+#error "UIP_CONN_HASH supports at most 254 entries per table"
+#endif
+
+/*
+ * Each table (UDP connections, TCP connections, TCP listen ports) is
+ * indexed by a set of buckets keyed on the local port. A bucket holds
+ * the table index of its first entry, and the entries of a bucket are
+ * chained through a per-table array of next indices. Chains are kept
+ * sorted on table index so that a lookup returns the same entry as a
+ * linear scan of the table would.
+ */
+#define CONN_HASH_NONE 0xff
+#define CONN_HASH(port) \
+  ((uint8_t)((port) ^ ((port) >> 8)) & (UIP_CONN_HASH_SIZE - 1))
+
+typedef uint8_t conn_hash_index_t;
+
+#if UIP_UDP
+static conn_hash_index_t udp_buckets[UIP_CONN_HASH_SIZE];
+static conn_hash_index_t udp_next[UIP_UDP_CONNS];
+#endif /* UIP_UDP */
+#if UIP_TCP
+static conn_hash_index_t tcp_buckets[UIP_CONN_HASH_SIZE];
+static conn_hash_index_t tcp_next[UIP_TCP_CONNS];
+static conn_hash_index_t listen_buckets[UIP_CONN_HASH_SIZE];
+static conn_hash_index_t listen_next[UIP_LISTENPORTS];
+#endif /* UIP_TCP */
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_insert(conn_hash_index_t *buckets, conn_hash_index_t *next,
+                 uint16_t port, conn_hash_index_t index)
+{
+  conn_hash_index_t *p = &buckets[CONN_HASH(port)];
+
+  while(*p != CONN_HASH_NONE && *p < index) {
+    p = &next[*p];
+  }
+  next[index] = *p;
+  *p = index;
+}
+/*---------------------------------------------------------------------------*/
+static void
+conn_hash_remove(conn_hash_index_t *buckets, conn_hash_index_t *next,
+                 uint16_t port, conn_hash_index_t index)
+{
+  conn_hash_index_t *p = &buckets[CONN_HASH(port)];
+
+  while(*p != CONN_HASH_NONE) {
+    if(*p == index) {
+      *p = next[index];
+      return;
+    }
+    p = &next[*p];
+  }
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+/* Move a TCP connection to the bucket of a new local port. Closed
+   connections may linger in their old bucket until the entry is
+   reused, as lookups skip connections in the CLOSED state. */
+static void
+tcp_conn_set_lport(struct uip_conn *conn, uint16_t port)
+{
+  conn_hash_index_t index = conn - uip_conns;
+
+  conn_hash_remove(tcp_buckets, tcp_next, conn->lport, index);
+  conn->lport = port;
+  conn_hash_insert(tcp_buckets, tcp_next, port, index);
+}
+#endif /* UIP_TCP */
+#endif /* UIP_CONN_HASH */
+/*---------------------------------------------------------------------------*/
+#if UIP_UDP
+void
+uip_udp_set_lport(struct uip_udp_conn *conn, uint16_t port)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t index = conn - uip_udp_conns;
+
+  if(conn->lport != 0) {
+    conn_hash_remove(udp_buckets, udp_next, conn->lport, index);
+  }
+  if(port != 0) {
+    conn_hash_insert(udp_buckets, udp_next, port, index);
+  }
+#endif /* UIP_CONN_HASH */
+  conn->lport = port;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+udp_lport_in_use(uint16_t port)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t c;
+
+  for(c = udp_buckets[CONN_HASH(port)]; c != CONN_HASH_NONE; c = udp_next[c]) {
+    if(uip_udp_conns[c].lport == port) {
+      return true;
+    }
+  }
+#else /* UIP_CONN_HASH */
+  int c;
+
+  for(c = 0; c < UIP_UDP_CONNS; ++c) {
+    if(uip_udp_conns[c].lport == port) {
+      return true;
+    }
+  }
+#endif /* UIP_CONN_HASH */
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+/* If the local UDP port is non-zero, the connection is considered to
+   be used. If so, the local port number is checked against the
+   destination port number in the received packet. If the two port
+   numbers match, the remote port number is checked if the connection
+   is bound to a remote port. Finally, if the connection is bound to a
+   remote IP address, the source IP address of the packet is
+   checked. */
+static bool
+udp_conn_match(const struct uip_udp_conn *conn)
+{
+  return conn->lport != 0 &&
+    UIP_UDP_BUF->destport == conn->lport &&
+    (conn->rport == 0 ||
+     UIP_UDP_BUF->srcport == conn->rport) &&
+    (uip_is_addr_unspecified(&conn->ripaddr) ||
+     uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &conn->ripaddr));
+}
+/*---------------------------------------------------------------------------*/
+/* Demultiplex the UDP packet in uip_buf between the UDP "connections". */
+static struct uip_udp_conn *
+udp_conn_lookup(void)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t c;
+
+  for(c = udp_buckets[CONN_HASH(UIP_UDP_BUF->destport)];
+      c != CONN_HASH_NONE; c = udp_next[c]) {
+    if(udp_conn_match(&uip_udp_conns[c])) {
+      return &uip_udp_conns[c];
+    }
+  }
+#else /* UIP_CONN_HASH */
+  struct uip_udp_conn *conn;
+
+  for(conn = &uip_udp_conns[0]; conn < &uip_udp_conns[UIP_UDP_CONNS]; ++conn) {
+    if(udp_conn_match(conn)) {
+      return conn;
+    }
+  }
+#endif /* UIP_CONN_HASH */
+  return NULL;
+}
+#endif /* UIP_UDP */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+static bool
+tcp_lport_in_use(uint16_t port)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t c;
+
+  for(c = tcp_buckets[CONN_HASH(port)]; c != CONN_HASH_NONE; c = tcp_next[c]) {
+    if(uip_conns[c].tcpstateflags != UIP_CLOSED &&
+       uip_conns[c].lport == port) {
+      return true;
+    }
+  }
+#else /* UIP_CONN_HASH */
+  int c;
+
+  for(c = 0; c < UIP_TCP_CONNS; ++c) {
+    if(uip_conns[c].tcpstateflags != UIP_CLOSED &&
+       uip_conns[c].lport == port) {
+      return true;
+    }
+  }
+#endif /* UIP_CONN_HASH */
+  return false;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+tcp_conn_match(const struct uip_conn *conn)
+{
+  return conn->tcpstateflags != UIP_CLOSED &&
+    UIP_TCP_BUF->destport == conn->lport &&
+    UIP_TCP_BUF->srcport == conn->rport &&
+    uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &conn->ripaddr);
+}
+/*---------------------------------------------------------------------------*/
+/* Find the active TCP connection that the segment in uip_buf belongs to. */
+static struct uip_conn *
+tcp_conn_lookup(void)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t c;
+
+  for(c = tcp_buckets[CONN_HASH(UIP_TCP_BUF->destport)];
+      c != CONN_HASH_NONE; c = tcp_next[c]) {
+    if(tcp_conn_match(&uip_conns[c])) {
+      return &uip_conns[c];
+    }
+  }
+#else /* UIP_CONN_HASH */
+  struct uip_conn *conn;
+
+  for(conn = &uip_conns[0]; conn < &uip_conns[UIP_TCP_CONNS]; ++conn) {
+    if(tcp_conn_match(conn)) {
+      return conn;
+    }
+  }
+#endif /* UIP_CONN_HASH */
+  return NULL;
+}
+/*---------------------------------------------------------------------------*/
+static bool
+tcp_is_listening(uint16_t port)
+{
+#if UIP_CONN_HASH
+  conn_hash_index_t c;
+
+  for(c = listen_buckets[CONN_HASH(port)]; c != CONN_HASH_NONE;
+      c = listen_next[c]) {
+    if(uip_listenports[c] == port) {
+      return true;
+    }
+  }
+#else /* UIP_CONN_HASH */
+  int c;
+
+  for(c = 0; c < UIP_LISTENPORTS; ++c) {
+    if(uip_listenports[c] == port) {
+      return true;
+    }
+  }
+#endif /* UIP_CONN_HASH */
+  return false;
+}
+#endif /* UIP_TCP */
+/** @} */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP
+#if UIP_TCP_CTIMER
+/* UIP_RTO and UIP_TIME_WAIT_TIMEOUT count pulses of tcpip's periodic
+   timer, which fires twice per second. */
+#define TCP_TIME(pulses) ((clock_time_t)(pulses) * (CLOCK_SECOND / 2))
+#else /* UIP_TCP_CTIMER */
+#define TCP_TIME(pulses) (pulses)
+#endif /* UIP_TCP_CTIMER */
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP_CTIMER
+static void
+tcp_rtt_estimate(struct uip_conn *conn, clock_time_t rtt)
+{
+  long m;
+
+  if(conn->sa == 0) {
+    /* The first measurement (RFC 6298, section 2.2) */
+    conn->sa = rtt << 3;
+    conn->sv = rtt << 1;
+  } else {
+    /* The same estimator as with the periodic timer, in clock ticks */
+    m = (long)rtt - (long)(conn->sa >> 3);
+    conn->sa += m;
+    if(m < 0) {
+      m = -m;
+    }
+    m -= (long)(conn->sv >> 2);
+    conn->sv += m;
+  }
+  conn->rto = MIN(MAX((conn->sa >> 3) + conn->sv, UIP_TCP_MIN_RTO),
+                  UIP_TCP_MAX_RTO);
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcp_timer_expired(void *ptr)
+{
+  uip_periodic_conn((struct uip_conn *)ptr);
+  tcpip_ipv6_output();
+}
+/*---------------------------------------------------------------------------*/
+static void
+tcp_timer_set(struct uip_conn *conn, clock_time_t t)
+{
+  ctimer_set_with_process(&conn->timer, t, tcp_timer_expired, conn,
+                          &tcpip_process);
+}
+/*---------------------------------------------------------------------------*/
+/* Without the periodic timer, the initial sequence number advances
+   with the clock instead. */
+static void
+tcp_iss_update(void)
+{
+  static clock_time_t last;
+  clock_time_t now = clock_time();
+
+  uip_add32(iss, 1 + MIN(now - last, 0xfffe));
+  memcpy(iss, uip_acc32, sizeof(iss));
+  last = now;
+}
+#else /* UIP_TCP_CTIMER */
+static void
+tcp_rtt_estimate(struct uip_conn *conn, signed char m)
+{
+  /* This is taken directly from VJs original code in his paper */
+  m = m - (conn->sa >> 3);
+  conn->sa += m;
+  if(m < 0) {
+    m = -m;
+  }
+  m = m - (conn->sv >> 2);
+  conn->sv += m;
+  conn->rto = (conn->sa >> 3) + conn->sv;
+}
+#endif /* UIP_TCP_CTIMER */
+/*---------------------------------------------------------------------------*/
+/* Restart the retransmission timer after data has been sent or
+   acknowledged. */
+static void
+tcp_timer_restart(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  if(uip_outstanding(conn)) {
+    tcp_timer_set(conn, conn->rto);
+  } else {
+    ctimer_stop(&conn->timer);
+  }
+#else /* UIP_TCP_CTIMER */
+  conn->timer = conn->rto;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* Back off the retransmission timer before the next retransmission. */
+static void
+tcp_timer_backoff(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  tcp_timer_set(conn, MIN(conn->rto << (conn->nrtx > 4 ? 4 : conn->nrtx),
+                          UIP_TCP_MAX_RTO));
+#else /* UIP_TCP_CTIMER */
+  conn->timer = UIP_RTO << (conn->nrtx > 4 ? 4 : conn->nrtx);
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* Returns true if the retransmission timer has expired. */
+static bool
+tcp_timer_tick(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  /* The timer callback only runs when the timer expires */
+  return true;
+#else /* UIP_TCP_CTIMER */
+  return conn->timer-- == 0;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* The time since the retransmission timer was last restarted. */
+static uint32_t
+tcp_timer_elapsed(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  return clock_time() - etimer_start_time(&conn->timer.etimer);
+#else /* UIP_TCP_CTIMER */
+  return conn->rto - conn->timer;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* Start timing out a connection in FIN_WAIT_2 or TIME_WAIT. */
+static void
+tcp_timer_wait(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  tcp_timer_set(conn, TCP_TIME(UIP_TIME_WAIT_TIMEOUT));
+#else /* UIP_TCP_CTIMER */
+  conn->timer = 0;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* Returns true if a connection in FIN_WAIT_2 or TIME_WAIT has timed
+   out. */
+static bool
+tcp_timer_wait_tick(struct uip_conn *conn)
+{
+#if UIP_TCP_CTIMER
+  return true;
+#else /* UIP_TCP_CTIMER */
+  return ++conn->timer == UIP_TIME_WAIT_TIMEOUT;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+/* Returns true if connection a has been in TIME_WAIT longer than b. */
+static bool
+tcp_timer_waited_longer(struct uip_conn *a, struct uip_conn *b)
+{
+#if UIP_TCP_CTIMER
+  return timer_remaining(&a->timer.etimer.timer) <
+    timer_remaining(&b->timer.etimer.timer);
+#else /* UIP_TCP_CTIMER */
+  return a->timer > b->timer;
+#endif /* UIP_TCP_CTIMER */
+}
+/*---------------------------------------------------------------------------*/
+#if UIP_TCP_SLIDING_WINDOW
+static void
+tcp_window_init(struct uip_conn *conn)
+{
+  conn->sliding_window = 0;
+  conn->nsegs = 0;
+  conn->dupacks = 0;
+  conn->snd_wnd = UIP_TCP_MSS;
+}
+/*---------------------------------------------------------------------------*/
+/* The number of bytes that can be sent beyond the data in flight. */
+static uint16_t
+tcp_window_space(const struct uip_conn *conn)
+{
+  uint32_t wnd = MIN(conn->snd_wnd,
+                     (uint32_t)UIP_TCP_MAX_SEGMENTS * conn->initialmss);
+
+  if(conn->nsegs >= UIP_TCP_MAX_SEGMENTS || conn->len >= wnd) {
+    return 0;
+  }
+  return wnd - conn->len;
+}
+/*---------------------------------------------------------------------------*/
+/* Window updates are not duplicate ACKs (RFC 5681, section 2). */
+static bool
+tcp_window_unchanged(const struct uip_conn *conn)
+{
+  uint16_t wnd = ((uint16_t)UIP_TCP_BUF->wnd[0] << 8) + UIP_TCP_BUF->wnd[1];
+
+  return (wnd == 0 ? conn->initialmss : wnd) == conn->snd_wnd;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the distance from sequence number b to sequence number a. */
+static uint32_t
+tcp_seq_diff(const uint8_t *a, const uint8_t *b)
+{
+  return (((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) |
+          ((uint32_t)a[2] << 8) | a[3]) -
+    (((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) |
+     ((uint32_t)b[2] << 8) | b[3]);
+}
+/*---------------------------------------------------------------------------*/
+/* Drop the segments covered by a cumulative ACK of acked bytes. The RTT
+   is sampled from the newest acknowledged segment, unless it has been
+   retransmitted (Karn's algorithm). */
+static void
+tcp_window_ack(struct uip_conn *conn, uint16_t acked)
+{
+  uint8_t i, n;
+  struct uip_tcp_seg *newest = NULL;
+
+  for(n = 0; n < conn->nsegs && conn->segs[n].end <= acked; n++) {
+    newest = &conn->segs[n];
+  }
+  if(newest != NULL && !newest->rexmit) {
+#if UIP_TCP_CTIMER
+    tcp_rtt_estimate(conn, clock_time() - newest->sent);
+#else /* UIP_TCP_CTIMER */
+    tcp_rtt_estimate(conn, newest->age);
+#endif /* UIP_TCP_CTIMER */
+  }
+
+  for(i = n; i < conn->nsegs; i++) {
+    conn->segs[i - n] = conn->segs[i];
+    conn->segs[i - n].end -= acked;
+  }
+  conn->nsegs -= n;
+}
+#endif /* UIP_TCP_SLIDING_WINDOW */
+/*---------------------------------------------------------------------------*/
+/* Returns true if the application may be polled for new data. */
+static bool
+tcp_can_send(const struct uip_conn *conn)
+{
+#if UIP_TCP_SLIDING_WINDOW
+  if(conn->sliding_window) {
+    return tcp_window_space(conn) > 0;
+  }
+#endif /* UIP_TCP_SLIDING_WINDOW */
+  return !uip_outstanding(conn);
+}
+#endif /* UIP_TCP */
+
 /*---------------------------------------------------------------------------*/
 /**
  * \name ICMPv6 variables
@@ -412,6 +914,16 @@ uip_init(void)
   }
 #endif /* UIP_UDP */
 
+#if UIP_CONN_HASH
+#if UIP_UDP
+  memset(udp_buckets, CONN_HASH_NONE, sizeof(udp_buckets));
+#endif /* UIP_UDP */
+#if UIP_TCP
+  memset(tcp_buckets, CONN_HASH_NONE, sizeof(tcp_buckets));
+  memset(listen_buckets, CONN_HASH_NONE, sizeof(listen_buckets));
+#endif /* UIP_TCP */
+#endif /* UIP_CONN_HASH */
+
 #if UIP_IPV6_MULTICAST
   UIP_MCAST6.init();
 #endif
@@ -434,12 +946,8 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
 
   /* Check if this port is already in use, and if so try to find
      another one. */
-  for(c = 0; c < UIP_TCP_CONNS; ++c) {
-    conn = &uip_conns[c];
-    if(conn->tcpstateflags != UIP_CLOSED &&
-       conn->lport == uip_htons(lastport)) {
-      goto again;
-    }
+  if(tcp_lport_in_use(uip_htons(lastport))) {
+    goto again;
   }
 
   conn = 0;
@@ -451,7 +959,7 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
     }
     if(cconn->tcpstateflags == UIP_TIME_WAIT) {
       if(conn == 0 ||
-         cconn->timer > conn->timer) {
+         tcp_timer_waited_longer(cconn, conn)) {
         conn = cconn;
       }
     }
@@ -463,6 +971,9 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
 
   conn->tcpstateflags = UIP_SYN_SENT;
 
+#if UIP_TCP_CTIMER
+  tcp_iss_update();
+#endif /* UIP_TCP_CTIMER */
   conn->snd_nxt[0] = iss[0];
   conn->snd_nxt[1] = iss[1];
   conn->snd_nxt[2] = iss[2];
@@ -477,11 +988,22 @@ uip_connect(const uip_ipaddr_t *ripaddr, uint16_t rport)
 
   conn->len = 1;   /* TCP length of the SYN is one. */
   conn->nrtx = 0;
-  conn->timer = 1; /* Send the SYN next time around. */
-  conn->rto = UIP_RTO;
+  conn->rto = TCP_TIME(UIP_RTO);
   conn->sa = 0;
   conn->sv = 16;   /* Initial value of the RTT variance. */
+#if UIP_TCP_CTIMER
+  tcp_timer_restart(conn);
+#else /* UIP_TCP_CTIMER */
+  conn->timer = 1; /* Send the SYN next time around. */
+#endif /* UIP_TCP_CTIMER */
+#if UIP_TCP_SLIDING_WINDOW
+  tcp_window_init(conn);
+#endif /* UIP_TCP_SLIDING_WINDOW */
+#if UIP_CONN_HASH
+  tcp_conn_set_lport(conn, uip_htons(lastport));
+#else /* UIP_CONN_HASH */
   conn->lport = uip_htons(lastport);
+#endif /* UIP_CONN_HASH */
   conn->rport = rport;
   uip_ipaddr_copy(&conn->ripaddr, ripaddr);
 
@@ -532,10 +1054,8 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     lastport = 4096;
   }
 
-  for(c = 0; c < UIP_UDP_CONNS; ++c) {
-    if(uip_udp_conns[c].lport == uip_htons(lastport)) {
-      goto again;
-    }
+  if(udp_lport_in_use(uip_htons(lastport))) {
+    goto again;
   }
 
   conn = 0;
@@ -550,7 +1070,7 @@ uip_udp_new(const uip_ipaddr_t *ripaddr, uint16_t rport)
     return 0;
   }
 
-  conn->lport = UIP_HTONS(lastport);
+  uip_udp_set_lport(conn, UIP_HTONS(lastport));
   conn->rport = rport;
   if(ripaddr == NULL) {
     memset(&conn->ripaddr, 0, sizeof(uip_ipaddr_t));
@@ -570,6 +1090,9 @@ uip_unlisten(uint16_t port)
   int c;
   for(c = 0; c < UIP_LISTENPORTS; ++c) {
     if(uip_listenports[c] == port) {
+#if UIP_CONN_HASH
+      conn_hash_remove(listen_buckets, listen_next, port, c);
+#endif /* UIP_CONN_HASH */
       uip_listenports[c] = 0;
       return;
     }
@@ -583,6 +1106,9 @@ uip_listen(uint16_t port)
   for(c = 0; c < UIP_LISTENPORTS; ++c) {
     if(uip_listenports[c] == 0) {
       uip_listenports[c] = port;
+#if UIP_CONN_HASH
+      conn_hash_insert(listen_buckets, listen_next, port, c);
+#endif /* UIP_CONN_HASH */
       return;
     }
   }
@@ -956,6 +1482,9 @@ uip_process(uint8_t flag)
   uint16_t tmp16;
   uint8_t opt;
   register struct uip_conn *uip_connr = uip_conn;
+#if UIP_TCP_SLIDING_WINDOW
+  uint16_t new_data_len = 0;
+#endif /* UIP_TCP_SLIDING_WINDOW */
 #endif /* UIP_TCP */
 #if UIP_UDP
   if(flag == UIP_UDP_SEND_CONN) {
@@ -969,7 +1498,12 @@ uip_process(uint8_t flag)
   if(flag == UIP_POLL_REQUEST) {
 #if UIP_TCP
     if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
-       !uip_outstanding(uip_connr)) {
+       tcp_can_send(uip_connr)) {
+#if UIP_TCP_SLIDING_WINDOW
+      /* With data in flight, uip_slen may still hold the length of the
+         last segment sent. */
+      uip_slen = 0;
+#endif /* UIP_TCP_SLIDING_WINDOW */
       uip_flags = UIP_POLL;
       UIP_APPCALL();
       goto appsend;
@@ -1006,8 +1540,7 @@ uip_process(uint8_t flag)
      */
     if(uip_connr->tcpstateflags == UIP_TIME_WAIT ||
        uip_connr->tcpstateflags == UIP_FIN_WAIT_2) {
-      ++(uip_connr->timer);
-      if(uip_connr->timer == UIP_TIME_WAIT_TIMEOUT) {
+      if(tcp_timer_wait_tick(uip_connr)) {
         uip_connr->tcpstateflags = UIP_CLOSED;
       }
     } else if(uip_connr->tcpstateflags != UIP_CLOSED) {
@@ -1017,7 +1550,14 @@ uip_process(uint8_t flag)
        * in which case we retransmit.
        */
       if(uip_outstanding(uip_connr)) {
-        if(uip_connr->timer-- == 0) {
+#if UIP_TCP_SLIDING_WINDOW && !UIP_TCP_CTIMER
+        for(c = 0; c < uip_connr->nsegs; c++) {
+          if(uip_connr->segs[c].age < 0x7f) {
+            uip_connr->segs[c].age++;
+          }
+        }
+#endif /* UIP_TCP_SLIDING_WINDOW && !UIP_TCP_CTIMER */
+        if(tcp_timer_tick(uip_connr)) {
           if(uip_connr->nrtx == UIP_MAXRTX ||
              ((uip_connr->tcpstateflags == UIP_SYN_SENT ||
                uip_connr->tcpstateflags == UIP_SYN_RCVD) &&
@@ -1038,9 +1578,7 @@ uip_process(uint8_t flag)
           }
 
           /* Exponential backoff. */
-          uip_connr->timer = UIP_RTO << (uip_connr->nrtx > 4?
-                                         4:
-                                         uip_connr->nrtx);
+          tcp_timer_backoff(uip_connr);
           ++(uip_connr->nrtx);
 
           /*
@@ -1071,6 +1609,15 @@ uip_process(uint8_t flag)
              * the code for sending out the packet (the apprexmit
              * label).
              */
+#if UIP_TCP_SLIDING_WINDOW
+            if(uip_connr->nsegs > 0) {
+              /* Retransmit the oldest segment in flight. The receiver
+                 may hold the later ones, so they stay in flight and
+                 are acknowledged cumulatively. */
+              uip_connr->segs[0].rexmit = 1;
+              uip_connr->dupacks = 0;
+            }
+#endif /* UIP_TCP_SLIDING_WINDOW */
             uip_flags = UIP_REXMIT;
             UIP_APPCALL();
             goto apprexmit;
@@ -1082,6 +1629,15 @@ uip_process(uint8_t flag)
             goto tcp_send_finack;
           }
         }
+#if UIP_TCP_SLIDING_WINDOW
+        if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
+           uip_connr->sliding_window && tcp_can_send(uip_connr)) {
+          /* There is room for more data in flight. */
+          uip_flags = UIP_POLL;
+          UIP_APPCALL();
+          goto appsend;
+        }
+#endif /* UIP_TCP_SLIDING_WINDOW */
       } else if((uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED) {
         /*
          * If there was no need for a retransmission, we poll the
@@ -1523,24 +2079,9 @@ uip_process(uint8_t flag)
   }
 
   /* Demultiplex this UDP packet between the UDP "connections". */
-  for(uip_udp_conn = &uip_udp_conns[0];
-      uip_udp_conn < &uip_udp_conns[UIP_UDP_CONNS];
-      ++uip_udp_conn) {
-    /* If the local UDP port is non-zero, the connection is considered
-       to be used. If so, the local port number is checked against the
-       destination port number in the received packet. If the two port
-       numbers match, the remote port number is checked if the
-       connection is bound to a remote port. Finally, if the
-       connection is bound to a remote IP address, the source IP
-       address of the packet is checked. */
-    if(uip_udp_conn->lport != 0 &&
-       UIP_UDP_BUF->destport == uip_udp_conn->lport &&
-       (uip_udp_conn->rport == 0 ||
-        UIP_UDP_BUF->srcport == uip_udp_conn->rport) &&
-       (uip_is_addr_unspecified(&uip_udp_conn->ripaddr) ||
-        uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &uip_udp_conn->ripaddr))) {
-      goto udp_found;
-    }
+  uip_udp_conn = udp_conn_lookup();
+  if(uip_udp_conn != NULL) {
+    goto udp_found;
   }
   LOG_ERR("udp: no matching connection found\n");
   UIP_STAT(++uip_stat.udp.drop);
@@ -1627,14 +2168,9 @@ uip_process(uint8_t flag)
 
   /* Demultiplex this segment. */
   /* First check any active connections. */
-  for(uip_connr = &uip_conns[0]; uip_connr <= &uip_conns[UIP_TCP_CONNS - 1];
-      ++uip_connr) {
-    if(uip_connr->tcpstateflags != UIP_CLOSED &&
-       UIP_TCP_BUF->destport == uip_connr->lport &&
-       UIP_TCP_BUF->srcport == uip_connr->rport &&
-       uip_ipaddr_cmp(&UIP_IP_BUF->srcipaddr, &uip_connr->ripaddr)) {
-      goto found;
-    }
+  uip_connr = tcp_conn_lookup();
+  if(uip_connr != NULL) {
+    goto found;
   }
 
   /* If we didn't find and active connection that expected the packet,
@@ -1645,12 +2181,9 @@ uip_process(uint8_t flag)
     goto reset;
   }
 
-  tmp16 = UIP_TCP_BUF->destport;
   /* Next, check listening connections. */
-  for(c = 0; c < UIP_LISTENPORTS; ++c) {
-    if(tmp16 == uip_listenports[c]) {
-      goto found_listen;
-    }
+  if(tcp_is_listening(UIP_TCP_BUF->destport)) {
+    goto found_listen;
   }
 
   /* No matching connection found, so we send a RST packet. */
@@ -1727,7 +2260,7 @@ uip_process(uint8_t flag)
     }
     if(uip_conns[c].tcpstateflags == UIP_TIME_WAIT) {
       if(uip_connr == 0 ||
-         uip_conns[c].timer > uip_connr->timer) {
+         tcp_timer_waited_longer(&uip_conns[c], uip_connr)) {
         uip_connr = &uip_conns[c];
       }
     }
@@ -1744,20 +2277,31 @@ uip_process(uint8_t flag)
   uip_conn = uip_connr;
 
   /* Fill in the necessary fields for the new connection. */
-  uip_connr->rto = uip_connr->timer = UIP_RTO;
+  uip_connr->rto = TCP_TIME(UIP_RTO);
   uip_connr->sa = 0;
   uip_connr->sv = 4;
   uip_connr->nrtx = 0;
+#if UIP_TCP_SLIDING_WINDOW
+  tcp_window_init(uip_connr);
+#endif /* UIP_TCP_SLIDING_WINDOW */
+#if UIP_CONN_HASH
+  tcp_conn_set_lport(uip_connr, UIP_TCP_BUF->destport);
+#else /* UIP_CONN_HASH */
   uip_connr->lport = UIP_TCP_BUF->destport;
+#endif /* UIP_CONN_HASH */
   uip_connr->rport = UIP_TCP_BUF->srcport;
   uip_ipaddr_copy(&uip_connr->ripaddr, &UIP_IP_BUF->srcipaddr);
   uip_connr->tcpstateflags = UIP_SYN_RCVD;
 
+#if UIP_TCP_CTIMER
+  tcp_iss_update();
+#endif /* UIP_TCP_CTIMER */
   uip_connr->snd_nxt[0] = iss[0];
   uip_connr->snd_nxt[1] = iss[1];
   uip_connr->snd_nxt[2] = iss[2];
   uip_connr->snd_nxt[3] = iss[3];
   uip_connr->len = 1;
+  tcp_timer_restart(uip_connr);
 
   /* rcv_nxt should be the seqno from the incoming packet + 1. */
   uip_connr->rcv_nxt[0] = UIP_TCP_BUF->seqno[0];
@@ -1886,6 +2430,41 @@ uip_process(uint8_t flag)
      data. If so, we update the sequence number, reset the length of
      the outstanding data, calculate RTT estimations, and reset the
      retransmission timer. */
+#if UIP_TCP_SLIDING_WINDOW
+  if(uip_connr->sliding_window) {
+    if((UIP_TCP_BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
+      uint32_t acked = tcp_seq_diff(UIP_TCP_BUF->ackno, uip_connr->snd_nxt);
+
+      if(acked > 0 && acked <= uip_connr->len) {
+        /* A cumulative ACK for some or all of the data in flight. */
+        uip_add32(uip_connr->snd_nxt, acked);
+        uip_connr->snd_nxt[0] = uip_acc32[0];
+        uip_connr->snd_nxt[1] = uip_acc32[1];
+        uip_connr->snd_nxt[2] = uip_acc32[2];
+        uip_connr->snd_nxt[3] = uip_acc32[3];
+        uip_connr->len -= acked;
+        tcp_window_ack(uip_connr, acked);
+        uip_acked_len = acked;
+        uip_flags = UIP_ACKDATA;
+        tcp_timer_restart(uip_connr);
+        uip_connr->nrtx = 0;
+        uip_connr->dupacks = 0;
+      } else if(acked == 0 && uip_len == 0 && uip_connr->nsegs > 0 &&
+                (UIP_TCP_BUF->flags & (TCP_SYN | TCP_FIN)) == 0 &&
+                tcp_window_unchanged(uip_connr) &&
+                (uip_connr->tcpstateflags & UIP_TS_MASK) == UIP_ESTABLISHED &&
+                ++uip_connr->dupacks == UIP_TCP_DUPACK_THRESHOLD) {
+        /* The receiver keeps acknowledging the start of the data in
+           flight: retransmit the oldest segment right away. */
+        UIP_STAT(++uip_stat.tcp.fastrexmit);
+        uip_connr->segs[0].rexmit = 1;
+        uip_flags = UIP_REXMIT;
+        UIP_APPCALL();
+        goto apprexmit;
+      }
+    }
+  } else
+#endif /* UIP_TCP_SLIDING_WINDOW */
   if((UIP_TCP_BUF->flags & TCP_ACK) && uip_outstanding(uip_connr)) {
     uip_add32(uip_connr->snd_nxt, uip_connr->len);
 
@@ -1901,26 +2480,15 @@ uip_process(uint8_t flag)
 
       /* Do RTT estimation, unless we have done retransmissions. */
       if(uip_connr->nrtx == 0) {
-        signed char m;
-        m = uip_connr->rto - uip_connr->timer;
-        /* This is taken directly from VJs original code in his paper */
-        m = m - (uip_connr->sa >> 3);
-        uip_connr->sa += m;
-        if(m < 0) {
-          m = -m;
-        }
-        m = m - (uip_connr->sv >> 2);
-        uip_connr->sv += m;
-        uip_connr->rto = (uip_connr->sa >> 3) + uip_connr->sv;
-
+        tcp_rtt_estimate(uip_connr, tcp_timer_elapsed(uip_connr));
       }
       /* Set the acknowledged flag. */
       uip_flags = UIP_ACKDATA;
-      /* Reset the retransmission timer. */
-      uip_connr->timer = uip_connr->rto;
 
       /* Reset length of outstanding data. */
       uip_connr->len = 0;
+      /* Reset the retransmission timer. */
+      tcp_timer_restart(uip_connr);
     }
 
   }
@@ -2040,6 +2608,9 @@ uip_process(uint8_t flag)
       uip_connr->len = 1;
       uip_connr->tcpstateflags = UIP_LAST_ACK;
       uip_connr->nrtx = 0;
+#if UIP_TCP_CTIMER
+      tcp_timer_restart(uip_connr);
+#endif /* UIP_TCP_CTIMER */
       tcp_send_finack:
       UIP_TCP_BUF->flags = TCP_FIN | TCP_ACK;
       goto tcp_send_nodata;
@@ -2093,6 +2664,9 @@ uip_process(uint8_t flag)
          "persistent timer" and uses the retransmission mechanim.
      */
     tmp16 = ((uint16_t)UIP_TCP_BUF->wnd[0] << 8) + (uint16_t)UIP_TCP_BUF->wnd[1];
+#if UIP_TCP_SLIDING_WINDOW
+    uip_connr->snd_wnd = tmp16 == 0 ? uip_connr->initialmss : tmp16;
+#endif /* UIP_TCP_SLIDING_WINDOW */
     if(tmp16 > uip_connr->initialmss ||
         tmp16 == 0) {
       tmp16 = uip_connr->initialmss;
@@ -2131,13 +2705,47 @@ uip_process(uint8_t flag)
       if(uip_flags & UIP_CLOSE) {
         uip_slen = 0;
         uip_connr->len = 1;
+#if UIP_TCP_SLIDING_WINDOW
+        uip_connr->nsegs = 0;
+#endif /* UIP_TCP_SLIDING_WINDOW */
         uip_connr->tcpstateflags = UIP_FIN_WAIT_1;
         uip_connr->nrtx = 0;
+#if UIP_TCP_CTIMER
+        tcp_timer_restart(uip_connr);
+#endif /* UIP_TCP_CTIMER */
         UIP_TCP_BUF->flags = TCP_FIN | TCP_ACK;
         goto tcp_send_nodata;
       }
 
       /* If uip_slen > 0, the application has data to be sent. */
+#if UIP_TCP_SLIDING_WINDOW
+      if(uip_slen > 0 && uip_connr->sliding_window) {
+        /* New data goes after the data in flight, as long as the
+           receiver's window and the segment table allow it. */
+        tmp16 = tcp_window_space(uip_connr);
+        if(uip_slen > uip_connr->mss) {
+          uip_slen = uip_connr->mss;
+        }
+        if(uip_slen > tmp16) {
+          uip_slen = tmp16;
+        }
+        if(uip_slen > 0) {
+          uip_connr->len += uip_slen;
+          if(uip_connr->nsegs == 0) {
+            tcp_timer_restart(uip_connr);
+          }
+          uip_connr->segs[uip_connr->nsegs].end = uip_connr->len;
+#if UIP_TCP_CTIMER
+          uip_connr->segs[uip_connr->nsegs].sent = clock_time();
+#else /* UIP_TCP_CTIMER */
+          uip_connr->segs[uip_connr->nsegs].age = 0;
+#endif /* UIP_TCP_CTIMER */
+          uip_connr->segs[uip_connr->nsegs].rexmit = 0;
+          uip_connr->nsegs++;
+          new_data_len = uip_slen;
+        }
+      } else
+#endif /* UIP_TCP_SLIDING_WINDOW */
       if(uip_slen > 0) {
 
         /* If the connection has acknowledged data, the contents of
@@ -2161,6 +2769,9 @@ uip_process(uint8_t flag)
           /* Remember how much data we send out now so that we know
                when everything has been acknowledged. */
           uip_connr->len = uip_slen;
+#if UIP_TCP_CTIMER
+          tcp_timer_restart(uip_connr);
+#endif /* UIP_TCP_CTIMER */
         } else {
 
           /* If the application already had unacknowledged data, we
@@ -2173,6 +2784,26 @@ uip_process(uint8_t flag)
       apprexmit:
       uip_appdata = uip_sappdata;
 
+#if UIP_TCP_SLIDING_WINDOW
+      if(uip_connr->sliding_window) {
+        if((uip_flags & UIP_REXMIT) && uip_connr->nsegs > 0) {
+          /* Only the oldest segment in flight is retransmitted. */
+          if(uip_slen > uip_connr->segs[0].end) {
+            uip_slen = uip_connr->segs[0].end;
+          } else if(uip_slen > 0) {
+            uip_connr->segs[0].end = uip_slen;
+            if(uip_connr->nsegs == 1) {
+              uip_connr->len = uip_slen;
+            }
+          }
+        }
+        if(uip_slen > 0 && uip_connr->len > 0) {
+          uip_len = uip_slen + UIP_IPTCPH_LEN;
+          UIP_TCP_BUF->flags = TCP_ACK | TCP_PSH;
+          goto tcp_send_noopts;
+        }
+      } else
+#endif /* UIP_TCP_SLIDING_WINDOW */
       /* If the application has data to be sent, or if the incoming
            packet had new data in it, we must send out a packet. */
       if(uip_slen > 0 && uip_connr->len > 0) {
@@ -2212,7 +2843,7 @@ uip_process(uint8_t flag)
     if(UIP_TCP_BUF->flags & TCP_FIN) {
       if(uip_flags & UIP_ACKDATA) {
         uip_connr->tcpstateflags = UIP_TIME_WAIT;
-        uip_connr->timer = 0;
+        tcp_timer_wait(uip_connr);
         uip_connr->len = 0;
       } else {
         uip_connr->tcpstateflags = UIP_CLOSING;
@@ -2223,6 +2854,10 @@ uip_process(uint8_t flag)
       goto tcp_send_ack;
     } else if(uip_flags & UIP_ACKDATA) {
       uip_connr->tcpstateflags = UIP_FIN_WAIT_2;
+#if UIP_TCP_CTIMER
+      /* The periodic timer counts on from the retransmission timer */
+      tcp_timer_wait(uip_connr);
+#endif /* UIP_TCP_CTIMER */
       uip_connr->len = 0;
       goto drop;
     }
@@ -2237,7 +2872,7 @@ uip_process(uint8_t flag)
     }
     if(UIP_TCP_BUF->flags & TCP_FIN) {
       uip_connr->tcpstateflags = UIP_TIME_WAIT;
-      uip_connr->timer = 0;
+      tcp_timer_wait(uip_connr);
       uip_add_rcv_nxt(1);
       uip_flags = UIP_CLOSE;
       UIP_APPCALL();
@@ -2254,7 +2889,7 @@ uip_process(uint8_t flag)
   case UIP_CLOSING:
     if(uip_flags & UIP_ACKDATA) {
       uip_connr->tcpstateflags = UIP_TIME_WAIT;
-      uip_connr->timer = 0;
+      tcp_timer_wait(uip_connr);
     }
   }
   goto drop;
@@ -2287,6 +2922,16 @@ uip_process(uint8_t flag)
   UIP_TCP_BUF->seqno[2] = uip_connr->snd_nxt[2];
   UIP_TCP_BUF->seqno[3] = uip_connr->snd_nxt[3];
 
+#if UIP_TCP_SLIDING_WINDOW
+  if(uip_connr->sliding_window && !(uip_flags & UIP_REXMIT) &&
+     (UIP_TCP_BUF->flags & (TCP_SYN | TCP_FIN | TCP_RST)) == 0) {
+    /* Anything but a retransmission is sequenced after the data
+       already in flight. */
+    uip_add32(uip_connr->snd_nxt, uip_connr->len - new_data_len);
+    memcpy(UIP_TCP_BUF->seqno, uip_acc32, sizeof(uip_acc32));
+  }
+#endif /* UIP_TCP_SLIDING_WINDOW */
+
   UIP_TCP_BUF->srcport  = uip_connr->lport;
   UIP_TCP_BUF->destport = uip_connr->rport;
 
@@ -176,6 +176,21 @@ void uip_log(char *msg);
 #define UIP_CONF_IPV6_QUEUE_PKT       0
 #endif
 
+#ifndef UIP_CONF_IPV6_QUEUE_PKT_POOL_SIZE
+/** Number of packet buffers shared by all %neighbor queues (default: 2) */
+#define UIP_CONF_IPV6_QUEUE_PKT_POOL_SIZE 2
+#endif
+
+#ifndef UIP_CONF_IPV6_QUEUE_PKT_DEPTH
+/** Maximum number of packets queued for a single %neighbor (default: 1) */
+#define UIP_CONF_IPV6_QUEUE_PKT_DEPTH 1
+#endif
+
+#ifndef UIP_CONF_IPV6_QUEUE_PKT_LIFETIME
+/** How long a packet may wait for address resolution (default: 4 s) */
+#define UIP_CONF_IPV6_QUEUE_PKT_LIFETIME (4 * CLOCK_SECOND)
+#endif
+
 #ifndef UIP_CONF_IPV6_CHECKS
 /** Do we do IPv6 consistency checks (highly recommended, default: yes) */
 #define UIP_CONF_IPV6_CHECKS          1
@@ -319,6 +334,34 @@ void uip_log(char *msg);
 #define UIP_LISTENPORTS (UIP_CONF_MAX_LISTENPORTS)
 #endif /* UIP_CONF_MAX_LISTENPORTS */
 
+/**
+ * Toggles whether incoming UDP and TCP segments are demultiplexed
+ * through a hash index keyed on the local port, instead of a linear
+ * scan of the connection and listen tables.
+ *
+ * The index costs one byte per connection, listen port and hash
+ * bucket, and pays off when many connections are configured.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_HASH
+#define UIP_CONN_HASH (UIP_CONF_CONN_HASH)
+#else /* UIP_CONF_CONN_HASH */
+#define UIP_CONN_HASH 0
+#endif /* UIP_CONF_CONN_HASH */
+
+/**
+ * The number of buckets in each connection hash index. Must be a
+ * power of two.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_CONN_HASH_SIZE
+#define UIP_CONN_HASH_SIZE (UIP_CONF_CONN_HASH_SIZE)
+#else /* UIP_CONF_CONN_HASH_SIZE */
+#define UIP_CONN_HASH_SIZE 16
+#endif /* UIP_CONF_CONN_HASH_SIZE */
+
 /**
  * Determines if support for TCP urgent data notification should be
  * compiled in.
@@ -395,6 +438,95 @@ void uip_log(char *msg);
 #define UIP_TIME_WAIT_TIMEOUT UIP_CONF_WAIT_TIMEOUT
 #endif
 
+/**
+ * Toggles support for sliding-window TCP.
+ *
+ * By default, uIP allows only a single unacknowledged segment per TCP
+ * connection. With this option, connections whose application has
+ * opted in with uip_set_sliding_window() can have up to
+ * UIP_TCP_MAX_SEGMENTS segments in flight, with cumulative
+ * acknowledgements, fast retransmit on duplicate acknowledgements and
+ * per-segment RTT estimation. Other connections keep the
+ * stop-and-wait behaviour.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_SLIDING_WINDOW
+#define UIP_TCP_SLIDING_WINDOW (UIP_CONF_TCP_SLIDING_WINDOW)
+#else
+#define UIP_TCP_SLIDING_WINDOW 0
+#endif
+
+/**
+ * The maximum number of unacknowledged segments per TCP connection
+ * in sliding-window mode.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_MAX_SEGMENTS
+#define UIP_TCP_MAX_SEGMENTS (UIP_CONF_TCP_MAX_SEGMENTS)
+#else
+#define UIP_TCP_MAX_SEGMENTS 4
+#endif
+
+/**
+ * The number of duplicate acknowledgements that trigger a fast
+ * retransmit in sliding-window mode.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_DUPACK_THRESHOLD
+#define UIP_TCP_DUPACK_THRESHOLD (UIP_CONF_TCP_DUPACK_THRESHOLD)
+#else
+#define UIP_TCP_DUPACK_THRESHOLD 3
+#endif
+
+/**
+ * Toggles per-connection TCP timers.
+ *
+ * By default, tcpip's periodic timer sweeps all TCP connections twice
+ * per second, which bounds the resolution of the retransmission
+ * timeout and keeps waking the CPU while any connection is open. With
+ * this option, every connection has its own callback timer, which is
+ * armed only while data is in flight or the connection is in
+ * FIN_WAIT_2 or TIME_WAIT, and RTTs are measured in clock ticks.
+ *
+ * Established connections are then no longer polled periodically:
+ * applications that rely on uip_poll() must ask for polls with
+ * tcpip_poll_tcp().
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_CTIMER
+#define UIP_TCP_CTIMER (UIP_CONF_TCP_CTIMER)
+#else
+#define UIP_TCP_CTIMER 0
+#endif
+
+/**
+ * The lower bound of the retransmission timeout with UIP_TCP_CTIMER,
+ * in clock ticks.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_MIN_RTO
+#define UIP_TCP_MIN_RTO (UIP_CONF_TCP_MIN_RTO)
+#else
+#define UIP_TCP_MIN_RTO (CLOCK_SECOND / 5)
+#endif
+
+/**
+ * The upper bound of the retransmission timeout with UIP_TCP_CTIMER,
+ * in clock ticks.
+ *
+ * \hideinitializer
+ */
+#ifdef UIP_CONF_TCP_MAX_RTO
+#define UIP_TCP_MAX_RTO (UIP_CONF_TCP_MAX_RTO)
+#else
+#define UIP_TCP_MAX_RTO (60 * CLOCK_SECOND)
+#endif
+
 /** @} */
 /*------------------------------------------------------------------------------*/
 /**
@@ -40,6 +40,7 @@
  */
 
 #include "net/mac/csma/csma.h"
+#include "net/mac/csma/csma-output.h"
 #include "net/mac/csma/csma-security.h"
 #include "net/packetbuf.h"
 #include "net/queuebuf.h"
@@ -48,10 +49,11 @@
 #include "sys/clock.h"
 #include "lib/random.h"
 #include "net/netstack.h"
-#include "lib/list.h"
 #include "lib/memb.h"
 #include "lib/assert.h"
 
+#include <string.h>
+
 /* Log configuration */
 #include "sys/log.h"
 #define LOG_MODULE "CSMA"
@@ -94,23 +96,57 @@ struct qbuf_metadata {
   uint8_t max_transmissions;
 };
 
+/* The maximum number of co-existing neighbor queues */
+#ifdef CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#define CSMA_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#else
+#define CSMA_MAX_NEIGHBOR_QUEUES 2
+#endif /* CSMA_CONF_MAX_NEIGHBOR_QUEUES */
+
+/* The number of buckets in the neighbor queue hash index. Must be a
+   power of two. */
+#ifdef CSMA_CONF_NEIGHBOR_HASH_SIZE
+#define CSMA_NEIGHBOR_HASH_SIZE CSMA_CONF_NEIGHBOR_HASH_SIZE
+#else
+#define CSMA_NEIGHBOR_HASH_SIZE 8
+#endif /* CSMA_CONF_NEIGHBOR_HASH_SIZE */
+
+#if (CSMA_NEIGHBOR_HASH_SIZE & (CSMA_NEIGHBOR_HASH_SIZE - 1)) != 0
+#error "CSMA_NEIGHBOR_HASH_SIZE must be a power of two"
+#endif
+#if CSMA_MAX_NEIGHBOR_QUEUES > 254
+#error "CSMA supports at most 254 neighbor queues"
+#endif
+
+/* Neighbor queues are found through a hash index keyed on the
+   link-layer address. Buckets and chains hold indices into the neighbor
+   queue pool, NEIGHBOR_NONE terminates a chain. */
+#define NEIGHBOR_NONE 0xff
+typedef uint8_t neighbor_index_t;
+
 /* Every neighbor has its own packet queue */
 struct neighbor_queue {
-  struct neighbor_queue *next;
   linkaddr_t addr;
   struct ctimer transmit_timer;
+  /* FIFO of packets: sent from the head, added at the tail */
+  struct packet_queue *head;
+  struct packet_queue *tail;
+  uint8_t queue_len;
   uint8_t transmissions;
   uint8_t collisions;
-  LIST_STRUCT(packet_queue);
+  neighbor_index_t hash_next;
+#if CSMA_BURST_MAX > 1
+  /* Next queue in the deficit round robin, and the bytes this queue may
+     still send, see CSMA_BURST_BYTES */
+  neighbor_index_t drr_next;
+  uint16_t deficit;
+#endif /* CSMA_BURST_MAX > 1 */
+#if CSMA_WITH_QUEUE_STATS
+  uint8_t max_queue_len;
+  uint16_t drops;
+#endif /* CSMA_WITH_QUEUE_STATS */
 };
 
-/* The maximum number of co-existing neighbor queues */
-#ifdef CSMA_CONF_MAX_NEIGHBOR_QUEUES
-#define CSMA_MAX_NEIGHBOR_QUEUES CSMA_CONF_MAX_NEIGHBOR_QUEUES
-#else
-#define CSMA_MAX_NEIGHBOR_QUEUES 2
-#endif /* CSMA_CONF_MAX_NEIGHBOR_QUEUES */
-
 /* The maximum number of pending packet per neighbor */
 #ifdef CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
 #define CSMA_MAX_PACKET_PER_NEIGHBOR CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
@@ -130,27 +166,181 @@ struct packet_queue {
 MEMB(neighbor_memb, struct neighbor_queue, CSMA_MAX_NEIGHBOR_QUEUES);
 MEMB(packet_memb, struct packet_queue, MAX_QUEUED_PACKETS);
 MEMB(metadata_memb, struct qbuf_metadata, MAX_QUEUED_PACKETS);
-LIST(neighbor_list);
+static neighbor_index_t neighbor_buckets[CSMA_NEIGHBOR_HASH_SIZE];
+
+#if CSMA_BURST_MAX > 1
+/* Deficit round robin. Queues with packets are listed in the order they
+   are served, from drr_head to drr_tail, and drr_timer starts the turn
+   of the head. Queues that just got their first packet come first, up
+   to drr_new_last, so that light flows do not wait behind a whole round
+   of backlogged queues. drr_state tells whether a turn is scheduled or in
+   progress, and drr_current is the queue in its turn, until it runs
+   empty. */
+static neighbor_index_t drr_head;
+static neighbor_index_t drr_tail;
+static neighbor_index_t drr_new_last;
+static struct ctimer drr_timer;
+static struct neighbor_queue *drr_current;
+static enum { DRR_IDLE, DRR_SCHEDULED, DRR_SERVING } drr_state;
+/* The frame in transmission, if it is to be followed by the next one in
+   its queue once acknowledged, and whether it was */
+static struct packet_queue *burst_packet;
+static uint8_t burst_continue;
+#endif /* CSMA_BURST_MAX > 1 */
+
+#if CSMA_WITH_QUEUE_STATS
+static struct csma_queue_stats queue_stats;
+#endif /* CSMA_WITH_QUEUE_STATS */
 
 static void packet_sent(struct neighbor_queue *n,
     struct packet_queue *q,
     int status,
     int num_transmissions);
 static void transmit_from_queue(void *ptr);
+#if CSMA_BURST_MAX > 1
+static void drr_serve(void *ptr);
+#endif /* CSMA_BURST_MAX > 1 */
+/*---------------------------------------------------------------------------*/
+static uint8_t
+neighbor_hash(const linkaddr_t *addr)
+{
+  uint8_t h = 0;
+  int i;
+
+  for(i = 0; i < LINKADDR_SIZE; i++) {
+    h ^= addr->u8[i];
+  }
+  return h & (CSMA_NEIGHBOR_HASH_SIZE - 1);
+}
+/*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+neighbor_from_index(neighbor_index_t i)
+{
+  return &((struct neighbor_queue *)neighbor_memb.mem)[i];
+}
+/*---------------------------------------------------------------------------*/
+static neighbor_index_t
+neighbor_index(const struct neighbor_queue *n)
+{
+  return n - (struct neighbor_queue *)neighbor_memb.mem;
+}
 /*---------------------------------------------------------------------------*/
 static struct neighbor_queue *
 neighbor_queue_from_addr(const linkaddr_t *addr)
 {
-  struct neighbor_queue *n = list_head(neighbor_list);
-  while(n != NULL) {
+  neighbor_index_t i = neighbor_buckets[neighbor_hash(addr)];
+  while(i != NEIGHBOR_NONE) {
+    struct neighbor_queue *n = neighbor_from_index(i);
     if(linkaddr_cmp(&n->addr, addr)) {
       return n;
     }
-    n = list_item_next(n);
+    i = n->hash_next;
   }
   return NULL;
 }
 /*---------------------------------------------------------------------------*/
+static struct neighbor_queue *
+neighbor_queue_add(const linkaddr_t *addr)
+{
+  struct neighbor_queue *n = memb_alloc(&neighbor_memb);
+  if(n != NULL) {
+    neighbor_index_t *bucket = &neighbor_buckets[neighbor_hash(addr)];
+    linkaddr_copy(&n->addr, addr);
+    n->head = NULL;
+    n->tail = NULL;
+    n->queue_len = 0;
+    n->transmissions = 0;
+    n->collisions = 0;
+#if CSMA_BURST_MAX > 1
+    n->deficit = 0;
+#endif /* CSMA_BURST_MAX > 1 */
+#if CSMA_WITH_QUEUE_STATS
+    n->max_queue_len = 0;
+    n->drops = 0;
+    if(++queue_stats.neighbors > queue_stats.max_neighbors) {
+      queue_stats.max_neighbors = queue_stats.neighbors;
+    }
+#endif /* CSMA_WITH_QUEUE_STATS */
+    n->hash_next = *bucket;
+    *bucket = neighbor_index(n);
+  }
+  return n;
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_queue_remove(struct neighbor_queue *n)
+{
+  neighbor_index_t index = neighbor_index(n);
+  neighbor_index_t *p = &neighbor_buckets[neighbor_hash(&n->addr)];
+
+  while(*p != NEIGHBOR_NONE) {
+    if(*p == index) {
+      *p = n->hash_next;
+      break;
+    }
+    p = &neighbor_from_index(*p)->hash_next;
+  }
+#if CSMA_WITH_QUEUE_STATS
+  queue_stats.neighbors--;
+  LOG_INFO("released queue for ");
+  LOG_INFO_LLADDR(&n->addr);
+  LOG_INFO_(", max depth %u, drops %u\n", n->max_queue_len, n->drops);
+#endif /* CSMA_WITH_QUEUE_STATS */
+  memb_free(&neighbor_memb, n);
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_BURST_MAX > 1
+static void
+drr_insert(struct neighbor_queue *n, neighbor_index_t prev)
+{
+  neighbor_index_t index = neighbor_index(n);
+
+  /* Give the queue its quantum for its next turn. Unused deficit
+     carries over, up to twice the quantum. */
+  n->deficit = MIN(n->deficit + CSMA_BURST_BYTES, 2 * CSMA_BURST_BYTES);
+  if(prev == NEIGHBOR_NONE) {
+    n->drr_next = drr_head;
+    drr_head = index;
+  } else {
+    n->drr_next = neighbor_from_index(prev)->drr_next;
+    neighbor_from_index(prev)->drr_next = index;
+  }
+  if(n->drr_next == NEIGHBOR_NONE) {
+    drr_tail = index;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+drr_remove(struct neighbor_queue *n)
+{
+  neighbor_index_t index = neighbor_index(n);
+  neighbor_index_t prev = NEIGHBOR_NONE;
+  neighbor_index_t i = drr_head;
+
+  while(i != NEIGHBOR_NONE && i != index) {
+    prev = i;
+    i = neighbor_from_index(i)->drr_next;
+  }
+  if(i == NEIGHBOR_NONE) {
+    return;
+  }
+  if(prev == NEIGHBOR_NONE) {
+    drr_head = n->drr_next;
+  } else {
+    neighbor_from_index(prev)->drr_next = n->drr_next;
+  }
+  if(drr_tail == index) {
+    drr_tail = prev;
+  }
+  if(drr_new_last == index) {
+    drr_new_last = prev;
+  }
+  if(drr_current == n) {
+    drr_current = NULL;
+  }
+}
+#endif /* CSMA_BURST_MAX > 1 */
+/*---------------------------------------------------------------------------*/
 static clock_time_t
 backoff_period(void)
 {
@@ -253,20 +443,35 @@ send_one_packet(struct neighbor_queue *n, struct packet_queue *q)
   return last_sent_ok;
 }
 /*---------------------------------------------------------------------------*/
+#if CSMA_BURST_MAX > 1
+static int
+burst_continues(struct neighbor_queue *n, struct packet_queue *q,
+                uint8_t burst_len)
+{
+  /* Whether the frame after q still fits in the burst and the deficit
+     of the neighbor, once q is sent */
+  return q->next != NULL && burst_len < CSMA_BURST_MAX
+    && n->deficit >= queuebuf_datalen(q->buf) + queuebuf_datalen(q->next->buf);
+}
+#endif /* CSMA_BURST_MAX > 1 */
+/*---------------------------------------------------------------------------*/
 static void
 transmit_from_queue(void *ptr)
 {
   struct neighbor_queue *n = ptr;
   if(n) {
-    struct packet_queue *q = list_head(n->packet_queue);
+    struct packet_queue *q = n->head;
     if(q != NULL) {
       LOG_INFO("preparing packet for ");
       LOG_INFO_LLADDR(&n->addr);
       LOG_INFO_(", seqno %u, tx %u, queue %d\n",
         queuebuf_attr(q->buf, PACKETBUF_ATTR_MAC_SEQNO),
-        n->transmissions, list_length(n->packet_queue));
+        n->transmissions, n->queue_len);
       /* Send first packet in the neighbor queue */
       queuebuf_to_packetbuf(q->buf);
+#if CSMA_BURST_MAX > 1
+      packetbuf_set_attr(PACKETBUF_ATTR_MAC_PENDING, q == burst_packet);
+#endif /* CSMA_BURST_MAX > 1 */
       send_one_packet(n, q);
     }
   }
@@ -278,6 +483,16 @@ schedule_transmission(struct neighbor_queue *n)
   clock_time_t delay;
   int backoff_exponent; /* BE in IEEE 802.15.4 */
 
+#if CSMA_BURST_MAX > 1
+  /* Queues are served in turn: the next turn goes to the head of the
+     round robin, after its own backoff. A turn in progress schedules
+     the next one when it ends. */
+  if(drr_state != DRR_IDLE || drr_head == NEIGHBOR_NONE) {
+    return;
+  }
+  n = neighbor_from_index(drr_head);
+#endif /* CSMA_BURST_MAX > 1 */
+
   backoff_exponent = MIN(n->collisions + CSMA_MIN_BE, CSMA_MAX_BE);
 
   /* Compute max delay as per IEEE 802.15.4: 2^BE-1 backoff periods  */
@@ -289,32 +504,96 @@ schedule_transmission(struct neighbor_queue *n)
 
   LOG_DBG("scheduling transmission in %u ticks, NB=%u, BE=%u\n",
       (unsigned)delay, n->collisions, backoff_exponent);
+#if CSMA_BURST_MAX > 1
+  drr_state = DRR_SCHEDULED;
+  ctimer_set(&drr_timer, delay, drr_serve, NULL);
+#else /* CSMA_BURST_MAX > 1 */
   ctimer_set(&n->transmit_timer, delay, transmit_from_queue, n);
+#endif /* CSMA_BURST_MAX > 1 */
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_BURST_MAX > 1
+static void
+drr_serve(void *ptr)
+{
+  struct neighbor_queue *n;
+  uint8_t burst_len = 0;
+
+  drr_state = DRR_IDLE;
+  if(drr_head == NEIGHBOR_NONE) {
+    return;
+  }
+  n = neighbor_from_index(drr_head);
+  drr_current = n;
+  drr_state = DRR_SERVING;
+  if(n->deficit >= queuebuf_datalen(n->head->buf)) {
+    do {
+      burst_continue = 0;
+      burst_packet = burst_continues(n, n->head, ++burst_len) ? n->head : NULL;
+      transmit_from_queue(n);
+      /* free_packet() sets burst_continue when the frame was
+         acknowledged, in which case n still has packets queued */
+      burst_packet = NULL;
+    } while(burst_continue);
+  }
+  drr_state = DRR_IDLE;
+
+  if(drr_current != NULL && n->collisions == 0) {
+    /* n still has packets: move it to the tail. After a collision, n
+       keeps its turn, and tries again after its backoff. */
+    drr_remove(n);
+    drr_insert(n, drr_tail);
+  }
+  schedule_transmission(NULL);
 }
+#endif /* CSMA_BURST_MAX > 1 */
 /*---------------------------------------------------------------------------*/
 static void
 free_packet(struct neighbor_queue *n, struct packet_queue *p, int status)
 {
   if(p != NULL) {
-    /* Remove packet from queue and deallocate */
-    list_remove(n->packet_queue, p);
+#if CSMA_BURST_MAX > 1
+    int burst = p == burst_packet && status == MAC_TX_OK;
+    if(status == MAC_TX_OK) {
+      /* Charge the neighbor for the frame */
+      uint16_t len = queuebuf_datalen(p->buf);
+      n->deficit = n->deficit > len ? n->deficit - len : 0;
+    }
+#endif /* CSMA_BURST_MAX > 1 */
+    /* Remove packet from queue and deallocate. Only the head of the
+       queue is ever in transmission. */
+    assert(p == n->head);
+    n->head = p->next;
+    if(n->head == NULL) {
+      n->tail = NULL;
+    }
+    n->queue_len--;
 
     queuebuf_free(p->buf);
     memb_free(&metadata_memb, p->ptr);
     memb_free(&packet_memb, p);
     LOG_DBG("free_queued_packet, queue length %d, free packets %zu\n",
-           list_length(n->packet_queue), memb_numfree(&packet_memb));
-    if(list_head(n->packet_queue) != NULL) {
+           n->queue_len, memb_numfree(&packet_memb));
+    if(n->head != NULL) {
       /* There is a next packet. We reset current tx information */
       n->transmissions = 0;
       n->collisions = 0;
+#if CSMA_BURST_MAX > 1
+      if(burst) {
+        /* Send the next packet right away, from drr_serve() */
+        burst_continue = 1;
+        return;
+      }
+#endif /* CSMA_BURST_MAX > 1 */
       /* Schedule next transmissions */
       schedule_transmission(n);
     } else {
       /* This was the last packet in the queue, we free the neighbor */
+#if CSMA_BURST_MAX > 1
+      drr_remove(n);
+#endif /* CSMA_BURST_MAX > 1 */
       ctimer_stop(&n->transmit_timer);
-      list_remove(neighbor_list, n);
-      memb_free(&neighbor_memb, n);
+      neighbor_queue_remove(n);
     }
   }
 }
@@ -464,22 +743,12 @@ csma_output_packet(mac_callback_t sent, void *ptr)
   n = neighbor_queue_from_addr(addr);
   if(n == NULL) {
     /* Allocate a new neighbor entry */
-    n = memb_alloc(&neighbor_memb);
-    if(n != NULL) {
-      /* Init neighbor entry */
-      linkaddr_copy(&n->addr, addr);
-      n->transmissions = 0;
-      n->collisions = 0;
-      /* Init packet queue for this neighbor */
-      LIST_STRUCT_INIT(n, packet_queue);
-      /* Add neighbor to the neighbor list */
-      list_add(neighbor_list, n);
-    }
+    n = neighbor_queue_add(addr);
   }
 
   if(n != NULL) {
     /* Add packet to the neighbor's queue */
-    if(list_length(n->packet_queue) < CSMA_MAX_PACKET_PER_NEIGHBOR) {
+    if(n->queue_len < CSMA_MAX_PACKET_PER_NEIGHBOR) {
       q = memb_alloc(&packet_memb);
       if(q != NULL) {
         q->ptr = memb_alloc(&metadata_memb);
@@ -495,16 +764,36 @@ csma_output_packet(mac_callback_t sent, void *ptr)
             }
             metadata->sent = sent;
             metadata->cptr = ptr;
-            list_add(n->packet_queue, q);
+            q->next = NULL;
+            if(n->tail != NULL) {
+              n->tail->next = q;
+            } else {
+              n->head = q;
+            }
+            n->tail = q;
+            n->queue_len++;
+#if CSMA_WITH_QUEUE_STATS
+            queue_stats.enqueued++;
+            if(n->queue_len > n->max_queue_len) {
+              n->max_queue_len = n->queue_len;
+            }
+            if(n->queue_len > queue_stats.max_queue_len) {
+              queue_stats.max_queue_len = n->queue_len;
+            }
+#endif /* CSMA_WITH_QUEUE_STATS */
 
             LOG_INFO("sending to ");
             LOG_INFO_LLADDR(addr);
             LOG_INFO_(", len %u, seqno %u, queue length %d, free packets %zu\n",
                     packetbuf_datalen(),
                     packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO),
-                    list_length(n->packet_queue), memb_numfree(&packet_memb));
+                    n->queue_len, memb_numfree(&packet_memb));
             /* If q is the first packet in the neighbor's queue, send asap */
-            if(list_head(n->packet_queue) == q) {
+            if(n->head == q) {
+#if CSMA_BURST_MAX > 1
+              drr_insert(n, drr_new_last);
+              drr_new_last = neighbor_index(n);
+#endif /* CSMA_BURST_MAX > 1 */
               schedule_transmission(n);
             }
             return;
@@ -516,15 +805,25 @@ csma_output_packet(mac_callback_t sent, void *ptr)
         LOG_WARN("could not allocate queuebuf, dropping packet\n");
       }
       /* The packet allocation failed. Remove and free neighbor entry if empty. */
-      if(list_length(n->packet_queue) == 0) {
-        list_remove(neighbor_list, n);
-        memb_free(&neighbor_memb, n);
+#if CSMA_WITH_QUEUE_STATS
+      queue_stats.dropped_no_buffer++;
+      n->drops++;
+#endif /* CSMA_WITH_QUEUE_STATS */
+      if(n->queue_len == 0) {
+        neighbor_queue_remove(n);
       }
     } else {
+#if CSMA_WITH_QUEUE_STATS
+      queue_stats.dropped_queue_full++;
+      n->drops++;
+#endif /* CSMA_WITH_QUEUE_STATS */
       LOG_WARN("Neighbor queue full\n");
     }
     LOG_WARN("could not allocate packet, dropping packet\n");
   } else {
+#if CSMA_WITH_QUEUE_STATS
+    queue_stats.dropped_no_neighbor++;
+#endif /* CSMA_WITH_QUEUE_STATS */
     LOG_WARN("could not allocate neighbor, dropping packet\n");
   }
   mac_call_sent_callback(sent, ptr, MAC_TX_QUEUE_FULL, 1);
@@ -536,4 +835,32 @@ csma_output_init(void)
   memb_init(&packet_memb);
   memb_init(&metadata_memb);
   memb_init(&neighbor_memb);
+  memset(neighbor_buckets, NEIGHBOR_NONE, sizeof(neighbor_buckets));
+#if CSMA_BURST_MAX > 1
+  drr_head = NEIGHBOR_NONE;
+  drr_tail = NEIGHBOR_NONE;
+  drr_new_last = NEIGHBOR_NONE;
+#endif /* CSMA_BURST_MAX > 1 */
+}
+/*---------------------------------------------------------------------------*/
+#if CSMA_WITH_QUEUE_STATS
+const struct csma_queue_stats *
+csma_output_get_queue_stats(void)
+{
+  return &queue_stats;
+}
+/*---------------------------------------------------------------------------*/
+int
+csma_output_get_neighbor_queue_stats(const linkaddr_t *addr,
+                                     struct csma_neighbor_queue_stats *stats)
+{
+  struct neighbor_queue *n = neighbor_queue_from_addr(addr);
+  if(n == NULL) {
+    return 0;
+  }
+  stats->queue_len = n->queue_len;
+  stats->max_queue_len = n->max_queue_len;
+  stats->drops = n->drops;
+  return 1;
 }
+#endif /* CSMA_WITH_QUEUE_STATS */
@@ -44,8 +44,48 @@
 
 #include "contiki.h"
 #include "net/mac/mac.h"
+#include "net/linkaddr.h"
+
+/* Keep per-neighbor queue depth and drop counters, to help tune
+   CSMA_CONF_MAX_PACKET_PER_NEIGHBOR and CSMA_CONF_MAX_NEIGHBOR_QUEUES */
+#ifdef CSMA_CONF_WITH_QUEUE_STATS
+#define CSMA_WITH_QUEUE_STATS CSMA_CONF_WITH_QUEUE_STATS
+#else
+#define CSMA_WITH_QUEUE_STATS 0
+#endif /* CSMA_CONF_WITH_QUEUE_STATS */
+
+/* Queue statistics since boot, over all neighbors */
+struct csma_queue_stats {
+  uint32_t enqueued;
+  /* Packets dropped because the neighbor queue was full */
+  uint16_t dropped_queue_full;
+  /* Packets dropped because all neighbor queues were in use */
+  uint16_t dropped_no_neighbor;
+  /* Packets dropped because no packet or queuebuf was left */
+  uint16_t dropped_no_buffer;
+  /* The deepest any neighbor queue has been */
+  uint8_t max_queue_len;
+  /* The number of neighbor queues in use, and the most in use at once */
+  uint8_t neighbors;
+  uint8_t max_neighbors;
+};
+
+/* Statistics of a neighbor queue. A queue, and its statistics, only
+   exist while packets are queued for the neighbor. */
+struct csma_neighbor_queue_stats {
+  uint8_t queue_len;
+  uint8_t max_queue_len;
+  uint16_t drops;
+};
 
 void csma_output_packet(mac_callback_t sent, void *ptr);
 void csma_output_init(void);
 
+#if CSMA_WITH_QUEUE_STATS
+const struct csma_queue_stats *csma_output_get_queue_stats(void);
+/* Returns 0 if no packets are queued for the neighbor */
+int csma_output_get_neighbor_queue_stats(const linkaddr_t *addr,
+                                         struct csma_neighbor_queue_stats *stats);
+#endif /* CSMA_WITH_QUEUE_STATS */
+
 #endif /* CSMA_OUTPUT_H_ */
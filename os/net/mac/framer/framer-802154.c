@@ -55,6 +55,174 @@ static uint8_t mac_dsn;
 
 static uint8_t initialized = 0;
 
+#if FRAMER_802154_HEADER_CACHE_SIZE
+/* The longest header: FCF, sequence number, two PAN IDs, two long
+   addresses and the longest auxiliary security header */
+#define HEADER_MAX_LEN (2 + 1 + 2 + 8 + 2 + 8 + 1 + 5 + 9)
+
+/* All that goes into the header of an outgoing frame, apart from the
+   sequence number and the frame counter */
+struct template_key {
+  linkaddr_t dest;
+  linkaddr_t src;
+  uint16_t pan_id;
+  uint8_t broadcast;
+  packetbuf_attr_t frame_type;
+  packetbuf_attr_t ack;
+  packetbuf_attr_t pending;
+  packetbuf_attr_t metadata;
+  packetbuf_attr_t no_src_addr;
+  packetbuf_attr_t no_dest_addr;
+#if LLSEC802154_USES_AUX_HEADER
+  packetbuf_attr_t security_level;
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  packetbuf_attr_t key_id_mode;
+  packetbuf_attr_t key_index;
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+};
+
+/* A header, ready to be copied to outgoing frames */
+struct header_template {
+  struct template_key key;
+  uint8_t hdr[HEADER_MAX_LEN];
+  uint8_t len;
+  uint8_t has_seqno;
+  /* Offset of the frame counter in the header, 0 if none */
+  uint8_t counter_offset;
+};
+
+static struct header_template templates[FRAMER_802154_HEADER_CACHE_SIZE];
+static uint8_t templates_used;
+static uint8_t next_template;
+#endif /* FRAMER_802154_HEADER_CACHE_SIZE */
+
+/*---------------------------------------------------------------------------*/
+static void
+setup_frame(frame802154_t *params)
+{
+  /* init to zeros */
+  memset(params, 0, sizeof(*params));
+
+  framer_802154_setup_params(packetbuf_attr, packetbuf_holds_broadcast(),
+                             params);
+
+  if(packetbuf_holds_broadcast()) {
+    params->dest_addr[0] = 0xFF;
+    params->dest_addr[1] = 0xFF;
+  } else {
+    linkaddr_copy((linkaddr_t *)&params->dest_addr,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  }
+
+  linkaddr_copy((linkaddr_t *)&params->src_addr,
+                packetbuf_addr(PACKETBUF_ADDR_SENDER));
+
+  params->payload = packetbuf_dataptr();
+  params->payload_len = packetbuf_datalen();
+}
+/*---------------------------------------------------------------------------*/
+#if FRAMER_802154_HEADER_CACHE_SIZE
+static struct header_template *
+get_template(void)
+{
+  struct template_key key;
+  struct header_template *t;
+  frame802154_t params;
+  int hdr_len;
+  int i;
+
+  /* Zero the padding too, keys are compared with memcmp */
+  memset(&key, 0, sizeof(key));
+  linkaddr_copy(&key.dest, packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  linkaddr_copy(&key.src, packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  key.pan_id = frame802154_get_pan_id();
+  key.broadcast = packetbuf_holds_broadcast();
+  key.frame_type = packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE);
+  key.ack = packetbuf_attr(PACKETBUF_ATTR_MAC_ACK);
+  key.pending = packetbuf_attr(PACKETBUF_ATTR_MAC_PENDING);
+  key.metadata = packetbuf_attr(PACKETBUF_ATTR_MAC_METADATA);
+  key.no_src_addr = packetbuf_attr(PACKETBUF_ATTR_MAC_NO_SRC_ADDR);
+  key.no_dest_addr = packetbuf_attr(PACKETBUF_ATTR_MAC_NO_DEST_ADDR);
+#if LLSEC802154_USES_AUX_HEADER
+  key.security_level = packetbuf_attr(PACKETBUF_ATTR_SECURITY_LEVEL);
+#if LLSEC802154_USES_EXPLICIT_KEYS
+  key.key_id_mode = packetbuf_attr(PACKETBUF_ATTR_KEY_ID_MODE);
+  key.key_index = packetbuf_attr(PACKETBUF_ATTR_KEY_INDEX);
+#endif /* LLSEC802154_USES_EXPLICIT_KEYS */
+#endif /* LLSEC802154_USES_AUX_HEADER */
+
+  for(i = 0; i < templates_used; i++) {
+    if(memcmp(&templates[i].key, &key, sizeof(key)) == 0) {
+      return &templates[i];
+    }
+  }
+
+  /* Not cached: build the header, replacing the oldest template */
+  setup_frame(&params);
+  hdr_len = frame802154_hdrlen(&params);
+  if(hdr_len > HEADER_MAX_LEN) {
+    return NULL;
+  }
+  t = &templates[next_template];
+  next_template = (next_template + 1) % FRAMER_802154_HEADER_CACHE_SIZE;
+  if(templates_used < FRAMER_802154_HEADER_CACHE_SIZE) {
+    templates_used++;
+  }
+  memcpy(&t->key, &key, sizeof(key));
+  t->len = frame802154_create(&params, t->hdr);
+  t->has_seqno = !params.fcf.sequence_number_suppression;
+  t->counter_offset = 0;
+#if LLSEC802154_USES_FRAME_COUNTER
+  if(params.fcf.security_enabled
+     && !params.aux_hdr.security_control.frame_counter_suppression) {
+    /* The counter follows the security control field, which starts the
+       auxiliary security header */
+    params.fcf.security_enabled = 0;
+    t->counter_offset = frame802154_hdrlen(&params) + 1;
+  }
+#endif /* LLSEC802154_USES_FRAME_COUNTER */
+  return t;
+}
+/*---------------------------------------------------------------------------*/
+static int
+create_from_template(int do_create)
+{
+  struct header_template *t;
+  uint8_t *hdr;
+
+  t = get_template();
+  if(t == NULL) {
+    return 0;
+  }
+  if(!do_create) {
+    return t->len;
+  }
+  if(!packetbuf_hdralloc(t->len)) {
+    LOG_ERR("Out: too large header: %u\n", t->len);
+    return FRAMER_FAILED;
+  }
+  hdr = packetbuf_hdrptr();
+  memcpy(hdr, t->hdr, t->len);
+  if(t->has_seqno) {
+    hdr[2] = packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO);
+  }
+#if LLSEC802154_USES_FRAME_COUNTER
+  if(t->counter_offset) {
+    frame802154_frame_counter_t counter;
+    counter.u16[0] = packetbuf_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_0_1);
+    counter.u16[1] = packetbuf_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_2_3);
+    memcpy(hdr + t->counter_offset, counter.u8, 4);
+  }
+#endif /* LLSEC802154_USES_FRAME_COUNTER */
+
+  LOG_INFO("Out: %2X ", t->key.frame_type);
+  LOG_INFO_LLADDR(&t->key.dest);
+  LOG_INFO_(" %d %u (%u)\n", t->len, packetbuf_datalen(), packetbuf_totlen());
+
+  return t->len;
+}
+#endif /* FRAMER_802154_HEADER_CACHE_SIZE */
 /*---------------------------------------------------------------------------*/
 static int
 create_frame(int do_create)
@@ -66,9 +234,6 @@ create_frame(int do_create)
     return -1;
   }
 
-  /* init to zeros */
-  memset(&params, 0, sizeof(params));
-
   if(!initialized) {
     initialized = 1;
     mac_dsn = random_rand() & 0xff;
@@ -89,22 +254,14 @@ create_frame(int do_create)
     mac_dsn++;
   }
 
-  framer_802154_setup_params(packetbuf_attr, packetbuf_holds_broadcast(),
-                             &params);
-
-  if(packetbuf_holds_broadcast()) {
-    params.dest_addr[0] = 0xFF;
-    params.dest_addr[1] = 0xFF;
-  } else {
-    linkaddr_copy((linkaddr_t *)&params.dest_addr,
-                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+#if FRAMER_802154_HEADER_CACHE_SIZE
+  hdr_len = create_from_template(do_create);
+  if(hdr_len != 0) {
+    return hdr_len;
   }
+#endif /* FRAMER_802154_HEADER_CACHE_SIZE */
 
-  linkaddr_copy((linkaddr_t *)&params.src_addr,
-                packetbuf_addr(PACKETBUF_ADDR_SENDER));
-
-  params.payload = packetbuf_dataptr();
-  params.payload_len = packetbuf_datalen();
+  setup_frame(&params);
   hdr_len = frame802154_hdrlen(&params);
   if(!do_create) {
     /* Only calculate header length */
@@ -139,7 +296,7 @@ framer_802154_setup_params(packetbuf_attr_t (*get_attr)(uint8_t type),
 
   /* Build the FCF. */
   params->fcf.frame_type = get_attr(PACKETBUF_ATTR_FRAME_TYPE);
-  params->fcf.frame_pending = 0;
+  params->fcf.frame_pending = get_attr(PACKETBUF_ATTR_MAC_PENDING);
   if(dest_is_broadcast) {
     params->fcf.ack_required = 0;
     /* Suppress seqno on broadcast if supported (frame v2 or more) */
@@ -42,6 +42,16 @@
 #include "net/packetbuf.h"
 #include "net/mac/framer/framer.h"
 
+/* The number of outgoing headers cached as templates, keyed on
+   destination, source, PAN ID, frame type and security parameters. A
+   cached header is copied to the frame and only its sequence number and
+   frame counter are filled in. 0 disables the cache. */
+#ifdef FRAMER_802154_CONF_HEADER_CACHE_SIZE
+#define FRAMER_802154_HEADER_CACHE_SIZE FRAMER_802154_CONF_HEADER_CACHE_SIZE
+#else /* FRAMER_802154_CONF_HEADER_CACHE_SIZE */
+#define FRAMER_802154_HEADER_CACHE_SIZE 0
+#endif /* FRAMER_802154_CONF_HEADER_CACHE_SIZE */
+
 /* Setup frame802154_t with use of a specified get_attr */
 void framer_802154_setup_params(packetbuf_attr_t (*get_attr)(uint8_t type),
                                 uint8_t dest_is_broadcast,
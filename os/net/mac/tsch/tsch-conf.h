@@ -225,6 +225,61 @@
 #define TSCH_CHANNEL_SCAN_DURATION CLOCK_SECOND
 #endif
 
+/* Fast (re)join. After leaving the network, the node keeps following the
+ * channel the network uses for EBs, slot by slot, as long as its timing is
+ * trusted. When the timing is unknown (e.g. after a reboot), it scans the
+ * channels of the network it was part of, one EB period on each. */
+#ifdef TSCH_CONF_WITH_FAST_JOIN
+#define TSCH_WITH_FAST_JOIN TSCH_CONF_WITH_FAST_JOIN
+#else
+#define TSCH_WITH_FAST_JOIN 0
+#endif
+
+/* For how long after the last synchronization the network timing is trusted,
+ * to follow the network. The clock drift accumulated in the meantime must stay
+ * below half of (timeslot length - max tx), about 2.9 ms with the default
+ * timing. Nodes leaving after TSCH_DESYNC_THRESHOLD scan instead. */
+#ifdef TSCH_CONF_FAST_JOIN_MAX_AGE
+#define TSCH_FAST_JOIN_MAX_AGE TSCH_CONF_FAST_JOIN_MAX_AGE
+#else
+#define TSCH_FAST_JOIN_MAX_AGE (60 * CLOCK_SECOND)
+#endif
+
+/* Keep the PAN ID, hopping sequence and EB period of the network across
+ * reboots, in a CFS file. Only useful with a join hopping sequence that
+ * differs from the default one, e.g. that matches the network's. With the
+ * default sequence, EB channels are pseudo-random, and rejoining after a
+ * reboot is no faster (median 15.9 s against 8.0 s without, with
+ * Orchestra on the native medium). */
+#ifdef TSCH_CONF_FAST_JOIN_WITH_CFS
+#define TSCH_FAST_JOIN_WITH_CFS TSCH_CONF_FAST_JOIN_WITH_CFS
+#else
+#define TSCH_FAST_JOIN_WITH_CFS 0
+#endif
+
+/* The CFS file used with TSCH_FAST_JOIN_WITH_CFS */
+#ifdef TSCH_CONF_FAST_JOIN_CFS_FILENAME
+#define TSCH_FAST_JOIN_CFS_FILENAME TSCH_CONF_FAST_JOIN_CFS_FILENAME
+#else
+#define TSCH_FAST_JOIN_CFS_FILENAME "tsch-join"
+#endif
+
+/* EB solicitation. A node following the network after leaving it sends Beacon
+ * Request commands in the network's first shared cell; nodes that receive
+ * one send an EB right away instead of at the end of their EB period. */
+#ifdef TSCH_CONF_WITH_EB_SOLICITATION
+#define TSCH_WITH_EB_SOLICITATION TSCH_CONF_WITH_EB_SOLICITATION
+#else
+#define TSCH_WITH_EB_SOLICITATION 0
+#endif
+
+/* Minimum interval between two Beacon Requests, and between two solicited EBs */
+#ifdef TSCH_CONF_EB_SOLICITATION_INTERVAL
+#define TSCH_EB_SOLICITATION_INTERVAL TSCH_CONF_EB_SOLICITATION_INTERVAL
+#else
+#define TSCH_EB_SOLICITATION_INTERVAL CLOCK_SECOND
+#endif
+
 /* TSCH EB: include timeslot timing Information Element? */
 #ifdef TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TIMING
 #define TSCH_PACKET_EB_WITH_TIMESLOT_TIMING TSCH_PACKET_CONF_EB_WITH_TIMESLOT_TIMING
@@ -314,6 +369,15 @@
 #define TSCH_QUEUE_MAX_NEIGHBOR_QUEUES ((NBR_TABLE_CONF_MAX_NEIGHBORS) + 2)
 #endif
 
+/* Keep bitmaps, indexed like the neighbor table, of the neighbors that have
+ * packets queued and of those in backoff. Shared slots then only look at
+ * backlogged neighbors rather than walking the whole neighbor table. */
+#ifdef TSCH_QUEUE_CONF_WITH_READY_SET
+#define TSCH_QUEUE_WITH_READY_SET TSCH_QUEUE_CONF_WITH_READY_SET
+#else
+#define TSCH_QUEUE_WITH_READY_SET 0
+#endif
+
 /******** Configuration: scheduling  *******/
 
 /* Initializes TSCH with a 6TiSCH minimal schedule */
@@ -353,6 +417,15 @@
 #define TSCH_SCHEDULE_MAX_LINKS 32
 #endif
 
+/* Keep a per-slotframe index of links sorted by timeslot, so that
+ * tsch_schedule_get_next_active_link() runs a binary search per slotframe
+ * instead of walking all links. Costs one pointer per link. */
+#ifdef TSCH_SCHEDULE_CONF_WITH_INDEX
+#define TSCH_SCHEDULE_WITH_INDEX TSCH_SCHEDULE_CONF_WITH_INDEX
+#else
+#define TSCH_SCHEDULE_WITH_INDEX 0
+#endif
+
 /* To include Sixtop Implementation */
 #ifdef TSCH_CONF_WITH_SIXTOP
 #define TSCH_WITH_SIXTOP TSCH_CONF_WITH_SIXTOP
@@ -368,6 +441,17 @@
 #define TSCH_WITH_LINK_SELECTOR (BUILD_WITH_ORCHESTRA)
 #endif /* TSCH_CONF_WITH_LINK_SELECTOR */
 
+/* Let packets that were assigned to a slotframe also go out in shared links
+ * to the broadcast address when we have Tx links to their destination
+ * (requires TSCH_WITH_LINK_SELECTOR). Needed by schedulers whose dedicated
+ * Tx cells would otherwise keep the packets of other slotframes queued, such
+ * as the adaptive Orchestra rule. */
+#ifdef TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS
+#define TSCH_SELECTED_PACKETS_USE_SHARED_LINKS TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS
+#else /* TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS */
+#define TSCH_SELECTED_PACKETS_USE_SHARED_LINKS 0
+#endif /* TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS */
+
 /* Configurable link comparator in case multiple links are scheduled at the same slot */
 #ifdef TSCH_CONF_LINK_COMPARATOR
 #define TSCH_LINK_COMPARATOR TSCH_CONF_LINK_COMPARATOR
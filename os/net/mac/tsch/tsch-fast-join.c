@@ -0,0 +1,420 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \addtogroup tsch
+ * @{
+ * \file
+ *         Fast TSCH (re)join. While associated, learns the PAN ID, hopping
+ *         sequence, EB channel offset and EB period of the network, from the
+ *         EBs of the time source. After leaving the network, as long as the
+ *         network timing is trusted, the radio follows the network's EB
+ *         channel slot by slot, and optionally solicits EBs in the
+ *         network's shared cell. Otherwise, the channels of the network are
+ *         scanned one EB period each.
+ */
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "net/mac/tsch/tsch-fast-join.h"
+#include "net/netstack.h"
+#include "lib/random.h"
+#if TSCH_FAST_JOIN_WITH_CFS
+#include "cfs/cfs.h"
+#endif /* TSCH_FAST_JOIN_WITH_CFS */
+#include <string.h>
+
+/* Log configuration */
+#include "sys/log.h"
+#define LOG_MODULE "TSCH Join"
+#define LOG_LEVEL LOG_LEVEL_MAC
+
+#if TSCH_WITH_FAST_JOIN
+
+/* Channel switches are never scheduled closer than this */
+#define SWITCH_GUARD US_TO_RTIMERTICKS(100)
+
+/* Version of struct join_hints, as stored in CFS */
+#define JOIN_HINTS_VERSION 1
+
+/* What we know of the network we were last part of */
+struct join_hints {
+  uint8_t version;
+  uint8_t hopping_sequence_len; /* 0 if nothing is known */
+  uint8_t hopping_sequence[TSCH_HOPPING_SEQUENCE_MAX_LEN];
+  uint8_t eb_channel_offset;
+  uint16_t pan_id;
+  uint32_t eb_period; /* In clock ticks, 0 if unknown */
+};
+static struct join_hints hints;
+
+/* The network timing, recorded when leaving the network */
+static struct {
+  uint8_t is_valid;
+  /* Start and ASN of the next slot to follow */
+  rtimer_clock_t slot_start;
+  struct tsch_asn_t asn;
+  struct tsch_asn_divisor_t hopping_sequence_length;
+  rtimer_clock_t slot_length;
+  rtimer_clock_t tx_offset;
+  /* Channel switches happen this long before tx_offset: halfway between
+   * the end of the longest frame and the start of the next slot's frame */
+  rtimer_clock_t switch_margin;
+  /* Last synchronization with the time source */
+  clock_time_t last_sync;
+#if TSCH_WITH_EB_SOLICITATION
+  /* The first shared cell of the schedule, to send Beacon Requests in */
+  uint8_t has_shared_cell;
+  struct tsch_asn_divisor_t shared_cell_period;
+  uint16_t shared_cell_timeslot;
+  uint16_t shared_cell_channel_offset;
+#endif /* TSCH_WITH_EB_SOLICITATION */
+} timing;
+
+/* Time of the last EB received from the time source, 0 if none yet
+ * since association */
+static clock_time_t last_eb_time;
+/* Scanning state when the network timing is unknown */
+static uint8_t sweep_index;
+static uint8_t sweep_remaining;
+
+static struct rtimer follow_timer;
+/* Is follow_timer pending? */
+static volatile uint8_t is_following;
+static volatile uint8_t is_stop_requested;
+
+#if TSCH_WITH_EB_SOLICITATION
+static uint8_t beacon_request[TSCH_PACKET_MAX_LEN];
+static int beacon_request_len;
+static clock_time_t last_solicitation;
+#endif /* TSCH_WITH_EB_SOLICITATION */
+
+/*---------------------------------------------------------------------------*/
+#if TSCH_FAST_JOIN_WITH_CFS
+static void
+hints_load(void)
+{
+  int fd = cfs_open(TSCH_FAST_JOIN_CFS_FILENAME, CFS_READ);
+  if(fd >= 0) {
+    if(cfs_read(fd, &hints, sizeof(hints)) != sizeof(hints)
+       || hints.version != JOIN_HINTS_VERSION
+       || hints.hopping_sequence_len > TSCH_HOPPING_SEQUENCE_MAX_LEN) {
+      memset(&hints, 0, sizeof(hints));
+    }
+    cfs_close(fd);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+hints_save(void)
+{
+  int fd;
+  cfs_remove(TSCH_FAST_JOIN_CFS_FILENAME);
+  fd = cfs_open(TSCH_FAST_JOIN_CFS_FILENAME, CFS_WRITE);
+  if(fd < 0 || cfs_write(fd, &hints, sizeof(hints)) != sizeof(hints)) {
+    LOG_ERR("! failed to save join hints\n");
+  }
+  if(fd >= 0) {
+    cfs_close(fd);
+  }
+}
+#endif /* TSCH_FAST_JOIN_WITH_CFS */
+/*---------------------------------------------------------------------------*/
+static uint8_t
+hints_channel(const struct tsch_asn_t *asn,
+              const struct tsch_asn_divisor_t *len, uint16_t channel_offset)
+{
+  return hints.hopping_sequence[(TSCH_ASN_MOD(*asn, *len) + channel_offset) % len->val];
+}
+/*---------------------------------------------------------------------------*/
+/* Move the timing to the first slot whose channel switch is far enough in
+ * the future to be scheduled */
+static void
+timing_catch_up(void)
+{
+  rtimer_clock_t now = RTIMER_NOW();
+  while(RTIMER_CLOCK_LT(timing.slot_start + timing.tx_offset - timing.switch_margin,
+                        now + SWITCH_GUARD)) {
+    timing.slot_start += timing.slot_length;
+    TSCH_ASN_INC(timing.asn, 1);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Called at the channel switch before each slot, from rtimer interrupt */
+static void
+follow(struct rtimer *t, void *ptr)
+{
+  uint8_t channel;
+
+  if(is_stop_requested
+     || clock_time() - timing.last_sync > TSCH_FAST_JOIN_MAX_AGE) {
+    timing.is_valid = 0;
+    is_following = 0;
+    return;
+  }
+
+  channel = hints_channel(&timing.asn, &timing.hopping_sequence_length,
+                          hints.eb_channel_offset);
+
+  /* The scan process holds the lock while it uses the radio. Leave the
+   * radio alone for this slot rather than interleave with it. */
+  if(!tsch_is_locked()) {
+#if TSCH_WITH_EB_SOLICITATION
+    if(timing.has_shared_cell && beacon_request_len > 0
+       && TSCH_ASN_MOD(timing.asn, timing.shared_cell_period) == timing.shared_cell_timeslot
+       && clock_time() - last_solicitation >= TSCH_EB_SOLICITATION_INTERVAL) {
+      /* Send a Beacon Request in the shared cell, at tx_offset */
+      NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL,
+          hints_channel(&timing.asn, &timing.hopping_sequence_length,
+                        timing.shared_cell_channel_offset));
+      NETSTACK_RADIO.prepare(beacon_request, beacon_request_len);
+      RTIMER_BUSYWAIT_UNTIL_ABS(0, timing.slot_start,
+                                timing.tx_offset - RADIO_DELAY_BEFORE_TX);
+      NETSTACK_RADIO.transmit(beacon_request_len);
+      NETSTACK_RADIO.on();
+      last_solicitation = clock_time();
+    }
+#endif /* TSCH_WITH_EB_SOLICITATION */
+
+    NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, channel);
+  }
+
+  /* Schedule the channel switch of the next slot */
+  timing.slot_start += timing.slot_length;
+  TSCH_ASN_INC(timing.asn, 1);
+  timing_catch_up();
+  rtimer_set(&follow_timer,
+             timing.slot_start + timing.tx_offset - timing.switch_margin,
+             1, follow, NULL);
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_fast_join_init(void)
+{
+#if TSCH_FAST_JOIN_WITH_CFS
+  hints_load();
+#endif /* TSCH_FAST_JOIN_WITH_CFS */
+  if(hints.hopping_sequence_len > 0) {
+    sweep_index = random_rand() % hints.hopping_sequence_len;
+    sweep_remaining = hints.hopping_sequence_len;
+    LOG_INFO("PAN ID %x, %u channels, EB period %lu\n",
+             hints.pan_id, hints.hopping_sequence_len,
+             (unsigned long)hints.eb_period);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_fast_join_eb_input(const struct tsch_asn_t *asn, uint8_t channel)
+{
+  clock_time_t now = clock_time();
+  uint16_t pan_id = frame802154_get_pan_id();
+  uint8_t k;
+  int is_changed = 0;
+
+  if(tsch_hopping_sequence_length.val > TSCH_HOPPING_SEQUENCE_MAX_LEN) {
+    return;
+  }
+
+  /* Same network as before? */
+  if(hints.pan_id != pan_id
+     || hints.hopping_sequence_len != tsch_hopping_sequence_length.val
+     || memcmp(hints.hopping_sequence, tsch_hopping_sequence,
+               tsch_hopping_sequence_length.val)) {
+    memset(&hints, 0, sizeof(hints));
+    hints.version = JOIN_HINTS_VERSION;
+    hints.pan_id = pan_id;
+    hints.hopping_sequence_len = tsch_hopping_sequence_length.val;
+    memcpy(hints.hopping_sequence, tsch_hopping_sequence,
+           tsch_hopping_sequence_length.val);
+    last_eb_time = 0;
+    is_changed = 1;
+  }
+
+  /* The channel offset the time source sends EBs with */
+  for(k = 0; k < hints.hopping_sequence_len; k++) {
+    if(hints_channel(asn, &tsch_hopping_sequence_length, k) == channel) {
+      hints.eb_channel_offset = k;
+      break;
+    }
+  }
+
+  /* The EB period, averaged over the intervals between EBs. Missed EBs
+   * make for longer intervals, which are capped to twice the period. */
+  if(last_eb_time != 0) {
+    uint32_t interval = now - last_eb_time;
+    uint32_t previous = hints.eb_period;
+    if(hints.eb_period == 0) {
+      hints.eb_period = interval;
+    } else {
+      interval = MIN(interval, 2 * hints.eb_period);
+      hints.eb_period = (3 * hints.eb_period + interval) / 4;
+    }
+    /* Only save significant changes */
+    if(previous == 0 || hints.eb_period > previous + previous / 4
+       || hints.eb_period < previous - previous / 4) {
+      is_changed = 1;
+    }
+  }
+  last_eb_time = now;
+
+#if TSCH_FAST_JOIN_WITH_CFS
+  if(is_changed) {
+    hints_save();
+  }
+#endif /* TSCH_FAST_JOIN_WITH_CFS */
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_fast_join_leaving(void)
+{
+  last_eb_time = 0;
+
+  if(hints.hopping_sequence_len == 0) {
+    return;
+  }
+
+  sweep_index = random_rand() % hints.hopping_sequence_len;
+  sweep_remaining = hints.hopping_sequence_len;
+
+  tsch_slot_operation_get_next_slot(&timing.slot_start, &timing.asn);
+  TSCH_ASN_DIVISOR_INIT(timing.hopping_sequence_length, hints.hopping_sequence_len);
+  timing.slot_length = tsch_timing[tsch_ts_timeslot_length];
+  timing.tx_offset = tsch_timing[tsch_ts_tx_offset];
+  timing.switch_margin = (tsch_timing[tsch_ts_timeslot_length]
+                          - tsch_timing[tsch_ts_max_tx]) / 2;
+  timing.last_sync = tsch_last_sync_time;
+
+#if TSCH_WITH_EB_SOLICITATION
+  {
+    struct tsch_slotframe *sf;
+    struct tsch_link *l = NULL;
+
+    for(sf = tsch_schedule_slotframe_head(); sf != NULL && l == NULL;
+        sf = tsch_schedule_slotframe_next(sf)) {
+      for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+        uint8_t options = LINK_OPTION_TX | LINK_OPTION_RX | LINK_OPTION_SHARED;
+        if((l->link_options & options) == options
+           && linkaddr_cmp(&l->addr, &tsch_broadcast_address)) {
+          timing.shared_cell_period = sf->size;
+          timing.shared_cell_timeslot = l->timeslot;
+          timing.shared_cell_channel_offset = l->channel_offset;
+          break;
+        }
+      }
+    }
+    timing.has_shared_cell = l != NULL;
+    beacon_request_len = tsch_packet_create_beacon_request(beacon_request,
+                                                           sizeof(beacon_request));
+  }
+#endif /* TSCH_WITH_EB_SOLICITATION */
+
+  timing.is_valid = 1;
+  is_stop_requested = 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_fast_join_follow(void)
+{
+  if(is_following) {
+    return 1;
+  }
+  if(!timing.is_valid) {
+    return 0;
+  }
+  if(clock_time() - timing.last_sync > TSCH_FAST_JOIN_MAX_AGE) {
+    timing.is_valid = 0;
+    return 0;
+  }
+  if(tsch_slot_operation_is_scheduled()) {
+    /* The last slot operation wakeup is still pending: wait for it,
+     * there is only one rtimer */
+    return 0;
+  }
+
+  LOG_INFO("following EB channels, last sync %lu ticks ago\n",
+           (unsigned long)(clock_time() - timing.last_sync));
+  timing_catch_up();
+  is_following = 1;
+  rtimer_set(&follow_timer,
+             timing.slot_start + timing.tx_offset - timing.switch_margin,
+             1, follow, NULL);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+uint8_t
+tsch_fast_join_scan_channel(clock_time_t *dwell)
+{
+  /* Sweep the channels of the network that are in the join sequence,
+   * each once. Then fall back to scanning the whole join sequence. */
+  while(sweep_remaining > 0) {
+    uint8_t channel;
+    int i;
+    int is_new = 1;
+    int is_in_join_sequence = 0;
+
+    sweep_index = (sweep_index + 1) % hints.hopping_sequence_len;
+    sweep_remaining--;
+    channel = hints.hopping_sequence[sweep_index];
+
+    for(i = 0; i < sweep_index; i++) {
+      if(hints.hopping_sequence[i] == channel) {
+        is_new = 0;
+      }
+    }
+    for(i = 0; i < sizeof(TSCH_JOIN_HOPPING_SEQUENCE); i++) {
+      if(TSCH_JOIN_HOPPING_SEQUENCE[i] == channel) {
+        is_in_join_sequence = 1;
+      }
+    }
+
+    if(is_new && is_in_join_sequence) {
+      /* Stay one EB period, for every neighbor to send an EB, whatever
+       * channel its EB cell maps to */
+      *dwell = MAX(TSCH_CHANNEL_SCAN_DURATION, hints.eb_period);
+      return channel;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_fast_join_scan_stop(void)
+{
+  if(is_following) {
+    /* Let the pending channel switch run, before the rtimer is used for
+     * slot operation */
+    is_stop_requested = 1;
+    RTIMER_BUSYWAIT_UNTIL(!is_following, 2 * timing.slot_length);
+  }
+  timing.is_valid = 0;
+}
+/*---------------------------------------------------------------------------*/
+#endif /* TSCH_WITH_FAST_JOIN */
+/** @} */
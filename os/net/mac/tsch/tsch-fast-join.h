@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \addtogroup tsch
+ * @{
+ * \file
+ *         Fast TSCH (re)join: learns the network's EB channels and period
+ *         while associated, and uses them to scan after leaving the network.
+ */
+
+#ifndef TSCH_FAST_JOIN_H_
+#define TSCH_FAST_JOIN_H_
+
+/********** Includes **********/
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch-types.h"
+
+/********** Functions *********/
+
+/**
+ * Initialize fast join, loading what was learned in previous sessions
+ */
+void tsch_fast_join_init(void);
+/**
+ * Learn from an EB of our time source
+ *
+ * \param asn The ASN of the timeslot the EB was received in
+ * \param channel The channel the EB was received on, 0 if unknown
+ */
+void tsch_fast_join_eb_input(const struct tsch_asn_t *asn, uint8_t channel);
+/**
+ * Record the network timing and schedule when leaving the network
+ */
+void tsch_fast_join_leaving(void);
+/**
+ * Keep the radio on the channel the network sends EBs on, as long as the
+ * network timing recorded when leaving is trusted. Called from the scanning
+ * loop.
+ *
+ * \return 1 if the radio follows the network, 0 if the channel is to be
+ * picked with tsch_fast_join_scan_channel
+ */
+int tsch_fast_join_follow(void);
+/**
+ * Pick the next channel to scan from the hopping sequence of the network
+ * we were part of
+ *
+ * \param dwell Set to how long to stay on the channel
+ * \return The channel, 0 if the network's hopping sequence is unknown
+ */
+uint8_t tsch_fast_join_scan_channel(clock_time_t *dwell);
+/**
+ * Stop following the network, before starting slot operation
+ */
+void tsch_fast_join_scan_stop(void);
+
+#endif /* TSCH_FAST_JOIN_H_ */
+/** @} */
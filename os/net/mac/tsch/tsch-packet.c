@@ -372,6 +372,27 @@ tsch_packet_create_eb(uint8_t *hdr_len, uint8_t *tsch_sync_ie_offset)
   return packetbuf_totlen();
 }
 /*---------------------------------------------------------------------------*/
+/* Create a Beacon Request, used to solicit EBs */
+int
+tsch_packet_create_beacon_request(uint8_t *buf, int buf_size)
+{
+  packetbuf_clear();
+
+  *(uint8_t *)packetbuf_dataptr() = FRAME802154_BEACONREQ;
+  packetbuf_set_datalen(1);
+
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_CMDFRAME);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_null);
+
+  if(NETSTACK_FRAMER.create() < 0 || packetbuf_totlen() > buf_size) {
+    return -1;
+  }
+
+  memcpy(buf, packetbuf_hdrptr(), packetbuf_totlen());
+  return packetbuf_totlen();
+}
+/*---------------------------------------------------------------------------*/
 /* Update ASN in EB packet */
 int
 tsch_packet_update_eb(uint8_t *buf, int buf_size, uint8_t tsch_sync_ie_offset)
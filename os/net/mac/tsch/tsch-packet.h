@@ -80,6 +80,13 @@ int tsch_packet_parse_eack(const uint8_t *buf, int buf_size,
  * \return The total length of the EB
  */
 int tsch_packet_create_eb(uint8_t *hdr_len, uint8_t *tsch_sync_ie_ptr);
+/**
+ * \brief Create a broadcast Beacon Request command frame
+ * \param buf The buffer where to build the frame
+ * \param buf_size The buffer size
+ * \return The length of the frame, -1 on failure
+ */
+int tsch_packet_create_beacon_request(uint8_t *buf, int buf_size);
 /**
  * \brief Update ASN in EB packet
  * \param buf The buffer that contains the EB
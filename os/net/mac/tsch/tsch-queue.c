@@ -55,6 +55,7 @@
 #include "net/queuebuf.h"
 #include "net/mac/tsch/tsch.h"
 #include "net/nbr-table.h"
+#include "sys/critical.h"
 #include <string.h>
 
 /* Log configuration */
@@ -75,6 +76,68 @@ NBR_TABLE(struct tsch_neighbor, tsch_neighbors);
 struct tsch_neighbor *n_broadcast;
 struct tsch_neighbor *n_eb;
 
+#if TSCH_QUEUE_WITH_READY_SET
+#define READY_SET_WORDS ((NBR_TABLE_MAX_NEIGHBORS + 31) / 32)
+/* Neighbors with a non-empty queue. Set after a packet is added, so a bit
+ * may briefly be set for an empty queue, but never cleared for a
+ * non-empty one. */
+static uint32_t queued_set[READY_SET_WORDS];
+/* Neighbors with a non-zero backoff window */
+static uint32_t backoff_set[READY_SET_WORDS];
+
+/* Both sets are indexed like the neighbor table, and updated from the
+ * process and from the slot operation, hence the critical sections */
+static void
+ready_set_write(uint32_t *set, int i, int value)
+{
+  int_master_status_t status = critical_enter();
+  if(value) {
+    set[i / 32] |= (uint32_t)1 << (i % 32);
+  } else {
+    set[i / 32] &= ~((uint32_t)1 << (i % 32));
+  }
+  critical_exit(status);
+}
+static void
+ready_set_update(uint32_t *set, const struct tsch_neighbor *n, int value)
+{
+  int i = nbr_table_get_index(tsch_neighbors, n);
+  if(i != -1) {
+    ready_set_write(set, i, value);
+  }
+}
+/* Neighbor table callback: a neighbor leaves both sets when it is removed,
+ * so that walking them never reaches a freed or reused entry */
+static void
+ready_set_remove(nbr_table_item_t *item)
+{
+  ready_set_update(queued_set, item, 0);
+  ready_set_update(backoff_set, item, 0);
+}
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+
+/*---------------------------------------------------------------------------*/
+/* May the neighbor's head packet go out in links to the broadcast address?
+ * Only if we have no Tx link to the neighbor or, with
+ * TSCH_SELECTED_PACKETS_USE_SHARED_LINKS, if the packet was explicitly
+ * selected for a slotframe (the link-selector then checks it matches) */
+static int
+nbr_uses_broadcast_links(const struct tsch_neighbor *n)
+{
+  if(n->tx_links_count == 0) {
+    return 1;
+  }
+#if TSCH_WITH_LINK_SELECTOR && TSCH_SELECTED_PACKETS_USE_SHARED_LINKS
+  {
+    int16_t get_index = ringbufindex_peek_get(&n->tx_ringbuf);
+    if(get_index != -1
+       && queuebuf_attr(n->tx_array[get_index]->qb, PACKETBUF_ATTR_TSCH_SLOTFRAME) != 0xffff) {
+      return 1;
+    }
+  }
+#endif /* TSCH_WITH_LINK_SELECTOR && TSCH_SELECTED_PACKETS_USE_SHARED_LINKS */
+  return 0;
+}
 /*---------------------------------------------------------------------------*/
 /* Add a TSCH neighbor */
 struct tsch_neighbor *
@@ -98,6 +161,9 @@ tsch_queue_add_nbr(const linkaddr_t *addr)
         n->is_broadcast = linkaddr_cmp(addr, &tsch_eb_address)
           || linkaddr_cmp(addr, &tsch_broadcast_address);
         tsch_queue_backoff_reset(n);
+#if TSCH_QUEUE_WITH_READY_SET
+        ready_set_update(queued_set, n, 0);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
       }
       tsch_release_lock();
     }
@@ -218,6 +284,11 @@ tsch_queue_remove_nbr(struct tsch_neighbor *n)
       /* Flush queue */
       tsch_queue_flush_nbr_queue(n);
 
+#if TSCH_QUEUE_WITH_READY_SET
+      /* nbr_table_remove() does not call the table callback */
+      ready_set_remove(n);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
+
       /* Free neighbor */
       nbr_table_remove(tsch_neighbors, n);
     }
@@ -260,6 +331,9 @@ tsch_queue_add_packet(const linkaddr_t *addr, uint8_t max_transmissions,
             /* Add to ringbuf (actual add committed through atomic operation) */
             n->tx_array[put_index] = p;
             ringbufindex_put(&n->tx_ringbuf);
+#if TSCH_QUEUE_WITH_READY_SET
+            ready_set_update(queued_set, n, 1);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
             LOG_DBG("packet is added put_index %u, packet %p\n",
                    put_index, p);
             return p;
@@ -299,6 +373,11 @@ tsch_queue_remove_packet_from_queue(struct tsch_neighbor *n)
     if(n != NULL) {
       /* Get and remove packet from ringbuf (remove committed through an atomic operation */
       int16_t get_index = ringbufindex_get(&n->tx_ringbuf);
+#if TSCH_QUEUE_WITH_READY_SET
+      if(ringbufindex_empty(&n->tx_ringbuf)) {
+        ready_set_update(queued_set, n, 0);
+      }
+#endif /* TSCH_QUEUE_WITH_READY_SET */
       if(get_index != -1) {
         return n->tx_array[get_index];
       } else {
@@ -464,11 +543,39 @@ struct tsch_packet *
 tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link *link)
 {
   if(!tsch_is_locked()) {
+#if TSCH_QUEUE_WITH_READY_SET
+    int is_shared_link = link != NULL && link->link_options & LINK_OPTION_SHARED;
+    int w;
+    /* Only look at neighbors with queued packets, and on shared links,
+     * whose backoff has expired */
+    for(w = 0; w < READY_SET_WORDS; w++) {
+      uint32_t ready = queued_set[w] & (is_shared_link ? ~backoff_set[w] : 0xffffffff);
+      int i;
+      for(i = w * 32; ready != 0; i++, ready >>= 1) {
+        if(ready & 1) {
+          struct tsch_neighbor *curr_nbr = nbr_table_get_from_index(tsch_neighbors, i);
+          if(curr_nbr == NULL || ringbufindex_empty(&curr_nbr->tx_ringbuf)) {
+            /* The last packet was removed while it was being added */
+            ready_set_write(queued_set, i, 0);
+          } else if(!curr_nbr->is_broadcast && nbr_uses_broadcast_links(curr_nbr)) {
+            /* Only look up for non-broadcast neighbors whose packets may use this link */
+            struct tsch_packet *p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
+            if(p != NULL) {
+              if(n != NULL) {
+                *n = curr_nbr;
+              }
+              return p;
+            }
+          }
+        }
+      }
+    }
+#else /* TSCH_QUEUE_WITH_READY_SET */
     struct tsch_neighbor *curr_nbr = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     struct tsch_packet *p = NULL;
     while(curr_nbr != NULL) {
-      if(!curr_nbr->is_broadcast && curr_nbr->tx_links_count == 0) {
-        /* Only look up for non-broadcast neighbors we do not have a tx link to */
+      if(!curr_nbr->is_broadcast && nbr_uses_broadcast_links(curr_nbr)) {
+        /* Only look up for non-broadcast neighbors whose packets may use this link */
         p = tsch_queue_get_packet_for_nbr(curr_nbr, link);
         if(p != NULL) {
           if(n != NULL) {
@@ -479,6 +586,7 @@ tsch_queue_get_unicast_packet_for_any(struct tsch_neighbor **n, struct tsch_link
       }
       curr_nbr = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, curr_nbr);
     }
+#endif /* TSCH_QUEUE_WITH_READY_SET */
   }
   return NULL;
 }
@@ -496,6 +604,9 @@ tsch_queue_backoff_reset(struct tsch_neighbor *n)
 {
   n->backoff_window = 0;
   n->backoff_exponent = TSCH_MAC_MIN_BE;
+#if TSCH_QUEUE_WITH_READY_SET
+  ready_set_update(backoff_set, n, 0);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
 }
 /*---------------------------------------------------------------------------*/
 /* Increment backoff exponent, pick a new window */
@@ -511,6 +622,9 @@ tsch_queue_backoff_inc(struct tsch_neighbor *n)
   /* Add one to the window as we will decrement it at the end of the current slot
    * through tsch_queue_update_all_backoff_windows */
   n->backoff_window++;
+#if TSCH_QUEUE_WITH_READY_SET
+  ready_set_update(backoff_set, n, 1);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
 }
 /*---------------------------------------------------------------------------*/
 /* Decrement backoff window for all queues directed at dest_addr */
@@ -519,15 +633,38 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 {
   if(!tsch_is_locked()) {
     int is_broadcast = linkaddr_cmp(dest_addr, &tsch_broadcast_address);
+#if TSCH_QUEUE_WITH_READY_SET
+    int w;
+    /* Only neighbors in backoff state need to be looked at */
+    for(w = 0; w < READY_SET_WORDS; w++) {
+      uint32_t in_backoff = backoff_set[w];
+      int i;
+      for(i = w * 32; in_backoff != 0; i++, in_backoff >>= 1) {
+        if(in_backoff & 1) {
+          struct tsch_neighbor *n = nbr_table_get_from_index(tsch_neighbors, i);
+          if(n == NULL) {
+            ready_set_write(backoff_set, i, 0);
+          } else if((is_broadcast && nbr_uses_broadcast_links(n))
+             || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, tsch_queue_get_nbr_address(n)))) {
+            n->backoff_window--;
+            if(n->backoff_window == 0) {
+              ready_set_update(backoff_set, n, 0);
+            }
+          }
+        }
+      }
+    }
+#else /* TSCH_QUEUE_WITH_READY_SET */
     struct tsch_neighbor *n = (struct tsch_neighbor *)nbr_table_head(tsch_neighbors);
     while(n != NULL) {
       if(n->backoff_window != 0 /* Is the queue in backoff state? */
-         && ((n->tx_links_count == 0 && is_broadcast)
+         && ((is_broadcast && nbr_uses_broadcast_links(n))
              || (n->tx_links_count > 0 && linkaddr_cmp(dest_addr, tsch_queue_get_nbr_address(n))))) {
         n->backoff_window--;
       }
       n = (struct tsch_neighbor *)nbr_table_next(tsch_neighbors, n);
     }
+#endif /* TSCH_QUEUE_WITH_READY_SET */
   }
 }
 /*---------------------------------------------------------------------------*/
@@ -535,7 +672,11 @@ tsch_queue_update_all_backoff_windows(const linkaddr_t *dest_addr)
 void
 tsch_queue_init(void)
 {
+#if TSCH_QUEUE_WITH_READY_SET
+  nbr_table_register(tsch_neighbors, ready_set_remove);
+#else /* TSCH_QUEUE_WITH_READY_SET */
   nbr_table_register(tsch_neighbors, NULL);
+#endif /* TSCH_QUEUE_WITH_READY_SET */
   memb_init(&packet_memb);
   /* Add virtual EB and the broadcast neighbors */
   n_eb = tsch_queue_add_nbr(&tsch_eb_address);
@@ -68,6 +68,84 @@ MEMB(slotframe_memb, struct tsch_slotframe, TSCH_SCHEDULE_MAX_SLOTFRAMES);
 /* List of slotframes (each slotframe holds its own list of links) */
 LIST(slotframe_list);
 
+#if TSCH_SCHEDULE_WITH_INDEX
+/* Schedule index: all links, grouped by slotframe, each group sorted by
+ * timeslot. Links sharing a timeslot are kept in insertion order, i.e. the
+ * order of the slotframe's links_list, so that overlaps are resolved exactly
+ * as when walking the lists. Empty slotframes point at the end of the index.
+ * Only modified with the TSCH lock held. */
+static struct tsch_link *link_index[TSCH_SCHEDULE_MAX_LINKS];
+static uint16_t link_index_len;
+
+/* Returns the position, relative to the slotframe's range, of the first
+ * link with a timeslot strictly greater than 'timeslot' */
+static uint16_t
+index_upper_bound(const struct tsch_slotframe *sf, uint16_t timeslot)
+{
+  struct tsch_link **base = &link_index[sf->index_start];
+  uint16_t lo = 0;
+  uint16_t hi = sf->index_len;
+  while(lo < hi) {
+    uint16_t mid = lo + (hi - lo) / 2;
+    if(base[mid]->timeslot <= timeslot) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves the range of every other slotframe after the index changed at
+ * position 'pos' by 'delta' entries */
+static void
+index_shift(struct tsch_slotframe *changed, uint16_t pos, int delta)
+{
+  struct tsch_slotframe *sf;
+  for(sf = list_head(slotframe_list); sf != NULL; sf = list_item_next(sf)) {
+    if(sf == changed) {
+      continue;
+    }
+    if(sf->index_len == 0) {
+      sf->index_start = link_index_len;
+    } else if(sf->index_start >= pos) {
+      sf->index_start += delta;
+    }
+  }
+  if(changed->index_len == 0) {
+    changed->index_start = link_index_len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_add_link(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos = sf->index_start + index_upper_bound(sf, l->timeslot);
+  memmove(&link_index[pos + 1], &link_index[pos],
+          (link_index_len - pos) * sizeof(link_index[0]));
+  link_index[pos] = l;
+  link_index_len++;
+  sf->index_len++;
+  index_shift(sf, pos, 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+index_remove_link(struct tsch_slotframe *sf, struct tsch_link *l)
+{
+  uint16_t pos;
+  for(pos = sf->index_start; pos < sf->index_start + sf->index_len; pos++) {
+    if(link_index[pos] == l) {
+      memmove(&link_index[pos], &link_index[pos + 1],
+              (link_index_len - pos - 1) * sizeof(link_index[0]));
+      link_index_len--;
+      sf->index_len--;
+      index_shift(sf, pos, -1);
+      return;
+    }
+  }
+}
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
+
 /* Adds and returns a slotframe (NULL if failure) */
 struct tsch_slotframe *
 tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
@@ -88,6 +166,10 @@ tsch_schedule_add_slotframe(uint16_t handle, uint16_t size)
       sf->handle = handle;
       TSCH_ASN_DIVISOR_INIT(sf->size, size);
       LIST_STRUCT_INIT(sf, links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+      sf->index_start = link_index_len;
+      sf->index_len = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       /* Add the slotframe to the global list */
       list_add(slotframe_list, sf);
     }
@@ -256,6 +338,9 @@ tsch_schedule_add_link(struct tsch_slotframe *slotframe,
           address = &linkaddr_null;
         }
         linkaddr_copy(&l->addr, address);
+#if TSCH_SCHEDULE_WITH_INDEX
+        index_add_link(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 
         LOG_INFO("add_link sf=%u opt=%s type=%s ts=%u ch=%u addr=",
                  slotframe->handle,
@@ -308,6 +393,9 @@ tsch_schedule_remove_link(struct tsch_slotframe *slotframe, struct tsch_link *l)
       LOG_INFO_LLADDR(&l->addr);
       LOG_INFO_("\n");
 
+#if TSCH_SCHEDULE_WITH_INDEX
+      index_remove_link(slotframe, l);
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       list_remove(slotframe->links_list, l);
       memb_free(&link_memb, l);
 
@@ -400,6 +488,59 @@ default_tsch_link_comparator(struct tsch_link *a, struct tsch_link *b)
   return a;
 }
 
+/*---------------------------------------------------------------------------*/
+/* Considers link 'l', occurring in 'time_to_timeslot' timeslots, as the next
+ * active link. Updates the current best and backup links accordingly. */
+static void
+select_link(struct tsch_link *l, uint16_t time_to_timeslot,
+            struct tsch_link **curr_best, uint16_t *time_to_curr_best,
+            struct tsch_link **curr_backup)
+{
+  if(*curr_best == NULL || time_to_timeslot < *time_to_curr_best) {
+    *time_to_curr_best = time_to_timeslot;
+    *curr_best = l;
+    *curr_backup = NULL;
+  } else if(time_to_timeslot == *time_to_curr_best) {
+    struct tsch_link *new_best = NULL;
+    /* Two links are overlapping, we need to select one of them.
+     * By standard: prioritize Tx links first, second by lowest handle */
+    if(((*curr_best)->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
+      /* Both or neither links have Tx, select the one with lowest handle */
+      if(l->slotframe_handle != (*curr_best)->slotframe_handle) {
+        if(l->slotframe_handle < (*curr_best)->slotframe_handle) {
+          new_best = l;
+        }
+      } else {
+        /* compare the link against the current best link and return the newly selected one */
+        new_best = TSCH_LINK_COMPARATOR(*curr_best, l);
+      }
+    } else {
+      /* Select the link that has the Tx option */
+      if(l->link_options & LINK_OPTION_TX) {
+        new_best = l;
+      }
+    }
+
+    /* Maintain backup_link */
+    /* Check if 'l' best can be used as backup */
+    if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
+      if(*curr_backup == NULL || l->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = l;
+      }
+    }
+    /* Check if curr_best can be used as backup */
+    if(new_best != *curr_best && ((*curr_best)->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
+      if(*curr_backup == NULL || (*curr_best)->slotframe_handle < (*curr_backup)->slotframe_handle) {
+        *curr_backup = *curr_best;
+      }
+    }
+
+    /* Maintain curr_best */
+    if(new_best != NULL) {
+      *curr_best = new_best;
+    }
+  }
+}
 /*---------------------------------------------------------------------------*/
 /* Returns the next active link after a given ASN, and a backup link (for the same ASN, with Rx flag) */
 struct tsch_link *
@@ -418,59 +559,39 @@ tsch_schedule_get_next_active_link(struct tsch_asn_t *asn, uint16_t *time_offset
     while(sf != NULL) {
       /* Get timeslot from ASN, given the slotframe length */
       uint16_t timeslot = TSCH_ASN_MOD(*asn, sf->size);
+#if TSCH_SCHEDULE_WITH_INDEX
+      if(sf->index_len > 0) {
+        /* Only the links at the first timeslot after the current one can
+         * be selected from this slotframe; wrap around if there is none */
+        struct tsch_link **base = &link_index[sf->index_start];
+        uint16_t i = index_upper_bound(sf, timeslot);
+        uint16_t next_timeslot;
+        uint16_t time_to_timeslot;
+        if(i == sf->index_len) {
+          i = 0;
+        }
+        next_timeslot = base[i]->timeslot;
+        time_to_timeslot =
+          next_timeslot > timeslot ?
+          next_timeslot - timeslot :
+          sf->size.val + next_timeslot - timeslot;
+        for(; i < sf->index_len && base[i]->timeslot == next_timeslot; i++) {
+          select_link(base[i], time_to_timeslot,
+                      &curr_best, &time_to_curr_best, &curr_backup);
+        }
+      }
+#else /* TSCH_SCHEDULE_WITH_INDEX */
       struct tsch_link *l = list_head(sf->links_list);
       while(l != NULL) {
         uint16_t time_to_timeslot =
           l->timeslot > timeslot ?
           l->timeslot - timeslot :
           sf->size.val + l->timeslot - timeslot;
-        if(curr_best == NULL || time_to_timeslot < time_to_curr_best) {
-          time_to_curr_best = time_to_timeslot;
-          curr_best = l;
-          curr_backup = NULL;
-        } else if(time_to_timeslot == time_to_curr_best) {
-          struct tsch_link *new_best = NULL;
-          /* Two links are overlapping, we need to select one of them.
-           * By standard: prioritize Tx links first, second by lowest handle */
-          if((curr_best->link_options & LINK_OPTION_TX) == (l->link_options & LINK_OPTION_TX)) {
-            /* Both or neither links have Tx, select the one with lowest handle */
-            if(l->slotframe_handle != curr_best->slotframe_handle) {
-              if(l->slotframe_handle < curr_best->slotframe_handle) {
-                new_best = l;
-              }
-            } else {
-              /* compare the link against the current best link and return the newly selected one */
-              new_best = TSCH_LINK_COMPARATOR(curr_best, l);
-            }
-          } else {
-            /* Select the link that has the Tx option */
-            if(l->link_options & LINK_OPTION_TX) {
-              new_best = l;
-            }
-          }
-
-          /* Maintain backup_link */
-          /* Check if 'l' best can be used as backup */
-          if(new_best != l && (l->link_options & LINK_OPTION_RX)) { /* Does 'l' have Rx flag? */
-            if(curr_backup == NULL || l->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = l;
-            }
-          }
-          /* Check if curr_best can be used as backup */
-          if(new_best != curr_best && (curr_best->link_options & LINK_OPTION_RX)) { /* Does curr_best have Rx flag? */
-            if(curr_backup == NULL || curr_best->slotframe_handle < curr_backup->slotframe_handle) {
-              curr_backup = curr_best;
-            }
-          }
-
-          /* Maintain curr_best */
-          if(new_best != NULL) {
-            curr_best = new_best;
-          }
-        }
-
+        select_link(l, time_to_timeslot,
+                    &curr_best, &time_to_curr_best, &curr_backup);
         l = list_item_next(l);
       }
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
       sf = list_item_next(sf);
     }
     if(time_offset != NULL) {
@@ -491,6 +612,9 @@ tsch_schedule_init(void)
     memb_init(&link_memb);
     memb_init(&slotframe_memb);
     list_init(slotframe_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+    link_index_len = 0;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
     tsch_release_lock();
     return 1;
   } else {
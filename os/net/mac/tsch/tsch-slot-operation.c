@@ -149,6 +149,9 @@ static rtimer_clock_t volatile current_slot_start;
 /* Are we currently inside a slot? */
 static volatile int tsch_in_slot_operation = 0;
 
+/* Is a slot operation rtimer pending? */
+static volatile int is_slot_operation_scheduled = 0;
+
 /* If we are inside a slot, these tell the current channel and channel offset */
 uint8_t tsch_current_channel;
 uint8_t tsch_current_channel_offset;
@@ -201,7 +204,9 @@ tsch_get_lock(void)
     if(tsch_in_slot_operation) {
       busy_wait = 1;
       busy_wait_time = RTIMER_NOW();
-      while(tsch_in_slot_operation) {
+      /* Busy-wait through the rtimer macro: on simulated platforms,
+       * this is what lets the slot operation run to completion */
+      while(!RTIMER_BUSYWAIT_UNTIL(!tsch_in_slot_operation, RTIMER_SECOND / 100)) {
         watchdog_periodic();
       }
       busy_wait_time = RTIMER_NOW() - busy_wait_time;
@@ -307,6 +312,7 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
   int missed = check_timer_miss(ref_time, offset - RTIMER_GUARD, now);
 
   if(missed) {
+    tsch_stats_profile_miss();
     TSCH_LOG_ADD(tsch_log_message,
                 snprintf(log->message, sizeof(log->message),
                     "!dl-miss %s %d %d",
@@ -315,12 +321,14 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
   } else {
     r = rtimer_set(tm, ref_time + offset, 1, (void (*)(struct rtimer *, void *))tsch_slot_operation, NULL);
     if(r == RTIMER_OK) {
+      is_slot_operation_scheduled = 1;
       return 1;
     }
   }
 
   /* block until the time to schedule comes */
   RTIMER_BUSYWAIT_UNTIL_ABS(0, ref_time, offset);
+  tsch_stats_profile_start();
   return 0;
 }
 /*---------------------------------------------------------------------------*/
@@ -333,6 +341,7 @@ tsch_schedule_slot_operation(struct rtimer *tm, rtimer_clock_t ref_time, rtimer_
       PT_YIELD(pt); \
     } \
     RTIMER_BUSYWAIT_UNTIL_ABS(0, ref_time, offset); \
+    tsch_stats_profile_start(); \
   } while(0);
 /*---------------------------------------------------------------------------*/
 /*
@@ -574,6 +583,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       } else {
         packet_ready = 1;
       }
+      tsch_stats_profile_mark(TSCH_STATS_PHASE_TX_PREPARE);
 
 #if LLSEC802154_ENABLED
       if(tsch_is_pan_secured) {
@@ -585,6 +595,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         if(with_encryption) {
           packet = encrypted_packet;
         }
+        tsch_stats_profile_mark(TSCH_STATS_PHASE_SECURITY);
       }
 #endif /* LLSEC802154_ENABLED */
 
@@ -592,6 +603,8 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
       if(packet_ready && NETSTACK_RADIO.prepare(packet, packet_len) == 0) { /* 0 means success */
         static rtimer_clock_t tx_duration;
 
+        tsch_stats_profile_mark(TSCH_STATS_PHASE_RADIO_PREPARE);
+
 #if TSCH_CCA_ENABLED
         cca_status = 1;
         /* delay before CCA */
@@ -602,6 +615,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
         RTIMER_BUSYWAIT_UNTIL_ABS(!(cca_status &= NETSTACK_RADIO.channel_clear()),
                            current_slot_start, tsch_timing[tsch_ts_cca_offset] + tsch_timing[tsch_ts_cca]);
         TSCH_DEBUG_TX_EVENT();
+        tsch_stats_profile_start();
         /* there is not enough time to turn radio off */
         /*  NETSTACK_RADIO.off(); */
         if(cca_status == 0) {
@@ -614,6 +628,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
           TSCH_DEBUG_TX_EVENT();
           /* send packet already in radio tx buffer */
           mac_tx_status = NETSTACK_RADIO.transmit(packet_len);
+          tsch_stats_profile_mark(TSCH_STATS_PHASE_RADIO_TRANSMIT);
           tx_count++;
           /* Save tx timestamp */
           tx_start_time = current_slot_start + tsch_timing[tsch_ts_tx_offset];
@@ -663,6 +678,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
               NETSTACK_RADIO.get_value(RADIO_PARAM_RX_MODE, &radio_rx_mode);
               NETSTACK_RADIO.set_value(RADIO_PARAM_RX_MODE, radio_rx_mode | RADIO_RX_MODE_ADDRESS_FILTER);
 #endif /* TSCH_HW_FRAME_FILTERING */
+              tsch_stats_profile_start();
 
               /* Read ack frame */
               ack_len = NETSTACK_RADIO.read((void *)ackbuf, sizeof(ackbuf));
@@ -675,6 +691,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
                     &frame, &ack_ies, &ack_hdrlen) == 0) {
                   ack_len = 0;
                 }
+                tsch_stats_profile_mark(TSCH_STATS_PHASE_ACK_PARSE);
 
 #if LLSEC802154_ENABLED
                 if(ack_len != 0) {
@@ -690,6 +707,7 @@ PT_THREAD(tsch_tx_slot(struct pt *pt, struct rtimer *t))
                       snprintf(log->message, sizeof(log->message),
                       "!failed to parse ACK"));
                 }
+                tsch_stats_profile_mark(TSCH_STATS_PHASE_SECURITY);
 #endif /* LLSEC802154_ENABLED */
               }
 
@@ -837,6 +855,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
       /* Check if receiving within guard time */
       RTIMER_BUSYWAIT_UNTIL_ABS((packet_seen = (NETSTACK_RADIO.receiving_packet() || NETSTACK_RADIO.pending_packet())),
           current_slot_start, tsch_timing[tsch_ts_rx_offset] + tsch_timing[tsch_ts_rx_wait] + RADIO_DELAY_BEFORE_DETECT);
+      tsch_stats_profile_start();
     }
     if(!packet_seen) {
       /* no packets on air */
@@ -851,6 +870,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
           current_slot_start, tsch_timing[tsch_ts_rx_offset] + tsch_timing[tsch_ts_rx_wait] + tsch_timing[tsch_ts_max_tx]);
       TSCH_DEBUG_RX_EVENT();
       tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
+      tsch_stats_profile_start();
 
       if(NETSTACK_RADIO.pending_packet()) {
         static int frame_valid;
@@ -887,13 +907,19 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
 
         if(frame_valid) {
           if(frame.fcf.frame_type != FRAME802154_DATAFRAME
-            && frame.fcf.frame_type != FRAME802154_BEACONFRAME) {
+            && frame.fcf.frame_type != FRAME802154_BEACONFRAME
+#if TSCH_WITH_EB_SOLICITATION
+            /* Beacon Requests */
+            && frame.fcf.frame_type != FRAME802154_CMDFRAME
+#endif /* TSCH_WITH_EB_SOLICITATION */
+            ) {
               TSCH_LOG_ADD(tsch_log_message,
                   snprintf(log->message, sizeof(log->message),
                   "!discarding frame with type %u, len %u", frame.fcf.frame_type, current_input->len));
               frame_valid = 0;
           }
         }
+        tsch_stats_profile_mark(TSCH_STATS_PHASE_RX_PARSE);
 
 #if LLSEC802154_ENABLED
         /* Decrypt and verify incoming frame */
@@ -908,6 +934,7 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
                 "!failed to authenticate frame %u", current_input->len));
             frame_valid = 0;
           }
+          tsch_stats_profile_mark(TSCH_STATS_PHASE_SECURITY);
         }
 #endif /* LLSEC802154_ENABLED */
 
@@ -948,23 +975,27 @@ PT_THREAD(tsch_rx_slot(struct pt *pt, struct rtimer *t))
               /* Build ACK frame */
               ack_len = tsch_packet_create_eack(ack_buf, sizeof(ack_buf),
                   &source_address, frame.seq, (int16_t)RTIMERTICKS_TO_US(estimated_drift), do_nack);
+              tsch_stats_profile_mark(TSCH_STATS_PHASE_ACK_PREPARE);
 
               if(ack_len > 0) {
 #if LLSEC802154_ENABLED
                 if(tsch_is_pan_secured) {
                   /* Secure ACK frame. There is only header and header IEs, therefore data len == 0. */
                   ack_len += tsch_security_secure_frame(ack_buf, ack_buf, ack_len, 0, &tsch_current_asn);
+                  tsch_stats_profile_mark(TSCH_STATS_PHASE_SECURITY);
                 }
 #endif /* LLSEC802154_ENABLED */
 
                 /* Copy to radio buffer */
                 NETSTACK_RADIO.prepare((const void *)ack_buf, ack_len);
+                tsch_stats_profile_mark(TSCH_STATS_PHASE_RADIO_PREPARE);
 
                 /* Wait for time to ACK and transmit ACK */
                 TSCH_SCHEDULE_AND_YIELD(pt, t, rx_start_time,
                                         packet_duration + tsch_timing[tsch_ts_tx_ack_delay] - RADIO_DELAY_BEFORE_TX, "RxBeforeAck");
                 TSCH_DEBUG_RX_EVENT();
                 NETSTACK_RADIO.transmit(ack_len);
+                tsch_stats_profile_mark(TSCH_STATS_PHASE_RADIO_TRANSMIT);
                 tsch_radio_off(TSCH_RADIO_CMD_OFF_WITHIN_TIMESLOT);
 
                 /* Schedule a burst link iff the frame pending bit was set */
@@ -1038,11 +1069,14 @@ static
 PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
 {
   TSCH_DEBUG_INTERRUPT();
+  is_slot_operation_scheduled = 0;
   PT_BEGIN(&slot_operation_pt);
 
   /* Loop over all active slots */
   while(tsch_is_associated) {
 
+    tsch_stats_profile_start();
+
     if(current_link == NULL || tsch_lock_requested) { /* Skip slot operation if there is no link
                                                           or if there is a pending request for getting the lock */
       /* Issue a log whenever skipping a slot */
@@ -1098,6 +1132,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
         NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, tsch_current_channel);
         /* Turn the radio on already here if configured so; necessary for radios with slow startup */
         tsch_radio_on(TSCH_RADIO_CMD_ON_START_OF_TIMESLOT);
+        tsch_stats_profile_mark(TSCH_STATS_PHASE_LINK_SELECTION);
         /* Decide whether it is a TX/RX/IDLE or OFF slot */
         /* Actual slot operation */
         if(current_packet != NULL) {
@@ -1181,6 +1216,7 @@ PT_THREAD(tsch_slot_operation(struct rtimer *t, void *ptr))
         /* Update current slot start */
         prev_slot_start = current_slot_start;
         current_slot_start += time_to_next_active_slot;
+        tsch_stats_profile_mark(TSCH_STATS_PHASE_SLOT_END);
       } while(!tsch_schedule_slot_operation(t, prev_slot_start, time_to_next_active_slot, "main"));
     }
 
@@ -1237,4 +1273,22 @@ tsch_slot_operation_sync(rtimer_clock_t next_slot_start,
   current_link = NULL;
 }
 /*---------------------------------------------------------------------------*/
+void
+tsch_slot_operation_get_next_slot(rtimer_clock_t *slot_start,
+    struct tsch_asn_t *slot_asn)
+{
+  int_master_status_t status;
+
+  status = critical_enter();
+  *slot_start = current_slot_start;
+  *slot_asn = tsch_current_asn;
+  critical_exit(status);
+}
+/*---------------------------------------------------------------------------*/
+int
+tsch_slot_operation_is_scheduled(void)
+{
+  return is_slot_operation_scheduled;
+}
+/*---------------------------------------------------------------------------*/
 /** @} */
@@ -93,6 +93,22 @@ void tsch_slot_operation_sync(rtimer_clock_t next_slot_start,
  * Start actual slot operation
  */
 void tsch_slot_operation_start(void);
+/**
+ * Get the start time and ASN of the next slot. Once slot operation has
+ * stopped, these remain those of the last slot that was scheduled.
+ *
+ * \param slot_start Set to the start of the slot, in rtimer ticks
+ * \param slot_asn Set to the ASN of the slot
+ */
+void tsch_slot_operation_get_next_slot(rtimer_clock_t *slot_start,
+    struct tsch_asn_t *slot_asn);
+/**
+ * Is a slot operation wakeup still pending? After leaving the network,
+ * slot operation ends at its next wakeup.
+ *
+ * \return 1 if a wakeup is pending, 0 otherwise
+ */
+int tsch_slot_operation_is_scheduled(void);
 
 #endif /* TSCH_SLOT_OPERATION_H_ */
 /** @} */
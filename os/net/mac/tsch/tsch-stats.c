@@ -38,6 +38,7 @@
 #include "net/mac/tsch/tsch.h"
 #include "net/netstack.h"
 #include "dev/radio.h"
+#include <string.h>
 
 /* Log configuration */
 #include "sys/log.h"
@@ -56,6 +57,18 @@ static struct ctimer periodic_timer;
 
 static void periodic(void *);
 
+#if TSCH_STATS_PROFILE
+static struct tsch_stats_phase_profile profile[TSCH_STATS_PHASE_COUNT];
+/* The end of the last marked phase, or the last wakeup */
+static rtimer_clock_t profile_last_time;
+static enum tsch_stats_phase profile_last_phase;
+
+static const char *const phase_names[TSCH_STATS_PHASE_COUNT] = {
+  "link-sel", "tx-prep", "security", "radio-prep", "radio-tx",
+  "ack-parse", "rx-parse", "ack-prep", "slot-end"
+};
+#endif /* TSCH_STATS_PROFILE */
+
 /*---------------------------------------------------------------------------*/
 void
 tsch_stats_init(void)
@@ -70,6 +83,7 @@ tsch_stats_init(void)
 #endif
 
   tsch_stats_reset_neighbor_stats();
+  tsch_stats_profile_reset();
 
   /* Start the periodic processing soonish */
   ctimer_set(&periodic_timer, TSCH_STATS_DECAY_INTERVAL / 10, periodic, NULL);
@@ -187,6 +201,84 @@ tsch_stats_sample_rssi(void)
 #endif /* TSCH_STATS_SAMPLE_NOISE_RSSI */
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_STATS_PROFILE
+void
+tsch_stats_profile_start(void)
+{
+  profile_last_time = RTIMER_NOW();
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_stats_profile_mark(enum tsch_stats_phase phase)
+{
+  rtimer_clock_t now = RTIMER_NOW();
+  rtimer_clock_t duration = now - profile_last_time;
+  struct tsch_stats_phase_profile *p = &profile[phase];
+
+  if(p->count == 0 || duration < p->min) {
+    p->min = duration;
+  }
+  if(duration > p->max) {
+    p->max = duration;
+  }
+  p->sum += duration;
+  p->count++;
+
+  profile_last_time = now;
+  profile_last_phase = phase;
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_stats_profile_miss(void)
+{
+  profile[profile_last_phase].misses++;
+}
+/*---------------------------------------------------------------------------*/
+const struct tsch_stats_phase_profile *
+tsch_stats_profile_get(enum tsch_stats_phase phase)
+{
+  if(phase >= TSCH_STATS_PHASE_COUNT) {
+    return NULL;
+  }
+  return &profile[phase];
+}
+/*---------------------------------------------------------------------------*/
+const char *
+tsch_stats_profile_phase_name(enum tsch_stats_phase phase)
+{
+  if(phase >= TSCH_STATS_PHASE_COUNT) {
+    return "?";
+  }
+  return phase_names[phase];
+}
+/*---------------------------------------------------------------------------*/
+void
+tsch_stats_profile_reset(void)
+{
+  memset(profile, 0, sizeof(profile));
+  profile_last_phase = TSCH_STATS_PHASE_LINK_SELECTION;
+}
+/*---------------------------------------------------------------------------*/
+static void
+profile_print(void)
+{
+  int i;
+
+  LOG_INFO("Slot operation profile (usec min/avg/max, count, misses):\n");
+  for(i = 0; i < TSCH_STATS_PHASE_COUNT; ++i) {
+    const struct tsch_stats_phase_profile *p = &profile[i];
+    if(p->count != 0 || p->misses != 0) {
+      LOG_INFO("  %-10s %lu/%lu/%lu, %lu, %u\n",
+          phase_names[i],
+          (unsigned long)RTIMERTICKS_TO_US_64(p->min),
+          (unsigned long)RTIMERTICKS_TO_US_64(p->count ? p->sum / p->count : 0),
+          (unsigned long)RTIMERTICKS_TO_US_64(p->max),
+          (unsigned long)p->count, p->misses);
+    }
+  }
+}
+#endif /* TSCH_STATS_PROFILE */
+/*---------------------------------------------------------------------------*/
 /* Periodic timer called every TSCH_STATS_DECAY_INTERVAL ticks */
 static void
 periodic(void *ptr)
@@ -220,6 +312,10 @@ periodic(void *ptr)
     }
   }
 
+#if TSCH_STATS_PROFILE
+  profile_print();
+#endif /* TSCH_STATS_PROFILE */
+
   /* Do not decay the periodic global stats, as they are updated independely of packet rate */
   for(i = 0; i < TSCH_STATS_NUM_CHANNELS; ++i) {
     /* decay Rx stats */
@@ -65,6 +65,16 @@
 #define TSCH_STATS_SAMPLE_NOISE_RSSI 0
 #endif
 
+/*
+ * Profile the execution time of the slot operation phases?
+ * Requires TSCH_STATS_ON.
+ */
+#if TSCH_STATS_ON && defined(TSCH_STATS_CONF_PROFILE)
+#define TSCH_STATS_PROFILE TSCH_STATS_CONF_PROFILE
+#else
+#define TSCH_STATS_PROFILE 0
+#endif
+
 /*
  * How to update a TSCH statistic.
  * Uses a hardcoded EWMA alpha value equal to 0.125 by default.
@@ -166,6 +176,46 @@ struct tsch_neighbor_stats {
 
 struct tsch_neighbor; /* Forward declaration */
 
+/*
+ * The phases of the slot operation timed by the profiler. Each phase
+ * covers the code run since the end of the previous one, or since the
+ * last wakeup: time spent sleeping or busy-waiting on the radio is
+ * never accounted for.
+ */
+enum tsch_stats_phase {
+  /* From the slot wakeup to the radio being on the slot's channel */
+  TSCH_STATS_PHASE_LINK_SELECTION,
+  /* Fetching the packet and updating the EB Sync-IE */
+  TSCH_STATS_PHASE_TX_PREPARE,
+  /* Securing or authenticating a frame or an ACK */
+  TSCH_STATS_PHASE_SECURITY,
+  /* Copying a frame or an ACK to the radio */
+  TSCH_STATS_PHASE_RADIO_PREPARE,
+  /* Starting the transmission of a frame or an ACK */
+  TSCH_STATS_PHASE_RADIO_TRANSMIT,
+  /* Reading and parsing an enhanced ACK */
+  TSCH_STATS_PHASE_ACK_PARSE,
+  /* Reading and parsing a received frame */
+  TSCH_STATS_PHASE_RX_PARSE,
+  /* Building an enhanced ACK */
+  TSCH_STATS_PHASE_ACK_PREPARE,
+  /* Post-processing and computing the next active slot */
+  TSCH_STATS_PHASE_SLOT_END,
+  TSCH_STATS_PHASE_COUNT, /* Not a phase */
+};
+
+struct tsch_stats_phase_profile {
+  /* total duration, in rtimer ticks */
+  uint64_t sum;
+  /* number of times the phase was executed */
+  uint32_t count;
+  /* shortest and longest duration, in rtimer ticks */
+  rtimer_clock_t min;
+  rtimer_clock_t max;
+  /* deadlines missed right after the phase */
+  uint16_t misses;
+};
+
 
 /************ External variables ***********/
 
@@ -194,7 +244,37 @@ struct tsch_neighbor_stats *tsch_stats_get_from_neighbor(struct tsch_neighbor *)
 
 void tsch_stats_reset_neighbor_stats(void);
 
-#else /* TSCH_STATS_ON */
+#endif /* TSCH_STATS_ON */
+
+#if TSCH_STATS_PROFILE
+
+/* Start timing a new phase. Called whenever the slot operation wakes up */
+void tsch_stats_profile_start(void);
+
+/* Account the time since the last start or mark to `phase` */
+void tsch_stats_profile_mark(enum tsch_stats_phase phase);
+
+/* Account a missed deadline to the last marked phase */
+void tsch_stats_profile_miss(void);
+
+/* Get the profile of a phase, or NULL if out of range */
+const struct tsch_stats_phase_profile *tsch_stats_profile_get(enum tsch_stats_phase phase);
+
+/* Get a short name of a phase, for printing */
+const char *tsch_stats_profile_phase_name(enum tsch_stats_phase phase);
+
+void tsch_stats_profile_reset(void);
+
+#else /* TSCH_STATS_PROFILE */
+
+#define tsch_stats_profile_start()
+#define tsch_stats_profile_mark(phase)
+#define tsch_stats_profile_miss()
+#define tsch_stats_profile_reset()
+
+#endif /* TSCH_STATS_PROFILE */
+
+#if !TSCH_STATS_ON
 
 #define tsch_stats_init()
 #define tsch_stats_tx_packet(n, mac_status, channel)
@@ -204,7 +284,7 @@ void tsch_stats_reset_neighbor_stats(void);
 #define tsch_stats_get_from_neighbor(neighbor) NULL
 #define tsch_stats_reset_neighbor_stats()
 
-#endif /* TSCH_STATS_ON */
+#endif /* !TSCH_STATS_ON */
 
 static inline uint8_t
 tsch_stats_channel_to_index(uint8_t channel)
@@ -44,6 +44,7 @@
 
 /********** Includes **********/
 
+#include "net/mac/tsch/tsch-conf.h"
 #include "net/mac/tsch/tsch-asn.h"
 #include "lib/list.h"
 #include "lib/ringbufindex.h"
@@ -91,6 +92,12 @@ struct tsch_slotframe {
   struct tsch_asn_divisor_t size;
   /* List of links belonging to this slotframe */
   LIST_STRUCT(links_list);
+#if TSCH_SCHEDULE_WITH_INDEX
+  /* Range of the schedule index holding this slotframe's links,
+   * sorted by timeslot */
+  uint16_t index_start;
+  uint16_t index_len;
+#endif /* TSCH_SCHEDULE_WITH_INDEX */
 };
 
 /** \brief TSCH packet information */
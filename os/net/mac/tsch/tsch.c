@@ -133,6 +133,10 @@ static uint8_t tsch_packet_seqno;
 static clock_time_t tsch_current_eb_period;
 /* Current period for keepalive output */
 static clock_time_t tsch_current_ka_timeout;
+#if TSCH_WITH_EB_SOLICITATION
+/* Was an EB solicited since the last one was enqueued? */
+static uint8_t is_eb_solicited;
+#endif /* TSCH_WITH_EB_SOLICITATION */
 
 /* For scheduling keepalive messages  */
 enum tsch_keepalive_status {
@@ -487,10 +491,34 @@ eb_input(struct input_packet *current_input)
           }
         }
       }
+
+#if TSCH_WITH_FAST_JOIN
+      if(tsch_is_associated) {
+        tsch_fast_join_eb_input(&current_input->rx_asn, current_input->channel);
+      }
+#endif /* TSCH_WITH_FAST_JOIN */
     }
   }
 }
 /*---------------------------------------------------------------------------*/
+#if TSCH_WITH_EB_SOLICITATION
+/* A node that is not part of the network asked for an EB: send one early,
+ * at most once per TSCH_EB_SOLICITATION_INTERVAL */
+static void
+beacon_request_input(void)
+{
+  static clock_time_t last_solicited_eb;
+
+  if(tsch_is_associated
+     && clock_time() - last_solicited_eb >= TSCH_EB_SOLICITATION_INTERVAL) {
+    LOG_INFO("EB solicited\n");
+    last_solicited_eb = clock_time();
+    is_eb_solicited = 1;
+    process_poll(&tsch_send_eb_process);
+  }
+}
+#endif /* TSCH_WITH_EB_SOLICITATION */
+/*---------------------------------------------------------------------------*/
 /* Process pending input packet(s) */
 static void
 tsch_rx_process_pending()
@@ -505,6 +533,12 @@ tsch_rx_process_pending()
     int is_eb = ret
       && frame.fcf.frame_version == FRAME802154_IEEE802154_2015
       && frame.fcf.frame_type == FRAME802154_BEACONFRAME;
+#if TSCH_WITH_EB_SOLICITATION
+    int is_beacon_request = ret
+      && frame.fcf.frame_type == FRAME802154_CMDFRAME
+      && frame.payload_len > 0
+      && frame.payload[0] == FRAME802154_BEACONREQ;
+#endif /* TSCH_WITH_EB_SOLICITATION */
 
     if(is_data) {
       /* Skip EBs and other control messages */
@@ -520,6 +554,11 @@ tsch_rx_process_pending()
     } else if(is_eb) {
       eb_input(current_input);
     }
+#if TSCH_WITH_EB_SOLICITATION
+    else if(is_beacon_request) {
+      beacon_request_input();
+    }
+#endif /* TSCH_WITH_EB_SOLICITATION */
 
     /* Remove input from ringbuf */
     ringbufindex_get(&input_ringbuf);
@@ -750,6 +789,9 @@ tsch_associate(const struct input_packet *input_eb, rtimer_clock_t timestamp)
 #endif
 
       tsch_association_count++;
+#if TSCH_WITH_FAST_JOIN
+      tsch_fast_join_eb_input(&ies.ie_asn, input_eb->channel);
+#endif /* TSCH_WITH_FAST_JOIN */
       LOG_INFO("association done (%u), sec %u, PAN ID %x, asn-%x.%"PRIx32", jp %u, timeslot id %u, hopping id %u, slotframe len %u with %u links, from ",
              tsch_association_count,
              tsch_is_pan_secured,
@@ -783,6 +825,10 @@ PT_THREAD(tsch_scan(struct pt *pt))
   static struct etimer scan_timer;
   /* Time when we started scanning on current_channel */
   static clock_time_t current_channel_since;
+  /* How long to scan on current_channel */
+  static clock_time_t current_channel_duration;
+  /* Is the radio following the network's EB channel? */
+  static uint8_t is_following;
 
   TSCH_ASN_INIT(tsch_current_asn, 0, 0);
 
@@ -798,14 +844,34 @@ PT_THREAD(tsch_scan(struct pt *pt))
     int is_packet_pending = 0;
     clock_time_t now_time = clock_time();
 
+#if TSCH_WITH_FAST_JOIN
+    /* While following the network, the radio is also used from the
+     * fast-join rtimer, which skips its slot when the lock is taken */
+    tsch_get_lock();
+    if(tsch_fast_join_follow()) {
+      /* The radio follows the network's EB channel, slot by slot */
+      is_following = 1;
+    } else
+#endif /* TSCH_WITH_FAST_JOIN */
     /* Switch to a (new) channel for scanning */
-    if(current_channel == 0 || now_time - current_channel_since > TSCH_CHANNEL_SCAN_DURATION) {
-      /* Pick a channel at random in TSCH_JOIN_HOPPING_SEQUENCE */
-      uint8_t scan_channel = TSCH_JOIN_HOPPING_SEQUENCE[
-          random_rand() % sizeof(TSCH_JOIN_HOPPING_SEQUENCE)];
+    if(current_channel == 0 || is_following
+       || now_time - current_channel_since > current_channel_duration) {
+      uint8_t scan_channel = 0;
+
+      current_channel_duration = TSCH_CHANNEL_SCAN_DURATION;
+#if TSCH_WITH_FAST_JOIN
+      /* Scan the channels of the network we were part of */
+      scan_channel = tsch_fast_join_scan_channel(&current_channel_duration);
+#endif /* TSCH_WITH_FAST_JOIN */
+      if(scan_channel == 0) {
+        /* Pick a channel at random in TSCH_JOIN_HOPPING_SEQUENCE */
+        scan_channel = TSCH_JOIN_HOPPING_SEQUENCE[
+            random_rand() % sizeof(TSCH_JOIN_HOPPING_SEQUENCE)];
+      }
 
       NETSTACK_RADIO.set_value(RADIO_PARAM_CHANNEL, scan_channel);
       current_channel = scan_channel;
+      is_following = 0;
       LOG_INFO("scanning on channel %u\n", scan_channel);
 
       current_channel_since = now_time;
@@ -822,17 +888,31 @@ PT_THREAD(tsch_scan(struct pt *pt))
     }
 
     if(is_packet_pending) {
-      rtimer_clock_t t1;
       /* Read packet */
       input_eb.len = NETSTACK_RADIO.read(input_eb.payload, TSCH_PACKET_MAX_LEN);
-
+      /* The channel is not known when following the network */
+      input_eb.channel = is_following ? 0 : current_channel;
       if(input_eb.len > 0) {
         /* Save packet timestamp */
         NETSTACK_RADIO.get_object(RADIO_PARAM_LAST_PACKET_TIMESTAMP, &t0, sizeof(rtimer_clock_t));
+      }
+    }
+#if TSCH_WITH_FAST_JOIN
+    /* Association takes the lock itself */
+    tsch_release_lock();
+#endif /* TSCH_WITH_FAST_JOIN */
+
+    if(is_packet_pending) {
+      rtimer_clock_t t1;
+      if(input_eb.len > 0) {
         t1 = RTIMER_NOW();
 
         /* Parse EB and attempt to associate */
-        LOG_INFO("scan: received packet (%u bytes) on channel %u\n", input_eb.len, current_channel);
+        if(is_following) {
+          LOG_INFO("scan: received packet (%u bytes) following the network\n", input_eb.len);
+        } else {
+          LOG_INFO("scan: received packet (%u bytes) on channel %u\n", input_eb.len, current_channel);
+        }
 
         /* Sanity-check the timestamp */
         if(ABS(RTIMER_CLOCK_DIFF(t0, t1)) < 2ul * RTIMER_SECOND) {
@@ -847,6 +927,9 @@ PT_THREAD(tsch_scan(struct pt *pt))
     }
 
     if(tsch_is_associated) {
+#if TSCH_WITH_FAST_JOIN
+      tsch_fast_join_scan_stop();
+#endif /* TSCH_WITH_FAST_JOIN */
       /* End of association, turn the radio off */
       NETSTACK_RADIO.off();
     } else if(!tsch_is_coordinator) {
@@ -889,6 +972,11 @@ PROCESS_THREAD(tsch_process, ev, data)
     LOG_WARN("leaving the network, stats: tx %lu, rx %lu, sync %lu\n",
       tx_count, rx_count, sync_count);
 
+#if TSCH_WITH_FAST_JOIN
+    /* Record the network timing, before it is reset */
+    tsch_fast_join_leaving();
+#endif /* TSCH_WITH_FAST_JOIN */
+
     /* Will need to re-synchronize */
     tsch_reset();
   }
@@ -961,7 +1049,18 @@ PROCESS_THREAD(tsch_send_eb_process, ev, data)
       delay = TSCH_EB_PERIOD;
     }
     etimer_set(&eb_timer, delay);
+#if TSCH_WITH_EB_SOLICITATION
+    PROCESS_WAIT_UNTIL(etimer_expired(&eb_timer) || is_eb_solicited);
+    if(is_eb_solicited) {
+      /* Send the next EB early, after a random delay: all neighbors that
+       * received the Beacon Request would otherwise send theirs at once */
+      etimer_set(&eb_timer, random_rand() % TSCH_EB_SOLICITATION_INTERVAL);
+      PROCESS_WAIT_UNTIL(etimer_expired(&eb_timer));
+      is_eb_solicited = 0;
+    }
+#else /* TSCH_WITH_EB_SOLICITATION */
     PROCESS_WAIT_UNTIL(etimer_expired(&eb_timer));
+#endif /* TSCH_WITH_EB_SOLICITATION */
   }
   PROCESS_END();
 }
@@ -996,9 +1095,11 @@ tsch_init(void)
   radio_value_t radio_max_payload_len;
 
   rtimer_clock_t t;
+  /* Through a variable: comparing an array address with NULL is a warning */
+  const uint16_t *timing_template = TSCH_DEFAULT_TIMESLOT_TIMING;
 
   /* Check that the platform provides a TSCH timeslot timing template */
-  if(TSCH_DEFAULT_TIMESLOT_TIMING == NULL) {
+  if(timing_template == NULL) {
     LOG_ERR("! platform does not provide a timeslot timing template.\n");
     return;
   }
@@ -1060,6 +1161,9 @@ tsch_init(void)
   tsch_queue_init();
   tsch_schedule_init();
   tsch_log_init();
+#if TSCH_WITH_FAST_JOIN
+  tsch_fast_join_init();
+#endif /* TSCH_WITH_FAST_JOIN */
   ringbufindex_init(&input_ringbuf, TSCH_MAX_INCOMING_PACKETS);
   ringbufindex_init(&dequeued_ringbuf, TSCH_DEQUEUED_ARRAY_SIZE);
 
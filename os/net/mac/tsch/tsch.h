@@ -62,6 +62,7 @@ frequency hopping for enhanced reliability.
 #include "net/mac/tsch/tsch-schedule.h"
 #include "net/mac/tsch/tsch-stats.h"
 #include "net/mac/tsch/tsch-roots.h"
+#include "net/mac/tsch/tsch-fast-join.h"
 #if UIP_CONF_IPV6_RPL
 #include "net/mac/tsch/tsch-rpl.h"
 #endif /* UIP_CONF_IPV6_RPL */
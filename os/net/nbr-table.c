@@ -457,6 +457,27 @@ nbr_table_get_from_lladdr(const nbr_table_t *table, const linkaddr_t *lladdr)
   return nbr_get_bit(used_map, table, item) ? item : NULL;
 }
 /*---------------------------------------------------------------------------*/
+/* Get the index of an item, between 0 and NBR_TABLE_MAX_NEIGHBORS - 1, or
+ * -1 if it is not in the table. The index stays the same until the item
+ * is removed, and is shared with the neighbor's items in other tables. */
+int
+nbr_table_get_index(const nbr_table_t *table, const void *item)
+{
+  return nbr_get_bit(used_map, table, item) ? index_from_item(table, item) : -1;
+}
+/*---------------------------------------------------------------------------*/
+/* Get an item from its index, or NULL if there is no such item in the table */
+void *
+nbr_table_get_from_index(const nbr_table_t *table, int index)
+{
+  void *item;
+  if(index < 0 || index >= NBR_TABLE_MAX_NEIGHBORS) {
+    return NULL;
+  }
+  item = item_from_index(table, index);
+  return nbr_get_bit(used_map, table, item) ? item : NULL;
+}
+/*---------------------------------------------------------------------------*/
 /* Removes a neighbor from the current table (unset "used" bit) */
 int
 nbr_table_remove(const nbr_table_t *table, const void *item)
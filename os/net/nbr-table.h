@@ -125,6 +125,10 @@ nbr_table_item_t *nbr_table_add_lladdr(const nbr_table_t *table,
                                        const void *data);
 nbr_table_item_t *nbr_table_get_from_lladdr(const nbr_table_t *table,
                                             const linkaddr_t *lladdr);
+int nbr_table_get_index(const nbr_table_t *table,
+                        const nbr_table_item_t *item);
+nbr_table_item_t *nbr_table_get_from_index(const nbr_table_t *table,
+                                           int index);
 /** @} */
 
 /** \name Neighbor tables: set flags (unused, locked, unlocked) */
@@ -300,6 +300,29 @@
 #define RPL_WITH_DAO_ACK 0
 #endif /* RPL_CONF_WITH_DAO_ACK */
 
+/*
+ * The maximum number of Target options in a DAO sent by a storing-mode
+ * node. With more than one, the DAOs of the children are not forwarded
+ * one by one: the routes they add or change are sent together to the
+ * preferred parent after RPL_DAO_AGGREGATION_DELAY, and each DAO of the
+ * node itself refreshes all routes of its sub-DODAG, so that the
+ * children's periodic DAOs can be acknowledged locally. DAOs are also
+ * limited by the size of the uIP buffer, and a DAO from a child with more
+ * targets to forward than RPL_DAO_MAX_TARGETS is refused. With 1, DAOs are
+ * handled as without aggregation.
+ */
+#ifdef RPL_CONF_DAO_MAX_TARGETS
+#define RPL_DAO_MAX_TARGETS RPL_CONF_DAO_MAX_TARGETS
+#else
+#define RPL_DAO_MAX_TARGETS 1
+#endif /* RPL_CONF_DAO_MAX_TARGETS */
+
+#ifdef RPL_CONF_DAO_AGGREGATION_DELAY
+#define RPL_DAO_AGGREGATION_DELAY RPL_CONF_DAO_AGGREGATION_DELAY
+#else
+#define RPL_DAO_AGGREGATION_DELAY (CLOCK_SECOND / 2)
+#endif /* RPL_CONF_DAO_AGGREGATION_DELAY */
+
 /*
  * RPL REPAIR ON DAO NACK. When enabled, DAO NACK will trigger a local
  * repair in order to quickly find a new parent to send DAOs to.
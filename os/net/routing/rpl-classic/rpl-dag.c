@@ -660,6 +660,9 @@ rpl_free_instance(rpl_instance_t *instance)
   ctimer_stop(&instance->dio_timer);
   ctimer_stop(&instance->dao_timer);
   ctimer_stop(&instance->dao_lifetime_timer);
+#if RPL_DAO_MAX_TARGETS > 1
+  ctimer_stop(&instance->dao_aggregation_timer);
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
 
   if(default_instance == instance) {
     default_instance = NULL;
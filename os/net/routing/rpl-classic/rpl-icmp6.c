@@ -641,96 +641,458 @@ dio_output(rpl_instance_t *instance, uip_ipaddr_t *uc_addr)
 #endif /* RPL_LEAF_ONLY */
 }
 /*---------------------------------------------------------------------------*/
-static void
-dao_input_storing(void)
-{
 #if RPL_WITH_STORING
-  uip_ipaddr_t dao_sender_addr;
-  rpl_dag_t *dag;
+#if RPL_DAO_MAX_TARGETS > 1
+/* A route marked for our parent by a DAO, and its state before */
+struct dao_in_mark {
+  uip_ds6_route_t *route;
+  uint8_t state_flags;
+  uint8_t dao_seqno_in;
+  uint8_t dao_seqno_out;
+};
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+
+/* A DAO received in storing mode, while its targets are processed */
+struct dao_in {
   rpl_instance_t *instance;
-  unsigned char *buffer;
-  uint16_t sequence;
-  uint8_t instance_id;
-  uint8_t lifetime;
-  uint8_t prefixlen;
+  rpl_dag_t *dag;
+  uip_ipaddr_t sender;
+  uint8_t sequence;
   uint8_t flags;
-  uint8_t subopt_type;
-  uip_ipaddr_t prefix;
-  uip_ds6_route_t *rep;
-  uint8_t buffer_length;
-  int pos;
-  int len;
-  int i;
-  int learned_from;
+  uint8_t learned_from;
+  uint8_t is_root;
+#if RPL_DAO_MAX_TARGETS > 1
+  uint8_t targets;
+  /* Acknowledge the DAO now: all its targets can be acknowledged */
+  uint8_t ack;
+  /* Acknowledge the DAO now in any case */
+  uint8_t nopath;
+  /* Forward the DAO to our parent as it is, with out_seq */
+  uint8_t forward;
+  uint8_t out_seq;
+  /* Some of the targets will be sent in a DAO of our own */
+  uint8_t aggregate;
+  /* The routes to restore if the DAO is dropped after all */
+  uint8_t marks;
+  struct dao_in_mark mark[RPL_DAO_MAX_TARGETS];
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+};
+/*---------------------------------------------------------------------------*/
+/* Reads the header of a DAO, and checks that it is for our DAG and does
+   not reveal a loop. Returns the offset of its first option, or -1 if
+   the DAO must be ignored. */
+static int
+dao_input_storing_header(struct dao_in *dao, unsigned char *buffer)
+{
   rpl_parent_t *parent;
-  uip_ds6_nbr_t *nbr;
-  int is_root;
-
-  prefixlen = 0;
-  parent = NULL;
-  memset(&prefix, 0, sizeof(prefix));
-
-  uip_ipaddr_copy(&dao_sender_addr, &UIP_IP_BUF->srcipaddr);
+  int pos;
 
-  buffer = UIP_ICMP_PAYLOAD;
-  buffer_length = uip_len - uip_l3_icmp_hdr_len;
+  uip_ipaddr_copy(&dao->sender, &UIP_IP_BUF->srcipaddr);
 
   pos = 0;
-  instance_id = buffer[pos++];
-
-  instance = rpl_get_instance(instance_id);
-
-  lifetime = instance->default_lifetime;
+  dao->instance = rpl_get_instance(buffer[pos++]);
 
-  flags = buffer[pos++];
+  dao->flags = buffer[pos++];
   /* reserved */
   pos++;
-  sequence = buffer[pos++];
+  dao->sequence = buffer[pos++];
 
-  dag = instance->current_dag;
-  is_root = (dag->rank == ROOT_RANK(instance));
+  dao->dag = dao->instance->current_dag;
+  dao->is_root = (dao->dag->rank == ROOT_RANK(dao->instance));
 
   /* Is the DAG ID present? */
-  if(flags & RPL_DAO_D_FLAG) {
-    if(memcmp(&dag->dag_id, &buffer[pos], sizeof(dag->dag_id))) {
+  if(dao->flags & RPL_DAO_D_FLAG) {
+    if(memcmp(&dao->dag->dag_id, &buffer[pos], sizeof(dao->dag->dag_id))) {
       LOG_INFO("Ignoring a DAO for a DAG different from ours\n");
-      return;
+      return -1;
     }
     pos += 16;
   }
 
-  learned_from = uip_is_addr_mcast(&dao_sender_addr) ?
+  dao->learned_from = uip_is_addr_mcast(&dao->sender) ?
     RPL_ROUTE_FROM_MULTICAST_DAO : RPL_ROUTE_FROM_UNICAST_DAO;
 
   /* Destination Advertisement Object */
   LOG_DBG("Received a (%s) DAO with sequence number %u from ",
-          learned_from == RPL_ROUTE_FROM_UNICAST_DAO ? "unicast" : "multicast",
-          sequence);
-  LOG_DBG_6ADDR(&dao_sender_addr);
+          dao->learned_from == RPL_ROUTE_FROM_UNICAST_DAO ? "unicast" : "multicast",
+          dao->sequence);
+  LOG_DBG_6ADDR(&dao->sender);
   LOG_DBG_("\n");
 
-  if(learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
+  if(dao->learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
     /* Check whether this is a DAO forwarding loop. */
-    parent = rpl_find_parent(dag, &dao_sender_addr);
+    parent = rpl_find_parent(dao->dag, &dao->sender);
     /* Check if this is a new DAO registration with an "illegal" rank.
        If we already route to this node, then it is likely. */
     if(parent != NULL &&
-       DAG_RANK(parent->rank, instance) < DAG_RANK(dag->rank, instance)) {
+       DAG_RANK(parent->rank, dao->instance) < DAG_RANK(dao->dag->rank, dao->instance)) {
       LOG_WARN("Loop detected when receiving a unicast DAO from a node with a lower rank! (%u < %u)\n",
-               DAG_RANK(parent->rank, instance), DAG_RANK(dag->rank, instance));
+               DAG_RANK(parent->rank, dao->instance), DAG_RANK(dao->dag->rank, dao->instance));
       parent->rank = RPL_INFINITE_RANK;
       parent->flags |= RPL_PARENT_FLAG_UPDATED;
-      return;
+      return -1;
     }
 
     /* If we get the DAO from our parent, we also have a loop. */
-    if(parent != NULL && parent == dag->preferred_parent) {
+    if(parent != NULL && parent == dao->dag->preferred_parent) {
       LOG_WARN("Loop detected when receiving a unicast DAO from our parent\n");
       parent->rank = RPL_INFINITE_RANK;
       parent->flags |= RPL_PARENT_FLAG_UPDATED;
-      return;
+      return -1;
+    }
+  }
+  return pos;
+}
+#endif /* RPL_WITH_STORING */
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+/*---------------------------------------------------------------------------*/
+/* Saves the state of a route before a target marks it. Returns 0 if the
+   DAO has more targets to mark than we can restore. */
+static int
+save_route_state(struct dao_in *dao, uip_ds6_route_t *rep)
+{
+  struct dao_in_mark *m;
+
+  if(dao->marks >= RPL_DAO_MAX_TARGETS) {
+    LOG_WARN("More than %u targets to forward in a DAO\n",
+             RPL_DAO_MAX_TARGETS);
+    return 0;
+  }
+  m = &dao->mark[dao->marks++];
+  m->route = rep;
+  m->state_flags = rep->state.state_flags;
+  m->dao_seqno_in = rep->state.dao_seqno_in;
+  m->dao_seqno_out = rep->state.dao_seqno_out;
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Undoes the marks of a DAO that is dropped, so that the routes of its
+   first targets are not sent to our parent nor wait for a DAO ACK. */
+static void
+restore_route_state(struct dao_in *dao)
+{
+  struct dao_in_mark *m;
+
+  /* In reverse order, in case a route was marked twice */
+  while(dao->marks > 0) {
+    m = &dao->mark[--dao->marks];
+    m->route->state.state_flags = m->state_flags;
+    m->route->state.dao_seqno_in = m->dao_seqno_in;
+    m->route->state.dao_seqno_out = m->dao_seqno_out;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Use the same outgoing sequence number for all targets of the DAO, if
+   it is forwarded as it is. Returns 0 if the route cannot be marked. */
+static int
+set_dao_fwd_seq(struct dao_in *dao, uip_ds6_route_t *rep)
+{
+  if(!save_route_state(dao, rep)) {
+    return 0;
+  }
+  if(!dao->forward) {
+    dao->forward = 1;
+    dao->out_seq = prepare_for_dao_fwd(dao->sequence, rep);
+    return 1;
+  }
+  rep->state.dao_seqno_in = dao->sequence;
+  rep->state.dao_seqno_out = dao->out_seq;
+  RPL_ROUTE_SET_DAO_PENDING(rep);
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Handles one target of a DAO. Returns 0 if the DAO must be dropped. */
+static int
+dao_input_storing_target(struct dao_in *dao, uip_ipaddr_t *prefix,
+                         uint8_t prefixlen, uint8_t lifetime)
+{
+  rpl_instance_t *instance;
+  rpl_dag_t *dag;
+  uip_ds6_route_t *rep;
+  uip_ds6_nbr_t *nbr;
+  int has_parent;
+  int known;
+
+  instance = dao->instance;
+  dag = dao->dag;
+  has_parent = dag->preferred_parent != NULL &&
+    rpl_parent_get_ipaddr(dag->preferred_parent) != NULL;
+  dao->targets++;
+
+  LOG_INFO("DAO lifetime: %u, prefix length: %u prefix: ",
+           (unsigned)lifetime, (unsigned)prefixlen);
+  LOG_INFO_6ADDR(prefix);
+  LOG_INFO_("\n");
+
+#if RPL_WITH_MULTICAST
+  if(uip_is_addr_mcast_global(prefix)) {
+    mcast_group = uip_mcast6_route_add(prefix);
+    if(mcast_group) {
+      mcast_group->dag = dag;
+      mcast_group->lifetime = RPL_LIFETIME(instance, lifetime);
+    }
+    /* Multicast routes are not acknowledged, only forwarded */
+    dao->ack = 0;
+    if(dao->learned_from == RPL_ROUTE_FROM_UNICAST_DAO && has_parent) {
+      dao->forward = 1;
+    }
+    return 1;
+  }
+#endif
+
+  rep = uip_ds6_route_lookup(prefix);
+
+  if(lifetime == RPL_ZERO_LIFETIME) {
+    LOG_INFO("No-Path DAO received\n");
+    /* Regardless of whether we remove it or not -- ACK the request. */
+    dao->nopath = 1;
+    /* No-Path DAO received; invoke the route purging routine. */
+    if(rep != NULL &&
+       !RPL_ROUTE_IS_NOPATH_RECEIVED(rep) &&
+       rep->length == prefixlen &&
+       uip_ds6_route_nexthop(rep) != NULL &&
+       uip_ipaddr_cmp(uip_ds6_route_nexthop(rep), &dao->sender)) {
+      LOG_DBG("Setting expiration timer for prefix ");
+      LOG_DBG_6ADDR(prefix);
+      LOG_DBG_("\n");
+      RPL_ROUTE_SET_NOPATH_RECEIVED(rep);
+      rep->state.lifetime = RPL_NOPATH_REMOVAL_DELAY;
+
+      /* We forward the incoming No-Path DAO to our parent, if we have
+         one. */
+      if(has_parent && !set_dao_fwd_seq(dao, rep)) {
+        return 0;
+      }
+    }
+    return 1;
+  }
+
+  LOG_INFO("Adding DAO route\n");
+
+  /* Update and add neighbor, and fail if there is no room. */
+  nbr = rpl_icmp6_update_nbr_table(&dao->sender,
+                                   NBR_TABLE_REASON_RPL_DAO, instance);
+  if(nbr == NULL) {
+    LOG_ERR("Out of memory, dropping DAO from ");
+    LOG_ERR_6ADDR(&dao->sender);
+    LOG_ERR_(", ");
+    LOG_ERR_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
+    LOG_ERR_("\n");
+    if(dao->flags & RPL_DAO_K_FLAG) {
+      /* Signal the failure to add the node. */
+      dao_ack_output(instance, &dao->sender, dao->sequence,
+                     dao->is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
+                     RPL_DAO_ACK_UNABLE_TO_ACCEPT);
+    }
+    return 0;
+  }
+
+  /* The parent already has the route, which our own DAOs keep fresh */
+  known = rep != NULL &&
+    !RPL_ROUTE_IS_NOPATH_RECEIVED(rep) &&
+    !RPL_ROUTE_IS_DAO_PENDING(rep) &&
+    !RPL_ROUTE_IS_DAO_FWD(rep) &&
+    uip_ds6_route_nexthop(rep) != NULL &&
+    uip_ipaddr_cmp(uip_ds6_route_nexthop(rep), &dao->sender);
+
+  rep = rpl_add_route(dag, prefix, prefixlen, &dao->sender);
+  if(rep == NULL) {
+    RPL_STAT(rpl_stats.mem_overflows++);
+    LOG_ERR("Could not add a route after receiving a DAO\n");
+    if(dao->flags & RPL_DAO_K_FLAG) {
+      /* Signal the failure to add the node. */
+      dao_ack_output(instance, &dao->sender, dao->sequence,
+                     dao->is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
+                     RPL_DAO_ACK_UNABLE_TO_ACCEPT);
+    }
+    return 0;
+  }
+
+  /* Set the lifetime and clear the NOPATH bit. */
+  rep->state.lifetime = RPL_LIFETIME(instance, lifetime);
+  rep->state.dao_lifetime = lifetime;
+  RPL_ROUTE_CLEAR_NOPATH_RECEIVED(rep);
+
+  if(dao->learned_from != RPL_ROUTE_FROM_UNICAST_DAO) {
+    return 1;
+  }
+
+  /*
+   * Check if this route is already installed and that we can
+   * acknowledge it now! Not pending and same sequence number
+   * means that we can acknowledge it. E.g., the route is
+   * installed already, so it will not take any more room that
+   * it already takes. Hence, it should be OK.
+   */
+  if(!((!RPL_ROUTE_IS_DAO_PENDING(rep) &&
+        rep->state.dao_seqno_in == dao->sequence) ||
+       dao->is_root) && !known) {
+    dao->ack = 0;
+  }
+
+  if(!has_parent) {
+    return 1;
+  }
+
+  if(!known) {
+    if(!save_route_state(dao, rep)) {
+      return 0;
+    }
+    /* Send the route with the next DAO to our parent, and relay the
+       parent's DAO-ACK */
+    RPL_ROUTE_SET_DAO_FWD(rep);
+    if(dao->flags & RPL_DAO_K_FLAG) {
+      rep->state.dao_seqno_in = dao->sequence;
+      RPL_ROUTE_SET_DAO_PENDING(rep);
+    }
+    dao->aggregate = 1;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Handles the Target options between start and end, with the given
+   lifetime. Returns 0 if the DAO must be dropped. */
+static int
+dao_input_storing_targets(struct dao_in *dao, unsigned char *buffer,
+                          int start, int end, uint8_t lifetime)
+{
+  uip_ipaddr_t prefix;
+  uint8_t prefixlen;
+  int len;
+  int i;
+
+  for(i = start; i < end; i += len) {
+    if(buffer[i] == RPL_OPTION_PAD1) {
+      len = 1;
+      continue;
+    }
+    /* The option consists of a two-byte header and a payload. */
+    len = 2 + buffer[i + 1];
+    if(buffer[i] != RPL_OPTION_TARGET) {
+      continue;
+    }
+
+    /* Handle the target option. */
+    prefixlen = buffer[i + 3];
+    if(prefixlen == 0) {
+      /* Ignore option targets with a prefix length of 0. */
+      continue;
+    }
+    if(prefixlen > 128) {
+      LOG_ERR("Too large target prefix length %d\n", prefixlen);
+      return 0;
+    }
+    if(i + 4 + ((prefixlen + 7) / CHAR_BIT) > end) {
+      LOG_ERR("Insufficient space to copy RPL Target of %d bits\n",
+              prefixlen);
+      return 0;
+    }
+    memset(&prefix, 0, sizeof(prefix));
+    memcpy(&prefix, buffer + i + 4, (prefixlen + 7) / CHAR_BIT);
+
+    if(!dao_input_storing_target(dao, &prefix, prefixlen, lifetime)) {
+      return 0;
+    }
+  }
+  return 1;
+}
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
+/*---------------------------------------------------------------------------*/
+static void
+dao_input_storing(void)
+{
+#if RPL_WITH_STORING
+  struct dao_in dao;
+  unsigned char *buffer;
+  uint16_t buffer_length;
+  uint8_t lifetime;
+  int pos;
+  int len;
+  int i;
+#if RPL_DAO_MAX_TARGETS > 1
+  int group;
+#else /* RPL_DAO_MAX_TARGETS > 1 */
+  uint8_t prefixlen;
+  uint8_t subopt_type;
+  uip_ipaddr_t prefix;
+  uip_ds6_route_t *rep;
+  uip_ds6_nbr_t *nbr;
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+
+  memset(&dao, 0, sizeof(dao));
+
+  buffer = UIP_ICMP_PAYLOAD;
+  buffer_length = uip_len - uip_l3_icmp_hdr_len;
+
+  pos = dao_input_storing_header(&dao, buffer);
+  if(pos < 0) {
+    return;
+  }
+  lifetime = dao.instance->default_lifetime;
+
+#if RPL_DAO_MAX_TARGETS > 1
+  dao.ack = 1;
+
+  /*
+   * A DAO carries one or more groups of Target options, each followed by
+   * the Transit Information option with the lifetime of its targets.
+   */
+  group = pos;
+  for(i = pos; i < buffer_length; i += len) {
+    if(buffer[i] == RPL_OPTION_PAD1) {
+      len = 1;
+    } else {
+      /* The option consists of a two-byte header and a payload. */
+      len = 2 + buffer[i + 1];
+    }
+
+    if(buffer[i] == RPL_OPTION_TRANSIT) {
+      /* The path sequence and control are ignored. */
+      /*      pathcontrol = buffer[i + 3];
+              pathsequence = buffer[i + 4];*/
+      lifetime = buffer[i + 5];
+      /* The parent address is also ignored. */
+      if(!dao_input_storing_targets(&dao, buffer, group, i, lifetime)) {
+        restore_route_state(&dao);
+        return;
+      }
+      group = i + len;
     }
   }
+  /* Targets with no Transit Information option after them */
+  if(!dao_input_storing_targets(&dao, buffer, group, buffer_length,
+                                lifetime)) {
+    restore_route_state(&dao);
+    return;
+  }
+
+  if(dao.forward) {
+    LOG_DBG("Forwarding DAO to parent ");
+    LOG_DBG_6ADDR(rpl_parent_get_ipaddr(dao.dag->preferred_parent));
+    LOG_DBG_(" in seq: %d out seq: %d\n", dao.sequence, dao.out_seq);
+
+    buffer = UIP_ICMP_PAYLOAD;
+    buffer[3] = dao.out_seq; /* add an outgoing seq no before fwd */
+    uip_icmp6_send(rpl_parent_get_ipaddr(dao.dag->preferred_parent),
+                   ICMP6_RPL, RPL_CODE_DAO, buffer_length);
+  }
+
+  if(dao.aggregate) {
+    rpl_schedule_dao_aggregation(dao.instance);
+  }
+
+  if((dao.flags & RPL_DAO_K_FLAG) &&
+     (dao.nopath ||
+      (dao.learned_from == RPL_ROUTE_FROM_UNICAST_DAO &&
+       dao.targets > 0 && dao.ack))) {
+    LOG_DBG("Sending DAO ACK\n");
+    uipbuf_clear();
+    dao_ack_output(dao.instance, &dao.sender, dao.sequence,
+                   RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+  }
+#else /* RPL_DAO_MAX_TARGETS > 1 */
+  prefixlen = 0;
+  memset(&prefix, 0, sizeof(prefix));
 
   /* Check if there are any RPL options present. */
   for(i = pos; i < buffer_length; i += len) {
@@ -786,8 +1148,8 @@ dao_input_storing(void)
     rep = NULL;
     mcast_group = uip_mcast6_route_add(&prefix);
     if(mcast_group) {
-      mcast_group->dag = dag;
-      mcast_group->lifetime = RPL_LIFETIME(instance, lifetime);
+      mcast_group->dag = dao.dag;
+      mcast_group->lifetime = RPL_LIFETIME(dao.instance, lifetime);
     }
     goto fwd_dao;
   }
@@ -802,7 +1164,7 @@ dao_input_storing(void)
        !RPL_ROUTE_IS_NOPATH_RECEIVED(rep) &&
        rep->length == prefixlen &&
        uip_ds6_route_nexthop(rep) != NULL &&
-       uip_ipaddr_cmp(uip_ds6_route_nexthop(rep), &dao_sender_addr)) {
+       uip_ipaddr_cmp(uip_ds6_route_nexthop(rep), &dao.sender)) {
       LOG_DBG("Setting expiration timer for prefix ");
       LOG_DBG_6ADDR(&prefix);
       LOG_DBG_("\n");
@@ -811,27 +1173,27 @@ dao_input_storing(void)
 
       /* We forward the incoming No-Path DAO to our parent, if we have
          one. */
-      if(dag->preferred_parent != NULL &&
-         rpl_parent_get_ipaddr(dag->preferred_parent) != NULL) {
+      if(dao.dag->preferred_parent != NULL &&
+         rpl_parent_get_ipaddr(dao.dag->preferred_parent) != NULL) {
         uint8_t out_seq;
-        out_seq = prepare_for_dao_fwd(sequence, rep);
+        out_seq = prepare_for_dao_fwd(dao.sequence, rep);
 
         LOG_DBG("Forwarding No-path DAO to parent - out_seq:%d",
                 out_seq);
-        LOG_DBG_6ADDR(rpl_parent_get_ipaddr(dag->preferred_parent));
+        LOG_DBG_6ADDR(rpl_parent_get_ipaddr(dao.dag->preferred_parent));
         LOG_DBG_("\n");
 
         buffer = UIP_ICMP_PAYLOAD;
         buffer[3] = out_seq; /* add an outgoing seq no before fwd */
-        uip_icmp6_send(rpl_parent_get_ipaddr(dag->preferred_parent),
+        uip_icmp6_send(rpl_parent_get_ipaddr(dao.dag->preferred_parent),
                        ICMP6_RPL, RPL_CODE_DAO, buffer_length);
       }
     }
     /* Regardless of whether we remove it or not -- ACK the request. */
-    if(flags & RPL_DAO_K_FLAG) {
+    if(dao.flags & RPL_DAO_K_FLAG) {
       /* Indicate that we accepted the no-path DAO. */
       uipbuf_clear();
-      dao_ack_output(instance, &dao_sender_addr, sequence,
+      dao_ack_output(dao.instance, &dao.sender, dao.sequence,
                      RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
     }
     return;
@@ -840,48 +1202,48 @@ dao_input_storing(void)
   LOG_INFO("Adding DAO route\n");
 
   /* Update and add neighbor, and fail if there is no room. */
-  nbr = rpl_icmp6_update_nbr_table(&dao_sender_addr,
-                                   NBR_TABLE_REASON_RPL_DAO, instance);
+  nbr = rpl_icmp6_update_nbr_table(&dao.sender,
+                                   NBR_TABLE_REASON_RPL_DAO, dao.instance);
   if(nbr == NULL) {
     LOG_ERR("Out of memory, dropping DAO from ");
-    LOG_ERR_6ADDR(&dao_sender_addr);
+    LOG_ERR_6ADDR(&dao.sender);
     LOG_ERR_(", ");
     LOG_ERR_LLADDR(packetbuf_addr(PACKETBUF_ADDR_SENDER));
     LOG_ERR_("\n");
-    if(flags & RPL_DAO_K_FLAG) {
+    if(dao.flags & RPL_DAO_K_FLAG) {
       /* Signal the failure to add the node. */
-      dao_ack_output(instance, &dao_sender_addr, sequence,
-                     is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
+      dao_ack_output(dao.instance, &dao.sender, dao.sequence,
+                     dao.is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
                      RPL_DAO_ACK_UNABLE_TO_ACCEPT);
     }
     return;
   }
 
-  rep = rpl_add_route(dag, &prefix, prefixlen, &dao_sender_addr);
+  rep = rpl_add_route(dao.dag, &prefix, prefixlen, &dao.sender);
   if(rep == NULL) {
     RPL_STAT(rpl_stats.mem_overflows++);
     LOG_ERR("Could not add a route after receiving a DAO\n");
-    if(flags & RPL_DAO_K_FLAG) {
+    if(dao.flags & RPL_DAO_K_FLAG) {
       /* Signal the failure to add the node. */
-      dao_ack_output(instance, &dao_sender_addr, sequence,
-                     is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
+      dao_ack_output(dao.instance, &dao.sender, dao.sequence,
+                     dao.is_root ? RPL_DAO_ACK_UNABLE_TO_ADD_ROUTE_AT_ROOT :
                      RPL_DAO_ACK_UNABLE_TO_ACCEPT);
     }
     return;
   }
 
   /* Set the lifetime and clear the NOPATH bit. */
-  rep->state.lifetime = RPL_LIFETIME(instance, lifetime);
+  rep->state.lifetime = RPL_LIFETIME(dao.instance, lifetime);
   RPL_ROUTE_CLEAR_NOPATH_RECEIVED(rep);
 
 #if RPL_WITH_MULTICAST
 fwd_dao:
 #endif
 
-  if(learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
+  if(dao.learned_from == RPL_ROUTE_FROM_UNICAST_DAO) {
     int should_ack = 0;
 
-    if(flags & RPL_DAO_K_FLAG) {
+    if(dao.flags & RPL_DAO_K_FLAG) {
       if(rep != NULL) {
         /*
          * Check if this route is already installed and that we can
@@ -891,44 +1253,45 @@ fwd_dao:
          * it already takes. Hence, it should be OK.
          */
         if((!RPL_ROUTE_IS_DAO_PENDING(rep) &&
-            rep->state.dao_seqno_in == sequence) ||
-           dag->rank == ROOT_RANK(instance)) {
+            rep->state.dao_seqno_in == dao.sequence) ||
+           dao.dag->rank == ROOT_RANK(dao.instance)) {
           should_ack = 1;
         }
       }
     }
 
-    if(dag->preferred_parent != NULL &&
-       rpl_parent_get_ipaddr(dag->preferred_parent) != NULL) {
+    if(dao.dag->preferred_parent != NULL &&
+       rpl_parent_get_ipaddr(dao.dag->preferred_parent) != NULL) {
       uint8_t out_seq = 0;
       if(rep != NULL) {
         /* If this is pending and we get the same sequence number,
            then it is a retransmission. */
         if(RPL_ROUTE_IS_DAO_PENDING(rep) &&
-           rep->state.dao_seqno_in == sequence) {
+           rep->state.dao_seqno_in == dao.sequence) {
           /* Keep the same sequence number as before for parent also. */
           out_seq = rep->state.dao_seqno_out;
         } else {
-          out_seq = prepare_for_dao_fwd(sequence, rep);
+          out_seq = prepare_for_dao_fwd(dao.sequence, rep);
         }
       }
 
       LOG_DBG("Forwarding DAO to parent ");
-      LOG_DBG_6ADDR(rpl_parent_get_ipaddr(dag->preferred_parent));
-      LOG_DBG_(" in seq: %d out seq: %d\n", sequence, out_seq);
+      LOG_DBG_6ADDR(rpl_parent_get_ipaddr(dao.dag->preferred_parent));
+      LOG_DBG_(" in seq: %d out seq: %d\n", dao.sequence, out_seq);
 
       buffer = UIP_ICMP_PAYLOAD;
       buffer[3] = out_seq; /* add an outgoing seq no before fwd */
-      uip_icmp6_send(rpl_parent_get_ipaddr(dag->preferred_parent),
+      uip_icmp6_send(rpl_parent_get_ipaddr(dao.dag->preferred_parent),
                      ICMP6_RPL, RPL_CODE_DAO, buffer_length);
     }
     if(should_ack) {
       LOG_DBG("Sending DAO ACK\n");
       uipbuf_clear();
-      dao_ack_output(instance, &dao_sender_addr, sequence,
+      dao_ack_output(dao.instance, &dao.sender, dao.sequence,
                      RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
     }
   }
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
 #endif /* RPL_WITH_STORING */
 }
 /*---------------------------------------------------------------------------*/
@@ -1143,6 +1506,195 @@ handle_dao_retransmission(void *ptr)
 }
 #endif /* RPL_WITH_DAO_ACK */
 /*---------------------------------------------------------------------------*/
+/* Writes the DAO base object, returns its length */
+static int
+add_dao_header(rpl_dag_t *dag, unsigned char *buffer, uint8_t lifetime,
+               uint8_t seq_no)
+{
+  int pos;
+
+  pos = 0;
+
+  buffer[pos++] = dag->instance->instance_id;
+  buffer[pos] = 0;
+#if RPL_DAO_SPECIFY_DAG
+  buffer[pos] |= RPL_DAO_D_FLAG;
+#endif /* RPL_DAO_SPECIFY_DAG */
+#if RPL_WITH_DAO_ACK
+  if(lifetime != RPL_ZERO_LIFETIME) {
+    buffer[pos] |= RPL_DAO_K_FLAG;
+  }
+#endif /* RPL_WITH_DAO_ACK */
+  ++pos;
+  buffer[pos++] = 0; /* reserved */
+  buffer[pos++] = seq_no;
+#if RPL_DAO_SPECIFY_DAG
+  memcpy(buffer + pos, &dag->dag_id, sizeof(dag->dag_id));
+  pos += sizeof(dag->dag_id);
+#endif /* RPL_DAO_SPECIFY_DAG */
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
+/* Appends a Target option, returns the new end of the DAO */
+static int
+add_target(unsigned char *buffer, int pos, const uip_ipaddr_t *prefix,
+           uint8_t prefixlen)
+{
+  buffer[pos++] = RPL_OPTION_TARGET;
+  buffer[pos++] = 2 + ((prefixlen + 7) / CHAR_BIT);
+  buffer[pos++] = 0; /* reserved */
+  buffer[pos++] = prefixlen;
+  memcpy(buffer + pos, prefix, (prefixlen + 7) / CHAR_BIT);
+  return pos + ((prefixlen + 7) / CHAR_BIT);
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+/* The largest DAO that fits in the uIP buffer with a hop-by-hop option */
+#define DAO_MAX_LEN (UIP_BUFSIZE - UIP_IPH_LEN - RPL_HOP_BY_HOP_LEN - \
+                     UIP_ICMPH_LEN)
+#define TARGET_LEN(prefixlen) (4 + ((prefixlen) + 7) / CHAR_BIT)
+#define TRANSIT_LEN 6
+
+/* Appends a storing-mode Transit Information option */
+static int
+add_transit(unsigned char *buffer, int pos, uint8_t lifetime)
+{
+  buffer[pos++] = RPL_OPTION_TRANSIT;
+  buffer[pos++] = 4;
+  buffer[pos++] = 0; /* flags - ignored */
+  buffer[pos++] = 0; /* path control - ignored */
+  buffer[pos++] = 0; /* path seq - ignored */
+  buffer[pos++] = lifetime;
+  return pos;
+}
+/*---------------------------------------------------------------------------*/
+/* Marks all routes of the sub-DODAG to be refreshed with the parent */
+static void
+mark_routes(rpl_dag_t *dag)
+{
+  uip_ds6_route_t *r;
+
+  for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+    if(r->state.dag == dag && !RPL_ROUTE_IS_NOPATH_RECEIVED(r)) {
+      RPL_ROUTE_SET_DAO_FWD(r);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/*
+ * Appends Target options for the routes that wait to be sent to the
+ * parent, and for the routes already sent in the DAO with the same
+ * sequence number if this is a retransmission. The DAO gets at most
+ * RPL_DAO_MAX_TARGETS targets, and targets with the same lifetime
+ * share a Transit Information option. Returns the new end of the DAO.
+ */
+static int
+add_route_targets(rpl_dag_t *dag, unsigned char *buffer, int pos,
+                  int targets, uint8_t seq_no)
+{
+  uip_ds6_route_t *r;
+  int lifetime;
+  int len;
+
+  lifetime = -1;
+  for(r = uip_ds6_route_head();
+      r != NULL && targets < RPL_DAO_MAX_TARGETS;
+      r = uip_ds6_route_next(r)) {
+    if(r->state.dag != dag || RPL_ROUTE_IS_NOPATH_RECEIVED(r) ||
+       !(RPL_ROUTE_IS_DAO_FWD(r) ||
+         (RPL_ROUTE_IS_DAO_PENDING(r) && r->state.dao_seqno_out == seq_no))) {
+      continue;
+    }
+
+    len = TARGET_LEN(r->length) + TRANSIT_LEN;
+    if(lifetime >= 0 && lifetime != r->state.dao_lifetime) {
+      len += TRANSIT_LEN;
+    }
+    if(pos + len > DAO_MAX_LEN) {
+      break;
+    }
+    if(lifetime >= 0 && lifetime != r->state.dao_lifetime) {
+      pos = add_transit(buffer, pos, lifetime);
+    }
+    pos = add_target(buffer, pos, &r->ipaddr, r->length);
+    lifetime = r->state.dao_lifetime;
+    targets++;
+
+    RPL_ROUTE_CLEAR_DAO_FWD(r);
+    if(RPL_ROUTE_IS_DAO_PENDING(r)) {
+      /* The DAO-ACK for this DAO is relayed to the next hop */
+      r->state.dao_seqno_out = seq_no;
+    }
+  }
+  if(lifetime >= 0) {
+    pos = add_transit(buffer, pos, lifetime);
+  }
+  return pos;
+}
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
+/*---------------------------------------------------------------------------*/
+void
+dao_output_routes(rpl_parent_t *parent)
+{
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+  rpl_dag_t *dag;
+  uip_ipaddr_t *parent_ipaddr;
+  uip_ds6_route_t *r;
+  unsigned char *buffer;
+  int header_len;
+  int pos;
+
+  if(rpl_get_mode() == RPL_MODE_FEATHER) {
+    return;
+  }
+
+  if(parent == NULL || parent->dag == NULL ||
+     parent->dag->instance == NULL) {
+    return;
+  }
+  dag = parent->dag;
+
+  parent_ipaddr = rpl_parent_get_ipaddr(parent);
+  if(parent_ipaddr == NULL) {
+    return;
+  }
+
+  for(;;) {
+    for(r = uip_ds6_route_head(); r != NULL; r = uip_ds6_route_next(r)) {
+      if(r->state.dag == dag && !RPL_ROUTE_IS_NOPATH_RECEIVED(r) &&
+         RPL_ROUTE_IS_DAO_FWD(r)) {
+        break;
+      }
+    }
+    if(r == NULL) {
+      return;
+    }
+
+    RPL_LOLLIPOP_INCREMENT(dao_sequence);
+    buffer = UIP_ICMP_PAYLOAD;
+    header_len = add_dao_header(dag, buffer, dag->instance->default_lifetime,
+                                dao_sequence);
+    pos = add_route_targets(dag, buffer, header_len, 0, dao_sequence);
+    if(pos == header_len) {
+      return;
+    }
+#if RPL_WITH_DAO_ACK
+    if(find_route_entry_by_dao_ack(dao_sequence) == NULL) {
+      /* Only refreshes: nobody waits for a DAO ACK */
+      buffer[1] &= ~RPL_DAO_K_FLAG;
+    }
+#endif /* RPL_WITH_DAO_ACK */
+
+    LOG_INFO("Sending a DAO with sequence number %u for the sub-DODAG to ",
+             dao_sequence);
+    LOG_INFO_6ADDR(parent_ipaddr);
+    LOG_INFO_("\n");
+
+    uip_icmp6_send(parent_ipaddr, ICMP6_RPL, RPL_CODE_DAO, pos);
+  }
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
+}
+/*---------------------------------------------------------------------------*/
 void
 dao_output(rpl_parent_t *parent, uint8_t lifetime)
 {
@@ -1204,6 +1756,9 @@ dao_output_target_seq(rpl_parent_t *parent, uip_ipaddr_t *prefix,
   int pos;
   uip_ipaddr_t *parent_ipaddr = NULL;
   uip_ipaddr_t *dest_ipaddr = NULL;
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+  int aggregate = 0;
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
 
   /* Destination Advertisement Object */
 
@@ -1244,34 +1799,11 @@ dao_output_target_seq(rpl_parent_t *parent, uip_ipaddr_t *prefix,
 #endif
 
   buffer = UIP_ICMP_PAYLOAD;
-  pos = 0;
-
-  buffer[pos++] = instance->instance_id;
-  buffer[pos] = 0;
-#if RPL_DAO_SPECIFY_DAG
-  buffer[pos] |= RPL_DAO_D_FLAG;
-#endif /* RPL_DAO_SPECIFY_DAG */
-#if RPL_WITH_DAO_ACK
-  if(lifetime != RPL_ZERO_LIFETIME) {
-    buffer[pos] |= RPL_DAO_K_FLAG;
-  }
-#endif /* RPL_WITH_DAO_ACK */
-  ++pos;
-  buffer[pos++] = 0; /* reserved */
-  buffer[pos++] = seq_no;
-#if RPL_DAO_SPECIFY_DAG
-  memcpy(buffer + pos, &dag->dag_id, sizeof(dag->dag_id));
-  pos += sizeof(dag->dag_id);
-#endif /* RPL_DAO_SPECIFY_DAG */
+  pos = add_dao_header(dag, buffer, lifetime, seq_no);
 
   /* Create a target suboption. */
   prefixlen = sizeof(*prefix) * CHAR_BIT;
-  buffer[pos++] = RPL_OPTION_TARGET;
-  buffer[pos++] = 2 + ((prefixlen + 7) / CHAR_BIT);
-  buffer[pos++] = 0; /* reserved */
-  buffer[pos++] = prefixlen;
-  memcpy(buffer + pos, prefix, (prefixlen + 7) / CHAR_BIT);
-  pos += ((prefixlen + 7) / CHAR_BIT);
+  pos = add_target(buffer, pos, prefix, prefixlen);
 
   /* Create a transit information sub-option. */
   buffer[pos++] = RPL_OPTION_TRANSIT;
@@ -1295,6 +1827,19 @@ dao_output_target_seq(rpl_parent_t *parent, uip_ipaddr_t *prefix,
     dest_ipaddr = &parent->dag->dag_id;
   }
 
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+  if(instance->mop != RPL_MOP_NON_STORING && lifetime != RPL_ZERO_LIFETIME &&
+     !uip_is_addr_mcast(prefix)) {
+    /*
+     * Our DAOs keep the routes of the whole sub-DODAG alive, so also
+     * retransmissions carry all of them.
+     */
+    mark_routes(dag);
+    pos = add_route_targets(dag, buffer, pos, 1, seq_no);
+    aggregate = 1;
+  }
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
+
   LOG_INFO("Sending a %sDAO with sequence number %u, lifetime %u, prefix ",
            lifetime == RPL_ZERO_LIFETIME ? "No-Path " : "", seq_no, lifetime);
 
@@ -1308,8 +1853,77 @@ dao_output_target_seq(rpl_parent_t *parent, uip_ipaddr_t *prefix,
   if(dest_ipaddr != NULL) {
     uip_icmp6_send(dest_ipaddr, ICMP6_RPL, RPL_CODE_DAO, pos);
   }
+
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+  if(aggregate) {
+    /* The routes that did not fit */
+    dao_output_routes(parent);
+  }
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_WITH_DAO_ACK && RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+/*
+ * Forwards a DAO ACK to the children whose DAOs were forwarded with the
+ * given sequence number, once per child and DAO. Returns the number of
+ * routes that were waiting for it.
+ */
+static int
+forward_dao_ack(rpl_instance_t *instance, uint8_t sequence, uint8_t status)
+{
+  uip_ds6_route_t *re;
+  uip_ds6_route_t *r;
+  uip_ds6_route_t *next;
+  const uip_ipaddr_t *nexthop;
+  uip_ipaddr_t dest;
+  uint8_t seqno_in;
+  int count;
+
+  count = 0;
+  while((re = find_route_entry_by_dao_ack(sequence)) != NULL) {
+    /* Pick the recorded seq no from that node and forward the DAO ACK.
+       Also clear the pending flag. */
+    RPL_ROUTE_CLEAR_DAO_PENDING(re);
+    count++;
+
+    nexthop = uip_ds6_route_nexthop(re);
+    if(nexthop == NULL) {
+      LOG_WARN("No next hop to fwd DAO ACK to\n");
+    } else {
+      uip_ipaddr_copy(&dest, nexthop);
+      seqno_in = re->state.dao_seqno_in;
+
+      /* The other targets of the same DAO share the DAO ACK. */
+      for(r = uip_ds6_route_head(); r != NULL; r = next) {
+        next = uip_ds6_route_next(r);
+        if(r != re && RPL_ROUTE_IS_DAO_PENDING(r) &&
+           r->state.dao_seqno_out == sequence &&
+           r->state.dao_seqno_in == seqno_in &&
+           uip_ds6_route_nexthop(r) != NULL &&
+           uip_ipaddr_cmp(uip_ds6_route_nexthop(r), &dest)) {
+          RPL_ROUTE_CLEAR_DAO_PENDING(r);
+          count++;
+          if(status >= RPL_DAO_ACK_UNABLE_TO_ACCEPT) {
+            uip_ds6_route_rm(r);
+          }
+        }
+      }
+
+      LOG_INFO("Fwd DAO ACK to:");
+      LOG_INFO_6ADDR(&dest);
+      LOG_INFO_("\n");
+      dao_ack_output(instance, &dest, seqno_in, status);
+    }
+
+    if(status >= RPL_DAO_ACK_UNABLE_TO_ACCEPT) {
+      /* This node did not get in to the routing tables above -- remove. */
+      uip_ds6_route_rm(re);
+    }
+  }
+  return count;
+}
+#endif /* RPL_WITH_DAO_ACK && RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
+/*---------------------------------------------------------------------------*/
 static void
 dao_ack_input(void)
 {
@@ -1377,6 +1991,21 @@ dao_ack_input(void)
       rpl_local_repair(instance);
     }
 #endif
+#if RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1
+  }
+
+  /*
+   * This DAO ACK should be forwarded to the recently registered routes.
+   * A DAO can carry several targets, and our own DAO can also carry
+   * the routes of our sub-DODAG.
+   */
+  if(RPL_IS_STORING(instance) &&
+     forward_dao_ack(instance, sequence, status) == 0 &&
+     sequence != instance->my_dao_seqno) {
+    LOG_WARN("No route entry found to forward DAO ACK (seqno %u)\n",
+             sequence);
+  }
+#else /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
   } else if(RPL_IS_STORING(instance)) {
     /* This DAO ACK should be forwarded to another recently registered route. */
     uip_ds6_route_t *re;
@@ -1406,6 +2035,7 @@ dao_ack_input(void)
                sequence);
     }
   }
+#endif /* RPL_WITH_STORING && RPL_DAO_MAX_TARGETS > 1 */
 #endif /* RPL_WITH_DAO_ACK */
   uipbuf_clear();
 }
@@ -367,6 +367,33 @@ rpl_cancel_dao(rpl_instance_t *instance)
 {
   ctimer_stop(&instance->dao_timer);
   ctimer_stop(&instance->dao_lifetime_timer);
+#if RPL_DAO_MAX_TARGETS > 1
+  ctimer_stop(&instance->dao_aggregation_timer);
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+}
+/*---------------------------------------------------------------------------*/
+#if RPL_DAO_MAX_TARGETS > 1
+static void
+handle_dao_aggregation_timer(void *ptr)
+{
+  rpl_instance_t *instance = (rpl_instance_t *)ptr;
+
+  if(instance->current_dag->preferred_parent != NULL) {
+    dao_output_routes(instance->current_dag->preferred_parent);
+  }
+}
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+/*---------------------------------------------------------------------------*/
+void
+rpl_schedule_dao_aggregation(rpl_instance_t *instance)
+{
+#if RPL_DAO_MAX_TARGETS > 1
+  if(ctimer_expired(&instance->dao_aggregation_timer)) {
+    LOG_DBG("Scheduling DAO aggregation timer\n");
+    ctimer_set(&instance->dao_aggregation_timer, RPL_DAO_AGGREGATION_DELAY,
+               handle_dao_aggregation_timer, instance);
+  }
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
 }
 /*---------------------------------------------------------------------------*/
 static void
@@ -265,6 +265,9 @@ struct rpl_instance {
 #if RPL_WITH_DAO_ACK
   struct ctimer dao_retransmit_timer;
 #endif /* RPL_WITH_DAO_ACK */
+#if RPL_DAO_MAX_TARGETS > 1
+  struct ctimer dao_aggregation_timer;
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
 };
 
 /*---------------------------------------------------------------------------*/
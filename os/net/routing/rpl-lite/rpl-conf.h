@@ -326,6 +326,72 @@
 #define RPL_DAO_RETRANSMISSION_TIMEOUT    (5 * CLOCK_SECOND)
 #endif /* RPL_CONF_DAO_RETRANSMISSION_TIMEOUT */
 
+/*
+ * DAO batching at the root. Incoming DAOs are held for up to
+ * RPL_DAO_BATCH_WINDOW and then installed together, before their
+ * DAO-ACKs are sent. A DAO that comes in while an older one from the
+ * same node is held replaces it. At most RPL_DAO_BATCH_SIZE DAOs are
+ * held; 0 disables batching.
+ */
+#ifdef RPL_CONF_DAO_BATCH_SIZE
+#define RPL_DAO_BATCH_SIZE              RPL_CONF_DAO_BATCH_SIZE
+#else
+#define RPL_DAO_BATCH_SIZE              0
+#endif /* RPL_CONF_DAO_BATCH_SIZE */
+
+#ifdef RPL_CONF_DAO_BATCH_WINDOW
+#define RPL_DAO_BATCH_WINDOW            RPL_CONF_DAO_BATCH_WINDOW
+#else
+#define RPL_DAO_BATCH_WINDOW            (CLOCK_SECOND / 4)
+#endif /* RPL_CONF_DAO_BATCH_WINDOW */
+
+/*
+ * Source routing headers cached at the root, one per destination. A
+ * cached header is copied to outgoing packets for as long as the
+ * source routing graph is unchanged (see uip_sr_version()). Headers
+ * longer than RPL_SRH_CACHE_MAX_LEN bytes are not cached. The cache is
+ * a hash table, best sized to about twice the number of destinations.
+ * 0 disables the cache.
+ */
+#ifdef RPL_CONF_SRH_CACHE_SIZE
+#define RPL_SRH_CACHE_SIZE              RPL_CONF_SRH_CACHE_SIZE
+#else
+#define RPL_SRH_CACHE_SIZE              0
+#endif /* RPL_CONF_SRH_CACHE_SIZE */
+
+#ifdef RPL_CONF_SRH_CACHE_MAX_LEN
+#define RPL_SRH_CACHE_MAX_LEN           RPL_CONF_SRH_CACHE_MAX_LEN
+#else
+#define RPL_SRH_CACHE_MAX_LEN           64
+#endif /* RPL_CONF_SRH_CACHE_MAX_LEN */
+
+/*
+ * Adapt the DAO delay to the node's position in the DODAG: the delay
+ * window grows with the node's depth (up to four hops), and shrinks for
+ * nodes with deeper neighbors (likely children). This spreads the DAOs that all nodes
+ * send after a global repair, and tends to register parents before
+ * their children.
+ */
+#ifdef RPL_CONF_DAO_ADAPTIVE_JITTER
+#define RPL_DAO_ADAPTIVE_JITTER         RPL_CONF_DAO_ADAPTIVE_JITTER
+#else
+#define RPL_DAO_ADAPTIVE_JITTER         0
+#endif /* RPL_CONF_DAO_ADAPTIVE_JITTER */
+
+/*
+ * Keep the candidate parents in a heap ordered by path cost, along with
+ * each neighbor's path cost, and update them when a DIO or a link-stats
+ * update concerns a neighbor. Parent selection then looks at the top of
+ * the heap and at the preferred parent instead of evaluating the OF for
+ * every neighbor. Our rank is still computed from the current link
+ * statistics. Worth it with many neighbors.
+ */
+#ifdef RPL_CONF_WITH_PARENT_RANKING
+#define RPL_WITH_PARENT_RANKING         RPL_CONF_WITH_PARENT_RANKING
+#else
+#define RPL_WITH_PARENT_RANKING         0
+#endif /* RPL_CONF_WITH_PARENT_RANKING */
+
 /******************************************************************************/
 /************************** More parameterization *****************************/
 /******************************************************************************/
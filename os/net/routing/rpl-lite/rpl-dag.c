@@ -57,6 +57,16 @@ extern rpl_of_t rpl_of0, rpl_mrhof;
 static rpl_of_t * const objective_functions[] = RPL_SUPPORTED_OFS;
 static int process_dio_init_dag(rpl_dio_t *dio);
 
+#if RPL_DAO_BATCH_SIZE > 0
+/* DAOs held at the root until the batch is processed */
+struct dao_batch_entry {
+  uip_ipaddr_t from;
+  rpl_dao_t dao;
+};
+static struct dao_batch_entry dao_batch[RPL_DAO_BATCH_SIZE];
+static uint8_t dao_batch_count;
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+
 /*---------------------------------------------------------------------------*/
 /* Allocate instance table. */
 rpl_instance_t curr_instance;
@@ -114,6 +124,9 @@ rpl_dag_leave(void)
   /* Remove all neighbors, links and default route */
   rpl_neighbor_remove_all();
   uip_sr_free_all();
+#if RPL_DAO_BATCH_SIZE > 0
+  dao_batch_count = 0;
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
 
   /* Stop all timers */
   rpl_timers_stop_dag_timers();
@@ -393,6 +406,9 @@ update_nbr_from_dio(uip_ipaddr_t *from, rpl_dio_t *dio)
 #if RPL_WITH_MC
   memcpy(&nbr->mc, &dio->mc, sizeof(nbr->mc));
 #endif /* RPL_WITH_MC */
+#if RPL_WITH_PARENT_RANKING
+  rpl_neighbor_update_ranking(nbr);
+#endif /* RPL_WITH_PARENT_RANKING */
 
   return nbr;
 }
@@ -629,18 +645,57 @@ rpl_process_dis(uip_ipaddr_t *from, int is_multicast)
   }
 }
 /*---------------------------------------------------------------------------*/
-void
-rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
+static int
+install_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
 {
   if(dao->lifetime == 0) {
     uip_sr_expire_parent(NULL, from, &dao->parent_addr);
   } else {
     if(!uip_sr_update_node(NULL, from, &dao->parent_addr, RPL_LIFETIME(dao->lifetime))) {
       LOG_ERR("failed to add link on incoming DAO\n");
+      return 0;
+    }
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
+{
+#if RPL_DAO_BATCH_SIZE > 0
+  int i;
+
+  for(i = 0; i < dao_batch_count; i++) {
+    if(uip_ipaddr_cmp(&dao_batch[i].from, from)) {
+      if(rpl_lollipop_greater_than(dao->sequence, dao_batch[i].dao.sequence)) {
+        /* The node has sent a newer DAO, which supersedes the held one */
+        LOG_DBG("DAO batch: replacing DAO seqno %u with %u\n",
+                dao_batch[i].dao.sequence, dao->sequence);
+        dao_batch[i].dao = *dao;
+      } else {
+        /* A retransmission or a late copy: the held DAO is as recent */
+        LOG_DBG("DAO batch: keeping DAO seqno %u over %u\n",
+                dao_batch[i].dao.sequence, dao->sequence);
+      }
       return;
     }
   }
 
+  if(dao_batch_count < RPL_DAO_BATCH_SIZE) {
+    uip_ipaddr_copy(&dao_batch[dao_batch_count].from, from);
+    dao_batch[dao_batch_count].dao = *dao;
+    dao_batch_count++;
+    rpl_timers_schedule_dao_batch();
+    return;
+  }
+
+  /* The batch is full, process this DAO right away */
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+
+  if(!install_dao(from, dao)) {
+    return;
+  }
+
 #if RPL_WITH_DAO_ACK
   if(dao->flags & RPL_DAO_K_FLAG) {
     rpl_timers_schedule_dao_ack(from, dao->sequence);
@@ -648,6 +703,36 @@ rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao)
 #endif /* RPL_WITH_DAO_ACK */
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_DAO_BATCH_SIZE > 0
+void
+rpl_dag_process_dao_batch(void)
+{
+  uint8_t installed[RPL_DAO_BATCH_SIZE];
+  int i;
+
+  LOG_INFO("DAO batch: installing %u DAOs\n", dao_batch_count);
+
+  /* Install all routes before sending any DAO-ACK, so that the DAO-ACKs
+   * to nodes whose parents are in the same batch can be source-routed */
+  for(i = 0; i < dao_batch_count; i++) {
+    installed[i] = install_dao(&dao_batch[i].from, &dao_batch[i].dao);
+  }
+
+#if RPL_WITH_DAO_ACK
+  /* Unlike rpl_timers_schedule_dao_ack(), which keeps a single pending
+   * DAO-ACK, this sends one to every node of the batch */
+  for(i = 0; i < dao_batch_count; i++) {
+    if(installed[i] && (dao_batch[i].dao.flags & RPL_DAO_K_FLAG)) {
+      rpl_icmp6_dao_ack_output(&dao_batch[i].from, dao_batch[i].dao.sequence,
+                               RPL_DAO_ACK_UNCONDITIONAL_ACCEPT);
+    }
+  }
+#endif /* RPL_WITH_DAO_ACK */
+
+  dao_batch_count = 0;
+}
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+/*---------------------------------------------------------------------------*/
 #if RPL_WITH_DAO_ACK
 void
 rpl_process_dao_ack(uint8_t sequence, uint8_t status)
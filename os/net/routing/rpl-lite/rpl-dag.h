@@ -166,6 +166,12 @@ void rpl_process_dio(uip_ipaddr_t *from, rpl_dio_t *dio);
 */
 void rpl_process_dao(uip_ipaddr_t *from, rpl_dao_t *dao);
 
+/**
+ * Installs the routes of the DAOs held at the root, and acknowledges
+ * them. Only used with RPL_DAO_BATCH_SIZE > 0.
+*/
+void rpl_dag_process_dao_batch(void);
+
 /**
  * Processes incoming DAO-ACK
  *
@@ -68,8 +68,13 @@ rpl_ext_header_srh_get_next_hop(uip_ipaddr_t *ipaddr)
     return 0;
   }
 
-  root_node = uip_sr_get_node(NULL, &curr_instance.dag.dag_id);
-  dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
+  if(rh_header != NULL && rh_header->routing_type == RPL_RH_TYPE_SRH) {
+    root_node = NULL;
+    dest_node = NULL;
+  } else {
+    root_node = uip_sr_get_node(NULL, &curr_instance.dag.dag_id);
+    dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
+  }
 
   if((rh_header != NULL && rh_header->routing_type == RPL_RH_TYPE_SRH) ||
      (dest_node != NULL && root_node != NULL &&
@@ -174,6 +179,85 @@ count_matching_bytes(const void *p1, const void *p2, size_t n)
   return n;
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_SRH_CACHE_SIZE
+/* A source routing header, as inserted in packets to dest */
+struct srh_cache_entry {
+  uip_ipaddr_t dest;
+  /* The IPv6 destination of the packets, i.e. the first hop */
+  uip_ipaddr_t first_hop;
+  /* Of the source routing graph the header was built from */
+  uint32_t version;
+  uint8_t len;
+  uint8_t hdr[RPL_SRH_CACHE_MAX_LEN];
+};
+
+static struct srh_cache_entry srh_cache[RPL_SRH_CACHE_SIZE];
+
+/* A destination's header is in one of the entries following the one its
+   interface identifier hashes to */
+#define SRH_CACHE_PROBES MIN(4, RPL_SRH_CACHE_SIZE)
+
+/* Returns the cache entry for dest, or a free entry to use for it. When
+   there is none, returns NULL: the cached headers stay until the graph
+   changes, rather than replacing each other. */
+static struct srh_cache_entry *
+srh_cache_entry(const uip_ipaddr_t *dest)
+{
+  struct srh_cache_entry *entry;
+  struct srh_cache_entry *unused;
+  uint32_t hash;
+  int i;
+
+  /* FNV-1a, so that identifiers that only differ in their last bytes,
+     as when nodes are numbered in sequence, still spread over the cache */
+  hash = 2166136261UL;
+  for(i = 8; i < 16; i++) {
+    hash = (hash ^ dest->u8[i]) * 16777619UL;
+  }
+  hash %= RPL_SRH_CACHE_SIZE;
+
+  unused = NULL;
+  for(i = 0; i < SRH_CACHE_PROBES; i++) {
+    entry = &srh_cache[(hash + i) % RPL_SRH_CACHE_SIZE];
+    if(entry->len > 0 && entry->version == uip_sr_version()) {
+      if(uip_ipaddr_cmp(&entry->dest, dest)) {
+        return entry;
+      }
+    } else if(unused == NULL) {
+      unused = entry;
+    }
+  }
+  return unused;
+}
+/*---------------------------------------------------------------------------*/
+/* Inserts a cached SRH. Returns 1 on success, 0 on failure. */
+static int
+insert_cached_srh_header(const struct srh_cache_entry *entry)
+{
+  struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
+
+  if(uip_len + entry->len > UIP_LINK_MTU) {
+    LOG_ERR("packet too long: impossible to add source routing header (%u bytes)\n", entry->len);
+    return 0;
+  }
+
+  /* Move existing ext headers and payload, and copy the SRH in front */
+  memmove(uip_buf + UIP_IPH_LEN + uip_ext_len + entry->len,
+      uip_buf + UIP_IPH_LEN + uip_ext_len, uip_len - UIP_IPH_LEN);
+  memcpy(rh_hdr, entry->hdr, entry->len);
+
+  rh_hdr->next = UIP_IP_BUF->proto;
+  UIP_IP_BUF->proto = UIP_PROTO_ROUTING;
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &entry->first_hop);
+
+  /* Update the IPv6 length field */
+  uipbuf_add_ext_hdr(entry->len);
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+
+  return 1;
+}
+#endif /* RPL_SRH_CACHE_SIZE */
+/*---------------------------------------------------------------------------*/
 /* Used by rpl_ext_header_update to insert a RPL SRH extension header. This
  * is used at the root, to initiate downward routing. Returns 1 on success,
  * 0 on failure.
@@ -191,6 +275,9 @@ insert_srh_header(void)
   uip_sr_node_t *root_node;
   uip_sr_node_t *node;
   uip_ipaddr_t node_addr;
+#if RPL_SRH_CACHE_SIZE
+  struct srh_cache_entry *entry;
+#endif /* RPL_SRH_CACHE_SIZE */
 
   /* Always insest SRH as first extension header */
   struct uip_routing_hdr *rh_hdr = (struct uip_routing_hdr *)UIP_IP_PAYLOAD(0);
@@ -210,6 +297,16 @@ insert_srh_header(void)
     return 1;
   }
 
+#if RPL_SRH_CACHE_SIZE
+  entry = srh_cache_entry(&UIP_IP_BUF->destipaddr);
+  if(entry != NULL && entry->len > 0 && entry->version == uip_sr_version() &&
+     uip_ipaddr_cmp(&entry->dest, &UIP_IP_BUF->destipaddr)) {
+    UIP_STAT(++uip_stat.sr.hit);
+    return insert_cached_srh_header(entry);
+  }
+  UIP_STAT(++uip_stat.sr.miss);
+#endif /* RPL_SRH_CACHE_SIZE */
+
   dest_node = uip_sr_get_node(NULL, &UIP_IP_BUF->destipaddr);
   if(dest_node == NULL) {
     /* The destination is not found, skip SRH insertion */
@@ -305,6 +402,17 @@ insert_srh_header(void)
 
   /* The next hop (i.e. node whose parent is the root) is placed as the current IPv6 destination */
   NETSTACK_ROUTING.get_sr_node_ipaddr(&node_addr, node);
+
+#if RPL_SRH_CACHE_SIZE
+  if(entry != NULL && ext_len <= RPL_SRH_CACHE_MAX_LEN) {
+    uip_ipaddr_copy(&entry->dest, &UIP_IP_BUF->destipaddr);
+    uip_ipaddr_copy(&entry->first_hop, &node_addr);
+    entry->version = uip_sr_version();
+    entry->len = ext_len;
+    memcpy(entry->hdr, rh_hdr, ext_len);
+  }
+#endif /* RPL_SRH_CACHE_SIZE */
+
   uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &node_addr);
 
   /* Update the IPv6 length field */
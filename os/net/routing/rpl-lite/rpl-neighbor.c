@@ -64,6 +64,14 @@ static rpl_nbr_t * best_parent(int fresh_only);
 /* Per-neighbor RPL information */
 NBR_TABLE_GLOBAL(rpl_nbr_t, rpl_neighbors);
 
+#if RPL_WITH_PARENT_RANKING
+/* The neighbors the OF accepts as parents, in a binary min-heap on path
+ * cost. Whether their rank is acceptable depends on our lowest rank, and
+ * is checked upon selection only. */
+static rpl_nbr_t *candidates[NBR_TABLE_MAX_NEIGHBORS];
+static int candidate_count;
+#endif /* RPL_WITH_PARENT_RANKING */
+
 /*---------------------------------------------------------------------------*/
 static int
 max_acceptable_rank(void)
@@ -190,6 +198,89 @@ rpl_get_ds6_nbr(rpl_nbr_t *nbr)
 }
 #endif /* UIP_ND6_SEND_NS */
 /*---------------------------------------------------------------------------*/
+#if RPL_WITH_PARENT_RANKING
+static void
+candidate_set(int pos, rpl_nbr_t *nbr)
+{
+  candidates[pos] = nbr;
+  nbr->candidate_pos = pos + 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Moves a candidate to its place in the heap after its path cost changed */
+static void
+candidate_fix(rpl_nbr_t *nbr)
+{
+  int pos = nbr->candidate_pos - 1;
+  int child;
+
+  /* Up */
+  while(pos > 0 && candidates[(pos - 1) / 2]->path_cost > nbr->path_cost) {
+    candidate_set(pos, candidates[(pos - 1) / 2]);
+    pos = (pos - 1) / 2;
+  }
+  /* Down */
+  while((child = 2 * pos + 1) < candidate_count) {
+    if(child + 1 < candidate_count
+       && candidates[child + 1]->path_cost < candidates[child]->path_cost) {
+      child++;
+    }
+    if(candidates[child]->path_cost >= nbr->path_cost) {
+      break;
+    }
+    candidate_set(pos, candidates[child]);
+    pos = child;
+  }
+  candidate_set(pos, nbr);
+}
+/*---------------------------------------------------------------------------*/
+static void
+candidate_remove(rpl_nbr_t *nbr)
+{
+  rpl_nbr_t *last;
+  int pos;
+
+  if(nbr->candidate_pos == 0) {
+    return;
+  }
+  pos = nbr->candidate_pos - 1;
+  nbr->candidate_pos = 0;
+  last = candidates[--candidate_count];
+  if(last != nbr) {
+    candidate_set(pos, last);
+    candidate_fix(last);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_update_ranking(rpl_nbr_t *nbr)
+{
+  if(nbr == NULL || !curr_instance.used) {
+    return;
+  }
+
+  nbr->path_cost = curr_instance.of->nbr_path_cost(nbr);
+
+  if(curr_instance.of->nbr_is_acceptable_parent(nbr)) {
+    if(nbr->candidate_pos == 0) {
+      candidate_set(candidate_count++, nbr);
+    }
+    candidate_fix(nbr);
+  } else {
+    candidate_remove(nbr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+rpl_neighbor_refresh_ranking(void)
+{
+  rpl_nbr_t *nbr;
+
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    rpl_neighbor_update_ranking(nbr);
+  }
+}
+#endif /* RPL_WITH_PARENT_RANKING */
+/*---------------------------------------------------------------------------*/
 static void
 remove_neighbor(rpl_nbr_t *nbr)
 {
@@ -205,6 +296,9 @@ remove_neighbor(rpl_nbr_t *nbr)
   if(nbr == curr_instance.dag.unicast_dio_target) {
     curr_instance.dag.unicast_dio_target = NULL;
   }
+#if RPL_WITH_PARENT_RANKING
+  candidate_remove(nbr);
+#endif /* RPL_WITH_PARENT_RANKING */
   nbr_table_remove(rpl_neighbors, nbr);
   rpl_timers_schedule_state_update(); /* Updating from here is unsafe; postpone */
 }
@@ -336,6 +430,39 @@ rpl_neighbor_get_from_ipaddr(uip_ipaddr_t *addr)
   return nbr_table_get_from_lladdr(rpl_neighbors, (linkaddr_t *)lladdr);
 }
 /*---------------------------------------------------------------------------*/
+#if RPL_WITH_PARENT_RANKING
+static int
+is_selectable(rpl_nbr_t *nbr)
+{
+#if UIP_ND6_SEND_NS
+  if(rpl_get_ds6_nbr(nbr) == NULL) {
+    return 0;
+  }
+#endif /* UIP_ND6_SEND_NS */
+  return acceptable_rank(rpl_neighbor_rank_via_nbr(nbr));
+}
+/*---------------------------------------------------------------------------*/
+/* The best parent as per the candidate heap: the candidate with the lowest
+ * path cost, or the preferred parent if the OF prefers to keep it. Returns
+ * NULL if the top candidate cannot be selected, in which case the caller
+ * has to go through all neighbors. */
+static rpl_nbr_t *
+ranked_best_parent(void)
+{
+  rpl_nbr_t *best = candidates[0];
+  rpl_nbr_t *preferred = curr_instance.dag.preferred_parent;
+
+  if(!is_selectable(best)) {
+    return NULL;
+  }
+  if(preferred != NULL && preferred != best
+     && preferred->candidate_pos != 0 && is_selectable(preferred)) {
+    best = curr_instance.of->best_parent(preferred, best);
+  }
+  return best;
+}
+#endif /* RPL_WITH_PARENT_RANKING */
+/*---------------------------------------------------------------------------*/
 static rpl_nbr_t *
 best_parent(int fresh_only)
 {
@@ -346,6 +473,19 @@ best_parent(int fresh_only)
     return NULL;
   }
 
+#if RPL_WITH_PARENT_RANKING
+  if(!fresh_only) {
+    if(candidate_count == 0) {
+      /* No neighbor is acceptable as per the OF */
+      return NULL;
+    }
+    best = ranked_best_parent();
+    if(best != NULL) {
+      return best;
+    }
+  }
+#endif /* RPL_WITH_PARENT_RANKING */
+
   /* Search for the best parent according to the OF */
   for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL; nbr = nbr_table_next(rpl_neighbors, nbr)) {
 
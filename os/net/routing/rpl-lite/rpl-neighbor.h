@@ -184,6 +184,22 @@ void rpl_neighbor_remove_all(void);
 */
 rpl_nbr_t *rpl_neighbor_select_best(void);
 
+#if RPL_WITH_PARENT_RANKING
+/**
+ * Updates a neighbor's path cost and its place among the candidate
+ * parents. To be called whenever the neighbor's rank, metric
+ * container or link statistics change.
+ *
+ * \param nbr The neighbor
+*/
+void rpl_neighbor_update_ranking(rpl_nbr_t *nbr);
+
+/**
+ * Updates the path cost and candidate status of all neighbors
+*/
+void rpl_neighbor_refresh_ranking(void);
+#endif /* RPL_WITH_PARENT_RANKING */
+
 /**
 * Print a textual description of RPL neighbor into a string
 *
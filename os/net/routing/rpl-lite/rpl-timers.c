@@ -76,6 +76,9 @@ static void send_new_dao(void *ptr);
 static void resend_dao(void *ptr);
 static void handle_dao_ack_timer(void *ptr);
 #endif /* RPL_WITH_DAO_ACK */
+#if RPL_DAO_BATCH_SIZE > 0
+static void handle_dao_batch_timer(void *ptr);
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
 #if RPL_WITH_PROBING
 static void handle_probing_timer(void *ptr);
 #endif /* RPL_WITH_PROBING */
@@ -259,6 +262,27 @@ schedule_dao_refresh(void)
   }
 }
 /*---------------------------------------------------------------------------*/
+clock_time_t
+rpl_timers_dao_delay(unsigned hops, unsigned children)
+{
+#if RPL_DAO_ADAPTIVE_JITTER
+  clock_time_t window;
+
+  /* There are usually more nodes at each depth than at the previous one:
+   * spread them over a window that grows with the depth, from
+   * RPL_DAO_DELAY at one hop to 2.5 * RPL_DAO_DELAY at four hops and
+   * more. Nodes with children use a shorter window, so that the root
+   * tends to know them before their children's DAOs come in and it
+   * has to source-route DAO-ACKs through them. */
+  hops = MIN(MAX(hops, 1), 4);
+  window = (RPL_DAO_DELAY * (1 + hops)) / 2 / (1 + MIN(children, 3));
+  /* Short DAO delays round the window down to zero */
+  return RPL_DAO_DELAY / 2 + (random_rand() % MAX(window, 1));
+#else /* RPL_DAO_ADAPTIVE_JITTER */
+  return RPL_DAO_DELAY / 2 + (random_rand() % (RPL_DAO_DELAY));
+#endif /* RPL_DAO_ADAPTIVE_JITTER */
+}
+/*---------------------------------------------------------------------------*/
 void
 rpl_timers_schedule_dao(void)
 {
@@ -266,7 +290,22 @@ rpl_timers_schedule_dao(void)
     /* No need for DAO aggregation delay as per RFC 6550 section 9.5, as this
     * only serves storing mode. Use simple delay instead, with the only purpose
     * to reduce congestion. */
-    clock_time_t expiration_time = RPL_DAO_DELAY / 2 + (random_rand() % (RPL_DAO_DELAY));
+    unsigned hops = 1;
+    unsigned children = 0;
+#if RPL_DAO_ADAPTIVE_JITTER
+    rpl_nbr_t *nbr;
+
+    if(curr_instance.dag.rank != RPL_INFINITE_RANK) {
+      hops = DAG_RANK(curr_instance.dag.rank) - 1;
+    }
+    for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL;
+        nbr = nbr_table_next(rpl_neighbors, nbr)) {
+      if(nbr->rank != RPL_INFINITE_RANK && nbr->rank > curr_instance.dag.rank) {
+        children++;
+      }
+    }
+#endif /* RPL_DAO_ADAPTIVE_JITTER */
+    clock_time_t expiration_time = rpl_timers_dao_delay(hops, children);
     ctimer_set(&curr_instance.dag.dao_timer, expiration_time, send_new_dao, NULL);
   }
 }
@@ -294,6 +333,25 @@ send_new_dao(void *ptr)
   /* Send a DAO with own prefix as target and default lifetime */
   rpl_icmp6_dao_output(curr_instance.default_lifetime);
 }
+#if RPL_DAO_BATCH_SIZE > 0
+/*---------------------------------------------------------------------------*/
+/*------------------------------- DAO batch -------------------------------- */
+/*---------------------------------------------------------------------------*/
+void
+rpl_timers_schedule_dao_batch(void)
+{
+  if(curr_instance.used && ctimer_expired(&curr_instance.dag.dao_batch_timer)) {
+    ctimer_set(&curr_instance.dag.dao_batch_timer, RPL_DAO_BATCH_WINDOW,
+               handle_dao_batch_timer, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+handle_dao_batch_timer(void *ptr)
+{
+  rpl_dag_process_dao_batch();
+}
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
 #if RPL_WITH_DAO_ACK
 /*---------------------------------------------------------------------------*/
 /*------------------------------- DAO-ACK ---------------------------------- */
@@ -514,6 +572,10 @@ handle_periodic_timer(void *ptr)
   if(curr_instance.used) {
     rpl_dag_periodic(PERIODIC_DELAY_SECONDS);
     uip_sr_periodic(PERIODIC_DELAY_SECONDS);
+#if RPL_WITH_PARENT_RANKING
+    /* Catch up with link statistics updated without a link callback */
+    rpl_neighbor_refresh_ranking();
+#endif /* RPL_WITH_PARENT_RANKING */
   }
 
   if(!curr_instance.used ||
@@ -549,6 +611,9 @@ rpl_timers_stop_dag_timers(void)
 #if RPL_WITH_DAO_ACK
   ctimer_stop(&curr_instance.dag.dao_ack_timer);
 #endif /* RPL_WITH_DAO_ACK */
+#if RPL_DAO_BATCH_SIZE > 0
+  ctimer_stop(&curr_instance.dag.dao_batch_timer);
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
 }
 /*---------------------------------------------------------------------------*/
 void
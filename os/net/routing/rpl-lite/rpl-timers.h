@@ -94,6 +94,22 @@ void rpl_timers_schedule_unicast_dio(rpl_nbr_t *target);
 */
 void rpl_timers_schedule_dao(void);
 
+/**
+ * Get the delay before sending a DAO. With RPL_DAO_ADAPTIVE_JITTER, the
+ * delay depends on the node's depth and number of likely children.
+ *
+ * \param hops The depth of the node in the DODAG, 1 for children of the root
+ * \param children The number of neighbors deeper in the DODAG
+ * \return A random delay
+*/
+clock_time_t rpl_timers_dao_delay(unsigned hops, unsigned children);
+
+/**
+ * Schedule processing of the batch of DAOs held at the root, after
+ * RPL_DAO_BATCH_WINDOW. Does nothing if it is already scheduled.
+*/
+void rpl_timers_schedule_dao_batch(void);
+
 /**
  * Schedule a DAO-ACK with no delay
 */
@@ -142,6 +142,11 @@ struct rpl_nbr {
 #endif /* RPL_WITH_MC */
   rpl_rank_t rank;
   uint8_t dtsn;
+#if RPL_WITH_PARENT_RANKING
+  uint16_t path_cost;      /* The neighbor's path cost */
+  uint16_t candidate_pos;  /* 1 + position in the candidate parent heap,
+  0 if the neighbor is not acceptable as parent */
+#endif /* RPL_WITH_PARENT_RANKING */
 };
 typedef struct rpl_nbr rpl_nbr_t;
 
@@ -219,6 +224,9 @@ struct rpl_dag {
   uint16_t dao_ack_sequence;
   struct ctimer dao_ack_timer;
 #endif /* RPL_WITH_DAO_ACK */
+#if RPL_DAO_BATCH_SIZE > 0
+  struct ctimer dao_batch_timer;
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
 };
 typedef struct rpl_dag rpl_dag_t;
 
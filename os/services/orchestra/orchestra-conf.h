@@ -49,6 +49,13 @@
 #define ORCHESTRA_RULES { &eb_per_time_source, \
                           &unicast_per_neighbor_rpl_ns, \
                           &default_common }
+/* Example configuration with traffic-adaptive dedicated cells (requires 6top
+ * and TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS);
+ * the adaptive rule must come before the unicast rule: */
+/* #define ORCHESTRA_RULES { &eb_per_time_source, \
+                             &unicast_adaptive, \
+                             &unicast_per_neighbor_rpl_ns, \
+                             &default_common } */
 /* Example configuration for RPL storing mode: */
 /* #define ORCHESTRA_RULES { &eb_per_time_source, \
                              &unicast_per_neighbor_rpl_storing, \
@@ -84,6 +91,73 @@
 #define ORCHESTRA_ROOT_PERIOD                     7
 #endif /* ORCHESTRA_CONF_ROOT_PERIOD */
 
+/* The 6P Scheduling Function ID used by the adaptive rule (unmanaged range) */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_SFID
+#define ORCHESTRA_ADAPTIVE_SFID                   ORCHESTRA_CONF_ADAPTIVE_SFID
+#else /* ORCHESTRA_CONF_ADAPTIVE_SFID */
+#define ORCHESTRA_ADAPTIVE_SFID                   0xf1
+#endif /* ORCHESTRA_CONF_ADAPTIVE_SFID */
+
+/* The 6P transaction timeout of the adaptive rule. 6P messages travel in the
+ * shared unicast cells, which are congested when cells are needed. */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_6P_TIMEOUT
+#define ORCHESTRA_ADAPTIVE_6P_TIMEOUT             ORCHESTRA_CONF_ADAPTIVE_6P_TIMEOUT
+#else /* ORCHESTRA_CONF_ADAPTIVE_6P_TIMEOUT */
+#define ORCHESTRA_ADAPTIVE_6P_TIMEOUT             (10 * CLOCK_SECOND)
+#endif /* ORCHESTRA_CONF_ADAPTIVE_6P_TIMEOUT */
+
+/* The maximum number of dedicated cells with a given neighbor, per direction */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_MAX_CELLS
+#define ORCHESTRA_ADAPTIVE_MAX_CELLS              ORCHESTRA_CONF_ADAPTIVE_MAX_CELLS
+#else /* ORCHESTRA_CONF_ADAPTIVE_MAX_CELLS */
+#define ORCHESTRA_ADAPTIVE_MAX_CELLS              4
+#endif /* ORCHESTRA_CONF_ADAPTIVE_MAX_CELLS */
+
+/* The number of candidate cells proposed in a 6P Add request */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_CANDIDATES
+#define ORCHESTRA_ADAPTIVE_CANDIDATES             ORCHESTRA_CONF_ADAPTIVE_CANDIDATES
+#else /* ORCHESTRA_CONF_ADAPTIVE_CANDIDATES */
+#define ORCHESTRA_ADAPTIVE_CANDIDATES             3
+#endif /* ORCHESTRA_CONF_ADAPTIVE_CANDIDATES */
+
+/* How often the adaptive rule samples the queue occupancy of each neighbor */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_SAMPLE_INTERVAL
+#define ORCHESTRA_ADAPTIVE_SAMPLE_INTERVAL        ORCHESTRA_CONF_ADAPTIVE_SAMPLE_INTERVAL
+#else /* ORCHESTRA_CONF_ADAPTIVE_SAMPLE_INTERVAL */
+#define ORCHESTRA_ADAPTIVE_SAMPLE_INTERVAL        (CLOCK_SECOND / 2)
+#endif /* ORCHESTRA_CONF_ADAPTIVE_SAMPLE_INTERVAL */
+
+/* Hysteresis of the adaptive rule. The load is the average number of queued
+ * packets times the link ETX, in 1/8th of a packet. A cell is added when the
+ * load reaches the add threshold, and one is deleted after the load stayed
+ * at or below the remove threshold for ORCHESTRA_ADAPTIVE_IDLE samples.
+ * After each change, the rule waits ORCHESTRA_ADAPTIVE_HOLD samples.
+ * Cells are negotiated in the shared cells, so a long idle period keeps them
+ * across bursts rather than negotiating them again when the network is busy. */
+#ifdef ORCHESTRA_CONF_ADAPTIVE_ADD_THRESHOLD
+#define ORCHESTRA_ADAPTIVE_ADD_THRESHOLD          ORCHESTRA_CONF_ADAPTIVE_ADD_THRESHOLD
+#else /* ORCHESTRA_CONF_ADAPTIVE_ADD_THRESHOLD */
+#define ORCHESTRA_ADAPTIVE_ADD_THRESHOLD          16
+#endif /* ORCHESTRA_CONF_ADAPTIVE_ADD_THRESHOLD */
+
+#ifdef ORCHESTRA_CONF_ADAPTIVE_REMOVE_THRESHOLD
+#define ORCHESTRA_ADAPTIVE_REMOVE_THRESHOLD       ORCHESTRA_CONF_ADAPTIVE_REMOVE_THRESHOLD
+#else /* ORCHESTRA_CONF_ADAPTIVE_REMOVE_THRESHOLD */
+#define ORCHESTRA_ADAPTIVE_REMOVE_THRESHOLD       2
+#endif /* ORCHESTRA_CONF_ADAPTIVE_REMOVE_THRESHOLD */
+
+#ifdef ORCHESTRA_CONF_ADAPTIVE_HOLD
+#define ORCHESTRA_ADAPTIVE_HOLD                   ORCHESTRA_CONF_ADAPTIVE_HOLD
+#else /* ORCHESTRA_CONF_ADAPTIVE_HOLD */
+#define ORCHESTRA_ADAPTIVE_HOLD                   4
+#endif /* ORCHESTRA_CONF_ADAPTIVE_HOLD */
+
+#ifdef ORCHESTRA_CONF_ADAPTIVE_IDLE
+#define ORCHESTRA_ADAPTIVE_IDLE                   ORCHESTRA_CONF_ADAPTIVE_IDLE
+#else /* ORCHESTRA_CONF_ADAPTIVE_IDLE */
+#define ORCHESTRA_ADAPTIVE_IDLE                   120
+#endif /* ORCHESTRA_CONF_ADAPTIVE_IDLE */
+
 /* Is the per-neighbor unicast slotframe sender-based (if not, it is receiver-based).
  * Note: sender-based works only with RPL storing mode as it relies on DAO and
  * routing entries to keep track of children and parents. */
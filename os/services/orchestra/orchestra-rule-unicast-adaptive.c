@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Orchestra: a traffic-adaptive slotframe with dedicated unicast cells.
+ *         The rule watches the TSCH queue occupancy towards each RPL neighbor
+ *         (preferred parent and, in storing mode, children), weighted by the
+ *         link ETX. When the load stays high, it negotiates an extra dedicated
+ *         cell with the neighbor over 6P; when the load stays low, it deletes
+ *         one. The cells are installed in the rule's own slotframe: Tx at the
+ *         sender, Rx at the receiver, on the receiver's Orchestra channel offset.
+ *         Packets towards a neighbor with dedicated cells are sent only in these
+ *         cells, so this rule must be listed before the unicast rules. The
+ *         slotframe has the unicast period, and cells avoid the unicast
+ *         timeslots of both ends and of the sender's other neighbors.
+ *         The cells are negotiated by orchestra-sf-adaptive.c.
+ *         Requires TSCH_CONF_WITH_SIXTOP, and
+ *         TSCH_CONF_SELECTED_PACKETS_USE_SHARED_LINKS so that packets of the
+ *         other rules are not held back by our Tx cells.
+ *         RPL storing mode only, like the storing unicast rule. In
+ *         non-storing mode, bursts make RPL parents change often and routing
+ *         loops form, with or without the rule. Its cells then follow the
+ *         parent changes, and the bursts get through much worse than with
+ *         static Orchestra in some topologies.
+ */
+
+#include "contiki.h"
+#include "orchestra.h"
+#include "orchestra-sf-adaptive.h"
+#include "net/packetbuf.h"
+#include "net/nbr-table.h"
+#include "net/link-stats.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/mac/tsch/sixtop/sixp-trans.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Orchestra"
+#define LOG_LEVEL  LOG_LEVEL_MAC
+
+#if TSCH_WITH_SIXTOP && UIP_MAX_ROUTES != 0
+
+/* Load is measured in 1/8th of a queued packet */
+#define LOAD_SCALE 8
+
+NBR_TABLE(struct orchestra_adaptive_nbr, adaptive_nbrs);
+
+static uint16_t slotframe_handle = 0;
+static struct tsch_slotframe *sf_adaptive;
+static struct ctimer sample_timer;
+/* Our time source, i.e. RPL preferred parent. Kept here as the rule runs
+ * before the unicast rules, which update orchestra_parent_linkaddr. */
+static linkaddr_t parent_linkaddr;
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get_node_timeslot(const linkaddr_t *addr)
+{
+  return ORCHESTRA_LINKADDR_HASH(addr) % ORCHESTRA_UNICAST_PERIOD;
+}
+/*---------------------------------------------------------------------------*/
+/* Our cells take precedence over the unicast rule's. A Tx cell would shadow
+ * our shared Tx cells towards the neighbors whose unicast timeslot it uses,
+ * and any cell would shadow our own unicast Rx cell. */
+int
+orchestra_adaptive_timeslot_is_reserved(uint16_t timeslot, int is_tx)
+{
+  struct orchestra_adaptive_nbr *e;
+  if(timeslot == get_node_timeslot(&linkaddr_node_addr)) {
+    return 1;
+  }
+  if(is_tx) {
+    for(e = nbr_table_head(adaptive_nbrs); e != NULL; e = nbr_table_next(adaptive_nbrs, e)) {
+      if(timeslot == get_node_timeslot(nbr_table_get_lladdr(adaptive_nbrs, e))) {
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+struct orchestra_adaptive_nbr *
+orchestra_adaptive_get_nbr(const linkaddr_t *addr)
+{
+  return nbr_table_get_from_lladdr(adaptive_nbrs, addr);
+}
+/*---------------------------------------------------------------------------*/
+struct orchestra_adaptive_nbr *
+orchestra_adaptive_get_or_add_nbr(const linkaddr_t *addr)
+{
+  struct orchestra_adaptive_nbr *e = nbr_table_get_from_lladdr(adaptive_nbrs, addr);
+  if(e == NULL) {
+    e = nbr_table_add_lladdr(adaptive_nbrs, addr, NBR_TABLE_REASON_SIXTOP, NULL);
+    if(e != NULL) {
+      memset(e, 0, sizeof(*e));
+      e->pending_rx_timeslot = 0xffff;
+    }
+  }
+  return e;
+}
+/*---------------------------------------------------------------------------*/
+static void
+remove_nbr(const linkaddr_t *addr)
+{
+  struct orchestra_adaptive_nbr *e;
+  if(addr == NULL) {
+    return;
+  }
+  orchestra_sf_adaptive_remove_cells(addr);
+  e = nbr_table_get_from_lladdr(adaptive_nbrs, addr);
+  if(e != NULL) {
+    nbr_table_remove(adaptive_nbrs, e);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+sample(void *ptr)
+{
+  struct orchestra_adaptive_nbr *e;
+
+  ctimer_reset(&sample_timer);
+
+  for(e = nbr_table_head(adaptive_nbrs); e != NULL; e = nbr_table_next(adaptive_nbrs, e)) {
+    const linkaddr_t *addr = nbr_table_get_lladdr(adaptive_nbrs, e);
+    const struct link_stats *stats = link_stats_from_lladdr(addr);
+    struct tsch_neighbor *n = tsch_queue_get_nbr(addr);
+    uint32_t load = n != NULL ? tsch_queue_nbr_packet_count(n) * LOAD_SCALE : 0;
+    struct tsch_link *last = NULL;
+    int num_tx;
+
+    /* A lossy link needs more cells for the same traffic */
+    if(stats != NULL && stats->etx != 0) {
+      load = load * stats->etx / LINK_STATS_ETX_DIVISOR;
+    }
+    e->load = (e->load * 3 + MIN(load, 0xffff)) / 4;
+
+    if(e->hold > 0) {
+      e->hold--;
+      continue;
+    }
+    if(!tsch_is_associated || sixp_trans_find(addr) != NULL) {
+      continue;
+    }
+    if(e->resync) {
+      /* Start over from an empty schedule on both sides */
+      orchestra_sf_adaptive_request_clear(addr);
+      e->resync = 0;
+      e->hold = ORCHESTRA_ADAPTIVE_HOLD;
+      continue;
+    }
+
+    num_tx = orchestra_sf_adaptive_count_cells(addr, LINK_OPTION_TX, &last);
+    if(e->load >= ORCHESTRA_ADAPTIVE_ADD_THRESHOLD) {
+      e->idle = 0;
+      /* Only request cells towards the neighbors we route through: the
+       * parent and, in storing mode, the children. Packets may stay queued
+       * for a former parent, or for a neighbor that only requested cells
+       * from us, and cells to it would shadow our other Tx cells. */
+      if((e->is_child || linkaddr_cmp(addr, &parent_linkaddr))
+         && num_tx < ORCHESTRA_ADAPTIVE_MAX_CELLS
+         && orchestra_sf_adaptive_request_add(addr) == 0) {
+        e->hold = ORCHESTRA_ADAPTIVE_HOLD;
+      }
+    } else if(e->load <= ORCHESTRA_ADAPTIVE_REMOVE_THRESHOLD && num_tx > 0) {
+      /* Delete the last cell only once nothing is queued for it */
+      if(++e->idle >= ORCHESTRA_ADAPTIVE_IDLE
+         && (num_tx > 1 || load == 0)
+         && orchestra_sf_adaptive_request_delete(addr, last) == 0) {
+        e->idle = 0;
+        e->hold = ORCHESTRA_ADAPTIVE_HOLD;
+      }
+    } else {
+      e->idle = 0;
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+child_added(const linkaddr_t *linkaddr)
+{
+  struct orchestra_adaptive_nbr *e = orchestra_adaptive_get_or_add_nbr(linkaddr);
+  if(e != NULL) {
+    e->is_child = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+child_removed(const linkaddr_t *linkaddr)
+{
+  struct orchestra_adaptive_nbr *e = orchestra_adaptive_get_nbr(linkaddr);
+  if(e != NULL) {
+    e->is_child = 0;
+  }
+  if(!linkaddr_cmp(linkaddr, &parent_linkaddr)) {
+    remove_nbr(linkaddr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+select_packet(uint16_t *slotframe, uint16_t *timeslot, uint16_t *channel_offset)
+{
+  /* Steer data packets to neighbors we have dedicated Tx cells with */
+  const linkaddr_t *dest = packetbuf_addr(PACKETBUF_ADDR_RECEIVER);
+
+  if(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) == FRAME802154_DATAFRAME
+     && !orchestra_is_root_schedule_active(dest)
+     && orchestra_sf_adaptive_count_cells(dest, LINK_OPTION_TX, NULL) > 0) {
+    if(slotframe != NULL) {
+      *slotframe = slotframe_handle;
+    }
+    /* Any of the cells, on the channel offset negotiated for it */
+    return 1;
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+new_time_source(const struct tsch_neighbor *old, const struct tsch_neighbor *new)
+{
+  if(new != old) {
+    const linkaddr_t *old_addr = tsch_queue_get_nbr_address(old);
+    const linkaddr_t *new_addr = tsch_queue_get_nbr_address(new);
+    if(old_addr != NULL && orchestra_sf_adaptive_count_cells(old_addr, LINK_OPTION_TX, NULL) > 0) {
+      /* Release the cells on both sides. Cells the former parent uses to send
+       * to us go too: should it still need them, e.g. after becoming our
+       * child, it will request new ones. */
+      orchestra_sf_adaptive_request_clear(old_addr);
+      orchestra_sf_adaptive_remove_cells(old_addr);
+    }
+    if(new_addr != NULL) {
+      linkaddr_copy(&parent_linkaddr, new_addr);
+      orchestra_adaptive_get_or_add_nbr(new_addr);
+    } else {
+      linkaddr_copy(&parent_linkaddr, &linkaddr_null);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+init(uint16_t sf_handle)
+{
+  slotframe_handle = sf_handle;
+  linkaddr_copy(&parent_linkaddr, &linkaddr_null);
+  /* Slotframe for the dedicated cells, empty until traffic requires it */
+  sf_adaptive = tsch_schedule_add_slotframe(slotframe_handle, ORCHESTRA_UNICAST_PERIOD);
+  nbr_table_register(adaptive_nbrs, NULL);
+  orchestra_sf_adaptive_init(sf_adaptive);
+  ctimer_set(&sample_timer, ORCHESTRA_ADAPTIVE_SAMPLE_INTERVAL, sample, NULL);
+}
+/*---------------------------------------------------------------------------*/
+struct orchestra_rule unicast_adaptive = {
+  init,
+  new_time_source,
+  select_packet,
+  child_added,
+  child_removed,
+  NULL,
+  "unicast adaptive",
+  ORCHESTRA_UNICAST_PERIOD,
+};
+
+#endif /* TSCH_WITH_SIXTOP && UIP_MAX_ROUTES != 0 */
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Orchestra: the 6P scheduling function of the traffic-adaptive rule.
+ *         It negotiates one dedicated cell at a time with a neighbor, Tx at
+ *         the sender and Rx at the receiver, on the receiver's Orchestra
+ *         channel offset. The sender proposes free timeslots and the receiver
+ *         accepts the first one that is free on its side too.
+ */
+
+#include "contiki.h"
+#include "orchestra.h"
+#include "orchestra-sf-adaptive.h"
+#include "lib/random.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/mac/tsch/sixtop/sixtop.h"
+#include "net/mac/tsch/sixtop/sixp.h"
+#include "net/mac/tsch/sixtop/sixp-pkt.h"
+#include "net/mac/tsch/sixtop/sixp-trans.h"
+
+#include "sys/log.h"
+#define LOG_MODULE "Orchestra"
+#define LOG_LEVEL  LOG_LEVEL_MAC
+
+#if TSCH_WITH_SIXTOP && UIP_MAX_ROUTES != 0
+
+/* A 6P cell: timeslot and channel offset, little endian */
+#define CELL_LEN 4
+/* Fixed part of Add and Delete requests: Metadata, CellOptions, NumCells */
+#define REQ_HDR_LEN 4
+
+static struct tsch_slotframe *sf_adaptive;
+static uint8_t req_storage[REQ_HDR_LEN + ORCHESTRA_ADAPTIVE_CANDIDATES * CELL_LEN];
+static uint8_t res_storage[CELL_LEN];
+
+static const sixtop_sf_t sf_adaptive_driver;
+
+/*---------------------------------------------------------------------------*/
+static uint16_t
+get_node_channel_offset(const linkaddr_t *addr)
+{
+  if(addr != NULL && ORCHESTRA_UNICAST_MAX_CHANNEL_OFFSET >= ORCHESTRA_UNICAST_MIN_CHANNEL_OFFSET) {
+    return ORCHESTRA_LINKADDR_HASH(addr) % (ORCHESTRA_UNICAST_MAX_CHANNEL_OFFSET - ORCHESTRA_UNICAST_MIN_CHANNEL_OFFSET + 1)
+        + ORCHESTRA_UNICAST_MIN_CHANNEL_OFFSET;
+  } else {
+    return 0xffff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+read_cell(const uint8_t *buf, uint16_t *timeslot, uint16_t *channel_offset)
+{
+  *timeslot = buf[0] | (buf[1] << 8);
+  *channel_offset = buf[2] | (buf[3] << 8);
+}
+/*---------------------------------------------------------------------------*/
+static void
+write_cell(uint8_t *buf, uint16_t timeslot, uint16_t channel_offset)
+{
+  buf[0] = timeslot & 0xff;
+  buf[1] = timeslot >> 8;
+  buf[2] = channel_offset & 0xff;
+  buf[3] = channel_offset >> 8;
+}
+/*---------------------------------------------------------------------------*/
+int
+orchestra_sf_adaptive_timeslot_is_free(uint16_t timeslot)
+{
+  struct tsch_link *l;
+  l = list_head(sf_adaptive->links_list);
+  while(l != NULL) {
+    if(l->timeslot == timeslot) {
+      return 0;
+    }
+    l = list_item_next(l);
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+/* Returns the number of cells with the given options to a neighbor,
+ * and one of them in `last` */
+int
+orchestra_sf_adaptive_count_cells(const linkaddr_t *addr, uint8_t link_options, struct tsch_link **last)
+{
+  int count = 0;
+  struct tsch_link *l = list_head(sf_adaptive->links_list);
+  while(l != NULL) {
+    if(l->link_options == link_options && linkaddr_cmp(&l->addr, addr)) {
+      count++;
+      if(last != NULL) {
+        *last = l;
+      }
+    }
+    l = list_item_next(l);
+  }
+  return count;
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_sf_adaptive_remove_cells(const linkaddr_t *addr)
+{
+  struct tsch_link *l = list_head(sf_adaptive->links_list);
+  if(orchestra_sf_adaptive_count_cells(addr, LINK_OPTION_TX, NULL) > 0) {
+    /* Packets steered to our Tx cells would remain stuck in the queue */
+    tsch_queue_free_packets_to(addr);
+  }
+  while(l != NULL) {
+    struct tsch_link *next = list_item_next(l);
+    if(linkaddr_cmp(&l->addr, addr)) {
+      tsch_schedule_remove_link(sf_adaptive, l);
+    }
+    l = next;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+orchestra_sf_adaptive_request_add(const linkaddr_t *addr)
+{
+  int i, num_candidates = 0;
+  uint16_t channel_offset = get_node_channel_offset(addr);
+
+  memset(req_storage, 0, sizeof(req_storage));
+  /* Propose random free timeslots, on the receiver's channel offset */
+  for(i = 0; i < 4 * ORCHESTRA_ADAPTIVE_CANDIDATES
+      && num_candidates < ORCHESTRA_ADAPTIVE_CANDIDATES; i++) {
+    uint16_t timeslot = random_rand() % ORCHESTRA_UNICAST_PERIOD;
+    int j, duplicate = 0;
+    for(j = 0; j < num_candidates; j++) {
+      uint16_t ts, ch;
+      read_cell(&req_storage[REQ_HDR_LEN + j * CELL_LEN], &ts, &ch);
+      duplicate |= ts == timeslot;
+    }
+    if(!duplicate && orchestra_sf_adaptive_timeslot_is_free(timeslot) && !orchestra_adaptive_timeslot_is_reserved(timeslot, 1)) {
+      write_cell(&req_storage[REQ_HDR_LEN + num_candidates * CELL_LEN], timeslot, channel_offset);
+      num_candidates++;
+    }
+  }
+  if(num_candidates == 0) {
+    return -1;
+  }
+
+  if(sixp_pkt_set_cell_options(SIXP_PKT_TYPE_REQUEST,
+                               (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_ADD,
+                               SIXP_PKT_CELL_OPTION_TX,
+                               req_storage, sizeof(req_storage)) != 0 ||
+     sixp_pkt_set_num_cells(SIXP_PKT_TYPE_REQUEST,
+                            (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_ADD,
+                            1, req_storage, sizeof(req_storage)) != 0) {
+    return -1;
+  }
+  return sixp_output(SIXP_PKT_TYPE_REQUEST, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_ADD,
+                     ORCHESTRA_ADAPTIVE_SFID,
+                     req_storage, REQ_HDR_LEN + num_candidates * CELL_LEN, addr,
+                     NULL, NULL, 0);
+}
+/*---------------------------------------------------------------------------*/
+int
+orchestra_sf_adaptive_request_delete(const linkaddr_t *addr, struct tsch_link *l)
+{
+  memset(req_storage, 0, sizeof(req_storage));
+  write_cell(&req_storage[REQ_HDR_LEN], l->timeslot, l->channel_offset);
+  if(sixp_pkt_set_cell_options(SIXP_PKT_TYPE_REQUEST,
+                               (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_DELETE,
+                               SIXP_PKT_CELL_OPTION_TX,
+                               req_storage, sizeof(req_storage)) != 0 ||
+     sixp_pkt_set_num_cells(SIXP_PKT_TYPE_REQUEST,
+                            (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_DELETE,
+                            1, req_storage, sizeof(req_storage)) != 0) {
+    return -1;
+  }
+  if(sixp_output(SIXP_PKT_TYPE_REQUEST, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_DELETE,
+                 ORCHESTRA_ADAPTIVE_SFID,
+                 req_storage, REQ_HDR_LEN + CELL_LEN, addr,
+                 NULL, NULL, 0) != 0) {
+    return -1;
+  }
+  /* Stop using the cell right away rather than when the response arrives:
+   * should either message be lost, the peer is left with an unused Rx cell
+   * instead of us sending in a cell it no longer listens to */
+  LOG_INFO("adaptive: removed tx cell %u to ", l->timeslot);
+  LOG_INFO_LLADDR(addr);
+  LOG_INFO_("\n");
+  tsch_schedule_remove_link(sf_adaptive, l);
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_sf_adaptive_request_clear(const linkaddr_t *addr)
+{
+  /* Best effort: the peer also drops our cells when it loses us as a child */
+  memset(req_storage, 0, sizeof(sixp_pkt_metadata_t));
+  sixp_output(SIXP_PKT_TYPE_REQUEST, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_CLEAR,
+              ORCHESTRA_ADAPTIVE_SFID, req_storage, sizeof(sixp_pkt_metadata_t), addr, NULL, NULL, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+response_sent(void *arg, uint16_t arg_len, const linkaddr_t *dest_addr,
+              sixp_output_status_t status)
+{
+  struct orchestra_adaptive_nbr *e = orchestra_adaptive_get_nbr(dest_addr);
+  if(e != NULL && e->pending_rx_timeslot != 0xffff) {
+    if(status == SIXP_OUTPUT_STATUS_SUCCESS) {
+      tsch_schedule_add_link(sf_adaptive, LINK_OPTION_RX, LINK_TYPE_NORMAL, dest_addr,
+                             e->pending_rx_timeslot, e->pending_rx_channel_offset, 0);
+      LOG_INFO("adaptive: rx cell %u to ", e->pending_rx_timeslot);
+      LOG_INFO_LLADDR(dest_addr);
+      LOG_INFO_(", %u cells\n", orchestra_sf_adaptive_count_cells(dest_addr, LINK_OPTION_RX, NULL));
+    }
+    e->pending_rx_timeslot = 0xffff;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_request_input(const uint8_t *body, uint16_t body_len, const linkaddr_t *peer_addr)
+{
+  const uint8_t *cell_list;
+  uint16_t cell_list_len;
+  uint16_t i, res_len = 0;
+  struct orchestra_adaptive_nbr *e = orchestra_adaptive_get_or_add_nbr(peer_addr);
+
+  if(e != NULL
+     && orchestra_sf_adaptive_count_cells(peer_addr, LINK_OPTION_RX, NULL) < ORCHESTRA_ADAPTIVE_MAX_CELLS
+     && sixp_pkt_get_cell_list(SIXP_PKT_TYPE_REQUEST,
+                               (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_ADD,
+                               &cell_list, &cell_list_len, body, body_len) == 0) {
+    /* Accept the first candidate whose timeslot is free on our side */
+    for(i = 0; i + CELL_LEN <= cell_list_len; i += CELL_LEN) {
+      uint16_t timeslot, channel_offset;
+      read_cell(&cell_list[i], &timeslot, &channel_offset);
+      if(timeslot < ORCHESTRA_UNICAST_PERIOD && orchestra_sf_adaptive_timeslot_is_free(timeslot)
+         && !orchestra_adaptive_timeslot_is_reserved(timeslot, 0)) {
+        memcpy(res_storage, &cell_list[i], CELL_LEN);
+        res_len = CELL_LEN;
+        e->pending_rx_timeslot = timeslot;
+        e->pending_rx_channel_offset = channel_offset;
+        break;
+      }
+    }
+  }
+
+  /* An empty cell list tells the requester that no candidate was accepted */
+  sixp_output(SIXP_PKT_TYPE_RESPONSE, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
+              ORCHESTRA_ADAPTIVE_SFID, res_len > 0 ? res_storage : NULL, res_len, peer_addr,
+              response_sent, NULL, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+delete_request_input(const uint8_t *body, uint16_t body_len, const linkaddr_t *peer_addr)
+{
+  const uint8_t *cell_list;
+  uint16_t cell_list_len;
+  uint16_t i, res_len = 0;
+
+  if(sixp_pkt_get_cell_list(SIXP_PKT_TYPE_REQUEST,
+                            (sixp_pkt_code_t)(uint8_t)SIXP_PKT_CMD_DELETE,
+                            &cell_list, &cell_list_len, body, body_len) == 0) {
+    for(i = 0; i + CELL_LEN <= cell_list_len; i += CELL_LEN) {
+      uint16_t timeslot, channel_offset;
+      struct tsch_link *l;
+      read_cell(&cell_list[i], &timeslot, &channel_offset);
+      l = tsch_schedule_get_link_by_timeslot(sf_adaptive, timeslot, channel_offset);
+      if(l != NULL && linkaddr_cmp(&l->addr, peer_addr)) {
+        tsch_schedule_remove_link(sf_adaptive, l);
+        memcpy(res_storage, &cell_list[i], CELL_LEN);
+        res_len = CELL_LEN;
+        LOG_INFO("adaptive: removed rx cell %u to ", timeslot);
+        LOG_INFO_LLADDR(peer_addr);
+        LOG_INFO_("\n");
+        break;
+      }
+    }
+  }
+
+  sixp_output(SIXP_PKT_TYPE_RESPONSE, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
+              ORCHESTRA_ADAPTIVE_SFID, res_len > 0 ? res_storage : NULL, res_len, peer_addr,
+              NULL, NULL, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+response_input(sixp_pkt_rc_t rc, const uint8_t *body, uint16_t body_len,
+               const linkaddr_t *peer_addr)
+{
+  const uint8_t *cell_list;
+  uint16_t cell_list_len;
+  uint16_t timeslot, channel_offset;
+  sixp_trans_t *trans = sixp_trans_find(peer_addr);
+  sixp_pkt_cmd_t cmd;
+
+  if(trans == NULL) {
+    return;
+  }
+  cmd = sixp_trans_get_cmd(trans);
+  /* Only Add responses matter: we stop using cells when asking to delete them */
+  if(rc != SIXP_PKT_RC_SUCCESS
+     || cmd != SIXP_PKT_CMD_ADD
+     || sixp_pkt_get_cell_list(SIXP_PKT_TYPE_RESPONSE,
+                               (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
+                               &cell_list, &cell_list_len, body, body_len) != 0
+     || cell_list_len < CELL_LEN) {
+    return;
+  }
+
+  read_cell(cell_list, &timeslot, &channel_offset);
+  if(timeslot < ORCHESTRA_UNICAST_PERIOD && orchestra_sf_adaptive_timeslot_is_free(timeslot)) {
+    tsch_schedule_add_link(sf_adaptive, LINK_OPTION_TX, LINK_TYPE_NORMAL, peer_addr,
+                           timeslot, channel_offset, 0);
+    LOG_INFO("adaptive: tx cell %u to ", timeslot);
+    LOG_INFO_LLADDR(peer_addr);
+    LOG_INFO_(", %u cells\n", orchestra_sf_adaptive_count_cells(peer_addr, LINK_OPTION_TX, NULL));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input(sixp_pkt_type_t type, sixp_pkt_code_t code,
+      const uint8_t *body, uint16_t body_len, const linkaddr_t *src_addr)
+{
+  if(sf_adaptive == NULL) {
+    return;
+  }
+  if(type == SIXP_PKT_TYPE_REQUEST) {
+    switch(code.cmd) {
+      case SIXP_PKT_CMD_ADD:
+        add_request_input(body, body_len, src_addr);
+        break;
+      case SIXP_PKT_CMD_DELETE:
+        delete_request_input(body, body_len, src_addr);
+        break;
+      case SIXP_PKT_CMD_CLEAR:
+        orchestra_sf_adaptive_remove_cells(src_addr);
+        sixp_output(SIXP_PKT_TYPE_RESPONSE, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_SUCCESS,
+                    ORCHESTRA_ADAPTIVE_SFID, NULL, 0, src_addr, NULL, NULL, 0);
+        break;
+      default:
+        sixp_output(SIXP_PKT_TYPE_RESPONSE, (sixp_pkt_code_t)(uint8_t)SIXP_PKT_RC_ERR,
+                    ORCHESTRA_ADAPTIVE_SFID, NULL, 0, src_addr, NULL, NULL, 0);
+        break;
+    }
+  } else if(type == SIXP_PKT_TYPE_RESPONSE) {
+    response_input(code.rc, body, body_len, src_addr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+error(sixp_error_t err, sixp_pkt_cmd_t cmd, uint8_t seqno,
+      const linkaddr_t *peer_addr)
+{
+  struct orchestra_adaptive_nbr *e = orchestra_adaptive_get_nbr(peer_addr);
+  if(e != NULL && err == SIXP_ERROR_SCHEDULE_INCONSISTENCY) {
+    /* Start over: drop our cells now, and clear the peer's at the next sample */
+    orchestra_sf_adaptive_remove_cells(peer_addr);
+    e->resync = 1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+void
+orchestra_sf_adaptive_init(struct tsch_slotframe *sf)
+{
+  sf_adaptive = sf;
+  sixtop_add_sf(&sf_adaptive_driver);
+}
+/*---------------------------------------------------------------------------*/
+static const sixtop_sf_t sf_adaptive_driver = {
+  ORCHESTRA_ADAPTIVE_SFID,
+  ORCHESTRA_ADAPTIVE_6P_TIMEOUT,
+  NULL,
+  input,
+  NULL,
+  error
+};
+
+#endif /* TSCH_WITH_SIXTOP && UIP_MAX_ROUTES != 0 */
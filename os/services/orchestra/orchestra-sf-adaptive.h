@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *         Orchestra: the 6P scheduling function that negotiates the cells of
+ *         the traffic-adaptive rule (orchestra-rule-unicast-adaptive.c).
+ *         The rule decides when to add or delete a cell; this module builds
+ *         and parses the 6P messages and installs the agreed cells in the
+ *         rule's slotframe.
+ */
+
+#ifndef ORCHESTRA_SF_ADAPTIVE_H_
+#define ORCHESTRA_SF_ADAPTIVE_H_
+
+#include "orchestra.h"
+#include "net/mac/tsch/sixtop/sixtop.h"
+
+/* Per-neighbor state of the adaptive rule */
+struct orchestra_adaptive_nbr {
+  /* EWMA of the ETX-weighted queue occupancy, in 1/8th of a packet */
+  uint16_t load;
+  /* Rx cell chosen for the neighbor, installed once our response is sent */
+  uint16_t pending_rx_timeslot;
+  uint16_t pending_rx_channel_offset;
+  /* Samples to wait before the next decision */
+  uint8_t hold;
+  /* Consecutive samples below the removal threshold */
+  uint16_t idle;
+  /* Set when the neighbor's view of our cells may differ from ours */
+  uint8_t resync;
+  /* Set while the neighbor is our RPL child (storing mode) */
+  uint8_t is_child;
+};
+
+/* Provided by the rule */
+struct orchestra_adaptive_nbr *orchestra_adaptive_get_nbr(const linkaddr_t *addr);
+struct orchestra_adaptive_nbr *orchestra_adaptive_get_or_add_nbr(const linkaddr_t *addr);
+int orchestra_adaptive_timeslot_is_reserved(uint16_t timeslot, int is_tx);
+
+/* Provided by the scheduling function */
+void orchestra_sf_adaptive_init(struct tsch_slotframe *sf);
+int orchestra_sf_adaptive_count_cells(const linkaddr_t *addr, uint8_t link_options,
+                                      struct tsch_link **last);
+int orchestra_sf_adaptive_timeslot_is_free(uint16_t timeslot);
+void orchestra_sf_adaptive_remove_cells(const linkaddr_t *addr);
+int orchestra_sf_adaptive_request_add(const linkaddr_t *addr);
+int orchestra_sf_adaptive_request_delete(const linkaddr_t *addr, struct tsch_link *l);
+void orchestra_sf_adaptive_request_clear(const linkaddr_t *addr);
+
+#endif /* ORCHESTRA_SF_ADAPTIVE_H_ */
@@ -614,6 +614,21 @@ PT_THREAD(cmd_tsch_status(struct pt *pt, shell_output_func output, char *args))
     SHELL_OUTPUT(output, "-- Network uptime: %lu seconds\n",
                  (unsigned long)(tsch_get_network_uptime_ticks() / CLOCK_SECOND));
   }
+#if TSCH_STATS_PROFILE
+  {
+    int i;
+    SHELL_OUTPUT(output, "-- Slot operation profile (usec min/avg/max, count, misses):\n");
+    for(i = 0; i < TSCH_STATS_PHASE_COUNT; i++) {
+      const struct tsch_stats_phase_profile *p = tsch_stats_profile_get(i);
+      SHELL_OUTPUT(output, "---- %-10s %lu/%lu/%lu, %lu, %u\n",
+                   tsch_stats_profile_phase_name(i),
+                   (unsigned long)RTIMERTICKS_TO_US_64(p->min),
+                   (unsigned long)RTIMERTICKS_TO_US_64(p->count ? p->sum / p->count : 0),
+                   (unsigned long)RTIMERTICKS_TO_US_64(p->max),
+                   (unsigned long)p->count, p->misses);
+    }
+  }
+#endif /* TSCH_STATS_PROFILE */
 
   PT_END(pt);
 }
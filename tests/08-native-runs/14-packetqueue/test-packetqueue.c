@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/*
+ * \file
+ *      Unit tests for the per-neighbor packet queue used during
+ *      IPv6 address resolution, and for the release of the queued
+ *      packets when the neighbor answers.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-nd6.h"
+#include "net/ipv6/uip-packetqueue.h"
+#include "net/ipv6/uipbuf.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define SHORT_LIFETIME (CLOCK_SECOND / 4)
+#define LONG_LIFETIME  (60 * CLOCK_SECOND)
+#define UDP_PORT       5678
+#define QUEUED         3
+
+static struct uip_packetqueue_handle h1;
+static struct uip_packetqueue_handle h2;
+static uint8_t pkt[32];
+static struct etimer et;
+
+static struct simple_udp_connection udp_conn;
+static uip_ipaddr_t nbr_ipaddr;
+static uip_lladdr_t nbr_lladdr = { { 0x02, 0x12, 0x4b, 0x00, 0, 0, 0, 0x02 } };
+static uint8_t sent_tags[2 * QUEUED];
+static int sent_count;
+static int ns_count;
+/*****************************************************************************/
+PROCESS(test_packetqueue_process, "Packet queue test process");
+AUTOSTART_PROCESSES(&test_packetqueue_process);
+/*****************************************************************************/
+static struct uip_packetqueue_packet *
+add(struct uip_packetqueue_handle *h, uint8_t tag, clock_time_t lifetime)
+{
+  memset(pkt, tag, sizeof(pkt));
+  return uip_packetqueue_add(h, lifetime, pkt, tag);
+}
+/*****************************************************************************/
+/* Record the UDP datagrams and NSs that reach the network layer */
+static enum netstack_ip_action
+capture_output(const linkaddr_t *localdest)
+{
+  if(UIP_IP_BUF->proto == UIP_PROTO_UDP &&
+     uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &nbr_ipaddr)) {
+    if(sent_count < sizeof(sent_tags)) {
+      sent_tags[sent_count] = uip_buf[UIP_IPUDPH_LEN];
+    }
+    sent_count++;
+  } else if(UIP_IP_BUF->proto == UIP_PROTO_ICMP6 &&
+            UIP_ICMP_BUF->type == ICMP6_NS) {
+    ns_count++;
+  }
+  return NETSTACK_IP_DROP;
+}
+
+static struct netstack_ip_packet_processor capture = {
+  .process_output = capture_output
+};
+/*****************************************************************************/
+/* Let the neighbor answer our NS with a solicited NA */
+static void
+receive_na(void)
+{
+  uip_nd6_na *na = (uip_nd6_na *)UIP_ICMP_PAYLOAD;
+  uint8_t *llao;
+
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = UIP_ND6_HOP_LIMIT;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, &nbr_ipaddr);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr,
+                  &uip_ds6_get_link_local(-1)->ipaddr);
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_ICMPH_LEN + UIP_ND6_NA_LEN +
+                       UIP_ND6_OPT_LLAO_LEN);
+  UIP_ICMP_BUF->type = ICMP6_NA;
+  UIP_ICMP_BUF->icode = 0;
+  na->flagsreserved = UIP_ND6_NA_FLAG_SOLICITED | UIP_ND6_NA_FLAG_OVERRIDE;
+  uip_ipaddr_copy(&na->tgtipaddr, &nbr_ipaddr);
+  llao = &uip_buf[UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN];
+  memset(llao, 0, UIP_ND6_OPT_LLAO_LEN);
+  llao[UIP_ND6_OPT_TYPE_OFFSET] = UIP_ND6_OPT_TLLAO;
+  llao[UIP_ND6_OPT_LEN_OFFSET] = UIP_ND6_OPT_LLAO_LEN >> 3;
+  memcpy(&llao[UIP_ND6_OPT_DATA_OFFSET], &nbr_lladdr, UIP_LLADDR_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+  uipbuf_set_len(UIP_IPH_LEN + UIP_ICMPH_LEN + UIP_ND6_NA_LEN +
+                 UIP_ND6_OPT_LLAO_LEN);
+  tcpip_input();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(fifo_order, "FIFO order and draining");
+UNIT_TEST(fifo_order)
+{
+  UNIT_TEST_BEGIN();
+
+  uip_packetqueue_new(&h1);
+  UNIT_TEST_ASSERT(uip_packetqueue_buflen(&h1) == 0);
+  UNIT_TEST_ASSERT(uip_packetqueue_buf(&h1) == NULL);
+
+  UNIT_TEST_ASSERT(add(&h1, 1, LONG_LIFETIME) != NULL);
+  UNIT_TEST_ASSERT(add(&h1, 2, LONG_LIFETIME) != NULL);
+  UNIT_TEST_ASSERT(add(&h1, 3, LONG_LIFETIME) != NULL);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h1) == 3);
+
+  /* Packets are released oldest first, and all of them can be drained. */
+  for(uint8_t tag = 1; tag <= 3; tag++) {
+    UNIT_TEST_ASSERT(uip_packetqueue_buflen(&h1) == tag);
+    UNIT_TEST_ASSERT(uip_packetqueue_buf(&h1)[0] == tag);
+    uip_packetqueue_free(&h1);
+  }
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h1) == 0);
+  UNIT_TEST_ASSERT(uip_packetqueue_buflen(&h1) == 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(overflow, "Depth limit and shared pool");
+UNIT_TEST(overflow)
+{
+  UNIT_TEST_BEGIN();
+
+  uip_stats_t overflows = uip_stat.nd6.queue_overflow;
+  uip_stats_t nomem = uip_stat.nd6.queue_nomem;
+
+  uip_packetqueue_new(&h1);
+  uip_packetqueue_new(&h2);
+
+  /* A fourth packet replaces the oldest one in a queue of depth three. */
+  for(uint8_t tag = 1; tag <= 4; tag++) {
+    UNIT_TEST_ASSERT(add(&h1, tag, LONG_LIFETIME) != NULL);
+  }
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h1) == 3);
+  UNIT_TEST_ASSERT(uip_packetqueue_buf(&h1)[0] == 2);
+  UNIT_TEST_ASSERT(uip_stat.nd6.queue_overflow == overflows + 1);
+
+  /* The pool holds four packets in total, shared between the queues. */
+  UNIT_TEST_ASSERT(add(&h2, 10, LONG_LIFETIME) != NULL);
+  UNIT_TEST_ASSERT(add(&h2, 11, LONG_LIFETIME) == NULL);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h2) == 1);
+  UNIT_TEST_ASSERT(uip_stat.nd6.queue_nomem == nomem + 1);
+
+  uip_packetqueue_flush(&h1);
+  uip_packetqueue_flush(&h2);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h1) == 0);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&h2) == 0);
+
+  /* Flushing returns all buffers to the pool. */
+  for(uint8_t tag = 1; tag <= 3; tag++) {
+    UNIT_TEST_ASSERT(add(&h1, tag, LONG_LIFETIME) != NULL);
+  }
+  UNIT_TEST_ASSERT(add(&h2, 10, LONG_LIFETIME) != NULL);
+  uip_packetqueue_flush(&h1);
+  uip_packetqueue_flush(&h2);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(resolution, "Release on address resolution");
+UNIT_TEST(resolution)
+{
+  uip_ds6_nbr_t *nbr;
+  uint8_t tag;
+
+  UNIT_TEST_BEGIN();
+
+  uip_ip6addr(&nbr_ipaddr, 0xfe80, 0, 0, 0, 0x0012, 0x4b00, 0, 0x0002);
+  simple_udp_register(&udp_conn, UDP_PORT, NULL, UDP_PORT, NULL);
+  netstack_ip_packet_processor_add(&capture);
+
+  /* The first datagram starts address resolution, the others wait */
+  for(tag = 1; tag <= QUEUED; tag++) {
+    simple_udp_sendto(&udp_conn, &tag, sizeof(tag), &nbr_ipaddr);
+  }
+  nbr = uip_ds6_nbr_lookup(&nbr_ipaddr);
+  UNIT_TEST_ASSERT(nbr != NULL && nbr->state == NBR_INCOMPLETE);
+  UNIT_TEST_ASSERT(ns_count == 1);
+  UNIT_TEST_ASSERT(sent_count == 0);
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&nbr->packethandle) == QUEUED);
+
+  /* The NA releases every queued datagram, oldest first */
+  receive_na();
+  UNIT_TEST_ASSERT(nbr->state == NBR_REACHABLE);
+  UNIT_TEST_ASSERT(sent_count == QUEUED);
+  for(tag = 1; tag <= QUEUED; tag++) {
+    UNIT_TEST_ASSERT(sent_tags[tag - 1] == tag);
+  }
+  UNIT_TEST_ASSERT(uip_packetqueue_count(&nbr->packethandle) == 0);
+
+  /* Later datagrams go out directly */
+  simple_udp_sendto(&udp_conn, &tag, sizeof(tag), &nbr_ipaddr);
+  UNIT_TEST_ASSERT(sent_count == QUEUED + 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_packetqueue_process, ev, data)
+{
+  static uip_stats_t expired;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(fifo_order);
+  UNIT_TEST_RUN(overflow);
+  UNIT_TEST_RUN(resolution);
+
+  /* Packets that outlive their lifetime are discarded individually. */
+  expired = uip_stat.nd6.queue_expired;
+  uip_packetqueue_new(&h1);
+  add(&h1, 1, SHORT_LIFETIME);
+  add(&h1, 2, LONG_LIFETIME);
+  etimer_set(&et, 2 * SHORT_LIFETIME);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  printf("Expired packets: %u\n",
+         (unsigned)(uip_stat.nd6.queue_expired - expired));
+
+  if(!UNIT_TEST_PASSED(fifo_order) ||
+     !UNIT_TEST_PASSED(overflow) ||
+     !UNIT_TEST_PASSED(resolution) ||
+     uip_stat.nd6.queue_expired != expired + 1 ||
+     uip_packetqueue_count(&h1) != 1 ||
+     uip_packetqueue_buf(&h1)[0] != 2) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+  uip_packetqueue_flush(&h1);
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
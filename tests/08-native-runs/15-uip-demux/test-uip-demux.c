@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/*
+ * \file
+ *      Unit tests for UDP and TCP demultiplexing in uIP. Build with
+ *      CONN_HASH=0 to test the linear table scan instead of the hash
+ *      index.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define TCP_SYN 0x02
+#define TCP_RST 0x04
+
+#define UDP_PORT_A 5000
+#define UDP_PORT_B 6000
+
+static uip_ipaddr_t local_addr;
+static uip_ipaddr_t peer_addr;
+static uip_ipaddr_t other_addr;
+/*****************************************************************************/
+PROCESS(test_uip_demux_process, "uIP demultiplexing test process");
+AUTOSTART_PROCESSES(&test_uip_demux_process);
+/*****************************************************************************/
+static void
+ip_header(const uip_ipaddr_t *src, uint8_t proto, uint16_t payload_len)
+{
+  memset(uip_buf, 0, UIP_IPH_LEN + payload_len);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = proto;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, payload_len);
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &local_addr);
+  uip_len = UIP_IPH_LEN + payload_len;
+  uip_ext_len = 0;
+}
+/*****************************************************************************/
+/* Feed a UDP datagram to uIP and return the connection it matched. */
+static struct uip_udp_conn *
+udp_input(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport)
+{
+  ip_header(src, UIP_PROTO_UDP, UIP_UDPH_LEN);
+  UIP_UDP_BUF->srcport = UIP_HTONS(srcport);
+  UIP_UDP_BUF->destport = UIP_HTONS(destport);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN);
+  /* A zero checksum is accepted by uIP. */
+  UIP_UDP_BUF->udpchksum = 0;
+
+  uip_udp_conn = NULL;
+  uip_input();
+  uipbuf_clear();
+  return uip_udp_conn;
+}
+/*****************************************************************************/
+static void
+tcp_input(const uip_ipaddr_t *src, uint16_t srcport, uint16_t destport,
+          uint8_t flags)
+{
+  ip_header(src, UIP_PROTO_TCP, UIP_TCPH_LEN);
+  UIP_TCP_BUF->srcport = UIP_HTONS(srcport);
+  UIP_TCP_BUF->destport = UIP_HTONS(destport);
+  UIP_TCP_BUF->tcpoffset = 5 << 4;
+  UIP_TCP_BUF->flags = flags;
+  UIP_TCP_BUF->wnd[0] = 1;
+  UIP_TCP_BUF->tcpchksum = 0;
+  UIP_TCP_BUF->tcpchksum = ~(uip_tcpchksum());
+
+  uip_conn = NULL;
+  uip_input();
+  uipbuf_clear();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(udp_wildcards, "UDP wildcard matching");
+UNIT_TEST(udp_wildcards)
+{
+  struct uip_udp_conn *specific;
+  struct uip_udp_conn *wildcard;
+  struct uip_udp_conn *other;
+
+  UNIT_TEST_BEGIN();
+
+  /* The connection bound to a remote endpoint comes first in the
+     table, so it must win over the wildcard connection. */
+  specific = uip_udp_new(&peer_addr, UIP_HTONS(UDP_PORT_B));
+  wildcard = uip_udp_new(NULL, 0);
+  UNIT_TEST_ASSERT(specific != NULL && wildcard != NULL);
+  uip_udp_bind(specific, UIP_HTONS(UDP_PORT_A));
+  uip_udp_bind(wildcard, UIP_HTONS(UDP_PORT_A));
+
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A) == specific);
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B + 1, UDP_PORT_A) == wildcard);
+  UNIT_TEST_ASSERT(udp_input(&other_addr, UDP_PORT_B, UDP_PORT_A) == wildcard);
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A + 1) == NULL);
+
+  /* Rebinding moves a connection to its new port. */
+  uip_udp_bind(specific, UIP_HTONS(UDP_PORT_A + 1));
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A) == wildcard);
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A + 1) == specific);
+
+  /* A port that hashes to the same bucket must not match. */
+  other = uip_udp_new(NULL, 0);
+  UNIT_TEST_ASSERT(other != NULL);
+  uip_udp_bind(other, UIP_HTONS(UDP_PORT_A + 256 + 1));
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A) == wildcard);
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B,
+                             UDP_PORT_A + 256 + 1) == other);
+
+  /* Removed connections no longer receive packets. */
+  uip_udp_remove(wildcard);
+  UNIT_TEST_ASSERT(udp_input(&other_addr, UDP_PORT_B, UDP_PORT_A) == NULL);
+  uip_udp_remove(specific);
+  uip_udp_remove(other);
+  UNIT_TEST_ASSERT(udp_input(&peer_addr, UDP_PORT_B, UDP_PORT_A + 1) == NULL);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(tcp_listen, "TCP listen port matching");
+UNIT_TEST(tcp_listen)
+{
+  uip_stats_t synrst;
+
+  UNIT_TEST_BEGIN();
+
+  synrst = uip_stat.tcp.synrst;
+  tcp_input(&peer_addr, 40000, 80, TCP_SYN);
+  UNIT_TEST_ASSERT(uip_stat.tcp.synrst == synrst + 1);
+
+  uip_listen(UIP_HTONS(80));
+  tcp_input(&peer_addr, 40000, 80, TCP_SYN);
+  UNIT_TEST_ASSERT(uip_stat.tcp.synrst == synrst + 1);
+  UNIT_TEST_ASSERT(uip_conn != NULL);
+  UNIT_TEST_ASSERT(uip_conn->lport == UIP_HTONS(80));
+  UNIT_TEST_ASSERT(uip_conn->rport == UIP_HTONS(40000));
+  UNIT_TEST_ASSERT(uip_conn->tcpstateflags == UIP_SYN_RCVD);
+
+  /* A reset for the half-open connection finds and closes it. */
+  tcp_input(&peer_addr, 40000, 80, TCP_RST);
+  UNIT_TEST_ASSERT(uip_conn != NULL);
+  UNIT_TEST_ASSERT(uip_conn->tcpstateflags == UIP_CLOSED);
+
+  uip_unlisten(UIP_HTONS(80));
+  tcp_input(&peer_addr, 40000, 80, TCP_SYN);
+  UNIT_TEST_ASSERT(uip_stat.tcp.synrst == synrst + 2);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_uip_demux_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  uip_ipaddr_copy(&local_addr, &uip_ds6_get_link_local(-1)->ipaddr);
+  uip_ip6addr(&peer_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 2);
+  uip_ip6addr(&other_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 3);
+
+  UNIT_TEST_RUN(udp_wildcards);
+  UNIT_TEST_RUN(tcp_listen);
+
+  if(!UNIT_TEST_PASSED(udp_wildcards) ||
+     !UNIT_TEST_PASSED(tcp_listen)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
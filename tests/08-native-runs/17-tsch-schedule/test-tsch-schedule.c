@@ -0,0 +1,238 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/*
+ * \file
+ *      Unit tests for the TSCH next-active-link lookup. Build with
+ *      INDEX=0 to test walking the lists of links instead of the
+ *      schedule index.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "contiki.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The parts of TSCH used by the schedule */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+struct tsch_link *current_link = NULL;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+void
+tsch_release_lock(void)
+{
+}
+struct tsch_neighbor *
+tsch_queue_add_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+struct tsch_neighbor *
+tsch_queue_get_nbr(const linkaddr_t *addr)
+{
+  return NULL;
+}
+/*****************************************************************************/
+PROCESS(test_tsch_schedule_process, "TSCH schedule test process");
+AUTOSTART_PROCESSES(&test_tsch_schedule_process);
+/*****************************************************************************/
+static struct tsch_link *
+next_link(uint32_t asn_ls4b, uint16_t *time_offset, struct tsch_link **backup)
+{
+  struct tsch_asn_t asn;
+
+  TSCH_ASN_INIT(asn, 0, asn_ls4b);
+  return tsch_schedule_get_next_active_link(&asn, time_offset, backup);
+}
+/*****************************************************************************/
+/* Time to the earliest link in the schedule, by walking all links */
+static uint16_t
+earliest_link(uint32_t asn_ls4b)
+{
+  struct tsch_slotframe *sf;
+  uint16_t best = 0xffff;
+
+  for(sf = tsch_schedule_slotframe_head(); sf != NULL;
+      sf = tsch_schedule_slotframe_next(sf)) {
+    uint16_t timeslot = asn_ls4b % sf->size.val;
+    struct tsch_link *l;
+    for(l = list_head(sf->links_list); l != NULL; l = list_item_next(l)) {
+      uint16_t time_to_timeslot = l->timeslot > timeslot ?
+        l->timeslot - timeslot : sf->size.val + l->timeslot - timeslot;
+      if(time_to_timeslot < best) {
+        best = time_to_timeslot;
+      }
+    }
+  }
+  return best;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(overlap, "Overlapping links and backup links");
+UNIT_TEST(overlap)
+{
+  struct tsch_slotframe *sf0;
+  struct tsch_slotframe *sf1;
+  struct tsch_link *rx;
+  struct tsch_link *rx2;
+  struct tsch_link *tx;
+  struct tsch_link *backup;
+  uint16_t time_offset;
+
+  UNIT_TEST_BEGIN();
+
+  tsch_schedule_remove_all_slotframes();
+  sf0 = tsch_schedule_add_slotframe(0, 7);
+  sf1 = tsch_schedule_add_slotframe(1, 11);
+  UNIT_TEST_ASSERT(sf0 != NULL && sf1 != NULL);
+  UNIT_TEST_ASSERT(next_link(0, &time_offset, &backup) == NULL);
+
+  rx = tsch_schedule_add_link(sf0, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                              &tsch_broadcast_address, 3, 0, 1);
+  tx = tsch_schedule_add_link(sf1, LINK_OPTION_TX, LINK_TYPE_NORMAL,
+                              &tsch_broadcast_address, 3, 0, 1);
+  UNIT_TEST_ASSERT(rx != NULL && tx != NULL);
+
+  /* Tx wins over Rx, and the Rx link is kept as backup */
+  UNIT_TEST_ASSERT(next_link(0, &time_offset, &backup) == tx);
+  UNIT_TEST_ASSERT(time_offset == 3);
+  UNIT_TEST_ASSERT(backup == rx);
+
+  /* At timeslot 3 itself, the next occurrences are a full slotframe away */
+  UNIT_TEST_ASSERT(next_link(3, &time_offset, &backup) == rx);
+  UNIT_TEST_ASSERT(time_offset == 7);
+  UNIT_TEST_ASSERT(backup == NULL);
+
+  /* Wrap around: from timeslot 5, sf0 is at 5 slots and sf1 at 9 */
+  UNIT_TEST_ASSERT(next_link(5, &time_offset, &backup) == rx);
+  UNIT_TEST_ASSERT(time_offset == 5);
+
+  /* Two Rx links in the same slotframe and timeslot: the first one added
+     is selected and the second one is the backup */
+  rx2 = tsch_schedule_add_link(sf0, LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                               &tsch_broadcast_address, 3, 1, 1);
+  UNIT_TEST_ASSERT(rx2 != NULL);
+  UNIT_TEST_ASSERT(next_link(3, &time_offset, &backup) == rx);
+  UNIT_TEST_ASSERT(backup == rx2);
+
+  /* Removed links are no longer selected */
+  UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf0, rx));
+  UNIT_TEST_ASSERT(next_link(3, &time_offset, &backup) == rx2);
+  UNIT_TEST_ASSERT(backup == NULL);
+  UNIT_TEST_ASSERT(tsch_schedule_remove_slotframe(sf0));
+  UNIT_TEST_ASSERT(next_link(3, &time_offset, &backup) == tx);
+  UNIT_TEST_ASSERT(time_offset == 11);
+
+  tsch_schedule_remove_all_slotframes();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(add_remove, "Random link additions and removals");
+UNIT_TEST(add_remove)
+{
+  static const uint16_t sizes[] = { 7, 31, 101 };
+  struct tsch_slotframe *sf[3];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  srand(1);
+  tsch_schedule_remove_all_slotframes();
+  for(i = 0; i < 3; i++) {
+    sf[i] = tsch_schedule_add_slotframe(i, sizes[i]);
+    UNIT_TEST_ASSERT(sf[i] != NULL);
+  }
+
+  for(i = 0; i < 2000; i++) {
+    int s = rand() % 3;
+    struct tsch_link *l = list_head(sf[s]->links_list);
+    uint32_t asn = rand();
+    uint16_t time_offset;
+
+    if(l != NULL && rand() % 3 == 0) {
+      /* Remove a random link of the slotframe */
+      int n = rand() % list_length(sf[s]->links_list);
+      while(n-- > 0) {
+        l = list_item_next(l);
+      }
+      UNIT_TEST_ASSERT(tsch_schedule_remove_link(sf[s], l));
+    } else {
+      tsch_schedule_add_link(sf[s], LINK_OPTION_RX, LINK_TYPE_NORMAL,
+                             &tsch_broadcast_address,
+                             rand() % sizes[s], rand() % 4, 1);
+    }
+
+    l = next_link(asn, &time_offset, NULL);
+    UNIT_TEST_ASSERT(l != NULL || earliest_link(asn) == 0xffff);
+    if(l != NULL) {
+      UNIT_TEST_ASSERT(time_offset == earliest_link(asn));
+    }
+  }
+
+  tsch_schedule_remove_all_slotframes();
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_tsch_schedule_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  tsch_schedule_init();
+
+  UNIT_TEST_RUN(overlap);
+  UNIT_TEST_RUN(add_remove);
+
+  if(!UNIT_TEST_PASSED(overlap) ||
+     !UNIT_TEST_PASSED(add_remove)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
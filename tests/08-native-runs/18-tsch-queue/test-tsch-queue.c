@@ -0,0 +1,213 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/*
+ * \file
+ *      Unit tests for TSCH shared-slot packet selection. Build with
+ *      READY_SET=0 to test walking the neighbor table instead of the
+ *      ready set.
+ */
+
+#include <stdio.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+/* The parts of TSCH used by the queue */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0 } };
+int tsch_is_coordinator = 0;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+void
+tsch_release_lock(void)
+{
+}
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*****************************************************************************/
+static struct tsch_link shared_link = {
+  .link_options = LINK_OPTION_TX | LINK_OPTION_SHARED,
+};
+static struct tsch_link dedicated_link = {
+  .link_options = LINK_OPTION_TX,
+};
+/*****************************************************************************/
+PROCESS(test_tsch_queue_process, "TSCH queue test process");
+AUTOSTART_PROCESSES(&test_tsch_queue_process);
+/*****************************************************************************/
+static linkaddr_t *
+nbr_addr(uint8_t id)
+{
+  static linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 1] = id;
+  return &addr;
+}
+/*****************************************************************************/
+static struct tsch_packet *
+queue_packet(uint8_t id)
+{
+  packetbuf_clear();
+  return tsch_queue_add_packet(nbr_addr(id), 1, NULL, NULL);
+}
+/*****************************************************************************/
+static void
+dequeue_packet(uint8_t id)
+{
+  tsch_queue_free_packet(
+    tsch_queue_remove_packet_from_queue(tsch_queue_get_nbr(nbr_addr(id))));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(shared_slot, "Packet selection in shared slots");
+UNIT_TEST(shared_slot)
+{
+  struct tsch_neighbor *n = NULL;
+  struct tsch_neighbor *n1;
+  struct tsch_neighbor *n2;
+  struct tsch_packet *p1;
+  struct tsch_packet *p2;
+  uint8_t window;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  n1 = tsch_queue_add_nbr(nbr_addr(1));
+  n2 = tsch_queue_add_nbr(nbr_addr(2));
+  UNIT_TEST_ASSERT(n1 != NULL && n2 != NULL);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == NULL);
+
+  p2 = queue_packet(2);
+  UNIT_TEST_ASSERT(p2 != NULL);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == p2);
+  UNIT_TEST_ASSERT(n == n2);
+
+  /* Neighbors we have a Tx link to are not served in shared slots */
+  n2->tx_links_count = 1;
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == NULL);
+  n2->tx_links_count = 0;
+
+  /* Neighbors in backoff are only served on dedicated links, until
+     their backoff window expires */
+  tsch_queue_backoff_inc(n2);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == NULL);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &dedicated_link) == p2);
+  for(i = 0; i <= (1 << TSCH_MAC_MAX_BE) && !tsch_queue_backoff_expired(n2); i++) {
+    tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  }
+  UNIT_TEST_ASSERT(tsch_queue_backoff_expired(n2));
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == p2);
+
+  /* Backoff windows of neighbors with a Tx link are only decremented
+     by links to them */
+  n1->tx_links_count = 1;
+  tsch_queue_backoff_inc(n1);
+  window = n1->backoff_window;
+  tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  UNIT_TEST_ASSERT(n1->backoff_window == window);
+  for(i = 0; i <= (1 << TSCH_MAC_MAX_BE) && !tsch_queue_backoff_expired(n1); i++) {
+    tsch_queue_update_all_backoff_windows(nbr_addr(1));
+  }
+  UNIT_TEST_ASSERT(tsch_queue_backoff_expired(n1));
+  n1->tx_links_count = 0;
+
+  /* Once a queue is emptied, the next backlogged neighbor is served */
+  p1 = queue_packet(1);
+  UNIT_TEST_ASSERT(p1 != NULL);
+  UNIT_TEST_ASSERT(tsch_queue_nbr_packet_count(n1) == 1);
+  dequeue_packet(2);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == p1);
+  UNIT_TEST_ASSERT(n == n1);
+  dequeue_packet(1);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == NULL);
+
+  /* Flushed neighbors are no longer served */
+  UNIT_TEST_ASSERT(queue_packet(2) != NULL);
+  tsch_queue_free_packets_to(nbr_addr(2));
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == NULL);
+
+  tsch_queue_free_unused_neighbors();
+  UNIT_TEST_ASSERT(tsch_queue_get_nbr(nbr_addr(1)) == NULL);
+
+  /* Neighbors removed by the neighbor table are no longer served */
+  p1 = queue_packet(1);
+  UNIT_TEST_ASSERT(p1 != NULL);
+  tsch_queue_backoff_inc(tsch_queue_get_nbr(nbr_addr(1)));
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &dedicated_link) == p1);
+  nbr_table_clear();
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &dedicated_link) == NULL);
+
+  /* A neighbor added in its place starts with no backoff */
+  tsch_queue_init();
+  p1 = queue_packet(1);
+  UNIT_TEST_ASSERT(p1 != NULL);
+  tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  UNIT_TEST_ASSERT(tsch_queue_get_unicast_packet_for_any(&n, &shared_link) == p1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_tsch_queue_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  tsch_queue_init();
+
+  UNIT_TEST_RUN(shared_slot);
+
+  if(!UNIT_TEST_PASSED(shared_slot)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+NODE_DIR=$CONTIKI/examples/6tisch/simple-node
+MEDIUM_DIR=$CONTIKI/tools/native-medium
+BUILDLOG=$BASENAME.build.log
+RUNLOG=$BASENAME.run.log
+RERUNLOG=$BASENAME.rerun.log
+
+test_init
+register_logfile $BUILDLOG
+register_logfile $RUNLOG
+
+echo "-- Starting test $BASENAME"
+assert "compile medium" "make -C $MEDIUM_DIR > $BUILDLOG 2>&1"
+assert "compile node" "make -C $NODE_DIR TARGET=native NATIVE_SIM=1 -j >> $BUILDLOG 2>&1"
+
+# Three nodes, node 1 is the coordinator and RPL root, with lossy channels
+SIM="$MEDIUM_DIR/native-medium -n 3 -t 300 -l 0.1 -c 20:0.3 -- $NODE_DIR/node.native"
+assert "run" "timeout 120 $SIM > $RUNLOG 2>&1"
+assert "node 2 joined" "grep -q 'ID:2.*association done' $RUNLOG"
+assert "node 3 joined" "grep -q 'ID:3.*association done' $RUNLOG"
+assert "acked unicast" "grep -q 'ID:[23].*uc-.* tx LL-000[23]->LL-0001.*st 0' $RUNLOG"
+assert "slot profile" "grep -q 'ID:2.*TSCH Stats.*ack-parse' $RUNLOG"
+# The run only depends on the nodes and on the seed
+assert "deterministic" "timeout 120 $SIM > $RERUNLOG 2>&1 && cmp -s $RUNLOG $RERUNLOG"
+
+rm -f $RERUNLOG
+do_wrap_up
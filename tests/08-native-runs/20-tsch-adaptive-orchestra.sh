@@ -0,0 +1,33 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+NODE_DIR=$CONTIKI/examples/6tisch/simple-node
+MEDIUM_DIR=$CONTIKI/tools/native-medium
+BUILDLOG=$BASENAME.build.log
+RUNLOG=$BASENAME.run.log
+NODE_FLAGS="MAKE_WITH_ORCHESTRA=1 MAKE_WITH_STORING_ROUTING=1 MAKE_WITH_ADAPTIVE_ORCHESTRA=1 MAKE_WITH_BURSTY_TRAFFIC=1"
+
+test_init
+register_logfile $BUILDLOG
+register_logfile $RUNLOG
+
+echo "-- Starting test $BASENAME"
+assert "compile medium" "make -C $MEDIUM_DIR > $BUILDLOG 2>&1"
+# The node is built with non-default flags: do not reuse other builds
+assert "compile node" "make -C $NODE_DIR TARGET=native clean >> $BUILDLOG 2>&1 && make -C $NODE_DIR TARGET=native NATIVE_SIM=1 $NODE_FLAGS -j >> $BUILDLOG 2>&1"
+
+# Five nodes sending bursts to the root
+SIM="$MEDIUM_DIR/native-medium -n 5 -t 120 -- $NODE_DIR/node.native"
+assert "run" "timeout 120 $SIM > $RUNLOG 2>&1"
+assert "tx cell added" "grep -q 'ID:[2-5].*adaptive: tx cell' $RUNLOG"
+assert "rx cell added" "grep -q 'ID:[1-5].*adaptive: rx cell' $RUNLOG"
+assert "tx in cell" "grep -Eq 'ID:[2-5].*link +1 .*uc-.* tx .*st 0' $RUNLOG"
+assert "bursts received" "grep -q 'ID:1.*Burst rx' $RUNLOG"
+
+make -C $NODE_DIR TARGET=native clean >> $BUILDLOG 2>&1
+do_wrap_up
@@ -0,0 +1,44 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+NODE_DIR=$CONTIKI/examples/6tisch/simple-node
+MEDIUM_DIR=$CONTIKI/tools/native-medium
+BUILDLOG=$BASENAME.build.log
+RUNLOG=$BASENAME.run.log
+REBOOTLOG=$BASENAME.reboot.log
+# Node files, kept across the two runs
+NODES=$BASENAME.nodes
+NODE_FLAGS="MAKE_WITH_FAST_JOIN=1 MAKE_WITH_PERIODIC_REJOIN=1"
+
+test_init
+register_logfile $BUILDLOG
+register_logfile $RUNLOG
+register_logfile $REBOOTLOG
+
+echo "-- Starting test $BASENAME"
+assert "compile medium" "make -C $MEDIUM_DIR > $BUILDLOG 2>&1"
+# The node is built with non-default flags: do not reuse other builds
+assert "compile node" "make -C $NODE_DIR TARGET=native clean >> $BUILDLOG 2>&1 && make -C $NODE_DIR TARGET=native NATIVE_SIM=1 $NODE_FLAGS -j >> $BUILDLOG 2>&1"
+
+# Five nodes leaving the network every minute
+rm -rf $NODES
+SIM="$MEDIUM_DIR/native-medium -n 5 -t 150 -d $NODES -- $NODE_DIR/node.native"
+assert "run" "timeout 120 $SIM > $RUNLOG 2>&1"
+assert "left" "grep -q 'ID:[2-5].*leaving the network' $RUNLOG"
+assert "following" "grep -q 'ID:[2-5].*following EB channels' $RUNLOG"
+assert "EB solicited" "grep -q 'EB solicited' $RUNLOG"
+assert "rejoined" "grep -q 'ID:[2-5].*association done (2)' $RUNLOG"
+
+# The nodes remember the network across reboots
+SIM="$MEDIUM_DIR/native-medium -n 5 -t 10 -d $NODES -- $NODE_DIR/node.native"
+assert "reboot" "timeout 60 $SIM > $REBOOTLOG 2>&1"
+assert "hints loaded" "grep -q 'ID:[2-5].*TSCH Join.*PAN ID 81a5' $REBOOTLOG"
+
+rm -rf $NODES
+make -C $NODE_DIR TARGET=native clean >> $BUILDLOG 2>&1
+do_wrap_up
@@ -0,0 +1,192 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the CSMA neighbor queues: FIFO order, lookup of
+ *      many neighbors through the hash index, and queue statistics.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/csma/csma-output.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define NUM_NBRS        CSMA_CONF_MAX_NEIGHBOR_QUEUES
+#define PKTS_PER_NBR    CSMA_CONF_MAX_PACKET_PER_NEIGHBOR
+
+/* Sequence number of the next packet expected from each neighbor queue */
+static uint8_t next_seqno[NUM_NBRS + 2];
+static int out_of_order;
+static int sent_count;
+static int queue_full_count;
+/*****************************************************************************/
+PROCESS(test_csma_queue_process, "CSMA queue test process");
+AUTOSTART_PROCESSES(&test_csma_queue_process);
+/*****************************************************************************/
+static linkaddr_t *
+nbr_addr(uint8_t id)
+{
+  static linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 1] = id;
+  return &addr;
+}
+/*****************************************************************************/
+static void
+packet_sent(void *ptr, int status, int transmissions)
+{
+  uint8_t id = (uintptr_t)ptr >> 8;
+  uint8_t seqno = (uintptr_t)ptr & 0xff;
+
+  if(status == MAC_TX_QUEUE_FULL) {
+    queue_full_count++;
+    return;
+  }
+  if(seqno != next_seqno[id]) {
+    out_of_order++;
+  }
+  next_seqno[id] = seqno + 1;
+  sent_count++;
+}
+/*****************************************************************************/
+static void
+queue_packet(uint8_t id, uint8_t seqno)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom("csma", 4);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, nbr_addr(id));
+  /* No acks on native: a single attempt per packet */
+  packetbuf_set_attr(PACKETBUF_ATTR_MAX_MAC_TRANSMISSIONS, 1);
+  csma_output_packet(packet_sent, (void *)(uintptr_t)(id << 8 | seqno));
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(queues, "Neighbor queues");
+UNIT_TEST(queues)
+{
+  struct csma_neighbor_queue_stats nstats;
+  const struct csma_queue_stats *stats = csma_output_get_queue_stats();
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Packets beyond the per-neighbor limit are dropped and counted */
+  for(i = 0; i <= PKTS_PER_NBR; i++) {
+    queue_packet(1, i);
+  }
+  UNIT_TEST_ASSERT(queue_full_count == 1);
+  UNIT_TEST_ASSERT(stats->dropped_queue_full == 1);
+  UNIT_TEST_ASSERT(csma_output_get_neighbor_queue_stats(nbr_addr(1), &nstats));
+  UNIT_TEST_ASSERT(nstats.queue_len == PKTS_PER_NBR);
+  UNIT_TEST_ASSERT(nstats.max_queue_len == PKTS_PER_NBR);
+  UNIT_TEST_ASSERT(nstats.drops == 1);
+
+  /* Fill all neighbor queues, then one more */
+  for(i = 2; i <= NUM_NBRS + 1; i++) {
+    queue_packet(i, 0);
+    queue_packet(i, 1);
+  }
+  UNIT_TEST_ASSERT(queue_full_count == 3);
+  UNIT_TEST_ASSERT(stats->dropped_no_neighbor == 2);
+  UNIT_TEST_ASSERT(stats->neighbors == NUM_NBRS);
+  UNIT_TEST_ASSERT(stats->max_neighbors == NUM_NBRS);
+  UNIT_TEST_ASSERT(stats->max_queue_len == PKTS_PER_NBR);
+  for(i = 2; i <= NUM_NBRS; i++) {
+    UNIT_TEST_ASSERT(csma_output_get_neighbor_queue_stats(nbr_addr(i), &nstats));
+    UNIT_TEST_ASSERT(nstats.queue_len == 2);
+  }
+  UNIT_TEST_ASSERT(!csma_output_get_neighbor_queue_stats(nbr_addr(NUM_NBRS + 1),
+                                                         &nstats));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(drain, "Draining the queues");
+UNIT_TEST(drain)
+{
+  struct csma_neighbor_queue_stats nstats;
+  const struct csma_queue_stats *stats = csma_output_get_queue_stats();
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  /* Every queued packet was sent, in order */
+  UNIT_TEST_ASSERT(sent_count == PKTS_PER_NBR + 2 * (NUM_NBRS - 1));
+  UNIT_TEST_ASSERT(out_of_order == 0);
+
+  /* Empty queues are released and removed from the index */
+  UNIT_TEST_ASSERT(stats->neighbors == 0);
+  for(i = 1; i <= NUM_NBRS; i++) {
+    UNIT_TEST_ASSERT(!csma_output_get_neighbor_queue_stats(nbr_addr(i), &nstats));
+  }
+
+  /* Queues can be allocated again */
+  queue_packet(NUM_NBRS, 2);
+  UNIT_TEST_ASSERT(csma_output_get_neighbor_queue_stats(nbr_addr(NUM_NBRS), &nstats));
+  UNIT_TEST_ASSERT(nstats.queue_len == 1);
+  UNIT_TEST_ASSERT(stats->neighbors == 1);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_csma_queue_process, ev, data)
+{
+  static struct etimer et;
+  static int waited;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(queues);
+
+  for(waited = 0; sent_count < PKTS_PER_NBR + 2 * (NUM_NBRS - 1)
+      && waited < 10 * CLOCK_SECOND; waited += CLOCK_SECOND / 10) {
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  UNIT_TEST_RUN(drain);
+
+  if(!UNIT_TEST_PASSED(queues) || !UNIT_TEST_PASSED(drain)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
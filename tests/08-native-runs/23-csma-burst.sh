@@ -0,0 +1,78 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+NODE_DIR=$BASENAME
+MEDIUM_DIR=$CONTIKI/tools/native-medium
+BUILDLOG=$BASENAME.build.log
+
+test_init
+register_logfile $BUILDLOG
+
+# Goodput of flow $2 in log $1, in bytes per second over 60 s
+function goodput( )
+{
+  grep "flow $2:" $1 | tail -1 | sed -E 's/.* pkts ([0-9]+) B.*/\1/' | awk '{ print int($1 / 60) }'
+}
+
+# Average latency of flow $2 in log $1, in microseconds
+function latency( )
+{
+  grep "flow $2:" $1 | tail -1 | sed -E 's/.* avg ([0-9]+) .*/\1/'
+}
+
+# Run a five-node simulation, with bursts of up to $1 frames and the
+# traffic of scenario $2
+function run( )
+{
+  local RUN=$BASENAME.burst-$1$2
+  local FAIRNESS=$([ -n "$2" ] && echo 1)
+  register_logfile $RUN.run.log
+  assert "compile burst $1$2" "make -C $NODE_DIR clean >> $BUILDLOG 2>&1 && make -C $NODE_DIR BURST=$1 FAIRNESS=$FAIRNESS -j >> $BUILDLOG 2>&1"
+  cp $NODE_DIR/csma-burst-node.native $RUN.native
+  SIM="$MEDIUM_DIR/native-medium -n 5 -t 60 -- ./$RUN.native"
+  assert "run burst $1$2" "timeout 300 $SIM > $RUN.run.log 2>&1"
+}
+
+echo "-- Starting test $BASENAME"
+assert "compile medium" "make -C $MEDIUM_DIR > $BUILDLOG 2>&1"
+
+# Node 1 sends bulk to node 2 and light flows to nodes 3 and 4, node 5
+# sends bulk to node 2
+for BURST in 1 8; do
+  run $BURST
+  RUNLOG=$BASENAME.burst-$BURST.run.log
+  # Light flows are not starved by bulk flows
+  assert "light flows burst $BURST" "grep -q 'flow 1.1: rx 599 pkts' $RUNLOG && grep -q 'flow 1.2: rx 599 pkts' $RUNLOG"
+  echo "burst $BURST: goodput $(goodput $RUNLOG 1.0) + $(goodput $RUNLOG 5.0) B/s, light latency $(latency $RUNLOG 1.1) us"
+done
+
+B1=$BASENAME.burst-1.run.log
+B8=$BASENAME.burst-8.run.log
+assert "burst goodput" "[ $(( $(goodput $B8 1.0) + $(goodput $B8 5.0) )) -gt $(( $(goodput $B1 1.0) + $(goodput $B1 5.0) )) ]"
+
+# Node 1 keeps 100-, 64- and 32-byte frames backlogged to nodes 2, 3
+# and 4, and sends a light flow to node 5
+for BURST in 1 8; do
+  run $BURST -fair
+  RUNLOG=$BASENAME.burst-$BURST-fair.run.log
+  assert "light flow burst $BURST-fair" "grep -q 'flow 1.3: rx 599 pkts' $RUNLOG"
+  echo "burst $BURST-fair: goodput $(goodput $RUNLOG 1.0) / $(goodput $RUNLOG 1.1) / $(goodput $RUNLOG 1.2) B/s, light latency $(latency $RUNLOG 1.3) us"
+done
+
+B1=$BASENAME.burst-1-fair.run.log
+B8=$BASENAME.burst-8-fair.run.log
+# Deficit round robin shares bytes evenly across backlogged queues
+MIN=$(printf "%s\n" $(goodput $B8 1.0) $(goodput $B8 1.1) $(goodput $B8 1.2) | sort -n | head -1)
+MAX=$(printf "%s\n" $(goodput $B8 1.0) $(goodput $B8 1.1) $(goodput $B8 1.2) | sort -n | tail -1)
+assert "byte fairness" "[ $(( MIN * 10 )) -ge $(( MAX * 9 )) ]"
+# and does not keep light flows behind backlogged queues
+assert "light latency" "[ $(latency $B8 1.3) -lt $(latency $B1 1.3) ]"
+
+rm -f $BASENAME.burst-*.native
+make -C $NODE_DIR clean >> $BUILDLOG 2>&1
+do_wrap_up
@@ -0,0 +1,237 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Traffic for the CSMA burst test. Node 1 sends a bulk flow to
+ *      node 2 and light periodic flows to nodes 3 and 4, while node 5
+ *      sends another bulk flow to node 2. Built with WITH_FAIRNESS,
+ *      node 1 instead keeps bulk flows to nodes 2, 3 and 4 backlogged,
+ *      with frames of different lengths, and sends a light flow to
+ *      node 5. Receivers log per-flow goodput and latency.
+ */
+
+#include "contiki.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/nullnet/nullnet.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define NUM_NODES        5
+#define NUM_FLOWS        4
+#define LIGHT_LEN        40
+#define LIGHT_INTERVAL   (CLOCK_SECOND / 10)
+#define REPORT_INTERVAL  (10 * CLOCK_SECOND)
+
+struct bulk_flow {
+  uint16_t src;
+  uint16_t dest;
+  uint8_t flow;
+  uint8_t len;
+};
+
+struct light_flow {
+  uint16_t src;
+  uint16_t dest;
+  uint8_t flow;
+};
+
+#if WITH_FAIRNESS
+/* Deep enough for every queue to stay backlogged over a whole turn */
+#define BULK_WINDOW      12
+static const struct bulk_flow bulk_flows[] = {
+  { 1, 2, 0, 100 }, { 1, 3, 1, 64 }, { 1, 4, 2, 32 }
+};
+static const struct light_flow light_flows[] = {
+  { 1, 5, 3 }
+};
+#else /* WITH_FAIRNESS */
+#define BULK_WINDOW      4
+static const struct bulk_flow bulk_flows[] = {
+  { 1, 2, 0, 100 }, { 5, 2, 0, 100 }
+};
+static const struct light_flow light_flows[] = {
+  { 1, 3, 1 }, { 1, 4, 2 }
+};
+#endif /* WITH_FAIRNESS */
+
+struct msg {
+  uint8_t flow;
+  uint32_t seqno;
+  rtimer_clock_t sent;
+};
+
+struct flow_stats {
+  uint32_t packets;
+  uint32_t bytes;
+  uint64_t latency_sum;
+  rtimer_clock_t latency_max;
+};
+
+static struct flow_stats stats[NUM_NODES + 1][NUM_FLOWS];
+static uint32_t seqnos[NUM_FLOWS];
+static uint8_t bulk_outstanding[NUM_FLOWS];
+static uint16_t my_id;
+/*---------------------------------------------------------------------------*/
+PROCESS(csma_burst_process, "CSMA burst test");
+AUTOSTART_PROCESSES(&csma_burst_process);
+/*---------------------------------------------------------------------------*/
+static void
+node_addr(uint16_t id, linkaddr_t *addr)
+{
+  /* Without IPv6, native link-layer addresses hold the node ID in their
+     first two bytes, low byte first */
+  linkaddr_copy(addr, &linkaddr_node_addr);
+  addr->u8[0] = id & 0xff;
+  addr->u8[1] = id >> 8;
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t
+node_id_from_addr(const linkaddr_t *addr)
+{
+  return addr->u8[0] | (addr->u8[1] << 8);
+}
+/*---------------------------------------------------------------------------*/
+static void
+bulk_sent(void *ptr, int status, int transmissions)
+{
+  bulk_outstanding[(uintptr_t)ptr]--;
+  process_poll(&csma_burst_process);
+}
+/*---------------------------------------------------------------------------*/
+static void
+send_packet(uint16_t dest, uint8_t flow, uint16_t len, int bulk)
+{
+  struct msg msg;
+  linkaddr_t addr;
+
+  msg.flow = flow;
+  msg.seqno = seqnos[flow]++;
+  msg.sent = RTIMER_NOW();
+
+  packetbuf_clear();
+  memset(packetbuf_dataptr(), 0, len);
+  memcpy(packetbuf_dataptr(), &msg, sizeof(msg));
+  packetbuf_set_datalen(len);
+  node_addr(dest, &addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &addr);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  if(bulk) {
+    bulk_outstanding[flow]++;
+    NETSTACK_MAC.send(bulk_sent, (void *)(uintptr_t)flow);
+  } else {
+    NETSTACK_MAC.send(NULL, NULL);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_callback(const void *data, uint16_t len,
+               const linkaddr_t *src, const linkaddr_t *dest)
+{
+  struct msg msg;
+  struct flow_stats *s;
+  uint16_t from = node_id_from_addr(src);
+  rtimer_clock_t latency;
+
+  if(len < sizeof(msg) || from == 0 || from > NUM_NODES) {
+    return;
+  }
+  memcpy(&msg, data, sizeof(msg));
+  if(msg.flow >= NUM_FLOWS) {
+    return;
+  }
+  latency = RTIMER_NOW() - msg.sent;
+  s = &stats[from][msg.flow];
+  s->packets++;
+  s->bytes += len;
+  s->latency_sum += latency;
+  if(latency > s->latency_max) {
+    s->latency_max = latency;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+report(void)
+{
+  int from, flow;
+
+  for(from = 1; from <= NUM_NODES; from++) {
+    for(flow = 0; flow < NUM_FLOWS; flow++) {
+      struct flow_stats *s = &stats[from][flow];
+      if(s->packets > 0) {
+        printf("flow %u.%u: rx %lu pkts %lu B, latency avg %lu max %lu us\n",
+               from, flow, (unsigned long)s->packets, (unsigned long)s->bytes,
+               (unsigned long)(s->latency_sum / s->packets),
+               (unsigned long)s->latency_max);
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(csma_burst_process, ev, data)
+{
+  static struct etimer light_timer;
+  static struct etimer report_timer;
+  unsigned i;
+
+  PROCESS_BEGIN();
+
+  my_id = node_id_from_addr(&linkaddr_node_addr);
+  nullnet_set_input_callback(input_callback);
+  etimer_set(&light_timer, LIGHT_INTERVAL);
+  etimer_set(&report_timer, REPORT_INTERVAL);
+  process_poll(&csma_burst_process);
+
+  while(1) {
+    PROCESS_WAIT_EVENT();
+    if(ev == PROCESS_EVENT_POLL) {
+      /* Keep the bulk flows backlogged */
+      for(i = 0; i < sizeof(bulk_flows) / sizeof(bulk_flows[0]); i++) {
+        const struct bulk_flow *f = &bulk_flows[i];
+        while(f->src == my_id && bulk_outstanding[f->flow] < BULK_WINDOW) {
+          send_packet(f->dest, f->flow, f->len, 1);
+        }
+      }
+    } else if(data == &light_timer) {
+      for(i = 0; i < sizeof(light_flows) / sizeof(light_flows[0]); i++) {
+        if(light_flows[i].src == my_id) {
+          send_packet(light_flows[i].dest, light_flows[i].flow, LIGHT_LEN, 0);
+        }
+      }
+      etimer_reset(&light_timer);
+    } else if(data == &report_timer) {
+      report();
+      etimer_reset(&report_timer);
+    }
+  }
+
+  PROCESS_END();
+}
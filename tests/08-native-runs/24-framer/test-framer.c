@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the 802.15.4 framer: headers created from cached
+ *      templates must match frame802154_create(), and parse back to the
+ *      attributes they were created from. Build with CACHE=0 to test
+ *      without the header cache.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/packetbuf.h"
+#include "net/mac/framer/framer-802154.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define PAYLOAD_LEN 50
+
+struct frame_case {
+  uint8_t dest;               /* 0 for broadcast */
+  uint8_t frame_type;
+  uint8_t ack;
+  uint8_t pending;
+  uint8_t security_level;
+  uint8_t key_id_mode;
+};
+
+static const struct frame_case cases[] = {
+  { 2, FRAME802154_DATAFRAME, 1, 0, 0, 0 },
+  { 2, FRAME802154_DATAFRAME, 1, 1, 0, 0 },
+  { 3, FRAME802154_DATAFRAME, 1, 0, 0, 0 },
+  { 0, FRAME802154_DATAFRAME, 0, 0, 0, 0 },
+  { 2, FRAME802154_CMDFRAME, 1, 0, 0, 0 },
+  { 2, FRAME802154_DATAFRAME, 1, 0, 5, 1 },
+  { 0, FRAME802154_DATAFRAME, 0, 0, 6, 2 },
+  { 3, FRAME802154_DATAFRAME, 1, 0, 7, 3 },
+  { 2, FRAME802154_DATAFRAME, 1, 0, 5, 1 },
+};
+
+static uint8_t payload[PAYLOAD_LEN];
+static uint8_t frame[PACKETBUF_SIZE];
+static int frame_len;
+/*****************************************************************************/
+PROCESS(test_framer_process, "Framer test process");
+AUTOSTART_PROCESSES(&test_framer_process);
+/*****************************************************************************/
+static linkaddr_t *
+nbr_addr(uint8_t id)
+{
+  static linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 1] = id;
+  return &addr;
+}
+/*****************************************************************************/
+static void
+setup_packetbuf(const struct frame_case *c, uint8_t seqno, uint32_t counter)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(payload, sizeof(payload));
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER,
+                     c->dest ? nbr_addr(c->dest) : &linkaddr_null);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, c->frame_type);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, c->ack);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_PENDING, c->pending);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno);
+  packetbuf_set_attr(PACKETBUF_ATTR_SECURITY_LEVEL, c->security_level);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_ID_MODE, c->key_id_mode);
+  packetbuf_set_attr(PACKETBUF_ATTR_KEY_INDEX, c->key_id_mode ? 1 : 0);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_0_1, counter & 0xffff);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_COUNTER_BYTES_2_3, counter >> 16);
+}
+/*****************************************************************************/
+static int
+reference_header(uint8_t *buf)
+{
+  frame802154_t params;
+
+  memset(&params, 0, sizeof(params));
+  framer_802154_setup_params(packetbuf_attr, packetbuf_holds_broadcast(),
+                             &params);
+  if(packetbuf_holds_broadcast()) {
+    params.dest_addr[0] = 0xff;
+    params.dest_addr[1] = 0xff;
+  } else {
+    linkaddr_copy((linkaddr_t *)&params.dest_addr,
+                  packetbuf_addr(PACKETBUF_ADDR_RECEIVER));
+  }
+  linkaddr_copy((linkaddr_t *)&params.src_addr,
+                packetbuf_addr(PACKETBUF_ADDR_SENDER));
+  return frame802154_create(&params, buf);
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(create, "Header creation");
+UNIT_TEST(create)
+{
+  uint8_t ref[PACKETBUF_SIZE];
+  int ref_len;
+  int i, round;
+
+  UNIT_TEST_BEGIN();
+
+  /* The second round creates every header from the cache, with new
+     sequence numbers and frame counters */
+  for(round = 0; round < 2; round++) {
+    for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+      setup_packetbuf(&cases[i], 10 * round + i + 1, 0x01020304 * (round + 1) + i);
+      ref_len = reference_header(ref);
+      UNIT_TEST_ASSERT(framer_802154.length() == ref_len);
+      UNIT_TEST_ASSERT(framer_802154.create() == ref_len);
+      UNIT_TEST_ASSERT(memcmp(packetbuf_hdrptr(), ref, ref_len) == 0);
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(parse, "Header parsing");
+UNIT_TEST(parse)
+{
+  frame802154_t ref;
+  int ref_len;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+    setup_packetbuf(&cases[i], i + 1, i);
+    UNIT_TEST_ASSERT(framer_802154.create() > 0);
+    frame_len = packetbuf_totlen();
+    memcpy(frame, packetbuf_hdrptr(), frame_len);
+
+    ref_len = frame802154_parse(frame, frame_len, &ref);
+    packetbuf_clear();
+    packetbuf_copyfrom(frame, frame_len);
+    UNIT_TEST_ASSERT(framer_802154.parse() == ref_len);
+    UNIT_TEST_ASSERT(packetbuf_datalen() == PAYLOAD_LEN);
+    UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_FRAME_TYPE) == cases[i].frame_type);
+    UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAC_ACK) == ref.fcf.ack_required);
+    UNIT_TEST_ASSERT(packetbuf_attr(PACKETBUF_ATTR_MAC_SEQNO) == ref.seq);
+    UNIT_TEST_ASSERT(linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_SENDER),
+                                  &linkaddr_node_addr));
+    UNIT_TEST_ASSERT(linkaddr_cmp(packetbuf_addr(PACKETBUF_ADDR_RECEIVER),
+                                  cases[i].dest ? nbr_addr(cases[i].dest)
+                                  : &linkaddr_null));
+  }
+
+  /* Frames to another PAN are rejected */
+  frame[3] ^= 0x01;
+  packetbuf_clear();
+  packetbuf_copyfrom(frame, frame_len);
+  UNIT_TEST_ASSERT(framer_802154.parse() == FRAMER_FAILED);
+
+  /* So are truncated frames */
+  frame[3] ^= 0x01;
+  packetbuf_clear();
+  packetbuf_copyfrom(frame, 10);
+  UNIT_TEST_ASSERT(framer_802154.parse() == FRAMER_FAILED);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_framer_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(create);
+  UNIT_TEST_RUN(parse);
+
+  if(!UNIT_TEST_PASSED(create) || !UNIT_TEST_PASSED(parse)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Once with AES-NI (where the CPU has it), once with the T-tables only
+./run-one.sh 25-aes-128
+AESNI=0 ./run-one.sh 25-aes-128
@@ -0,0 +1,198 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the T-table AES-128 driver: it must agree with the
+ *      FIPS-197 test vectors and with the reference driver, also when
+ *      switching between more keys than its schedule cache holds. Build
+ *      with AESNI=0 to leave out AES-NI on x86.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/aes-128.h"
+#include "lib/aes-128-ttable.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define RANDOM_BLOCKS 1000
+#define SWITCH_KEYS   (AES_128_TTABLE_KEY_CACHE_SIZE + 2)
+
+extern const struct aes_128_driver aes_128_driver;
+
+struct vector {
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t plaintext[AES_128_BLOCK_SIZE];
+  uint8_t ciphertext[AES_128_BLOCK_SIZE];
+};
+
+static const struct vector vectors[] = {
+  /* FIPS-197, Appendix C.1 */
+  { { 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+      0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f },
+    { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77,
+      0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff },
+    { 0x69, 0xc4, 0xe0, 0xd8, 0x6a, 0x7b, 0x04, 0x30,
+      0xd8, 0xcd, 0xb7, 0x80, 0x70, 0xb4, 0xc5, 0x5a } },
+  /* FIPS-197, Appendix B */
+  { { 0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+      0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c },
+    { 0x32, 0x43, 0xf6, 0xa8, 0x88, 0x5a, 0x30, 0x8d,
+      0x31, 0x31, 0x98, 0xa2, 0xe0, 0x37, 0x07, 0x34 },
+    { 0x39, 0x25, 0x84, 0x1d, 0x02, 0xdc, 0x09, 0xfb,
+      0xdc, 0x11, 0x85, 0x97, 0x19, 0x6a, 0x0b, 0x32 } },
+};
+#define NUM_VECTORS (sizeof(vectors) / sizeof(vectors[0]))
+
+PROCESS(test_aes_process, "AES-128 test");
+AUTOSTART_PROCESSES(&test_aes_process);
+/*****************************************************************************/
+static void
+random_bytes(uint8_t *buf, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    buf[i] = random_rand();
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(vectors, "Test vectors");
+UNIT_TEST(vectors)
+{
+  uint8_t block[AES_128_BLOCK_SIZE];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < NUM_VECTORS; i++) {
+    memcpy(block, vectors[i].plaintext, sizeof(block));
+    aes_128_ttable_driver.set_key(vectors[i].key);
+    aes_128_ttable_driver.encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, vectors[i].ciphertext, sizeof(block)));
+
+    memcpy(block, vectors[i].plaintext, sizeof(block));
+    aes_128_driver.set_key(vectors[i].key);
+    aes_128_driver.encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, vectors[i].ciphertext, sizeof(block)));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(random_blocks, "Random keys and blocks");
+UNIT_TEST(random_blocks)
+{
+  uint8_t key[AES_128_KEY_LENGTH];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  uint8_t expected[AES_128_BLOCK_SIZE];
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < RANDOM_BLOCKS; i++) {
+    random_bytes(key, sizeof(key));
+    random_bytes(block, sizeof(block));
+    memcpy(expected, block, sizeof(block));
+    aes_128_driver.set_key(key);
+    aes_128_driver.encrypt(expected);
+    aes_128_ttable_driver.set_key(key);
+    aes_128_ttable_driver.encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, expected, sizeof(block)));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(key_switch, "Key schedule cache");
+UNIT_TEST(key_switch)
+{
+  static uint8_t keys[SWITCH_KEYS][AES_128_KEY_LENGTH];
+  uint8_t block[AES_128_BLOCK_SIZE];
+  uint8_t expected[AES_128_BLOCK_SIZE];
+  int i, k;
+
+  UNIT_TEST_BEGIN();
+
+  for(k = 0; k < SWITCH_KEYS; k++) {
+    random_bytes(keys[k], sizeof(keys[k]));
+  }
+
+  /* Cycle through more keys than the cache holds, and back and forth
+     between two of them, so that entries are both hit and replaced */
+  for(i = 0; i < 4 * SWITCH_KEYS; i++) {
+    k = (i & 1) ? 0 : (i / 2) % SWITCH_KEYS;
+    random_bytes(block, sizeof(block));
+    memcpy(expected, block, sizeof(block));
+    aes_128_driver.set_key(keys[k]);
+    aes_128_driver.encrypt(expected);
+    aes_128_ttable_driver.set_key(keys[k]);
+    aes_128_ttable_driver.encrypt(block);
+    UNIT_TEST_ASSERT(!memcmp(block, expected, sizeof(block)));
+  }
+
+  /* A key changed in place must not be served from the cache */
+  aes_128_ttable_driver.set_key(keys[1]);
+  keys[1][0] ^= 0x01;
+  random_bytes(block, sizeof(block));
+  memcpy(expected, block, sizeof(block));
+  aes_128_driver.set_key(keys[1]);
+  aes_128_driver.encrypt(expected);
+  aes_128_ttable_driver.set_key(keys[1]);
+  aes_128_ttable_driver.encrypt(block);
+  UNIT_TEST_ASSERT(!memcmp(block, expected, sizeof(block)));
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_aes_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(vectors);
+  UNIT_TEST_RUN(random_blocks);
+  UNIT_TEST_RUN(key_switch);
+
+  if(!UNIT_TEST_PASSED(vectors) || !UNIT_TEST_PASSED(random_blocks) ||
+     !UNIT_TEST_PASSED(key_switch)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
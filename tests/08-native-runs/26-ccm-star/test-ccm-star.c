@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the single-pass CCM* driver: for random keys,
+ *      nonces, headers and payloads of 802.15.4 frame sizes it must give
+ *      the same ciphertext and MIC as ccm_star_driver, and decrypt back.
+ *      Build with AESNI=0 to use the T-table AES on x86.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/ccm-star.h"
+#include "lib/ccm-star-single-pass.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define RANDOM_CASES 2000
+#define FRAME_MAX    127
+#define MIC_MAX      16
+
+extern const struct ccm_star_driver ccm_star_driver;
+
+PROCESS(test_ccm_process, "CCM* test");
+AUTOSTART_PROCESSES(&test_ccm_process);
+/*****************************************************************************/
+static void
+random_bytes(uint8_t *buf, int len)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    buf[i] = random_rand();
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(compare, "Same output as ccm_star_driver");
+UNIT_TEST(compare)
+{
+  uint8_t key[16];
+  uint8_t nonce[CCM_STAR_NONCE_LENGTH];
+  uint8_t a[FRAME_MAX];
+  uint8_t m[FRAME_MAX];
+  uint8_t m_ref[FRAME_MAX];
+  uint8_t plain[FRAME_MAX];
+  uint8_t mic[MIC_MAX];
+  uint8_t mic_ref[MIC_MAX];
+  uint16_t a_len;
+  uint16_t m_len;
+  uint8_t mic_len;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < RANDOM_CASES; i++) {
+    random_bytes(key, sizeof(key));
+    random_bytes(nonce, sizeof(nonce));
+    /* Lengths as in a frame, including empty header or payload */
+    mic_len = 4 + 2 * (random_rand() % 7);
+    a_len = random_rand() % (FRAME_MAX - mic_len + 1);
+    m_len = random_rand() % (FRAME_MAX - mic_len - a_len + 1);
+    random_bytes(a, a_len);
+    random_bytes(plain, m_len);
+    memcpy(m, plain, m_len);
+    memcpy(m_ref, plain, m_len);
+
+    ccm_star_driver.set_key(key);
+    ccm_star_driver.aead(nonce, m_ref, m_len, a, a_len, mic_ref, mic_len, 1);
+    ccm_star_single_pass_driver.set_key(key);
+    ccm_star_single_pass_driver.aead(nonce, m, m_len, a, a_len, mic, mic_len, 1);
+    UNIT_TEST_ASSERT(!memcmp(m, m_ref, m_len));
+    UNIT_TEST_ASSERT(!memcmp(mic, mic_ref, mic_len));
+
+    /* And back */
+    ccm_star_single_pass_driver.aead(nonce, m, m_len, a, a_len, mic, mic_len, 0);
+    UNIT_TEST_ASSERT(!memcmp(m, plain, m_len));
+    UNIT_TEST_ASSERT(!memcmp(mic, mic_ref, mic_len));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_ccm_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(compare);
+
+  if(!UNIT_TEST_PASSED(compare)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,6 @@
+#!/bin/bash -e
+
+# Every crc16_data() implementation against crc16_add()
+for IMPL in BITWISE TABLE SLICE4 SLICE8 CLMUL; do
+  CRC16_IMPL=$IMPL ./run-one.sh 27-crc16
+done
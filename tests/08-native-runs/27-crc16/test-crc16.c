@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for crc16_data(): whichever implementation
+ *      CRC16_CONF_IMPL selects must agree with crc16_add(), for any
+ *      length, alignment and initial value. Build with CRC16_IMPL=BITWISE,
+ *      TABLE, SLICE4, SLICE8 or CLMUL to pick one.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "lib/crc16.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define MAX_LEN      300
+#define RANDOM_CASES 5000
+
+PROCESS(test_crc16_process, "CRC16 test");
+AUTOSTART_PROCESSES(&test_crc16_process);
+/*****************************************************************************/
+static unsigned short
+reference(const unsigned char *data, int len, unsigned short acc)
+{
+  int i;
+
+  for(i = 0; i < len; i++) {
+    acc = crc16_add(data[i], acc);
+  }
+  return acc;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(check_value, "Check value");
+UNIT_TEST(check_value)
+{
+  const unsigned char *check = (const unsigned char *)"123456789";
+
+  UNIT_TEST_BEGIN();
+
+  /* CRC-16/KERMIT */
+  UNIT_TEST_ASSERT(reference(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 9, 0) == 0x2189);
+  UNIT_TEST_ASSERT(crc16_data(check, 0, 0x1234) == 0x1234);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(all_lengths, "All lengths and alignments");
+UNIT_TEST(all_lengths)
+{
+  static unsigned char buf[MAX_LEN + 8];
+  int len, offset;
+  int i;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < sizeof(buf); i++) {
+    buf[i] = random_rand();
+  }
+  for(offset = 0; offset < 8; offset++) {
+    for(len = 0; len <= MAX_LEN; len++) {
+      UNIT_TEST_ASSERT(crc16_data(buf + offset, len, 0) ==
+                       reference(buf + offset, len, 0));
+      UNIT_TEST_ASSERT(crc16_data(buf + offset, len, 0xffff) ==
+                       reference(buf + offset, len, 0xffff));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(random_data, "Random data and initial values");
+UNIT_TEST(random_data)
+{
+  static unsigned char buf[MAX_LEN];
+  unsigned short acc;
+  int len, split;
+  int i, j;
+
+  UNIT_TEST_BEGIN();
+
+  for(i = 0; i < RANDOM_CASES; i++) {
+    len = random_rand() % (MAX_LEN + 1);
+    for(j = 0; j < len; j++) {
+      buf[j] = random_rand();
+    }
+    acc = random_rand();
+    UNIT_TEST_ASSERT(crc16_data(buf, len, acc) == reference(buf, len, acc));
+
+    /* As a running checksum over two parts */
+    split = len ? random_rand() % len : 0;
+    UNIT_TEST_ASSERT(crc16_data(buf + split, len - split,
+                                crc16_data(buf, split, acc)) ==
+                     reference(buf, len, acc));
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_crc16_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(check_value);
+  UNIT_TEST_RUN(all_lengths);
+  UNIT_TEST_RUN(random_data);
+
+  if(!UNIT_TEST_PASSED(check_value) || !UNIT_TEST_PASSED(all_lengths) ||
+     !UNIT_TEST_PASSED(random_data)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,8 @@
+#!/bin/bash -e
+
+# The DAO storm without batching or adaptive jitter, with each of them,
+# and with both
+DAO_BATCH=0 DAO_JITTER=0 ./run-one.sh 28-rpl-dao-storm
+DAO_BATCH=0 ./run-one.sh 28-rpl-dao-storm
+DAO_JITTER=0 ./run-one.sh 28-rpl-dao-storm
+./run-one.sh 28-rpl-dao-storm
@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      A DAO storm at an RPL root, as after a global repair. A random
+ *      tree of NUM_NODES simulated nodes joins the new DODAG version hop
+ *      by hop; each node sends its DAO after rpl_timers_dao_delay(), and
+ *      retransmits it until the root's DAO-ACK comes back, as rpl-lite
+ *      does. The DAOs go through the root's real IPv6 and RPL input, and
+ *      DAO-ACKs are caught on output. The test reports the peak DAO
+ *      rate and the time until all nodes are reachable downwards.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/netstack.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define NUM_NODES        300
+/* Per-hop delay of the new DODAG version, from [HOP_DELAY, 2 * HOP_DELAY) */
+#define HOP_DELAY        (2 * CLOCK_SECOND / TIME_SCALE)
+#define POLL_INTERVAL    (CLOCK_SECOND / 100)
+/* The peak DAO rate is counted over windows of one (unscaled) second */
+#define RATE_WINDOW      (CLOCK_SECOND / TIME_SCALE)
+#define STORM_TIMEOUT    (120 * CLOCK_SECOND / TIME_SCALE)
+
+struct node {
+  uint16_t parent;      /* Node index, 0 for the root */
+  uint8_t hops;
+  uint8_t children;
+  uint8_t seqno;
+  uint8_t transmissions;
+  uint8_t acked;
+  uint8_t failed;
+  clock_time_t next_tx;
+  clock_time_t reachable_at;
+};
+
+/* nodes[0] is the root */
+static struct node nodes[NUM_NODES + 1];
+static clock_time_t storm_start;
+
+static unsigned long daos_sent;
+static unsigned long dao_acks;
+static unsigned long dao_acks_stale;
+static unsigned long rate_window;
+static unsigned rate_count;
+static unsigned rate_peak;
+
+PROCESS(test_dao_storm_process, "RPL DAO storm test");
+AUTOSTART_PROCESSES(&test_dao_storm_process);
+/*****************************************************************************/
+static void
+node_addr(int id, uip_ipaddr_t *addr)
+{
+  const uip_ipaddr_t *dag_id = &curr_instance.dag.dag_id;
+
+  if(id == 0) {
+    uip_ipaddr_copy(addr, dag_id);
+    return;
+  }
+  memcpy(addr, dag_id, 8);
+  memset(addr->u8 + 8, 0, 8);
+  addr->u8[8] = 0x02;
+  addr->u8[14] = id >> 8;
+  addr->u8[15] = id & 0xff;
+}
+/*****************************************************************************/
+static void
+build_tree(void)
+{
+  uip_ipaddr_t addr;
+  uip_lladdr_t lladdr;
+  int i;
+
+  memset(nodes, 0, sizeof(nodes));
+  for(i = 1; i <= NUM_NODES; i++) {
+    /* A random recursive tree: fan-out and depth both vary */
+    nodes[i].parent = random_rand() % i;
+    nodes[i].hops = nodes[nodes[i].parent].hops + 1;
+    nodes[nodes[i].parent].children++;
+
+    /* The root's children are its neighbors, as if they had sent DIOs */
+    if(nodes[i].parent == 0) {
+      node_addr(i, &addr);
+      uip_create_linklocal_prefix(&addr);
+      uip_ds6_set_lladdr_from_iid(&lladdr, &addr);
+      uip_ds6_nbr_add(&addr, &lladdr, 1, NBR_REACHABLE,
+                      NBR_TABLE_REASON_RPL_DIO, NULL);
+    }
+  }
+}
+/*****************************************************************************/
+static void
+start_storm(void)
+{
+  clock_time_t joined[NUM_NODES + 1];
+  int i;
+
+  storm_start = clock_time();
+  joined[0] = 0;
+  for(i = 1; i <= NUM_NODES; i++) {
+    joined[i] = joined[nodes[i].parent] + HOP_DELAY +
+      random_rand() % HOP_DELAY;
+    nodes[i].seqno = RPL_LOLLIPOP_INIT;
+    nodes[i].next_tx = storm_start + joined[i] +
+      rpl_timers_dao_delay(nodes[i].hops, nodes[i].children);
+  }
+}
+/*****************************************************************************/
+static void
+send_dao(int i)
+{
+  uint8_t *buffer;
+  uip_ipaddr_t parent;
+  int pos;
+
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 64;
+  node_addr(i, &UIP_IP_BUF->srcipaddr);
+  node_addr(0, &UIP_IP_BUF->destipaddr);
+  UIP_ICMP_BUF->type = ICMP6_RPL;
+  UIP_ICMP_BUF->icode = RPL_CODE_DAO;
+
+  /* As rpl_icmp6_dao_output() */
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = curr_instance.instance_id;
+  buffer[pos++] = RPL_DAO_K_FLAG;
+  buffer[pos++] = 0;
+  buffer[pos++] = nodes[i].seqno;
+
+  buffer[pos++] = RPL_OPTION_TARGET;
+  buffer[pos++] = 2 + 16;
+  buffer[pos++] = 0;
+  buffer[pos++] = 128;
+  memcpy(buffer + pos, &UIP_IP_BUF->srcipaddr, 16);
+  pos += 16;
+
+  node_addr(nodes[i].parent, &parent);
+  buffer[pos++] = RPL_OPTION_TRANSIT;
+  buffer[pos++] = 20;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = curr_instance.default_lifetime;
+  memcpy(buffer + pos, &parent, 16);
+  pos += 16;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + pos;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+
+  daos_sent++;
+  if(clock_time() - storm_start >= (rate_window + 1) * RATE_WINDOW) {
+    rate_window = (clock_time() - storm_start) / RATE_WINDOW;
+    rate_count = 0;
+  }
+  rate_peak = MAX(rate_peak, ++rate_count);
+
+  tcpip_input();
+}
+/*****************************************************************************/
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  uip_ipaddr_t final;
+  const uint8_t *hdr;
+  const uint8_t *icmp;
+  uint8_t cmpre;
+  int id;
+  int len;
+
+  /* The final destination is the last address of the source routing
+     header, with the first CmprE bytes elided, or the IPv6 destination
+     if the header has no addresses */
+  uip_ipaddr_copy(&final, &UIP_IP_BUF->destipaddr);
+  icmp = uip_buf + UIP_IPH_LEN;
+  if(UIP_IP_BUF->proto == UIP_PROTO_ROUTING) {
+    hdr = icmp;
+    len = (hdr[1] + 1) * 8;
+    cmpre = hdr[4] & 0x0f;
+    if(len - 8 - (hdr[5] >> 4) >= 16 - cmpre) {
+      memcpy(final.u8 + cmpre, hdr + len - (hdr[5] >> 4) - (16 - cmpre),
+             16 - cmpre);
+    }
+    icmp += len;
+  } else if(UIP_IP_BUF->proto != UIP_PROTO_ICMP6) {
+    return NETSTACK_IP_DROP;
+  }
+
+  if(icmp[0] == ICMP6_RPL && icmp[1] == RPL_CODE_DAO_ACK) {
+    id = (final.u8[14] << 8) | final.u8[15];
+    if(id > 0 && id <= NUM_NODES) {
+      if(icmp[UIP_ICMPH_LEN + 2] == nodes[id].seqno) {
+        nodes[id].acked = 1;
+        dao_acks++;
+      } else {
+        dao_acks_stale++;
+      }
+    }
+  }
+  return NETSTACK_IP_DROP;
+}
+/*****************************************************************************/
+static struct netstack_ip_packet_processor ip_processor = {
+  .process_input = NULL,
+  .process_output = ip_output
+};
+/*****************************************************************************/
+/* Sends the DAOs and retransmissions that are due. Returns 1 while some
+   node still waits for its DAO-ACK. */
+static int
+run_nodes(void)
+{
+  clock_time_t now;
+  int pending;
+  int i;
+
+  now = clock_time();
+  pending = 0;
+  for(i = 1; i <= NUM_NODES; i++) {
+    if(nodes[i].acked || nodes[i].failed) {
+      continue;
+    }
+    pending = 1;
+    if((long)(now - nodes[i].next_tx) < 0) {
+      continue;
+    }
+    if(nodes[i].transmissions == RPL_DAO_MAX_RETRANSMISSIONS) {
+      /* The node would now do a local repair */
+      nodes[i].failed = 1;
+      continue;
+    }
+    nodes[i].transmissions++;
+    nodes[i].next_tx = now + RPL_DAO_RETRANSMISSION_TIMEOUT / 2 +
+      random_rand() % RPL_DAO_RETRANSMISSION_TIMEOUT;
+    send_dao(i);
+  }
+  return pending;
+}
+/*****************************************************************************/
+/* Returns the number of nodes the root can reach */
+static int
+poll_reachability(void)
+{
+  uip_ipaddr_t addr;
+  int reachable;
+  int i;
+
+  reachable = 0;
+  for(i = 1; i <= NUM_NODES; i++) {
+    if(nodes[i].reachable_at == 0) {
+      node_addr(i, &addr);
+      if(uip_sr_is_addr_reachable(NULL, &addr)) {
+        nodes[i].reachable_at = clock_time();
+      }
+    }
+    reachable += nodes[i].reachable_at != 0;
+  }
+  return reachable;
+}
+/*****************************************************************************/
+static clock_time_t full_reachability;
+static int max_hops;
+static int failed;
+
+UNIT_TEST_REGISTER(storm, "DAO storm");
+UNIT_TEST(storm)
+{
+  int i, acked;
+
+  UNIT_TEST_BEGIN();
+
+  acked = 0;
+  for(i = 1; i <= NUM_NODES; i++) {
+    failed += nodes[i].failed;
+    acked += nodes[i].acked;
+    max_hops = MAX(max_hops, nodes[i].hops);
+  }
+  UNIT_TEST_ASSERT(full_reachability != 0);
+  UNIT_TEST_ASSERT(uip_sr_num_nodes() == NUM_NODES + 1);
+#if RPL_DAO_BATCH_SIZE > 0
+  /* Without batching, the root only keeps the last of the DAO-ACKs it
+     has to send, so some nodes may give up */
+  UNIT_TEST_ASSERT(acked == NUM_NODES);
+  UNIT_TEST_ASSERT(failed == 0);
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_dao_storm_process, ev, data)
+{
+  static struct etimer et;
+  static int pending;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  NETSTACK_ROUTING.root_start();
+  netstack_ip_packet_processor_add(&ip_processor);
+  build_tree();
+
+  /* Let the root settle */
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  start_storm();
+  do {
+    pending = run_nodes();
+    if(full_reachability == 0 && poll_reachability() == NUM_NODES) {
+      full_reachability = clock_time() - storm_start;
+    }
+    etimer_set(&et, POLL_INTERVAL);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  } while((pending || full_reachability == 0) &&
+          clock_time() - storm_start < STORM_TIMEOUT);
+
+  UNIT_TEST_RUN(storm);
+
+  printf("storm: %u nodes, depth up to %u, DAO batch %u, adaptive jitter %u, "
+         "times scaled by 1/%u\n", NUM_NODES, max_hops, RPL_DAO_BATCH_SIZE,
+         RPL_DAO_ADAPTIVE_JITTER, TIME_SCALE);
+  printf("storm: %lu DAOs sent, at most %u per second (unscaled), "
+         "%lu DAO-ACKs, %lu stale DAO-ACKs, %d nodes gave up\n",
+         daos_sent, rate_peak, dao_acks, dao_acks_stale, failed);
+  printf("storm: full downward reachability after %lu ms (%lu ms unscaled)\n",
+         (unsigned long)(full_reachability * 1000 / CLOCK_SECOND),
+         (unsigned long)(full_reachability * 1000 / CLOCK_SECOND * TIME_SCALE));
+
+  if(!UNIT_TEST_PASSED(storm)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# One target per DAO, as before, and multi-target DAOs
+DAO_TARGETS=1 ./run-one.sh 29-rpl-dao-aggregation
+./run-one.sh 29-rpl-dao-aggregation
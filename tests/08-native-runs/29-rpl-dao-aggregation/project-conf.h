@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H
+#define PROJECT_CONF_H
+
+/* 6LoWPAN over nullmac, so that no tun device is needed */
+#define NETSTACK_CONF_NETWORK sicslowpan_driver
+/* Do not wake up for stdin, but wake up every millisecond so that the
+   timers expire on time */
+#define SELECT_CONF_STDIN 0
+#define SELECT_CONF_TIMEOUT 1
+
+/* Routes to the whole simulated sub-DODAG */
+#define NETSTACK_MAX_ROUTE_ENTRIES 64
+
+#define RPL_CONF_MOP RPL_MOP_STORING_NO_MULTICAST
+#define RPL_CONF_WITH_DAO_ACK 1
+#define RPL_CONF_WITH_PROBING 0
+#define RPL_CONF_DAO_DELAY (CLOCK_SECOND / 4)
+
+#ifndef RPL_CONF_DAO_MAX_TARGETS
+#define RPL_CONF_DAO_MAX_TARGETS 16
+#endif /* RPL_CONF_DAO_MAX_TARGETS */
+
+#define LOG_CONF_LEVEL_RPL LOG_LEVEL_WARN
+#define LOG_CONF_LEVEL_IPV6 LOG_LEVEL_WARN
+
+#endif /* !PROJECT_CONF_H */
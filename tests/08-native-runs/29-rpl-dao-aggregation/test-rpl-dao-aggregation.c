@@ -0,0 +1,613 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      DAO overhead of a storing-mode RPL node with a sub-DODAG. The node
+ *      under test runs the real rpl-classic stack and joins the DODAG of
+ *      a simulated parent, which acknowledges its DAOs. Simulated
+ *      children refresh the routes to themselves and to the nodes below
+ *      them: with one target per DAO, every node's DAO is forwarded by
+ *      every hop; with multi-target DAOs, each child sends the routes of
+ *      its sub-DODAG in its own DAOs. The test counts the DAOs and
+ *      DAO-ACKs the node under test sends and receives, and checks that
+ *      the parent's routes to all targets stay alive and that all DAOs
+ *      from the children get acknowledged. With multi-target DAOs, it
+ *      also checks that a DAO dropped for lack of room in the routing
+ *      table leaves no route of its first targets to send to the parent.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/link-stats.h"
+#include "net/routing/rpl-classic/rpl-private.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define NUM_CHILDREN     4
+/* Nodes below each child */
+#define SUBTREE_SIZE     7
+#define NUM_NODES        (NUM_CHILDREN * (1 + SUBTREE_SIZE))
+
+/* The DODAG is advertised with a route lifetime of LIFETIME seconds */
+#define LIFETIME         6
+#define DIO_INTERVAL     (2 * CLOCK_SECOND)
+#define ACK_DELAY        (CLOCK_SECOND / 50)
+#define POLL_INTERVAL    (CLOCK_SECOND / 100)
+#define RUN_TIME         (30 * CLOCK_SECOND)
+/* Time for the last DAOs to be acknowledged */
+#define DRAIN_TIME       (2 * CLOCK_SECOND)
+#define ACK_QUEUE_SIZE   16
+
+/* DIO base object flags, as in rpl-icmp6.c */
+#define DIO_GROUNDED     0x80
+#define DIO_MOP_SHIFT    3
+
+/* Simulated nodes have ids 1..NUM_NODES; ids 1..NUM_CHILDREN are the
+   children of the node under test */
+struct node {
+  clock_time_t next_tx;
+  clock_time_t expires;     /* Of the parent's route to the node */
+  uint8_t known;
+};
+
+/* The DAOs of a child that wait for a DAO-ACK */
+struct child {
+  uint8_t seqno;
+  uint8_t waiting[256 / 8];
+};
+
+static struct node nodes[NUM_NODES + 1];
+static struct node self;
+static struct child children[NUM_CHILDREN + 1];
+static uip_ipaddr_t parent_addr;
+static uip_ipaddr_t dag_id;
+static clock_time_t run_start;
+static clock_time_t next_dio;
+
+static uint8_t ack_queue[ACK_QUEUE_SIZE];
+static clock_time_t ack_time[ACK_QUEUE_SIZE];
+static int acks_queued;
+
+static unsigned long daos_in;
+static unsigned long daos_out;
+static unsigned long targets_out;
+static unsigned long dao_acks_in;
+static unsigned long dao_acks_out;
+static unsigned long child_daos;
+static unsigned long child_acks;
+static unsigned long lapses;
+static uint8_t last_ack_status;
+
+PROCESS(test_dao_aggregation_process, "RPL DAO aggregation test");
+AUTOSTART_PROCESSES(&test_dao_aggregation_process);
+/*****************************************************************************/
+static void
+node_addr(int id, uip_ipaddr_t *addr, int link_local)
+{
+  uip_ip6addr(addr, 0xfd00, 0, 0, 0, 0x0200, 0, 0, id);
+  if(link_local) {
+    uip_create_linklocal_prefix(addr);
+  }
+}
+/*****************************************************************************/
+static int
+before(clock_time_t a, clock_time_t b)
+{
+  return (long)(a - b) < 0;
+}
+/*****************************************************************************/
+#if RPL_DAO_MAX_TARGETS == 1
+static int
+child_of(int id)
+{
+  return id <= NUM_CHILDREN ? id : (id - NUM_CHILDREN - 1) / SUBTREE_SIZE + 1;
+}
+#endif /* RPL_DAO_MAX_TARGETS == 1 */
+/*****************************************************************************/
+/* Passes the packet in uip_buf, from the given link-local address, to the
+   node under test */
+static void
+input(const uip_ipaddr_t *src, const uip_ipaddr_t *dest, uint8_t code,
+      int len)
+{
+  uip_lladdr_t lladdr;
+
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 255;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dest);
+  UIP_ICMP_BUF->type = ICMP6_RPL;
+  UIP_ICMP_BUF->icode = code;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + len;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+
+  uip_ds6_set_lladdr_from_iid(&lladdr, src);
+  packetbuf_clear();
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, (linkaddr_t *)&lladdr);
+  tcpip_input();
+}
+/*****************************************************************************/
+/* A DIO from the parent, which is the root of the DODAG */
+static void
+send_dio(void)
+{
+  uip_ipaddr_t dest;
+  uip_lladdr_t lladdr;
+  uint8_t *buffer;
+  int pos;
+
+  uipbuf_clear();
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = RPL_DEFAULT_INSTANCE;
+  buffer[pos++] = RPL_LOLLIPOP_INIT;
+  buffer[pos++] = RPL_MIN_HOPRANKINC >> 8;
+  buffer[pos++] = RPL_MIN_HOPRANKINC & 0xff;
+  buffer[pos++] = DIO_GROUNDED |
+    (RPL_MOP_STORING_NO_MULTICAST << DIO_MOP_SHIFT);
+  buffer[pos++] = 0; /* DTSN */
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  buffer[pos++] = RPL_OPTION_DAG_CONF;
+  buffer[pos++] = 14;
+  buffer[pos++] = 0;
+  buffer[pos++] = RPL_DIO_INTERVAL_DOUBLINGS;
+  buffer[pos++] = RPL_DIO_INTERVAL_MIN;
+  buffer[pos++] = RPL_DIO_REDUNDANCY;
+  buffer[pos++] = RPL_MAX_RANKINC >> 8;
+  buffer[pos++] = RPL_MAX_RANKINC & 0xff;
+  buffer[pos++] = RPL_MIN_HOPRANKINC >> 8;
+  buffer[pos++] = RPL_MIN_HOPRANKINC & 0xff;
+  buffer[pos++] = RPL_OF_OCP >> 8;
+  buffer[pos++] = RPL_OF_OCP & 0xff;
+  buffer[pos++] = 0;
+  buffer[pos++] = LIFETIME;
+  buffer[pos++] = 0; /* Lifetime unit: one second */
+  buffer[pos++] = 1;
+
+  buffer[pos++] = RPL_OPTION_PREFIX_INFO;
+  buffer[pos++] = 30;
+  buffer[pos++] = 64;
+  buffer[pos++] = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  memset(buffer + pos, 0xff, 8); /* Infinite lifetimes */
+  pos += 8;
+  memset(buffer + pos, 0, 4);
+  pos += 4;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  /* A good link to the parent, as if our DAOs had got through */
+  uip_ds6_set_lladdr_from_iid(&lladdr, &parent_addr);
+  link_stats_packet_sent((linkaddr_t *)&lladdr, MAC_TX_OK, 1);
+
+  uip_create_linklocal_rplnodes_mcast(&dest);
+  input(&parent_addr, &dest, RPL_CODE_DIO, pos);
+}
+/*****************************************************************************/
+static int
+add_target(uint8_t *buffer, int pos, int id)
+{
+  buffer[pos++] = RPL_OPTION_TARGET;
+  buffer[pos++] = 2 + 16;
+  buffer[pos++] = 0;
+  buffer[pos++] = 128;
+  node_addr(id, (uip_ipaddr_t *)(buffer + pos), 0);
+  return pos + 16;
+}
+/*****************************************************************************/
+/* Starts a DAO from a child, returns the position of its first option */
+static int
+begin_dao(int child)
+{
+  uint8_t *buffer;
+  int pos;
+
+  uipbuf_clear();
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = RPL_DEFAULT_INSTANCE;
+  buffer[pos++] = RPL_DAO_K_FLAG;
+  buffer[pos++] = 0;
+  RPL_LOLLIPOP_INCREMENT(children[child].seqno);
+  buffer[pos++] = children[child].seqno;
+  children[child].waiting[children[child].seqno / 8] |=
+    1 << (children[child].seqno % 8);
+  return pos;
+}
+/*****************************************************************************/
+/* Ends the DAO with a Transit Information option and passes it to the
+   node under test */
+static void
+end_dao(int child, int pos)
+{
+  uip_ipaddr_t src;
+  uip_ipaddr_t dest;
+  uint8_t *buffer;
+
+  buffer = UIP_ICMP_PAYLOAD;
+  buffer[pos++] = RPL_OPTION_TRANSIT;
+  buffer[pos++] = 4;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = LIFETIME;
+
+  node_addr(child, &src, 1);
+  uip_ipaddr_copy(&dest, &uip_ds6_get_link_local(-1)->ipaddr);
+  child_daos++;
+  daos_in++;
+  input(&src, &dest, RPL_CODE_DAO, pos);
+}
+/*****************************************************************************/
+/* A DAO from a child with a target for node id, and for the nodes below
+   the child if subtree is set */
+static void
+send_dao(int child, int id, int subtree)
+{
+  int pos;
+  int i;
+
+  pos = begin_dao(child);
+  pos = add_target(UIP_ICMP_PAYLOAD, pos, id);
+  for(i = 0; subtree && i < SUBTREE_SIZE; i++) {
+    pos = add_target(UIP_ICMP_PAYLOAD, pos,
+                     NUM_CHILDREN + 1 + (child - 1) * SUBTREE_SIZE + i);
+  }
+  end_dao(child, pos);
+}
+/*****************************************************************************/
+/* The DAO-ACKs from the parent, for the DAOs of the node under test */
+static void
+send_dao_acks(void)
+{
+  uip_ipaddr_t dest;
+  uint8_t *buffer;
+  int i;
+
+  while(acks_queued > 0 && !before(clock_time(), ack_time[0])) {
+    uipbuf_clear();
+    buffer = UIP_ICMP_PAYLOAD;
+    buffer[0] = RPL_DEFAULT_INSTANCE;
+    buffer[1] = 0;
+    buffer[2] = ack_queue[0];
+    buffer[3] = RPL_DAO_ACK_UNCONDITIONAL_ACCEPT;
+
+    acks_queued--;
+    for(i = 0; i < acks_queued; i++) {
+      ack_queue[i] = ack_queue[i + 1];
+      ack_time[i] = ack_time[i + 1];
+    }
+
+    uip_ipaddr_copy(&dest, &uip_ds6_get_link_local(-1)->ipaddr);
+    dao_acks_in++;
+    input(&parent_addr, &dest, RPL_CODE_DAO_ACK, 4);
+  }
+}
+/*****************************************************************************/
+static clock_time_t
+refresh_time(void)
+{
+  /* As rpl-classic: between 1/2 and 3/4 of the lifetime */
+  return clock_time() + LIFETIME * CLOCK_SECOND / 2 +
+    random_rand() % (LIFETIME * CLOCK_SECOND / 4);
+}
+/*****************************************************************************/
+/* Sends the DAOs that are due from the simulated sub-DODAG */
+static void
+run_nodes(int refresh)
+{
+  int id;
+
+  for(id = 1; id <= NUM_NODES; id++) {
+    if(before(clock_time(), nodes[id].next_tx)) {
+      continue;
+    }
+    nodes[id].next_tx = refresh_time();
+    if(!refresh) {
+      continue;
+    }
+#if RPL_DAO_MAX_TARGETS > 1
+    /* The children send the routes of their sub-DODAGs with their own
+       DAOs, and acknowledge the DAOs from below themselves */
+    if(id <= NUM_CHILDREN) {
+      send_dao(id, id, 1);
+    }
+#else /* RPL_DAO_MAX_TARGETS > 1 */
+    /* Every node's DAO is forwarded by its child of the node under test */
+    send_dao(child_of(id), id, 0);
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+  }
+}
+/*****************************************************************************/
+/* The parent's routes: each Target option gets the lifetime of the next
+   Transit Information option */
+static void
+parent_dao_input(const uint8_t *buffer, int len)
+{
+  uip_ipaddr_t prefix;
+  struct node *n;
+  int group;
+  int i;
+  int j;
+  int id;
+
+  daos_out++;
+  group = 4;
+  if(buffer[1] & RPL_DAO_D_FLAG) {
+    group += 16;
+  }
+  for(i = group; i < len; i += 2 + buffer[i + 1]) {
+    if(buffer[i] != RPL_OPTION_TRANSIT) {
+      continue;
+    }
+    for(j = group; j < i; j += 2 + buffer[j + 1]) {
+      if(buffer[j] != RPL_OPTION_TARGET) {
+        continue;
+      }
+      targets_out++;
+      memset(&prefix, 0, sizeof(prefix));
+      memcpy(&prefix, buffer + j + 4, 16);
+      if(uip_ds6_is_my_addr(&prefix)) {
+        n = &self;
+      } else {
+        id = (prefix.u8[14] << 8) | prefix.u8[15];
+        if(id < 1 || id > NUM_NODES) {
+          continue;
+        }
+        n = &nodes[id];
+      }
+      if(n->known && before(n->expires, clock_time())) {
+        lapses++;
+      }
+      n->known = 1;
+      n->expires = clock_time() + buffer[i + 5] * CLOCK_SECOND;
+    }
+    group = i + 2 + buffer[i + 1];
+  }
+
+  if((buffer[1] & RPL_DAO_K_FLAG) && acks_queued < ACK_QUEUE_SIZE) {
+    ack_queue[acks_queued] = buffer[3];
+    ack_time[acks_queued] = clock_time() + ACK_DELAY;
+    acks_queued++;
+  }
+}
+/*****************************************************************************/
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  const uint8_t *hdr;
+  uint8_t proto;
+  uint8_t seqno;
+  int len;
+  int id;
+
+  hdr = uip_buf + UIP_IPH_LEN;
+  proto = UIP_IP_BUF->proto;
+  if(proto == UIP_PROTO_HBHO) {
+    proto = hdr[0];
+    hdr += (hdr[1] + 1) * 8;
+  }
+  if(proto != UIP_PROTO_ICMP6 || hdr[0] != ICMP6_RPL) {
+    return NETSTACK_IP_DROP;
+  }
+  len = uip_len - (hdr - uip_buf) - UIP_ICMPH_LEN;
+
+  if(hdr[1] == RPL_CODE_DAO &&
+     uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &parent_addr)) {
+    parent_dao_input(hdr + UIP_ICMPH_LEN, len);
+  } else if(hdr[1] == RPL_CODE_DAO_ACK) {
+    dao_acks_out++;
+    last_ack_status = hdr[UIP_ICMPH_LEN + 3];
+    id = (UIP_IP_BUF->destipaddr.u8[14] << 8) |
+      UIP_IP_BUF->destipaddr.u8[15];
+    seqno = hdr[UIP_ICMPH_LEN + 2];
+    if(id >= 1 && id <= NUM_CHILDREN &&
+       (children[id].waiting[seqno / 8] & (1 << (seqno % 8))) &&
+       hdr[UIP_ICMPH_LEN + 3] < RPL_DAO_ACK_UNABLE_TO_ACCEPT) {
+      children[id].waiting[seqno / 8] &= ~(1 << (seqno % 8));
+      child_acks++;
+    }
+  }
+  return NETSTACK_IP_DROP;
+}
+/*****************************************************************************/
+static struct netstack_ip_packet_processor ip_processor = {
+  .process_input = NULL,
+  .process_output = ip_output
+};
+/*****************************************************************************/
+/* Routes the parent does not have, when the sub-DODAG stops refreshing */
+static int stale;
+
+static void
+count_stale(void)
+{
+  int id;
+
+  stale = !self.known || before(self.expires, clock_time());
+  for(id = 1; id <= NUM_NODES; id++) {
+    stale += !nodes[id].known || before(nodes[id].expires, clock_time());
+  }
+}
+
+UNIT_TEST_REGISTER(aggregation, "DAO aggregation");
+UNIT_TEST(aggregation)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(stale == 0);
+  UNIT_TEST_ASSERT(lapses == 0);
+  UNIT_TEST_ASSERT(child_acks == child_daos);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+#if RPL_DAO_MAX_TARGETS > 1
+/* Routes to the nodes of a DAO dropped half-way */
+#define DROPPED_FIRST    (NUM_NODES + 1)
+#define DROPPED_ROUTES   4
+
+UNIT_TEST_REGISTER(rollback, "DAO rollback");
+UNIT_TEST(rollback)
+{
+  uip_ipaddr_t nexthop;
+  uip_ipaddr_t prefix;
+  uip_ds6_route_t *r;
+  unsigned long acks;
+  int marked;
+  int pos;
+  int id;
+
+  UNIT_TEST_BEGIN();
+
+  /* Leave room for only the first targets of the DAO */
+  node_addr(1, &nexthop, 1);
+  for(id = DROPPED_FIRST + RPL_DAO_MAX_TARGETS;
+      uip_ds6_route_num_routes() < UIP_DS6_ROUTE_NB - DROPPED_ROUTES;
+      id++) {
+    node_addr(id, &prefix, 0);
+    UNIT_TEST_ASSERT(rpl_add_route(rpl_get_any_dag(), &prefix, 128,
+                                   &nexthop) != NULL);
+  }
+
+  acks = child_acks;
+  pos = begin_dao(1);
+  for(id = DROPPED_FIRST; id <= DROPPED_FIRST + DROPPED_ROUTES; id++) {
+    pos = add_target(UIP_ICMP_PAYLOAD, pos, id);
+  }
+  end_dao(1, pos);
+
+  marked = 0;
+  for(id = DROPPED_FIRST; id < DROPPED_FIRST + DROPPED_ROUTES; id++) {
+    node_addr(id, &prefix, 0);
+    r = uip_ds6_route_lookup(&prefix);
+    UNIT_TEST_ASSERT(r != NULL);
+    marked += RPL_ROUTE_IS_DAO_FWD(r) || RPL_ROUTE_IS_DAO_PENDING(r);
+  }
+  UNIT_TEST_ASSERT(marked == 0);
+  /* The child got a DAO-NACK */
+  UNIT_TEST_ASSERT(child_acks == acks);
+  UNIT_TEST_ASSERT(last_ack_status >= RPL_DAO_ACK_UNABLE_TO_ACCEPT);
+
+  UNIT_TEST_END();
+}
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+/*****************************************************************************/
+PROCESS_THREAD(test_dao_aggregation_process, ev, data)
+{
+  static struct etimer et;
+  unsigned long packets;
+  unsigned long minute;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  netstack_ip_packet_processor_add(&ip_processor);
+  uip_ip6addr(&parent_addr, 0xfe80, 0, 0, 0, 0, 0, 0, 1);
+  uip_ip6addr(&dag_id, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+
+  /* Join the parent's DODAG */
+  do {
+    send_dio();
+    next_dio = clock_time() + DIO_INTERVAL;
+    etimer_set(&et, CLOCK_SECOND / 10);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  } while(rpl_get_any_dag() == NULL ||
+          rpl_get_any_dag()->preferred_parent == NULL ||
+          rpl_get_any_dag()->rank == RPL_INFINITE_RANK);
+
+  run_start = clock_time();
+  run_nodes(0);
+  while(before(clock_time(), run_start + RUN_TIME + DRAIN_TIME)) {
+    if(!before(clock_time(), next_dio)) {
+      send_dio();
+      next_dio = clock_time() + DIO_INTERVAL;
+    }
+    send_dao_acks();
+    if(before(clock_time(), run_start + RUN_TIME)) {
+      run_nodes(1);
+      count_stale();
+    } else {
+      run_nodes(0);
+    }
+    etimer_set(&et, POLL_INTERVAL);
+    PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  }
+
+  UNIT_TEST_RUN(aggregation);
+#if RPL_DAO_MAX_TARGETS > 1
+  UNIT_TEST_RUN(rollback);
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+
+  packets = daos_in + daos_out + dao_acks_in + dao_acks_out;
+  minute = 60 * CLOCK_SECOND;
+  printf("aggregation: %u children with %u nodes below each, up to %u "
+         "targets per DAO, route lifetime %u s\n", NUM_CHILDREN,
+         SUBTREE_SIZE, RPL_DAO_MAX_TARGETS, LIFETIME);
+  printf("aggregation: DAOs in %lu, out %lu with %lu targets, DAO-ACKs in "
+         "%lu, out %lu, child DAOs acknowledged %lu/%lu, stale routes %d\n",
+         daos_in, daos_out, targets_out, dao_acks_in, dao_acks_out,
+         child_acks, child_daos, stale);
+  printf("aggregation: %lu DAO and DAO-ACK packets per minute\n",
+         packets * minute / (RUN_TIME + DRAIN_TIME));
+
+  if(!UNIT_TEST_PASSED(aggregation)
+#if RPL_DAO_MAX_TARGETS > 1
+     || !UNIT_TEST_PASSED(rollback)
+#endif /* RPL_DAO_MAX_TARGETS > 1 */
+     ) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
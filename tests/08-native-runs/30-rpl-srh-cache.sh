@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Source routing headers built for every packet, and cached
+SRH_CACHE=0 ./run-one.sh 30-rpl-srh-cache
+./run-one.sh 30-rpl-srh-cache
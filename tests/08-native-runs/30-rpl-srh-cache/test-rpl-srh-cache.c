@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Source routing headers at an RPL root that polls all nodes of a
+ *      large non-storing network in turn. Packets to every node go
+ *      through the root's extension header insertion, and the test
+ *      checks the source route in each of them against the topology,
+ *      also after some nodes have changed parents. The test reports the
+ *      hit rate of the root's source routing header cache.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define NUM_NODES        1000
+#define MAX_HOPS         7
+#define ROUNDS           4
+#define REPARENTED       20
+#define LIFETIME         3600
+#define PAYLOAD_LEN      32
+
+struct node {
+  uint16_t parent;      /* Node index, 0 for the root */
+  uint8_t hops;
+  uint8_t iid[8];
+};
+
+/* nodes[0] is the root */
+static struct node nodes[NUM_NODES + 1];
+
+static unsigned long packets;
+static unsigned long errors;
+
+PROCESS(test_srh_cache_process, "RPL SRH cache test");
+AUTOSTART_PROCESSES(&test_srh_cache_process);
+/*****************************************************************************/
+static void
+node_addr(int id, uip_ipaddr_t *addr)
+{
+  if(id == 0) {
+    uip_ipaddr_copy(addr, &curr_instance.dag.dag_id);
+    return;
+  }
+  memcpy(addr, &curr_instance.dag.dag_id, 8);
+  memcpy(addr->u8 + 8, nodes[id].iid, 8);
+}
+/*****************************************************************************/
+static void
+update_link(int id)
+{
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+
+  node_addr(id, &child);
+  node_addr(nodes[id].parent, &parent);
+  uip_sr_update_node(NULL, &child, &parent, LIFETIME);
+}
+/*****************************************************************************/
+/* Picks a parent for node id among the nodes before it, so that the
+   graph has no loops and the node is at most MAX_HOPS hops away */
+static int
+pick_parent(int id, int max_hops)
+{
+  int parent;
+
+  do {
+    parent = random_rand() % id;
+  } while(nodes[parent].hops >= max_hops);
+  return parent;
+}
+/*****************************************************************************/
+static void
+build_tree(void)
+{
+  int i;
+  int j;
+
+  for(i = 1; i <= NUM_NODES; i++) {
+    /* EUI-64-like identifiers, unique through the last two bytes */
+    for(j = 0; j < 6; j++) {
+      nodes[i].iid[j] = random_rand();
+    }
+    nodes[i].iid[6] = i >> 8;
+    nodes[i].iid[7] = i & 0xff;
+
+    nodes[i].parent = pick_parent(i, MAX_HOPS - 1);
+    nodes[i].hops = nodes[nodes[i].parent].hops + 1;
+    update_link(i);
+  }
+}
+/*****************************************************************************/
+/* Moves some nodes to other parents that are no deeper in the DODAG */
+static void
+reparent(void)
+{
+  int i;
+  int id;
+
+  for(i = 0; i < REPARENTED; i++) {
+    id = 1 + random_rand() % NUM_NODES;
+    nodes[id].parent = pick_parent(id, nodes[nodes[id].parent].hops + 1);
+    update_link(id);
+  }
+  for(id = 1; id <= NUM_NODES; id++) {
+    nodes[id].hops = nodes[nodes[id].parent].hops + 1;
+  }
+}
+/*****************************************************************************/
+/* A UDP packet from the root to node id */
+static void
+make_packet(int id)
+{
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  node_addr(0, &UIP_IP_BUF->srcipaddr);
+  node_addr(id, &UIP_IP_BUF->destipaddr);
+
+  UIP_UDP_BUF->srcport = UIP_HTONS(5683);
+  UIP_UDP_BUF->destport = UIP_HTONS(5683);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->udpchksum = 0;
+  memset(UIP_UDP_PAYLOAD, id & 0xff, PAYLOAD_LEN);
+
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+}
+/*****************************************************************************/
+/* Checks the source route to node id in uip_buf. Returns 1 if correct. */
+static int
+check_packet(int id)
+{
+  uip_ipaddr_t addr;
+  uint16_t path[MAX_HOPS];
+  const uint8_t *rh;
+  const uint8_t *hop;
+  uint8_t cmpr;
+  int path_len;
+  int ext_len;
+  int node;
+  int i;
+
+  /* The route from the first hop down to node id, backwards */
+  path_len = 0;
+  for(node = id; nodes[node].parent != 0; node = nodes[node].parent) {
+    path[path_len++] = node;
+  }
+
+  node_addr(node, &addr);
+  rh = uip_buf + UIP_IPH_LEN;
+  ext_len = (rh[1] + 1) * 8;
+  if(UIP_IP_BUF->proto != UIP_PROTO_ROUTING ||
+     rh[0] != UIP_PROTO_UDP ||
+     rh[2] != RPL_RH_TYPE_SRH ||
+     rh[3] != path_len ||
+     !uip_ipaddr_cmp(&UIP_IP_BUF->destipaddr, &addr) ||
+     uip_len != UIP_IPH_LEN + ext_len + UIP_UDPH_LEN + PAYLOAD_LEN ||
+     uipbuf_get_len_field(UIP_IP_BUF) != uip_len - UIP_IPH_LEN ||
+     uip_buf[UIP_IPH_LEN + ext_len + UIP_UDPH_LEN] != (id & 0xff)) {
+    return 0;
+  }
+
+  /* The addresses of the hops after the first hop, with the first CmprI
+     (or CmprE for the last one) bytes elided */
+  hop = rh + 8;
+  for(i = path_len - 1; i >= 0; i--) {
+    cmpr = i == 0 ? rh[4] & 0x0f : rh[4] >> 4;
+    node_addr(path[i], &addr);
+    if(memcmp(hop, addr.u8 + cmpr, 16 - cmpr) != 0) {
+      return 0;
+    }
+    hop += 16 - cmpr;
+  }
+  return 1;
+}
+/*****************************************************************************/
+/* Sends a packet to every node */
+static void
+poll_nodes(void)
+{
+  int id;
+
+  for(id = 1; id <= NUM_NODES; id++) {
+    make_packet(id);
+    if(!NETSTACK_ROUTING.ext_header_update()) {
+      errors++;
+      continue;
+    }
+    packets++;
+    errors += !check_packet(id);
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(srh_cache, "SRH cache");
+UNIT_TEST(srh_cache)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(errors == 0);
+  UNIT_TEST_ASSERT(packets == 2 * ROUNDS * NUM_NODES);
+#if RPL_SRH_CACHE_SIZE > 0
+  UNIT_TEST_ASSERT(uip_stat.sr.hit + uip_stat.sr.miss == packets);
+  /* Every node at least misses after the topology changed */
+  UNIT_TEST_ASSERT(uip_stat.sr.miss >= 2 * NUM_NODES);
+  UNIT_TEST_ASSERT(uip_stat.sr.hit > 0);
+#endif /* RPL_SRH_CACHE_SIZE > 0 */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_srh_cache_process, ev, data)
+{
+  int i;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  NETSTACK_ROUTING.root_start();
+  build_tree();
+
+  for(i = 0; i < 2 * ROUNDS; i++) {
+    if(i == ROUNDS) {
+      reparent();
+    }
+    poll_nodes();
+  }
+
+  UNIT_TEST_RUN(srh_cache);
+
+  printf("srh: %u nodes, up to %u hops, SRH cache size %u, %lu packets, "
+         "%lu errors\n", NUM_NODES, MAX_HOPS, RPL_SRH_CACHE_SIZE, packets,
+         errors);
+  printf("srh: cache hits %lu, misses %lu\n",
+         (unsigned long)uip_stat.sr.hit, (unsigned long)uip_stat.sr.miss);
+
+  if(!UNIT_TEST_PASSED(srh_cache)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Parents selected by going through all neighbors, and from the heap
+PARENT_RANKING=0 ./run-one.sh 31-rpl-parent-select
+./run-one.sh 31-rpl-parent-select
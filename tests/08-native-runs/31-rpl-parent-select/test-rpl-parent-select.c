@@ -0,0 +1,398 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      RPL parent selection in a dense neighborhood. The node under test
+ *      runs rpl-lite and hears DIOs from many neighbors whose ranks keep
+ *      changing, some of which advertise an infinite rank for a while,
+ *      while the link statistics towards random neighbors get updated.
+ *      After every DIO, the test checks that the preferred parent is an
+ *      acceptable one within the MRHOF hysteresis of the best, and, with
+ *      the candidate parent heap, that the heap matches the OF. It also
+ *      checks that the node's rank follows link statistics of the
+ *      preferred parent that change without a link callback.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/link-stats.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+#include "lib/random.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define NUM_NEIGHBORS    60
+#define NUM_DIOS         10000
+#define MIN_RANK         (2 * RPL_MIN_HOPRANKINC)
+#define MAX_RANK         (12 * RPL_MIN_HOPRANKINC)
+#define RANK_STEP        64
+/* One in POISON_RATE DIOs advertises an infinite rank */
+#define POISON_RATE      64
+/* Check the candidate heap every CHECK_INTERVAL DIOs */
+#define CHECK_INTERVAL   100
+/* Let the timers run every BATCH_SIZE DIOs */
+#define BATCH_SIZE       500
+
+/* MRHOF's parent switch threshold, as in rpl-mrhof.c */
+#define RANK_THRESHOLD   192
+
+/* DIO base object flags, as in rpl-icmp6.c */
+#define DIO_GROUNDED     0x80
+#define DIO_MOP_SHIFT    3
+
+static rpl_rank_t ranks[NUM_NEIGHBORS + 1];
+static uip_ipaddr_t dag_id;
+
+static unsigned long dios;
+static unsigned long link_updates;
+static unsigned long switches;
+static unsigned long errors;
+static unsigned long heap_errors;
+static unsigned long rank_errors;
+
+PROCESS(test_parent_select_process, "RPL parent selection test");
+AUTOSTART_PROCESSES(&test_parent_select_process);
+/*****************************************************************************/
+static void
+neighbor_addr(int id, uip_ipaddr_t *addr)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0x0200, 0, 0, id);
+}
+/*****************************************************************************/
+static void
+neighbor_lladdr(int id, uip_lladdr_t *lladdr)
+{
+  uip_ipaddr_t addr;
+
+  neighbor_addr(id, &addr);
+  uip_ds6_set_lladdr_from_iid(lladdr, &addr);
+}
+/*****************************************************************************/
+/* Builds a DIO from neighbor id in uip_buf, ready for tcpip_input() */
+static void
+make_dio(int id, rpl_rank_t rank)
+{
+  uip_lladdr_t lladdr;
+  uint8_t *buffer;
+  int pos;
+
+  uipbuf_clear();
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = RPL_DEFAULT_INSTANCE;
+  buffer[pos++] = RPL_LOLLIPOP_INIT;
+  buffer[pos++] = rank >> 8;
+  buffer[pos++] = rank & 0xff;
+  buffer[pos++] = DIO_GROUNDED |
+    (RPL_MOP_NO_DOWNWARD_ROUTES << DIO_MOP_SHIFT);
+  buffer[pos++] = 0; /* DTSN */
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  buffer[pos++] = RPL_OPTION_DAG_CONF;
+  buffer[pos++] = 14;
+  buffer[pos++] = 0;
+  buffer[pos++] = RPL_DIO_INTERVAL_DOUBLINGS;
+  buffer[pos++] = RPL_DIO_INTERVAL_MIN;
+  buffer[pos++] = RPL_DIO_REDUNDANCY;
+  buffer[pos++] = RPL_MAX_RANKINC >> 8;
+  buffer[pos++] = RPL_MAX_RANKINC & 0xff;
+  buffer[pos++] = RPL_MIN_HOPRANKINC >> 8;
+  buffer[pos++] = RPL_MIN_HOPRANKINC & 0xff;
+  buffer[pos++] = RPL_OF_OCP >> 8;
+  buffer[pos++] = RPL_OF_OCP & 0xff;
+  buffer[pos++] = 0;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME_UNIT >> 8;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME_UNIT & 0xff;
+
+  buffer[pos++] = RPL_OPTION_PREFIX_INFO;
+  buffer[pos++] = 30;
+  buffer[pos++] = 64;
+  buffer[pos++] = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  memset(buffer + pos, 0xff, 8); /* Infinite lifetimes */
+  pos += 8;
+  memset(buffer + pos, 0, 4);
+  pos += 4;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 255;
+  neighbor_addr(id, &UIP_IP_BUF->srcipaddr);
+  uip_create_linklocal_rplnodes_mcast(&UIP_IP_BUF->destipaddr);
+  UIP_ICMP_BUF->type = ICMP6_RPL;
+  UIP_ICMP_BUF->icode = RPL_CODE_DIO;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + pos;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+
+  neighbor_lladdr(id, &lladdr);
+  packetbuf_clear();
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, (linkaddr_t *)&lladdr);
+}
+/*****************************************************************************/
+/* A transmission to neighbor id, as reported by the MAC layer */
+static void
+packet_sent(int id, int status, int numtx)
+{
+  uip_lladdr_t lladdr;
+
+  neighbor_lladdr(id, &lladdr);
+  link_stats_packet_sent((linkaddr_t *)&lladdr, status, numtx);
+  NETSTACK_ROUTING.link_callback((linkaddr_t *)&lladdr, status, numtx);
+}
+/*****************************************************************************/
+/* A transmission to the preferred parent that only the link statistics
+   see, as with a MAC layer that does not call the link callback. The
+   node's rank must follow at the next state update. */
+static void
+silent_packet_sent(void)
+{
+  const linkaddr_t *lladdr;
+
+  lladdr = rpl_neighbor_get_lladdr(curr_instance.dag.preferred_parent);
+  if(lladdr == NULL) {
+    return;
+  }
+  link_stats_packet_sent(lladdr, MAC_TX_OK, 1 + random_rand() % 4);
+  rpl_dag_update_state();
+  if(curr_instance.dag.preferred_parent != NULL
+     && curr_instance.dag.rank !=
+     curr_instance.of->rank_via_nbr(curr_instance.dag.preferred_parent)) {
+    rank_errors++;
+  }
+  /* Let the routing layer catch up, as for the other transmissions */
+  NETSTACK_ROUTING.link_callback(lladdr, MAC_TX_OK, 1);
+}
+/*****************************************************************************/
+static void
+next_rank(int id)
+{
+  int rank;
+
+  rank = ranks[id] + (int)(random_rand() % (2 * RANK_STEP + 1)) - RANK_STEP;
+  ranks[id] = MAX(MIN_RANK, MIN(rank, MAX_RANK));
+}
+/*****************************************************************************/
+/* The preferred parent must be acceptable, and not much worse than the
+   best acceptable neighbor */
+static void
+check_parent(void)
+{
+  rpl_nbr_t *parent;
+  rpl_nbr_t *nbr;
+  const rpl_of_t *of;
+  uint32_t max_rank;
+  uint16_t best_cost;
+  uint16_t parent_cost;
+
+  of = curr_instance.of;
+  parent = curr_instance.dag.preferred_parent;
+  if(parent == NULL || !of->nbr_is_acceptable_parent(parent)) {
+    errors++;
+    return;
+  }
+
+  max_rank = (uint32_t)curr_instance.dag.lowest_rank +
+    curr_instance.max_rankinc;
+  best_cost = 0xffff;
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL;
+      nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    if(of->nbr_is_acceptable_parent(nbr)
+       && of->rank_via_nbr(nbr) <= max_rank) {
+      best_cost = MIN(best_cost, of->nbr_path_cost(nbr));
+    }
+  }
+
+  parent_cost = of->nbr_path_cost(parent);
+  if(parent_cost >= best_cost + RANK_THRESHOLD
+     || curr_instance.dag.rank != of->rank_via_nbr(parent)) {
+    errors++;
+  }
+}
+/*****************************************************************************/
+#if RPL_WITH_PARENT_RANKING
+/* The cached path costs must match the OF, the heap must hold
+   the neighbors the OF accepts as parents, and every candidate's path
+   cost must be at least that of its parent in the heap */
+static void
+check_heap(void)
+{
+  static rpl_nbr_t *heap[NBR_TABLE_MAX_NEIGHBORS];
+  rpl_nbr_t *nbr;
+  const rpl_of_t *of;
+  int count;
+  int i;
+
+  of = curr_instance.of;
+  memset(heap, 0, sizeof(heap));
+  count = 0;
+  for(nbr = nbr_table_head(rpl_neighbors); nbr != NULL;
+      nbr = nbr_table_next(rpl_neighbors, nbr)) {
+    if(nbr->path_cost != of->nbr_path_cost(nbr)
+       || (nbr->candidate_pos != 0) != of->nbr_is_acceptable_parent(nbr)) {
+      heap_errors++;
+    }
+    if(nbr->candidate_pos != 0) {
+      if(nbr->candidate_pos > NBR_TABLE_MAX_NEIGHBORS
+         || heap[nbr->candidate_pos - 1] != NULL) {
+        heap_errors++;
+        continue;
+      }
+      heap[nbr->candidate_pos - 1] = nbr;
+      count++;
+    }
+  }
+
+  for(i = 0; i < count; i++) {
+    if(heap[i] == NULL
+       || (i > 0 && heap[i]->path_cost < heap[(i - 1) / 2]->path_cost)) {
+      heap_errors++;
+    }
+  }
+}
+#endif /* RPL_WITH_PARENT_RANKING */
+/*****************************************************************************/
+UNIT_TEST_REGISTER(parent_select, "Parent selection");
+UNIT_TEST(parent_select)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(dios == NUM_DIOS);
+  UNIT_TEST_ASSERT(errors == 0);
+  UNIT_TEST_ASSERT(heap_errors == 0);
+  UNIT_TEST_ASSERT(rank_errors == 0);
+  UNIT_TEST_ASSERT(switches > 0);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_parent_select_process, ev, data)
+{
+  static struct etimer et;
+  static int i;
+  rpl_nbr_t *parent;
+  int id;
+  int j;
+
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  uip_ip6addr(&dag_id, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+
+  /* Fresh link statistics towards all neighbors */
+  for(id = 1; id <= NUM_NEIGHBORS; id++) {
+    ranks[id] = MIN_RANK + random_rand() % (MAX_RANK - MIN_RANK);
+    for(j = 0; j < 4; j++) {
+      packet_sent(id, MAC_TX_OK, 1 + random_rand() % 3);
+    }
+  }
+
+  /* Join, and hear from all neighbors */
+  for(id = 1; id <= NUM_NEIGHBORS; id++) {
+    make_dio(id, ranks[id]);
+    tcpip_input();
+  }
+  etimer_set(&et, CLOCK_SECOND / 10);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  for(i = 0; i < NUM_DIOS; i++) {
+    id = 1 + random_rand() % NUM_NEIGHBORS;
+    if(random_rand() % POISON_RATE == 0) {
+      make_dio(id, RPL_INFINITE_RANK);
+    } else {
+      next_rank(id);
+      make_dio(id, ranks[id]);
+    }
+    parent = curr_instance.dag.preferred_parent;
+    tcpip_input();
+    dios++;
+    switches += curr_instance.dag.preferred_parent != parent;
+    check_parent();
+
+    /* A transmission to a random neighbor, and the state update that
+       the link callback schedules */
+    id = 1 + random_rand() % NUM_NEIGHBORS;
+    packet_sent(id, random_rand() % 8 ? MAC_TX_OK : MAC_TX_NOACK,
+                1 + random_rand() % 3);
+    rpl_dag_update_state();
+    link_updates++;
+    check_parent();
+
+    silent_packet_sent();
+
+#if RPL_WITH_PARENT_RANKING
+    if(i % CHECK_INTERVAL == 0) {
+      check_heap();
+    }
+#endif /* RPL_WITH_PARENT_RANKING */
+
+    if(i % BATCH_SIZE == BATCH_SIZE - 1) {
+      etimer_set(&et, 1);
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    }
+  }
+
+  UNIT_TEST_RUN(parent_select);
+
+  printf("parent-select: %u neighbors, parent ranking %u, %lu DIOs, %lu "
+         "link updates, %lu parent switches, %lu errors, %lu heap errors, "
+         "%lu rank errors\n",
+         NUM_NEIGHBORS, RPL_WITH_PARENT_RANKING, dios, link_updates,
+         switches, errors, heap_errors, rank_errors);
+
+  if(!UNIT_TEST_PASSED(parent_select)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,31 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+
+NODE_DIR=$BASENAME
+MEDIUM_DIR=$CONTIKI/tools/native-medium
+BUILDLOG=$BASENAME.build.log
+RUNLOG=$BASENAME.run.log
+NODES=16
+
+test_init
+register_logfile $BUILDLOG
+register_logfile $RUNLOG
+
+echo "-- Starting test $BASENAME"
+assert "compile medium" "make -C $MEDIUM_DIR > $BUILDLOG 2>&1"
+assert "compile node" "make -C $NODE_DIR clean >> $BUILDLOG 2>&1 && make -C $NODE_DIR -j >> $BUILDLOG 2>&1"
+
+SIM="$MEDIUM_DIR/native-medium -n $NODES -t 135 -l 0.3 -- ./$NODE_DIR/mpl-node.native"
+assert "run" "timeout 300 $SIM > $RUNLOG 2>&1"
+# Every forwarder gets the whole image, and delivers each message once
+assert "complete" "[ $(grep -c 'mpl-node: rx 300/300, 0 delivered twice' $RUNLOG) -eq $((NODES - 1)) ]"
+
+echo "completion: $(grep 'complete after' $RUNLOG | awk '{ if($(NF - 1) > t) t = $(NF - 1) } END { print t }') ms"
+
+make -C $NODE_DIR clean >> $BUILDLOG 2>&1
+do_wrap_up
@@ -0,0 +1,167 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Nodes for the MPL dissemination test. All nodes hear each other
+ *      over a lossy medium. Node 1 is the RPL root and the MPL seed, and
+ *      once the other nodes have joined, it sends an image,
+ *      one message at a time, to the All MPL Forwarders address; all
+ *      other nodes forward it and recover the messages they lost from
+ *      their neighbors. Every node reports when it has the whole image,
+ *      and what it sent.
+ */
+
+#include "contiki.h"
+#include "sys/node-id.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/multicast/uip-mcast6.h"
+#include "net/ipv6/multicast/mpl.h"
+#include "net/netstack.h"
+#include "net/routing/routing.h"
+
+#include <stdio.h>
+#include <string.h>
+/*---------------------------------------------------------------------------*/
+#define SEED_ID          1
+/* More messages than MPL has sequence numbers, so that they wrap */
+#define NUM_MESSAGES     300
+#define MESSAGE_LEN      64
+#define SEND_INTERVAL    (CLOCK_SECOND / 4)
+#define START_DELAY      (10 * CLOCK_SECOND)
+#define REPORT_DELAY     (120 * CLOCK_SECOND)
+#define UDP_PORT         4321
+
+static struct simple_udp_connection udp_conn;
+static uip_ipaddr_t domain_addr;
+static uint8_t received[NUM_MESSAGES];
+static uint16_t num_received;
+static uint16_t delivered_twice;
+static clock_time_t start_time;
+static clock_time_t complete_time;
+static unsigned long data_out;
+static unsigned long control_out;
+/*---------------------------------------------------------------------------*/
+PROCESS(mpl_node_process, "MPL dissemination node");
+AUTOSTART_PROCESSES(&mpl_node_process);
+/*---------------------------------------------------------------------------*/
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  if(UIP_IP_BUF->proto == UIP_PROTO_HBHO) {
+    data_out++;
+  } else if(UIP_IP_BUF->proto == UIP_PROTO_ICMP6
+            && UIP_ICMP_BUF->type == ICMP6_MPL) {
+    control_out++;
+  }
+  return NETSTACK_IP_PROCESS;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor ip_processor = {
+  .process_input = NULL,
+  .process_output = ip_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+udp_rx_callback(struct simple_udp_connection *c,
+                const uip_ipaddr_t *sender_addr,
+                uint16_t sender_port,
+                const uip_ipaddr_t *receiver_addr,
+                uint16_t receiver_port,
+                const uint8_t *data,
+                uint16_t datalen)
+{
+  uint16_t index;
+
+  if(datalen != MESSAGE_LEN) {
+    return;
+  }
+  index = data[0] << 8 | data[1];
+  if(index >= NUM_MESSAGES) {
+    return;
+  }
+  if(received[index]) {
+    delivered_twice++;
+    return;
+  }
+  received[index] = 1;
+  num_received++;
+  if(num_received == NUM_MESSAGES) {
+    complete_time = clock_time() - start_time;
+    printf("mpl-node: complete after %lu ms\n",
+           (unsigned long)(complete_time * 1000 / CLOCK_SECOND));
+  }
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(mpl_node_process, ev, data)
+{
+  static struct etimer et;
+  static uint8_t buf[MESSAGE_LEN];
+  static uint16_t index;
+
+  PROCESS_BEGIN();
+
+  /* The seed is also the RPL root, so that all nodes get global
+     addresses */
+  if(node_id == SEED_ID) {
+    NETSTACK_ROUTING.root_start();
+  }
+
+  netstack_ip_packet_processor_add(&ip_processor);
+  simple_udp_register(&udp_conn, UDP_PORT, NULL, UDP_PORT, udp_rx_callback);
+  ALL_MPL_FORWARDERS(&domain_addr, UIP_MCAST6_SCOPE_REALM_LOCAL);
+
+  etimer_set(&et, START_DELAY);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+  start_time = clock_time();
+
+  if(node_id == SEED_ID) {
+    for(index = 0; index < NUM_MESSAGES; index++) {
+      memset(buf, index, sizeof(buf));
+      buf[0] = index >> 8;
+      buf[1] = index & 0xff;
+      simple_udp_sendto(&udp_conn, buf, sizeof(buf), &domain_addr);
+      etimer_set(&et, SEND_INTERVAL);
+      PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+    }
+  }
+
+  etimer_set(&et, start_time + REPORT_DELAY - clock_time());
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  printf("mpl-node: rx %u/%u, %u delivered twice, %lu data tx, "
+         "%lu control tx\n",
+         num_received, node_id == SEED_ID ? 0 : NUM_MESSAGES,
+         delivered_twice, data_out, control_out);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H
+#define PROJECT_CONF_H
+
+#include "net/ipv6/multicast/uip-mcast6-engines.h"
+
+/* The simulated radio does not acknowledge frames by itself */
+#define CSMA_CONF_SEND_SOFT_ACK 1
+
+#define UIP_MCAST6_CONF_ENGINE UIP_MCAST6_ENGINE_MPL
+
+/* Node 1 seeds an image that all other nodes forward. The buffer only
+   holds part of the image. */
+#define MPL_CONF_PROACTIVE_FORWARDING 1
+#define MPL_CONF_BUFFERED_MESSAGE_SET_SIZE 16
+#define MPL_CONF_DATA_MESSAGE_IMIN 64
+#define MPL_CONF_DATA_MESSAGE_IMAX 2
+#define MPL_CONF_CONTROL_MESSAGE_IMIN 64
+#define MPL_CONF_CONTROL_MESSAGE_IMAX 4
+
+#define LOG_CONF_LEVEL_MAC LOG_LEVEL_ERR
+#define LOG_CONF_LEVEL_IPV6 LOG_LEVEL_WARN
+#define LOG_CONF_LEVEL_RPL LOG_LEVEL_WARN
+
+#endif /* !PROJECT_CONF_H */
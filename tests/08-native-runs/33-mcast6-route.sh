@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# Routes in a single list, as without the hash table, and no duplicate cache
+ROUTE_HASH=1 DUP_CACHE=0 ./run-one.sh 33-mcast6-route
+./run-one.sh 33-mcast6-route
@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for the multicast routing table and duplicate cache.
+ *      Build with ROUTE_HASH=1 to test a single list instead of the hash
+ *      table, and with DUP_CACHE=0 to test without duplicate suppression.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "contiki.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/multicast/uip-mcast6-route.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define STREAM_LEN 1000
+#define UDP_PORT   3001
+
+static uip_ipaddr_t src_a;
+static uip_ipaddr_t src_b;
+static uip_ipaddr_t group_a;
+static uip_ipaddr_t group_b;
+/*****************************************************************************/
+PROCESS(test_mcast6_route_process, "Multicast routing table test process");
+AUTOSTART_PROCESSES(&test_mcast6_route_process);
+/*****************************************************************************/
+static void
+group(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xff1e, 0, 0, 0, 0, 0, 0x89, id);
+}
+/*****************************************************************************/
+/*
+ * Put a UDP datagram from src to a group in uip_buf, optionally behind a
+ * hop-by-hop options header. The sequence number stands in for the payload
+ * and the UDP checksum over it.
+ */
+static void
+datagram(const uip_ipaddr_t *src, const uip_ipaddr_t *dst, uint16_t seq,
+         uint8_t ttl, int hbho)
+{
+  struct uip_ext_hdr *ext;
+  struct uip_udp_hdr *udp;
+  uint16_t ext_len;
+
+  ext_len = hbho ? 8 : 0;
+  memset(uip_buf, 0, UIP_IPH_LEN + ext_len + UIP_UDPH_LEN + 2);
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->ttl = ttl;
+  uip_ipaddr_copy(&UIP_IP_BUF->srcipaddr, src);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, dst);
+  if(hbho) {
+    UIP_IP_BUF->proto = UIP_PROTO_HBHO;
+    ext = (struct uip_ext_hdr *)UIP_IP_PAYLOAD(0);
+    ext->next = UIP_PROTO_UDP;
+    ext->len = 0;
+    /* PadN over the rest of the header */
+    ((uint8_t *)ext)[2] = UIP_EXT_HDR_OPT_PADN;
+    ((uint8_t *)ext)[3] = 4;
+  } else {
+    UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  }
+  udp = (struct uip_udp_hdr *)UIP_IP_PAYLOAD(ext_len);
+  udp->srcport = UIP_HTONS(UDP_PORT);
+  udp->destport = UIP_HTONS(UDP_PORT);
+  udp->udplen = UIP_HTONS(UIP_UDPH_LEN + 2);
+  udp->udpchksum = UIP_HTONS(~seq);
+  ((uint8_t *)udp)[UIP_UDPH_LEN] = seq >> 8;
+  ((uint8_t *)udp)[UIP_UDPH_LEN + 1] = seq & 0xff;
+  uip_len = UIP_IPH_LEN + ext_len + UIP_UDPH_LEN + 2;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+}
+/*****************************************************************************/
+static int
+is_dup(const uip_ipaddr_t *src, const uip_ipaddr_t *dst, uint16_t seq,
+       uint8_t ttl, int hbho)
+{
+  datagram(src, dst, seq, ttl, hbho);
+  return uip_mcast6_route_is_dup();
+}
+/*****************************************************************************/
+/*
+ * Receive a stream where datagram i arrives 1 + i % 3 times, the copies
+ * two and three datagrams late. Returns how many copies were not
+ * suppressed.
+ */
+static unsigned
+receive_stream(uint16_t first_seq, unsigned *received)
+{
+  unsigned delivered;
+  int i;
+
+  delivered = 0;
+  *received = 0;
+  for(i = 0; i < STREAM_LEN + 3; i++) {
+    if(i < STREAM_LEN) {
+      delivered += !is_dup(&src_a, &group_a, first_seq + i, 64, 0);
+      (*received)++;
+    }
+    if(i >= 2 && i - 2 < STREAM_LEN && (i - 2) % 3 >= 1) {
+      delivered += !is_dup(&src_a, &group_a, first_seq + i - 2, 63, 0);
+      (*received)++;
+    }
+    if(i >= 3 && i - 3 < STREAM_LEN && (i - 3) % 3 == 2) {
+      delivered += !is_dup(&src_a, &group_a, first_seq + i - 3, 62, 0);
+      (*received)++;
+    }
+  }
+  return delivered;
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(routes, "Multicast route table");
+UNIT_TEST(routes)
+{
+  uip_mcast6_route_t *r;
+  uip_mcast6_route_t *r10;
+  uip_ipaddr_t addr;
+  int i;
+  int n;
+
+  UNIT_TEST_BEGIN();
+
+  uip_mcast6_route_init();
+  UNIT_TEST_ASSERT(uip_mcast6_route_count() == 0);
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&group_a) == NULL);
+
+  for(i = 0; i < UIP_MCAST6_ROUTE_CONF_ROUTES; i++) {
+    group(&addr, i);
+    UNIT_TEST_ASSERT(uip_mcast6_route_add(&addr) != NULL);
+  }
+  UNIT_TEST_ASSERT(uip_mcast6_route_count() == UIP_MCAST6_ROUTE_CONF_ROUTES);
+  group(&addr, UIP_MCAST6_ROUTE_CONF_ROUTES);
+  UNIT_TEST_ASSERT(uip_mcast6_route_add(&addr) == NULL);
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&addr) == NULL);
+
+  /* Every group is found, and adding it again returns the same route */
+  for(i = 0; i < UIP_MCAST6_ROUTE_CONF_ROUTES; i++) {
+    group(&addr, i);
+    r = uip_mcast6_route_lookup(&addr);
+    UNIT_TEST_ASSERT(r != NULL && uip_ipaddr_cmp(&r->group, &addr));
+    UNIT_TEST_ASSERT(uip_mcast6_route_add(&addr) == r);
+  }
+  /* The same group in another scope is another group */
+  group(&addr, 1);
+  addr.u8[1] = 0x15;
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&addr) == NULL);
+
+  /* Removed routes are no longer found, the others still are */
+  group(&addr, 10);
+  r10 = uip_mcast6_route_lookup(&addr);
+  uip_mcast6_route_rm(r10);
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&addr) == NULL);
+  UNIT_TEST_ASSERT(uip_mcast6_route_count() == UIP_MCAST6_ROUTE_CONF_ROUTES - 1);
+  for(i = 0; i < UIP_MCAST6_ROUTE_CONF_ROUTES; i++) {
+    group(&addr, i);
+    UNIT_TEST_ASSERT((uip_mcast6_route_lookup(&addr) == NULL) == (i == 10));
+  }
+  group(&addr, 10);
+  UNIT_TEST_ASSERT(uip_mcast6_route_add(&addr) != NULL);
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&addr) != NULL);
+
+  /* The list still holds all routes */
+  n = 0;
+  for(r = uip_mcast6_route_list_head(); r != NULL; r = r->next) {
+    n++;
+  }
+  UNIT_TEST_ASSERT(n == UIP_MCAST6_ROUTE_CONF_ROUTES);
+
+  while((r = uip_mcast6_route_list_head()) != NULL) {
+    uip_mcast6_route_rm(r);
+  }
+  UNIT_TEST_ASSERT(uip_mcast6_route_count() == 0);
+  group(&addr, 0);
+  UNIT_TEST_ASSERT(uip_mcast6_route_lookup(&addr) == NULL);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(duplicates, "Duplicate cache");
+UNIT_TEST(duplicates)
+{
+  unsigned delivered;
+  unsigned received;
+#if UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE
+  clock_time_t start;
+  int i;
+#endif /* UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE */
+
+  UNIT_TEST_BEGIN();
+
+  uip_mcast6_route_init();
+
+#if UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE
+  start = clock_time();
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 1, 64, 0));
+  /* Copies differ in hop limit and extension headers */
+  UNIT_TEST_ASSERT(is_dup(&src_a, &group_a, 1, 64, 0));
+  UNIT_TEST_ASSERT(is_dup(&src_a, &group_a, 1, 63, 0));
+  UNIT_TEST_ASSERT(is_dup(&src_a, &group_a, 1, 63, 1));
+  /* Other datagrams, sources and groups */
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 2, 64, 0));
+  UNIT_TEST_ASSERT(!is_dup(&src_b, &group_a, 1, 64, 0));
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_b, 1, 64, 0));
+  UNIT_TEST_ASSERT(is_dup(&src_a, &group_a, 2, 60, 0));
+  /* Checksums 0x1040 and 0x1121 would collide in a 16-bit hash of the
+     header */
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, (uint16_t)~0x1040, 64, 0));
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, (uint16_t)~0x1121, 64, 0));
+
+  /* The cache only remembers the latest datagrams */
+  for(i = 0; i < UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE; i++) {
+    UNIT_TEST_ASSERT(!is_dup(&src_b, &group_b, 100 + i, 64, 0));
+  }
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 1, 64, 0));
+
+  /* Each datagram of a stream is delivered once */
+  delivered = receive_stream(1000, &received);
+  UNIT_TEST_ASSERT(delivered == STREAM_LEN);
+
+  /* Datagrams are forgotten after a while */
+  UNIT_TEST_ASSERT(is_dup(&src_a, &group_a, 1000 + STREAM_LEN - 1, 64, 0));
+  while(clock_time() - start <= UIP_MCAST6_ROUTE_CONF_DUP_LIFETIME) {
+    usleep(10000);
+  }
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 1000 + STREAM_LEN - 1, 64, 0));
+#else /* UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE */
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 1, 64, 0));
+  UNIT_TEST_ASSERT(!is_dup(&src_a, &group_a, 1, 64, 0));
+  delivered = receive_stream(1000, &received);
+  UNIT_TEST_ASSERT(delivered == received);
+#endif /* UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE */
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_mcast6_route_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  uip_ip6addr(&src_a, 0xfd00, 0, 0, 0, 0x212, 0x4b00, 0, 1);
+  uip_ip6addr(&src_b, 0xfd00, 0, 0, 0, 0x212, 0x4b00, 0, 2);
+  group(&group_a, 0x1001);
+  group(&group_b, 0x1002);
+
+  UNIT_TEST_RUN(routes);
+  UNIT_TEST_RUN(duplicates);
+
+  if(!UNIT_TEST_PASSED(routes) ||
+     !UNIT_TEST_PASSED(duplicates)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,5 @@
+#!/bin/bash -e
+
+# All resources in a single chain, which also checks the prefix walk
+RESOURCE_HASH=1 ./run-one.sh 34-coap-dispatch
+./run-one.sh 34-coap-dispatch
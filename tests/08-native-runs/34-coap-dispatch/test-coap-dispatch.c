@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/*
+ * \file
+ *      Unit tests for resolving a CoAP Uri-Path to its resource. The
+ *      results are compared against a linear walk over the resource list,
+ *      as the engine used to do.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "contiki.h"
+#include "coap-engine.h"
+#include "unit-test/unit-test.h"
+/*****************************************************************************/
+#define MAX_RESOURCES 500
+#define URL_LEN       24
+
+static coap_resource_t many_resources[MAX_RESOURCES];
+static char many_paths[MAX_RESOURCES][URL_LEN];
+static int many_count;
+
+RESOURCE(res_a, "", NULL, NULL, NULL, NULL);
+RESOURCE(res_a2, "", NULL, NULL, NULL, NULL);
+PARENT_RESOURCE(res_p, "", NULL, NULL, NULL, NULL);
+RESOURCE(res_p_q, "", NULL, NULL, NULL, NULL);
+RESOURCE(res_x_y, "", NULL, NULL, NULL, NULL);
+PARENT_RESOURCE(res_x, "", NULL, NULL, NULL, NULL);
+PARENT_RESOURCE(res_x_y_z, "", NULL, NULL, NULL, NULL);
+RESOURCE(res_moved, "", NULL, NULL, NULL, NULL);
+/*****************************************************************************/
+PROCESS(test_coap_dispatch_process, "CoAP dispatch test process");
+AUTOSTART_PROCESSES(&test_coap_dispatch_process);
+/*****************************************************************************/
+/* The lookup the engine did before resources were hashed */
+static coap_resource_t *
+linear_lookup(const char *url, int url_len)
+{
+  coap_resource_t *resource;
+  int res_url_len;
+
+  for(resource = coap_get_first_resource(); resource != NULL;
+      resource = coap_get_next_resource(resource)) {
+    res_url_len = strlen(resource->url);
+    if((url_len == res_url_len
+        || (url_len > res_url_len
+            && (resource->flags & HAS_SUB_RESOURCES)
+            && url[res_url_len] == '/'))
+       && strncmp(resource->url, url, res_url_len) == 0) {
+      return resource;
+    }
+  }
+  return NULL;
+}
+/*****************************************************************************/
+static coap_resource_t *
+lookup(const char *url)
+{
+  return coap_get_resource_by_path(url, strlen(url));
+}
+/*****************************************************************************/
+/*
+ * Activate LwM2M-like resources up to count: object/instance paths, every
+ * fourth of them a parent of its resource IDs.
+ */
+static void
+activate_many_resources(int count)
+{
+  coap_resource_t *r;
+
+  for(; many_count < count; many_count++) {
+    r = &many_resources[many_count];
+    r->flags = many_count % 4 == 0 ? HAS_SUB_RESOURCES : NO_FLAGS;
+    snprintf(many_paths[many_count], URL_LEN, "%u/%u",
+             3300 + many_count / 8, many_count % 8);
+    coap_activate_resource(r, many_paths[many_count]);
+  }
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(paths, "Exact and parent paths");
+UNIT_TEST(paths)
+{
+  UNIT_TEST_BEGIN();
+
+  UNIT_TEST_ASSERT(lookup("a") == NULL);
+
+  coap_activate_resource(&res_a, "a");
+  coap_activate_resource(&res_a2, "a");
+  coap_activate_resource(&res_p, "p");
+  coap_activate_resource(&res_p_q, "p/q");
+  coap_activate_resource(&res_x_y, "x/y");
+  coap_activate_resource(&res_x, "x");
+  coap_activate_resource(&res_x_y_z, "x/y/z");
+  UNIT_TEST_ASSERT(res_p_q.url_len == 3);
+
+  /* Exact paths, the first activated wins */
+  UNIT_TEST_ASSERT(lookup("a") == &res_a);
+  UNIT_TEST_ASSERT(lookup("p") == &res_p);
+  UNIT_TEST_ASSERT(lookup("x") == &res_x);
+  UNIT_TEST_ASSERT(lookup("x/y") == &res_x_y);
+
+  /* Sub-resources only below parents, at a segment boundary */
+  UNIT_TEST_ASSERT(lookup("a/b") == NULL);
+  UNIT_TEST_ASSERT(lookup("p/r") == &res_p);
+  UNIT_TEST_ASSERT(lookup("p/") == &res_p);
+  UNIT_TEST_ASSERT(lookup("pq") == NULL);
+  UNIT_TEST_ASSERT(lookup("x/w/v") == &res_x);
+  UNIT_TEST_ASSERT(lookup("x/yz") == &res_x);
+
+  /* A parent activated first shadows the resources below it */
+  UNIT_TEST_ASSERT(lookup("p/q") == &res_p);
+  UNIT_TEST_ASSERT(lookup("x/y/z/1") == &res_x);
+
+  UNIT_TEST_ASSERT(lookup("") == NULL);
+  UNIT_TEST_ASSERT(coap_get_resource_by_path(NULL, 0) == NULL);
+  UNIT_TEST_ASSERT(coap_get_resource_by_path("p/q", 1) == &res_p);
+
+  /* Activating again moves a resource to its new path */
+  coap_activate_resource(&res_moved, "old");
+  UNIT_TEST_ASSERT(lookup("old") == &res_moved);
+  coap_activate_resource(&res_moved, "new/path");
+  UNIT_TEST_ASSERT(lookup("old") == NULL);
+  UNIT_TEST_ASSERT(lookup("new/path") == &res_moved);
+  UNIT_TEST_ASSERT(res_moved.url_len == 8);
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+UNIT_TEST_REGISTER(many, "Same resource as the linear walk");
+UNIT_TEST(many)
+{
+  static const char *const suffixes[] = { "", "/5700", "/5700/1", "/", "0" };
+  char url[URL_LEN + 8];
+  int i;
+  int s;
+
+  UNIT_TEST_BEGIN();
+
+  activate_many_resources(MAX_RESOURCES);
+
+  for(i = 0; i < MAX_RESOURCES + 16; i++) {
+    for(s = 0; s < sizeof(suffixes) / sizeof(suffixes[0]); s++) {
+      snprintf(url, sizeof(url), "%u/%u%s", 3300 + i / 8, i % 8, suffixes[s]);
+      UNIT_TEST_ASSERT(lookup(url) == linear_lookup(url, strlen(url)));
+      UNIT_TEST_ASSERT((lookup(url) == NULL) ==
+                       (i >= MAX_RESOURCES || (s > 0 && i % 4 != 0)
+                        || s == 4));
+    }
+  }
+
+  UNIT_TEST_END();
+}
+/*****************************************************************************/
+PROCESS_THREAD(test_coap_dispatch_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  printf("Run unit-test\n");
+  printf("---\n");
+
+  UNIT_TEST_RUN(paths);
+
+  UNIT_TEST_RUN(many);
+
+  if(!UNIT_TEST_PASSED(paths) ||
+     !UNIT_TEST_PASSED(many)) {
+    printf("=check-me= FAILED\n");
+    printf("---\n");
+  }
+
+  printf("=check-me= DONE\n");
+  printf("---\n");
+
+  PROCESS_END();
+}
@@ -0,0 +1,34 @@
+#!/bin/bash
+source ../utils.sh
+
+# Contiki directory
+CONTIKI=$1
+
+# Example code directory
+CODE_DIR=packet-injector
+CODE=packet-injector
+REPEAT=1000
+
+echo "Building native node"
+make -C $CODE_DIR TARGET=native
+
+# Replay the capture and make sure every packet gets through the stack
+echo "Replaying $CODE_DIR/replay-data/replay.pcap $REPEAT times"
+OUTPUT=$(TEST_REPEAT=$REPEAT timeout -k 1s 20s \
+  "$CODE_DIR/$CODE.native" "$CODE_DIR/replay-data/replay.pcap")
+INJECTOR_EXIT_CODE=$?
+echo "$OUTPUT"
+echo "exit code:" $INJECTOR_EXIT_CODE
+
+PACKETS=$((4 * REPEAT))
+if [ $INJECTOR_EXIT_CODE -eq 0 ] &&
+   echo "$OUTPUT" | grep -q "packets/s" &&
+   echo "$OUTPUT" | grep -q "IP input $PACKETS, IP output (dropped) $PACKETS, framer errors 0"; then
+  printf "%-32s TEST OK\n" "$CODE-replay"
+else
+  printf "%-32s TEST FAIL\n" "$CODE-replay"
+fi
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -44,7 +44,11 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <time.h>
 #include <unistd.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 /* Contiki-NG headers. */
 #include <dev/ble-hal.h>
@@ -52,10 +56,13 @@
 #include <net/ipv6/uiplib.h>
 #include <net/mac/ble/ble-l2cap.h>
 #include <net/netstack.h>
+#include <net/routing/routing.h>
 #include <net/packetbuf.h>
 #include <net/ipv6/sicslowpan.h>
 #include <net/app-layer/coap/coap.h>
 #include <net/app-layer/coap/coap-engine.h>
+#include <lib/heapmem.h>
+#include <lib/memb.h>
 
 /* Log configuration. */
 #include "sys/log.h"
@@ -68,6 +75,24 @@
 #define TEST_COAP_ENDPOINT "fdfd::100"
 #define TEST_COAP_PORT 8293
 
+/* Replay mode: corpus limits */
+#define REPLAY_MAX_PACKETS 1024
+#define REPLAY_CORPUS_SIZE (256 * 1024)
+
+/* pcap link types */
+#define DLT_RAW                  101
+#define DLT_IEEE802_15_4         195
+#define DLT_IPV6                 229
+#define DLT_IEEE802_15_4_NOFCS   230
+
+#if defined(__x86_64__) || defined(__i386__)
+#define REPLAY_STAMP() __rdtsc()
+#define REPLAY_STAMP_UNIT "cycles"
+#else
+#define REPLAY_STAMP() now_ns()
+#define REPLAY_STAMP_UNIT "ns"
+#endif
+
 extern int contiki_argc;
 extern char **contiki_argv;
 
@@ -172,6 +197,337 @@ inject_sicslowpan_packet(char *data, int len)
   return true;
 }
 /*---------------------------------------------------------------------------*/
+/*
+ * Replay mode. With TEST_REPEAT set, all packets are loaded first and
+ * then fed through the stack that many times in a tight loop. IP output
+ * is dropped before it reaches 6LoWPAN, and the time spent in the framer,
+ * in 6LoWPAN and in IPv6 and above (extension headers, ICMPv6, UDP, CoAP)
+ * is accumulated per packet.
+ */
+enum replay_link {
+  REPLAY_LINK_802154,
+  REPLAY_LINK_IPV6,
+};
+
+enum replay_layer {
+  REPLAY_LAYER_FRAMER,
+  REPLAY_LAYER_6LOWPAN,
+  REPLAY_LAYER_IPV6,
+  REPLAY_LAYER_COUNT
+};
+
+static const char *replay_layer_names[REPLAY_LAYER_COUNT] = {
+  "framer", "6lowpan", "ipv6+"
+};
+
+struct replay_packet {
+  uint8_t *data;
+  uint16_t len;
+  uint8_t link;
+};
+
+static struct replay_packet replay_packets[REPLAY_MAX_PACKETS];
+static int replay_packet_count;
+static uint8_t replay_corpus[REPLAY_CORPUS_SIZE];
+static size_t replay_corpus_used;
+
+static uint64_t replay_layer_time[REPLAY_LAYER_COUNT];
+static uint64_t replay_ip_start;
+static bool replay_ip_reached;
+static unsigned long replay_ip_inputs;
+static unsigned long replay_ip_outputs;
+static unsigned long replay_framer_errors;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static enum netstack_ip_action
+replay_ip_input(void)
+{
+  replay_ip_start = REPLAY_STAMP();
+  replay_ip_reached = true;
+  replay_ip_inputs++;
+  return NETSTACK_IP_PROCESS;
+}
+/*---------------------------------------------------------------------------*/
+static enum netstack_ip_action
+replay_ip_output(const linkaddr_t *localdest)
+{
+  replay_ip_outputs++;
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor replay_ip_processor = {
+  .process_input = replay_ip_input,
+  .process_output = replay_ip_output
+};
+/*---------------------------------------------------------------------------*/
+static void
+replay_res_get_handler(coap_message_t *request, coap_message_t *response,
+                       uint8_t *buffer, uint16_t preferred_size,
+                       int32_t *offset)
+{
+  coap_set_header_content_format(response, TEXT_PLAIN);
+  coap_set_payload(response, "Hello", 5);
+}
+RESOURCE(replay_res_hello, "title=\"Hello\"", replay_res_get_handler,
+         NULL, NULL, NULL);
+/*---------------------------------------------------------------------------*/
+static bool
+replay_add(const uint8_t *data, int len, enum replay_link link)
+{
+  struct replay_packet *p;
+
+  if(replay_packet_count == REPLAY_MAX_PACKETS ||
+     replay_corpus_used + len > sizeof(replay_corpus)) {
+    LOG_ERR("The replay corpus is full\n");
+    return false;
+  }
+  p = &replay_packets[replay_packet_count++];
+  p->data = &replay_corpus[replay_corpus_used];
+  p->len = len;
+  p->link = link;
+  memcpy(p->data, data, len);
+  replay_corpus_used += len;
+  return true;
+}
+/*---------------------------------------------------------------------------*/
+static uint32_t
+pcap_u32(const uint8_t *p, bool swap)
+{
+  return swap ? (uint32_t)p[0] << 24 | p[1] << 16 | p[2] << 8 | p[3]
+    : (uint32_t)p[3] << 24 | p[2] << 16 | p[1] << 8 | p[0];
+}
+/*---------------------------------------------------------------------------*/
+/* Returns 1 if a pcap file was loaded, 0 if the file is not pcap, and -1
+   on errors */
+static int
+replay_load_pcap(const char *filename)
+{
+  FILE *f;
+  uint8_t hdr[24];
+  uint8_t record[16];
+  static uint8_t buf[65536];
+  uint32_t magic;
+  uint32_t linktype;
+  uint32_t len;
+  uint32_t strip;
+  enum replay_link link;
+  bool swap;
+  int result;
+
+  f = fopen(filename, "rb");
+  if(f == NULL) {
+    LOG_ERR("open: %s\n", strerror(errno));
+    return -1;
+  }
+
+  if(fread(hdr, 1, sizeof(hdr), f) != sizeof(hdr)) {
+    fclose(f);
+    return 0;
+  }
+  /* Microsecond or nanosecond timestamps, in either byte order */
+  magic = pcap_u32(hdr, false);
+  if(magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+    swap = false;
+  } else if(magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+    swap = true;
+  } else {
+    fclose(f);
+    return 0;
+  }
+
+  linktype = pcap_u32(hdr + 20, swap) & 0xffff;
+  strip = 0;
+  switch(linktype) {
+  case DLT_IEEE802_15_4:
+    /* Drop the FCS */
+    strip = 2;
+    link = REPLAY_LINK_802154;
+    break;
+  case DLT_IEEE802_15_4_NOFCS:
+    link = REPLAY_LINK_802154;
+    break;
+  case DLT_RAW:
+  case DLT_IPV6:
+    link = REPLAY_LINK_IPV6;
+    break;
+  default:
+    LOG_ERR("%s: unsupported link type %lu\n", filename,
+            (unsigned long)linktype);
+    fclose(f);
+    return -1;
+  }
+
+  result = 1;
+  while(fread(record, 1, sizeof(record), f) == sizeof(record)) {
+    len = pcap_u32(record + 8, swap);
+    if(len > sizeof(buf) || fread(buf, 1, len, f) != len) {
+      LOG_ERR("%s: truncated record\n", filename);
+      result = -1;
+      break;
+    }
+    if(link == REPLAY_LINK_IPV6 && (len == 0 || (buf[0] >> 4) != 6)) {
+      /* Not IPv6 */
+      continue;
+    }
+    if(len <= strip || !replay_add(buf, len - strip, link)) {
+      result = -1;
+      break;
+    }
+  }
+
+  fclose(f);
+  return result;
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay_load(const char *filename, const char *protocol_name)
+{
+  static char file_buf[TEST_BUFFER_SIZE];
+  int len;
+  int result;
+
+  result = replay_load_pcap(filename);
+  if(result < 0) {
+    exit(EXIT_FAILURE);
+  } else if(result > 0) {
+    return;
+  }
+
+  /* A single packet, of the kind given by TEST_PROTOCOL */
+  len = read_packet(filename, file_buf, TEST_BUFFER_SIZE);
+  if(len < 0) {
+    exit(EXIT_FAILURE);
+  }
+  if(!strcasecmp(protocol_name, "sicslowpan")) {
+    result = replay_add((uint8_t *)file_buf, len, REPLAY_LINK_802154);
+  } else if(!strcasecmp(protocol_name, "uip") ||
+            !strcasecmp(protocol_name, "tcpip")) {
+    result = replay_add((uint8_t *)file_buf, len, REPLAY_LINK_IPV6);
+  } else {
+    LOG_ERR("Replay supports pcap files, or sicslowpan, uip and tcpip packets\n");
+    exit(EXIT_FAILURE);
+  }
+  if(!result) {
+    exit(EXIT_FAILURE);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay_packet(const struct replay_packet *p)
+{
+  uint64_t start;
+  uint64_t parsed;
+  uint64_t end;
+
+  if(p->link == REPLAY_LINK_IPV6) {
+    set_uip_buf((char *)p->data, p->len);
+    start = REPLAY_STAMP();
+    tcpip_input();
+    replay_layer_time[REPLAY_LAYER_IPV6] += REPLAY_STAMP() - start;
+    return;
+  }
+
+  packetbuf_copyfrom(p->data, p->len);
+  start = REPLAY_STAMP();
+  if(NETSTACK_FRAMER.parse() < 0) {
+    replay_layer_time[REPLAY_LAYER_FRAMER] += REPLAY_STAMP() - start;
+    replay_framer_errors++;
+    return;
+  }
+  parsed = REPLAY_STAMP();
+  replay_layer_time[REPLAY_LAYER_FRAMER] += parsed - start;
+
+  replay_ip_reached = false;
+  sicslowpan_driver.input();
+  end = REPLAY_STAMP();
+  if(replay_ip_reached) {
+    replay_layer_time[REPLAY_LAYER_6LOWPAN] += replay_ip_start - parsed;
+    replay_layer_time[REPLAY_LAYER_IPV6] += end - replay_ip_start;
+  } else {
+    replay_layer_time[REPLAY_LAYER_6LOWPAN] += end - parsed;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay_report(unsigned long repeat, uint64_t elapsed_ns)
+{
+  unsigned long packets;
+  heapmem_stats_t heap;
+#if MEMB_WITH_STATS
+  struct memb *m;
+#endif /* MEMB_WITH_STATS */
+  int i;
+
+  packets = repeat * replay_packet_count;
+  LOG_INFO("Replayed %d packets %lu times: %lu packets in %lu us, "
+           "%lu packets/s\n", replay_packet_count, repeat, packets,
+           (unsigned long)(elapsed_ns / 1000),
+           (unsigned long)(packets * 1000000000ULL / MAX(elapsed_ns, 1)));
+  for(i = 0; i < REPLAY_LAYER_COUNT; i++) {
+    LOG_INFO("Layer %-8s %8lu " REPLAY_STAMP_UNIT "/packet\n",
+             replay_layer_names[i],
+             (unsigned long)(replay_layer_time[i] / packets));
+  }
+  LOG_INFO("IP input %lu, IP output (dropped) %lu, framer errors %lu\n",
+           replay_ip_inputs, replay_ip_outputs, replay_framer_errors);
+
+  heapmem_stats(&heap);
+  LOG_INFO("heapmem: allocated %lu, footprint %lu\n",
+           (unsigned long)heap.allocated, (unsigned long)heap.footprint);
+#if MEMB_WITH_STATS
+  for(m = memb_stats_head(); m != NULL; m = m->next) {
+    if(m->max_count > 0) {
+      LOG_INFO("memb %-24s max %3u of %3u in use\n",
+               m->name, m->max_count, m->num);
+    }
+  }
+#endif /* MEMB_WITH_STATS */
+}
+/*---------------------------------------------------------------------------*/
+static void
+replay(unsigned long repeat, int file_count, char **files,
+       const char *protocol_name)
+{
+  uint64_t start;
+  unsigned long r;
+  int i;
+
+  for(i = 0; i < file_count; i++) {
+    replay_load(files[i], protocol_name);
+  }
+  if(replay_packet_count == 0) {
+    LOG_ERR("Nothing to replay\n");
+    exit(EXIT_FAILURE);
+  }
+
+  /* A DODAG root with a CoAP resource, so that RPL hop-by-hop options
+     and CoAP requests in the corpus are processed in full */
+  NETSTACK_ROUTING.root_start();
+  coap_engine_init();
+  coap_activate_resource(&replay_res_hello, "test/hello");
+  netstack_ip_packet_processor_add(&replay_ip_processor);
+  log_set_level("all", LOG_LEVEL_NONE);
+#if MEMB_WITH_STATS
+  memb_stats_reset();
+#endif /* MEMB_WITH_STATS */
+
+  start = now_ns();
+  for(r = 0; r < repeat; r++) {
+    for(i = 0; i < replay_packet_count; i++) {
+      replay_packet(&replay_packets[i]);
+    }
+  }
+  replay_report(repeat, now_ns() - start);
+}
+/*---------------------------------------------------------------------------*/
 protocol_function_t
 select_protocol(const char *protocol_name)
 {
@@ -226,6 +582,7 @@ PROCESS_THREAD(packet_injector_process, ev, data)
   static const char *filename;
   static const char *protocol_name;
   static protocol_function_t protocol_input;
+  const char *repeat;
 
   PROCESS_BEGIN();
 
@@ -234,6 +591,13 @@ PROCESS_THREAD(packet_injector_process, ev, data)
     protocol_name = TEST_PROTOCOL_DEFAULT;
   }
 
+  repeat = getenv("TEST_REPEAT");
+  if(repeat != NULL) {
+    replay(strtoul(repeat, NULL, 0), contiki_argc - 1, contiki_argv + 1,
+           protocol_name);
+    exit(EXIT_SUCCESS);
+  }
+
   protocol_input = select_protocol(protocol_name);
   if(protocol_input == NULL) {
     LOG_ERR("unsupported protocol: \"%s\"\n",
@@ -8,3 +8,6 @@
 #ifndef CONTIKI_TARGET_SIMPLELINK
 #define LOG_CONF_LEVEL_FRAMER                      LOG_LEVEL_DBG
 #endif
+
+/* Track memb usage for the replay mode */
+#define MEMB_CONF_WITH_STATS                       1
@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Writes replay.pcap, the corpus for the packet-injector replay benchmark.
+
+The frames are 802.15.4 data frames without FCS (DLT 230) from a neighbor
+to the native node (PAN 0xabcd, link-layer address 01:02:...:08), carrying
+6LoWPAN-compressed IPv6:
+
+  1. CoAP GET /test/hello, link-local, UDP compressed with NHC
+  2. CoAP GET /test/hello to the node's fd00:: address, behind a RPL
+     hop-by-hop option (instance 0, going up)
+  3. ICMPv6 echo request, link-local
+  4. UDP to a closed port, link-local (answered by an ICMPv6 error)
+"""
+
+import struct
+
+PAN_ID = 0xabcd
+NODE_LL = bytes([0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08])
+PEER_LL = bytes([0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02])
+DLT_IEEE802_15_4_NOFCS = 230
+
+
+def iid(lladdr):
+    return bytes([lladdr[0] ^ 0x02]) + lladdr[1:]
+
+
+NODE_LINK_LOCAL = bytes.fromhex("fe80000000000000") + iid(NODE_LL)
+NODE_GLOBAL = bytes.fromhex("fd00000000000000") + iid(NODE_LL)
+PEER_LINK_LOCAL = bytes.fromhex("fe80000000000000") + iid(PEER_LL)
+
+
+def checksum(src, dst, proto, payload):
+    data = src + dst + struct.pack("!IxxxB", len(payload), proto) + payload
+    if len(data) % 2:
+        data += b"\0"
+    s = sum(struct.unpack("!%dH" % (len(data) // 2), data))
+    while s >> 16:
+        s = (s & 0xffff) + (s >> 16)
+    return (~s & 0xffff) or 0xffff
+
+
+def mac_header(seqno):
+    # Data frame, PAN ID compression, long destination and source
+    fcf = 0x0001 | 0x0040 | (3 << 10) | (3 << 14)
+    return (struct.pack("<HBH", fcf, seqno, PAN_ID) +
+            NODE_LL[::-1] + PEER_LL[::-1])
+
+
+def udp(src, dst, sport, dport, payload):
+    hdr = struct.pack("!HHHH", sport, dport, 8 + len(payload), 0)
+    csum = checksum(src, dst, 17, hdr + payload)
+    return struct.pack("!HHHH", sport, dport, 8 + len(payload), csum)
+
+
+def coap_get(mid):
+    # CON GET, token 0x4242, Uri-Path "test" / "hello"
+    return (bytes([0x42, 0x01]) + struct.pack("!H", mid) + b"\x42\x42" +
+            bytes([0xb4]) + b"test" + bytes([0x05]) + b"hello")
+
+
+def frame_coap_link_local(seqno):
+    # IPHC: TF elided, NH compressed, hop limit 64, both addresses from
+    # the link layer
+    coap = coap_get(0x100 + seqno)
+    hdr = udp(PEER_LINK_LOCAL, NODE_LINK_LOCAL, 0xc001, 5683, coap)
+    sport, dport, _, csum = struct.unpack("!HHHH", hdr)
+    # NHC UDP, ports and checksum inline
+    return (mac_header(seqno) + bytes([0x7e, 0x33, 0xf0]) +
+            struct.pack("!HHH", sport, dport, csum) + coap)
+
+
+def frame_coap_hbh(seqno):
+    # IPHC: TF elided, next header inline, hop limit 64, source from the
+    # link layer, destination inline
+    coap = coap_get(0x100 + seqno)
+    hbh = bytes([17, 0, 0x63, 4, 0x00, 0]) + struct.pack("!H", 512)
+    return (mac_header(seqno) + bytes([0x7a, 0x30, 0]) + NODE_GLOBAL + hbh +
+            udp(PEER_LINK_LOCAL, NODE_GLOBAL, 0xc001, 5683, coap) + coap)
+
+
+def frame_echo(seqno):
+    payload = struct.pack("!HH", 0x1234, seqno) + bytes(range(32))
+    icmp = bytes([128, 0, 0, 0]) + payload
+    csum = checksum(PEER_LINK_LOCAL, NODE_LINK_LOCAL, 58, icmp)
+    icmp = bytes([128, 0]) + struct.pack("!H", csum) + payload
+    # IPHC: TF elided, next header inline (ICMPv6), hop limit 64,
+    # both addresses from the link layer
+    return mac_header(seqno) + bytes([0x7a, 0x33, 58]) + icmp
+
+
+def frame_closed_port(seqno):
+    payload = bytes(20)
+    hdr = udp(PEER_LINK_LOCAL, NODE_LINK_LOCAL, 0xc002, 7777, payload)
+    sport, dport, _, csum = struct.unpack("!HHHH", hdr)
+    return (mac_header(seqno) + bytes([0x7e, 0x33, 0xf0]) +
+            struct.pack("!HHH", sport, dport, csum) + payload)
+
+
+def main():
+    frames = [frame_coap_link_local(1), frame_coap_hbh(2), frame_echo(3),
+              frame_closed_port(4)]
+    with open("replay.pcap", "wb") as f:
+        f.write(struct.pack("<IHHiIII", 0xa1b2c3d4, 2, 4, 0, 0, 65535,
+                            DLT_IEEE802_15_4_NOFCS))
+        for i, frame in enumerate(frames):
+            f.write(struct.pack("<IIII", i, 0, len(frame), len(frame)))
+            f.write(frame)
+
+
+if __name__ == "__main__":
+    main()
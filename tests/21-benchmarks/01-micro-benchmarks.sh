@@ -0,0 +1,2 @@
+#!/bin/sh
+./run-benchmark.sh 01-micro-benchmarks
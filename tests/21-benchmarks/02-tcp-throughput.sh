@@ -0,0 +1,60 @@
+#!/bin/bash
+source ../utils.sh
+
+# Sends a stream over TCP from a native node to a sink on the tun host
+# and reports the throughput. The test fails if the sink does not get the
+# whole stream intact; the throughput itself is not checked.
+
+# Contiki directory
+CONTIKI=$1
+# Test basename
+BASENAME=$(basename $0 .sh)
+TEST_CODE_DIR=tcp-throughput
+
+# Bytes sent by the node, see tcp-throughput.c
+TOTAL_BYTES=262144
+
+echo "Starting TCP sink"
+python3 $TEST_CODE_DIR/sink.py > sink.log 2> sink.err &
+SPID=$!
+sleep 1
+
+# Starting Contiki-NG native node
+echo "Starting native node"
+make -C $TEST_CODE_DIR > make.log 2> make.err
+sudo $TEST_CODE_DIR/tcp-throughput.native > node.log 2> node.err &
+CPID=$!
+
+# Wait for the node to report the transfer
+for i in $(seq 1 60); do
+  grep -q "=check-me=" node.log && break
+  sleep 1
+done
+wait $SPID
+grep "bytes/s" node.log | tee $BASENAME.log
+cat sink.log | tee -a $BASENAME.log
+
+echo "Closing native node"
+kill_bg $CPID
+
+if grep -q "=check-me= DONE" node.log &&
+   grep -q "Received $TOTAL_BYTES bytes" sink.log ; then
+  printf "%-32s TEST OK\n" "$BASENAME" | tee $BASENAME.testlog;
+else
+  echo "==== make.log ====" ; cat make.log;
+  echo "==== make.err ====" ; cat make.err;
+  echo "==== node.log ====" ; cat node.log;
+  echo "==== node.err ====" ; cat node.err;
+  echo "==== sink.log ====" ; cat sink.log;
+  echo "==== sink.err ====" ; cat sink.err;
+
+  printf "%-32s TEST FAIL\n" "$BASENAME" | tee $BASENAME.testlog;
+  rm -f make.log make.err node.log node.err sink.log sink.err
+  exit 1
+fi
+
+rm -f make.log make.err node.log node.err sink.log sink.err
+
+# We do not want Make to stop -> Return 0
+# The Makefile will check if a log contains FAIL at the end
+exit 0
@@ -0,0 +1,2 @@
+#!/bin/sh
+./run-benchmark.sh 03-tsch-benchmarks
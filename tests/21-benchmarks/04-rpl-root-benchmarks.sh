@@ -0,0 +1,2 @@
+#!/bin/sh
+./run-benchmark.sh 04-rpl-root-benchmarks
@@ -0,0 +1,2 @@
+#!/bin/sh
+./run-benchmark.sh 05-rpl-node-benchmarks
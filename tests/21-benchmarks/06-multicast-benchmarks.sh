@@ -0,0 +1,2 @@
+#!/bin/sh
+./run-benchmark.sh 06-multicast-benchmarks
@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   A small timing framework for native micro-benchmarks.
+ */
+
+#include "bench.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+extern int contiki_argc;
+extern char **contiki_argv;
+
+volatile uint32_t bench_sink;
+/*---------------------------------------------------------------------------*/
+static uint64_t
+now_ns(void)
+{
+  struct timespec ts;
+
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+/*---------------------------------------------------------------------------*/
+static int
+selected(const struct bench *b, const struct bench_config *config)
+{
+  int i;
+
+  if(config->filter_count == 0) {
+    return 1;
+  }
+  for(i = 0; i < config->filter_count; i++) {
+    if(strncmp(b->name, config->filters[i], strlen(config->filters[i])) == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+int
+bench_run_all(const struct bench *benches, int count,
+              const struct bench_config *config, FILE *out)
+{
+  const struct bench *b;
+  uint32_t iterations;
+  uint64_t best;
+  uint64_t start;
+  uint64_t elapsed;
+  double ns_per_op;
+  int done;
+  int run;
+  int i;
+
+  fprintf(out, "{\n");
+  fprintf(out, "  \"version\": \"%s\",\n", CONTIKI_VERSION_STRING);
+  fprintf(out, "  \"compiler\": \"%s\",\n", __VERSION__);
+  fprintf(out, "  \"runs\": %d,\n", config->runs);
+  fprintf(out, "  \"benchmarks\": [");
+
+  done = 0;
+  for(i = 0; i < count; i++) {
+    b = &benches[i];
+    if(!selected(b, config)) {
+      continue;
+    }
+    iterations = config->iterations ? config->iterations : b->iterations;
+
+    if(b->setup != NULL) {
+      b->setup();
+    }
+    /* Warm up caches and branch predictors */
+    b->run(iterations / 10 + 1);
+
+    best = UINT64_MAX;
+    for(run = 0; run < config->runs; run++) {
+      start = now_ns();
+      b->run(iterations);
+      elapsed = now_ns() - start;
+      best = MIN(best, elapsed);
+    }
+    if(best == 0) {
+      best = 1;
+    }
+    ns_per_op = (double)best / iterations;
+
+    fprintf(out, "%s\n    {\"name\": \"%s\", \"iterations\": %lu, "
+            "\"ns_per_op\": %.2f, \"ops_per_sec\": %.0f",
+            done ? "," : "", b->name, (unsigned long)iterations,
+            ns_per_op, 1e9 / ns_per_op);
+    if(b->bytes > 0) {
+      fprintf(out, ", \"bytes_per_op\": %lu, \"mbytes_per_sec\": %.2f",
+              (unsigned long)b->bytes, b->bytes * 1e3 / ns_per_op);
+    }
+    fprintf(out, "}");
+    fflush(out);
+    done++;
+  }
+
+  fprintf(out, "\n  ]\n}\n");
+  return done;
+}
+/*---------------------------------------------------------------------------*/
+void
+bench_main(const struct bench *benches, int count)
+{
+  struct bench_config config;
+  FILE *out;
+  int i;
+
+  memset(&config, 0, sizeof(config));
+  out = stdout;
+  config.runs = BENCH_RUNS;
+  for(i = 1; i < contiki_argc; i++) {
+    if(!strcmp(contiki_argv[i], "-o") && i + 1 < contiki_argc) {
+      out = fopen(contiki_argv[++i], "w");
+      if(out == NULL) {
+        perror("fopen");
+        exit(EXIT_FAILURE);
+      }
+    } else if(!strcmp(contiki_argv[i], "-n") && i + 1 < contiki_argc) {
+      config.iterations = strtoul(contiki_argv[++i], NULL, 0);
+    } else if(!strcmp(contiki_argv[i], "-r") && i + 1 < contiki_argc) {
+      config.runs = atoi(contiki_argv[++i]);
+    } else {
+      break;
+    }
+  }
+  config.filters = &contiki_argv[i];
+  config.filter_count = contiki_argc - i;
+
+  if(bench_run_all(benches, count, &config, out) == 0) {
+    fprintf(stderr, "no benchmark selected\n");
+    exit(EXIT_FAILURE);
+  }
+  fclose(out);
+
+  exit(EXIT_SUCCESS);
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,91 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   A small timing framework for native micro-benchmarks. Each benchmark
+ *   runs its operation a configurable number of times; the best of a few
+ *   runs, timed with CLOCK_MONOTONIC, is reported as JSON.
+ */
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include "contiki.h"
+#include <stdio.h>
+
+/* Default number of timed runs per benchmark; the best one is kept */
+#ifdef BENCH_CONF_RUNS
+#define BENCH_RUNS BENCH_CONF_RUNS
+#else
+#define BENCH_RUNS 3
+#endif
+
+struct bench {
+  const char *name;
+  /* Default number of operations per run */
+  uint32_t iterations;
+  /* Bytes processed by one operation, or 0 */
+  uint32_t bytes;
+  /* Called once before the runs, may be NULL */
+  void (*setup)(void);
+  /* Performs the operation 'iterations' times */
+  void (*run)(uint32_t iterations);
+};
+
+/* Benchmarks store results here so that the compiler keeps the work */
+extern volatile uint32_t bench_sink;
+
+struct bench_config {
+  /* Overrides the iterations of every benchmark if non-zero */
+  uint32_t iterations;
+  int runs;
+  /* Only run benchmarks whose name starts with one of these, if any */
+  char **filters;
+  int filter_count;
+};
+
+/**
+ * \brief Runs the benchmarks and writes the results as a JSON object.
+ * \return The number of benchmarks run.
+ */
+int bench_run_all(const struct bench *benches, int count,
+                  const struct bench_config *config, FILE *out);
+
+/**
+ * \brief Runs the benchmarks selected on the command line and exits.
+ *
+ * Usage: <program>.native [-o file] [-n iterations] [-r runs]
+ *                         [name-prefix ...]
+ *
+ * The results are written to stdout, or to the file given with -o.
+ */
+void bench_main(const struct bench *benches, int count);
+
+#endif /* BENCH_H_ */
@@ -0,0 +1,879 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Native micro-benchmarks for os/lib and netstack kernels. See
+ *   bench_main() for the command line.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/aes-128.h"
+#include "lib/ccm-star.h"
+#include "lib/crc16.h"
+#include "lib/heapmem.h"
+#include "lib/list.h"
+#include "lib/memb.h"
+#include "lib/ringbuf.h"
+#include "net/linkaddr.h"
+#include "net/mac/mac.h"
+#include "net/mac/framer/framer-802154.h"
+#include "net/nbr-table.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-ds6-route.h"
+#include "net/app-layer/coap/coap.h"
+#include "net/app-layer/coap/coap-engine.h"
+
+#include "bench.h"
+
+#define NEIGHBORS      32
+#define ROUTES         64
+#define UDP_PORT_LOCAL 0xf0b2
+#define UDP_PORT_PEER  0xf0b1
+#define UDP_PAYLOAD    50
+#define MAC_PAYLOAD    102
+
+#define TCP_RST        0x04
+
+/* The reference AES-128 and CCM* drivers, which AES_128 and CCM_STAR may
+   be configured away from */
+extern const struct aes_128_driver aes_128_driver;
+extern const struct ccm_star_driver ccm_star_driver;
+
+PROCESS(micro_benchmarks_process, "Micro-benchmarks");
+AUTOSTART_PROCESSES(&micro_benchmarks_process);
+/*---------------------------------------------------------------------------*/
+static void
+fail(const char *what)
+{
+  fprintf(stderr, "setup failed: %s\n", what);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+static uint8_t data[1280] __attribute__((aligned(4)));
+
+static void
+data_setup(void)
+{
+  int i;
+
+  for(i = 0; i < sizeof(data); i++) {
+    data[i] = i * 7 + 3;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+crc16_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += crc16_data(data, 127, 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+crc16_long_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += crc16_data(data, sizeof(data), 0);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* One byte at a time, as crc16_data() does with CRC16_IMPL_BITWISE */
+static void
+crc16_add_run(uint32_t iterations)
+{
+  unsigned short acc;
+  int i;
+
+  while(iterations--) {
+    acc = 0;
+    for(i = 0; i < 127; i++) {
+      acc = crc16_add(data[i], acc);
+    }
+    bench_sink += acc;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+chksum_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += uip_chksum((uint16_t *)data, sizeof(data));
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_setup(void)
+{
+  data_setup();
+  AES_128.set_key(data);
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_run(uint32_t iterations)
+{
+  while(iterations--) {
+    AES_128.encrypt(data + 16);
+  }
+  bench_sink += data[16];
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_reference_setup(void)
+{
+  data_setup();
+  aes_128_driver.set_key(data);
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_reference_run(uint32_t iterations)
+{
+  while(iterations--) {
+    aes_128_driver.encrypt(data + 16);
+  }
+  bench_sink += data[16];
+}
+/*---------------------------------------------------------------------------*/
+/* Switches between two keys every four blocks, as when encrypting one
+   short CCM* frame per key */
+static void
+aes_key_switch(const struct aes_128_driver *driver, uint32_t iterations)
+{
+  uint32_t i;
+
+  for(i = 0; i < iterations; i++) {
+    if((i & 3) == 0) {
+      driver->set_key(data + ((i & 4) ? AES_128_KEY_LENGTH : 0));
+    }
+    driver->encrypt(data + 64);
+  }
+  bench_sink += data[64];
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_key_switch_run(uint32_t iterations)
+{
+  aes_key_switch(&AES_128, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+aes_reference_key_switch_run(uint32_t iterations)
+{
+  aes_key_switch(&aes_128_driver, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_setup(void)
+{
+  data_setup();
+  CCM_STAR.set_key(data);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_two_pass_setup(void)
+{
+  data_setup();
+  ccm_star_driver.set_key(data);
+}
+/*---------------------------------------------------------------------------*/
+/* A 21-byte header and a payload of 'm_len' bytes, with a 64-bit MIC and
+   a new frame counter in the nonce for every frame */
+static void
+ccm(const struct ccm_star_driver *driver, uint16_t m_len, uint32_t iterations)
+{
+  while(iterations--) {
+    data[16 + 8] = iterations;
+    driver->aead(data + 16, data + 64 + 21, m_len, data + 64, 21,
+                 data + 64 + 21 + m_len, 8, 1);
+  }
+  bench_sink += data[64 + 21 + m_len];
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_short_run(uint32_t iterations)
+{
+  ccm(&CCM_STAR, 40, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_run(uint32_t iterations)
+{
+  ccm(&CCM_STAR, 98, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_two_pass_short_run(uint32_t iterations)
+{
+  ccm(&ccm_star_driver, 40, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+ccm_two_pass_run(uint32_t iterations)
+{
+  ccm(&ccm_star_driver, 98, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+heapmem_setup(void)
+{
+  static void *held[32];
+  int i;
+
+  /* Leave some allocations of different sizes in place */
+  for(i = 0; i < 32; i++) {
+    held[i] = heapmem_alloc(16 + (i % 4) * 24);
+    if(held[i] == NULL) {
+      fail("heapmem");
+    }
+  }
+  for(i = 0; i < 32; i += 3) {
+    heapmem_free(held[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+heapmem_run(uint32_t iterations)
+{
+  void *p;
+
+  while(iterations--) {
+    p = heapmem_alloc(64);
+    bench_sink += (uintptr_t)p;
+    heapmem_free(p);
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct block {
+  struct block *next;
+  uint8_t payload[28];
+};
+MEMB(block_memb, struct block, 32);
+LIST(block_list);
+
+static void
+memb_setup(void)
+{
+  int i;
+
+  memb_init(&block_memb);
+  for(i = 0; i < 16; i++) {
+    memb_alloc(&block_memb);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+memb_run(uint32_t iterations)
+{
+  struct block *b;
+
+  while(iterations--) {
+    b = memb_alloc(&block_memb);
+    bench_sink += (uintptr_t)b;
+    memb_free(&block_memb, b);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static struct block list_items[17];
+
+static void
+list_setup(void)
+{
+  int i;
+
+  list_init(block_list);
+  for(i = 0; i < 16; i++) {
+    list_add(block_list, &list_items[i]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Appends to, and removes from the end of, a 16-item list */
+static void
+list_run(uint32_t iterations)
+{
+  while(iterations--) {
+    list_add(block_list, &list_items[16]);
+    list_remove(block_list, &list_items[16]);
+  }
+  bench_sink += list_length(block_list);
+}
+/*---------------------------------------------------------------------------*/
+static struct ringbuf ringbuf;
+static uint8_t ringbuf_data[128];
+
+static void
+ringbuf_setup(void)
+{
+  ringbuf_init(&ringbuf, ringbuf_data, sizeof(ringbuf_data));
+}
+/*---------------------------------------------------------------------------*/
+static void
+ringbuf_run(uint32_t iterations)
+{
+  int i;
+
+  while(iterations--) {
+    for(i = 0; i < 32; i++) {
+      ringbuf_put(&ringbuf, i);
+    }
+    for(i = 0; i < 32; i++) {
+      bench_sink += ringbuf_get(&ringbuf);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+struct bench_nbr {
+  uint8_t value;
+};
+NBR_TABLE(struct bench_nbr, bench_nbrs);
+
+static linkaddr_t nbr_addrs[NEIGHBORS];
+static uip_ipaddr_t route_dests[ROUTES];
+
+static void
+set_peer_addr(linkaddr_t *addr, int i)
+{
+  memset(addr, 0, sizeof(*addr));
+  addr->u8[0] = 0x02;
+  addr->u8[LINKADDR_SIZE - 2] = 0x80;
+  addr->u8[LINKADDR_SIZE - 1] = i + 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_setup(void)
+{
+  struct bench_nbr *n;
+  uip_ipaddr_t ipaddr;
+  int i;
+
+  nbr_table_register(bench_nbrs, NULL);
+  for(i = 0; i < NEIGHBORS; i++) {
+    set_peer_addr(&nbr_addrs[i], i);
+    n = nbr_table_add_lladdr(bench_nbrs, &nbr_addrs[i],
+                             NBR_TABLE_REASON_UNDEFINED, NULL);
+    if(n == NULL) {
+      fail("nbr-table");
+    }
+    n->value = i;
+
+    uip_create_linklocal_prefix(&ipaddr);
+    uip_ds6_set_addr_iid(&ipaddr, (uip_lladdr_t *)&nbr_addrs[i]);
+    if(uip_ds6_nbr_add(&ipaddr, (uip_lladdr_t *)&nbr_addrs[i], 1,
+                       NBR_REACHABLE, NBR_TABLE_REASON_UNDEFINED,
+                       NULL) == NULL) {
+      fail("ds6 neighbor");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+nbr_run(uint32_t iterations)
+{
+  struct bench_nbr *n;
+
+  while(iterations--) {
+    n = nbr_table_get_from_lladdr(bench_nbrs,
+                                  &nbr_addrs[iterations % NEIGHBORS]);
+    bench_sink += n->value;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_setup(void)
+{
+  uip_ipaddr_t nexthop;
+  int i;
+
+  if(uip_ds6_route_num_routes() > 0) {
+    return;
+  }
+  if(nbr_table_head(bench_nbrs) == NULL) {
+    nbr_setup();
+  }
+  for(i = 0; i < ROUTES; i++) {
+    uip_ip6addr(&route_dests[i], 0xfd00, 0, 0, 0, 0, 0, 0x100, i + 1);
+    uip_create_linklocal_prefix(&nexthop);
+    uip_ds6_set_addr_iid(&nexthop, (uip_lladdr_t *)&nbr_addrs[i % NEIGHBORS]);
+    if(uip_ds6_route_add(&route_dests[i], 128, &nexthop) == NULL) {
+      fail("route");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += (uintptr_t)uip_ds6_route_lookup(&route_dests[iterations % ROUTES]);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A unicast data frame to the peer, with an acknowledgement request.
+   Each operation sets up the packetbuf as the MAC layer gets it, then
+   creates or parses the header. */
+static uint8_t mac_frame[PACKETBUF_SIZE];
+static uint16_t mac_frame_len;
+
+static void
+framer_packetbuf(uint8_t seqno)
+{
+  packetbuf_clear();
+  packetbuf_copyfrom(data, UDP_PAYLOAD);
+  packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &nbr_addrs[0]);
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &linkaddr_node_addr);
+  packetbuf_set_attr(PACKETBUF_ATTR_FRAME_TYPE, FRAME802154_DATAFRAME);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_ACK, 1);
+  packetbuf_set_attr(PACKETBUF_ATTR_MAC_SEQNO, seqno);
+}
+/*---------------------------------------------------------------------------*/
+static void
+framer_setup(void)
+{
+  data_setup();
+  set_peer_addr(&nbr_addrs[0], 0);
+  framer_packetbuf(1);
+  if(framer_802154.create() < 0) {
+    fail("framer create");
+  }
+  mac_frame_len = packetbuf_totlen();
+  memcpy(mac_frame, packetbuf_hdrptr(), mac_frame_len);
+  packetbuf_clear();
+  packetbuf_copyfrom(mac_frame, mac_frame_len);
+  if(framer_802154.parse() < 0) {
+    fail("framer parse");
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+framer_create_run(uint32_t iterations)
+{
+  while(iterations--) {
+    framer_packetbuf(iterations | 1);
+    bench_sink += framer_802154.create();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+framer_parse_run(uint32_t iterations)
+{
+  while(iterations--) {
+    packetbuf_clear();
+    packetbuf_copyfrom(mac_frame, mac_frame_len);
+    bench_sink += framer_802154.parse();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A MAC driver that keeps the frame it is given, so that 6LoWPAN output
+   can be benchmarked and its result fed back as input */
+static uint8_t frame[PACKETBUF_SIZE];
+static uint16_t frame_len;
+
+static void
+capture_send(mac_callback_t sent, void *ptr)
+{
+  frame_len = packetbuf_totlen();
+  memcpy(frame, packetbuf_hdrptr(), frame_len);
+  mac_call_sent_callback(sent, ptr, MAC_TX_OK, 1);
+}
+static void capture_input(void) { }
+static int capture_on(void) { return 1; }
+static int capture_off(void) { return 1; }
+static int capture_max_payload(void) { return MAC_PAYLOAD; }
+static void capture_init(void) { }
+
+const struct mac_driver capture_mac_driver = {
+  "capture",
+  capture_init,
+  capture_send,
+  capture_input,
+  capture_on,
+  capture_off,
+  capture_max_payload,
+};
+/*---------------------------------------------------------------------------*/
+static uint8_t ip_packet[UIP_IPUDPH_LEN + UDP_PAYLOAD];
+static uint16_t ip_len;
+static struct simple_udp_connection udp_conn;
+static uint32_t udp_received;
+
+static void
+udp_rx(struct simple_udp_connection *c,
+       const uip_ipaddr_t *sender_addr, uint16_t sender_port,
+       const uip_ipaddr_t *receiver_addr, uint16_t receiver_port,
+       const uint8_t *data, uint16_t datalen)
+{
+  udp_received++;
+}
+/*---------------------------------------------------------------------------*/
+static void
+sicslowpan_setup(void)
+{
+  if(ip_len > 0) {
+    return;
+  }
+  set_peer_addr(&nbr_addrs[0], 0);
+  simple_udp_register(&udp_conn, UDP_PORT_LOCAL, NULL, UDP_PORT_PEER, udp_rx);
+
+  /* A link-local UDP packet from the peer to us, as it would come in */
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, UIP_UDPH_LEN + UDP_PAYLOAD);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->srcipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, (uip_lladdr_t *)&nbr_addrs[0]);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->destipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->destipaddr, &uip_lladdr);
+  UIP_UDP_BUF->srcport = UIP_HTONS(UDP_PORT_PEER);
+  UIP_UDP_BUF->destport = UIP_HTONS(UDP_PORT_LOCAL);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + UDP_PAYLOAD);
+  UIP_UDP_BUF->udpchksum = 0;
+  memcpy(uip_buf + UIP_IPUDPH_LEN, data, UDP_PAYLOAD);
+  uip_len = UIP_IPUDPH_LEN + UDP_PAYLOAD;
+  UIP_UDP_BUF->udpchksum = ~uip_udpchksum();
+  ip_len = uip_len;
+  memcpy(ip_packet, uip_buf, ip_len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+compress_run(uint32_t iterations)
+{
+  while(iterations--) {
+    memcpy(uip_buf, ip_packet, ip_len);
+    uip_len = ip_len;
+    NETSTACK_NETWORK.output(&linkaddr_node_addr);
+    bench_sink += frame_len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+uncompress_setup(void)
+{
+  sicslowpan_setup();
+  compress_run(1);
+  udp_received = 0;
+}
+/*---------------------------------------------------------------------------*/
+/* Decompresses and delivers the packet to a UDP socket */
+static void
+uncompress_run(uint32_t iterations)
+{
+  while(iterations--) {
+    packetbuf_copyfrom(frame, frame_len);
+    packetbuf_set_addr(PACKETBUF_ADDR_SENDER, &nbr_addrs[0]);
+    packetbuf_set_addr(PACKETBUF_ADDR_RECEIVER, &linkaddr_node_addr);
+    NETSTACK_NETWORK.input();
+  }
+  if(udp_received == 0) {
+    fail("6LoWPAN input");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* IPv6 packets from the peer as uip_input() gets them, after the full
+   UDP and TCP tables: to the last UDP connection, to a UDP port and to a
+   TCP port nobody has */
+static uint8_t demux_hit[UIP_IPUDPH_LEN];
+static uint8_t demux_miss[UIP_IPUDPH_LEN];
+static uint8_t demux_tcp_miss[UIP_IPTCPH_LEN];
+static int demux_ready;
+
+static void
+demux_packet(uint8_t *packet, uint8_t proto, uint16_t destport)
+{
+  uint16_t len;
+
+  len = proto == UIP_PROTO_UDP ? UIP_UDPH_LEN : UIP_TCPH_LEN;
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = proto;
+  UIP_IP_BUF->ttl = 64;
+  uipbuf_set_len_field(UIP_IP_BUF, len);
+  uip_create_linklocal_prefix(&UIP_IP_BUF->srcipaddr);
+  uip_ds6_set_addr_iid(&UIP_IP_BUF->srcipaddr, (uip_lladdr_t *)&nbr_addrs[1]);
+  uip_ipaddr_copy(&UIP_IP_BUF->destipaddr, &uip_ds6_get_link_local(-1)->ipaddr);
+  if(proto == UIP_PROTO_UDP) {
+    UIP_UDP_BUF->srcport = UIP_HTONS(UDP_PORT_PEER);
+    UIP_UDP_BUF->destport = destport;
+    UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN);
+    /* A zero checksum is accepted by uIP */
+    UIP_UDP_BUF->udpchksum = 0;
+  } else {
+    /* A reset, which gets no answer */
+    UIP_TCP_BUF->srcport = UIP_HTONS(UDP_PORT_PEER);
+    UIP_TCP_BUF->destport = destport;
+    UIP_TCP_BUF->tcpoffset = 5 << 4;
+    UIP_TCP_BUF->flags = TCP_RST;
+    UIP_TCP_BUF->wnd[0] = 1;
+    UIP_TCP_BUF->tcpchksum = 0;
+    UIP_TCP_BUF->tcpchksum = ~uip_tcpchksum();
+  }
+  memcpy(packet, uip_buf, UIP_IPH_LEN + len);
+  uipbuf_clear();
+}
+/*---------------------------------------------------------------------------*/
+static void
+demux_setup(void)
+{
+  struct uip_udp_conn *c;
+  struct uip_udp_conn *last;
+  uip_ipaddr_t peer;
+  int i;
+
+  if(demux_ready) {
+    return;
+  }
+  set_peer_addr(&nbr_addrs[1], 1);
+  uip_create_linklocal_prefix(&peer);
+  uip_ds6_set_addr_iid(&peer, (uip_lladdr_t *)&nbr_addrs[1]);
+
+  last = NULL;
+  while((c = uip_udp_new(&peer, UIP_HTONS(UDP_PORT_PEER))) != NULL) {
+    last = c;
+  }
+  if(last == NULL) {
+    fail("udp connections");
+  }
+  for(i = 0; i < UIP_LISTENPORTS; i++) {
+    uip_listen(UIP_HTONS(1000 + i));
+  }
+
+  demux_packet(demux_hit, UIP_PROTO_UDP, last->lport);
+  demux_packet(demux_miss, UIP_PROTO_UDP, UIP_HTONS(1));
+  demux_packet(demux_tcp_miss, UIP_PROTO_TCP, UIP_HTONS(2));
+  demux_ready = 1;
+
+  memcpy(uip_buf, demux_hit, sizeof(demux_hit));
+  uip_len = sizeof(demux_hit);
+  uip_udp_conn = NULL;
+  uip_input();
+  uipbuf_clear();
+  if(uip_udp_conn != last) {
+    fail("uip_input");
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+demux_run(const uint8_t *packet, uint16_t len, uint32_t iterations)
+{
+  while(iterations--) {
+    memcpy(uip_buf, packet, len);
+    uip_len = len;
+    uip_input();
+    bench_sink += uip_len;
+    uipbuf_clear();
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+demux_hit_run(uint32_t iterations)
+{
+  demux_run(demux_hit, sizeof(demux_hit), iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+demux_miss_run(uint32_t iterations)
+{
+  demux_run(demux_miss, sizeof(demux_miss), iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+demux_tcp_miss_run(uint32_t iterations)
+{
+  demux_run(demux_tcp_miss, sizeof(demux_tcp_miss), iterations);
+}
+/*---------------------------------------------------------------------------*/
+static coap_message_t coap_message;
+static uint8_t coap_buf[COAP_MAX_PACKET_SIZE];
+static uint8_t coap_serialized[COAP_MAX_PACKET_SIZE];
+static size_t coap_len;
+
+static void
+coap_setup(void)
+{
+  static const uint8_t token[] = { 0xde, 0xad, 0xbe, 0xef };
+
+  data_setup();
+  coap_init_message(&coap_message, COAP_TYPE_CON, COAP_POST, 0x1234);
+  coap_set_token(&coap_message, token, sizeof(token));
+  coap_set_header_uri_path(&coap_message, "sensors/temperature");
+  coap_set_header_content_format(&coap_message, TEXT_PLAIN);
+  coap_set_payload(&coap_message, data, 32);
+  coap_len = coap_serialize_message(&coap_message, coap_buf);
+  if(coap_len == 0) {
+    fail("coap");
+  }
+  memcpy(coap_serialized, coap_buf, coap_len);
+}
+/*---------------------------------------------------------------------------*/
+static void
+coap_serialize_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += coap_serialize_message(&coap_message, coap_buf);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Parsing joins Uri-Path segments in place, so the message is copied
+   back every time */
+static void
+coap_parse_run(uint32_t iterations)
+{
+  coap_message_t message;
+
+  while(iterations--) {
+    memcpy(coap_buf, coap_serialized, coap_len);
+    if(coap_parse_message(&message, coap_buf, coap_len) != NO_ERROR) {
+      fail("coap parse");
+    }
+    bench_sink += message.payload_len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+#define COAP_RESOURCES 500
+#define COAP_URL_LEN   24
+
+static coap_resource_t coap_resources[COAP_RESOURCES];
+static char coap_paths[COAP_RESOURCES][COAP_URL_LEN];
+static char coap_urls[COAP_RESOURCES][COAP_URL_LEN];
+static uint8_t coap_url_lens[COAP_RESOURCES];
+static uint16_t coap_activated;
+static uint16_t coap_requested;
+
+/* Activates LwM2M-like resources up to count: object/instance paths,
+   every fourth of them a parent of its resource IDs. One request in
+   eight is for a sub-resource of a parent. */
+static void
+coap_resources_fill(uint16_t count)
+{
+  coap_resource_t *r;
+  uint16_t i;
+
+  for(i = coap_activated; i < count; i++) {
+    r = &coap_resources[i];
+    r->flags = i % 4 == 0 ? HAS_SUB_RESOURCES : NO_FLAGS;
+    snprintf(coap_paths[i], COAP_URL_LEN, "%u/%u", 3300 + i / 8, i % 8);
+    coap_activate_resource(r, coap_paths[i]);
+    coap_url_lens[i] = snprintf(coap_urls[i], COAP_URL_LEN, "%s%s",
+                                coap_paths[i], i % 8 == 0 ? "/5700" : "");
+  }
+  coap_activated = MAX(coap_activated, count);
+  coap_requested = count;
+}
+/*---------------------------------------------------------------------------*/
+static void coap_resource_setup_10(void) { coap_resources_fill(10); }
+static void coap_resource_setup_100(void) { coap_resources_fill(100); }
+static void coap_resource_setup_500(void) { coap_resources_fill(500); }
+/*---------------------------------------------------------------------------*/
+/* Requests for all resources in turn */
+static void
+coap_resource_run(uint32_t iterations)
+{
+  static uint16_t next;
+
+  while(iterations--) {
+    next = (next + 1) % coap_requested;
+    if(coap_get_resource_by_path(coap_urls[next],
+                                 coap_url_lens[next]) == NULL) {
+      fail("coap resource");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Requests for a path no resource serves */
+static void
+coap_resource_miss_run(uint32_t iterations)
+{
+  static const char url[] = "9999/0/5700";
+
+  while(iterations--) {
+    bench_sink += coap_get_resource_by_path(url, sizeof(url) - 1) == NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "crc16_data/127", 100000, 127, data_setup, crc16_run },
+  { "crc16_data/1280", 20000, 1280, data_setup, crc16_long_run },
+  { "crc16_add/127", 100000, 127, data_setup, crc16_add_run },
+  { "uip_chksum/1280", 50000, 1280, data_setup, chksum_run },
+  { "aes_128_encrypt", 1000000, 16, aes_setup, aes_run },
+  { "aes_128_encrypt_key_switch/4", 1000000, 16, data_setup,
+    aes_key_switch_run },
+  { "aes_128_reference_encrypt", 1000000, 16, aes_reference_setup,
+    aes_reference_run },
+  { "aes_128_reference_encrypt_key_switch/4", 1000000, 16, data_setup,
+    aes_reference_key_switch_run },
+  { "ccm_star_aead/61", 100000, 61, ccm_setup, ccm_short_run },
+  { "ccm_star_aead/119", 100000, 119, ccm_setup, ccm_run },
+  { "ccm_star_two_pass_aead/61", 100000, 61, ccm_two_pass_setup,
+    ccm_two_pass_short_run },
+  { "ccm_star_two_pass_aead/119", 100000, 119, ccm_two_pass_setup,
+    ccm_two_pass_run },
+  { "heapmem_alloc_free/64", 1000000, 0, heapmem_setup, heapmem_run },
+  { "memb_alloc_free", 1000000, 0, memb_setup, memb_run },
+  { "list_add_remove/16", 1000000, 0, list_setup, list_run },
+  { "ringbuf_put_get/32", 200000, 32, ringbuf_setup, ringbuf_run },
+  { "nbr_table_get_from_lladdr/32", 1000000, 0, nbr_setup, nbr_run },
+  { "uip_ds6_route_lookup/64", 200000, 0, route_setup, route_run },
+  { "framer_802154_create", 1000000, 0, framer_setup, framer_create_run },
+  { "framer_802154_parse", 1000000, 0, framer_setup, framer_parse_run },
+  { "sicslowpan_compress/udp50", 200000, 0, sicslowpan_setup, compress_run },
+  { "sicslowpan_uncompress/udp50", 200000, 0, uncompress_setup, uncompress_run },
+  { "uip_input_udp_hit/64", 200000, 0, demux_setup, demux_hit_run },
+  { "uip_input_udp_miss/64", 200000, 0, demux_setup, demux_miss_run },
+  { "uip_input_tcp_miss/32", 200000, 0, demux_setup, demux_tcp_miss_run },
+  { "coap_serialize_message", 500000, 0, coap_setup, coap_serialize_run },
+  { "coap_parse_message", 500000, 0, coap_setup, coap_parse_run },
+  { "coap_get_resource_by_path/10", 200000, 0, coap_resource_setup_10,
+    coap_resource_run },
+  { "coap_get_resource_by_path/100", 200000, 0, coap_resource_setup_100,
+    coap_resource_run },
+  { "coap_get_resource_by_path/500", 200000, 0, coap_resource_setup_500,
+    coap_resource_run },
+  { "coap_get_resource_by_path_miss/500", 200000, 0,
+    coap_resource_setup_500, coap_resource_miss_run },
+};
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(micro_benchmarks_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  bench_main(benches, sizeof(benches) / sizeof(benches[0]));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
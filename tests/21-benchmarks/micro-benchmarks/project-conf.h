@@ -0,0 +1,50 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#define NETSTACK_CONF_NETWORK     sicslowpan_driver
+#define NETSTACK_CONF_MAC         capture_mac_driver
+#define UIP_CONF_MAX_ROUTES       64
+#define UIP_CONF_TCP              1
+#define UIP_CONF_UDP_CONNS        64
+#define UIP_CONF_MAX_LISTENPORTS  32
+#ifndef UIP_CONF_CONN_HASH
+#define UIP_CONF_CONN_HASH        1
+#endif /* UIP_CONF_CONN_HASH */
+#define HEAPMEM_CONF_ARENA_SIZE   65536
+#define AES_128_CONF              aes_128_ttable_driver
+#define CCM_STAR_CONF             ccm_star_single_pass_driver
+#ifndef CRC16_CONF_IMPL
+#define CRC16_CONF_IMPL           CRC16_IMPL_CLMUL
+#endif /* CRC16_CONF_IMPL */
+#define LOG_CONF_LEVEL_MAIN       LOG_LEVEL_WARN
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,337 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Native benchmarks for an MPL forwarder that buffers data messages
+ *   from many seeds, and for the multicast routing table and duplicate
+ *   cache that SMRF and ESMRF forward with. MPL messages go through the
+ *   node's real IPv6 input and the MPL engine. See bench_main() for the
+ *   command line.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/simple-udp.h"
+#include "net/ipv6/multicast/uip-mcast6.h"
+#include "net/ipv6/multicast/mpl.h"
+#include "net/ipv6/multicast/uip-mcast6-route.h"
+#include "net/packetbuf.h"
+
+#include "bench.h"
+
+#define NUM_SEEDS     MPL_SEED_SET_SIZE
+#define UDP_PORT      4321
+#define PAYLOAD_LEN   32
+/* A hop-by-hop options header with an MPL option, whose seed ID is the
+   source address, padded to eight bytes */
+#define HBHO_LEN      8
+#define DATA_LEN      (UIP_IPH_LEN + HBHO_LEN + UIP_UDPH_LEN + PAYLOAD_LEN)
+#define SEQ_OFFSET    (UIP_IPH_LEN + 5)
+
+/* A data message from each seed, to which only the sequence number is
+   added */
+static uint8_t messages[NUM_SEEDS][DATA_LEN];
+static uint8_t next_seq[NUM_SEEDS];
+static struct simple_udp_connection udp_conn;
+static uint32_t udp_received;
+
+PROCESS(multicast_benchmarks_process, "Multicast benchmarks");
+AUTOSTART_PROCESSES(&multicast_benchmarks_process);
+/*---------------------------------------------------------------------------*/
+static void
+fail(const char *what)
+{
+  fprintf(stderr, "setup failed: %s\n", what);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+static void
+udp_rx(struct simple_udp_connection *c,
+       const uip_ipaddr_t *sender_addr, uint16_t sender_port,
+       const uip_ipaddr_t *receiver_addr, uint16_t receiver_port,
+       const uint8_t *data, uint16_t datalen)
+{
+  udp_received++;
+}
+/*---------------------------------------------------------------------------*/
+/* Passes the data message with sequence number seq from a seed to the
+   node */
+static void
+data_input(int seed, uint8_t seq)
+{
+  memcpy(uip_buf, messages[seed], DATA_LEN);
+  uip_buf[SEQ_OFFSET] = seq;
+  uip_len = DATA_LEN;
+  packetbuf_clear();
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+/* Builds a UDP datagram to the All MPL Forwarders address from each seed,
+   as it would come in from a neighbor */
+static void
+mpl_setup(void)
+{
+  static uint8_t built;
+  uint8_t *hbho;
+  int seed;
+  int i;
+
+  if(built) {
+    return;
+  }
+  built = 1;
+
+  simple_udp_register(&udp_conn, UDP_PORT, NULL, UDP_PORT, udp_rx);
+  for(seed = 0; seed < NUM_SEEDS; seed++) {
+    uipbuf_clear();
+    UIP_IP_BUF->vtc = 0x60;
+    UIP_IP_BUF->proto = UIP_PROTO_HBHO;
+    UIP_IP_BUF->ttl = 64;
+    uipbuf_set_len_field(UIP_IP_BUF, DATA_LEN - UIP_IPH_LEN);
+    uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0x0200, 0, 0,
+                seed + 1);
+    ALL_MPL_FORWARDERS(&UIP_IP_BUF->destipaddr, UIP_MCAST6_SCOPE_REALM_LOCAL);
+
+    hbho = UIP_IP_PAYLOAD(0);
+    hbho[0] = UIP_PROTO_UDP;
+    hbho[1] = 0;
+    hbho[2] = HBHO_OPT_TYPE_MPL;
+    hbho[3] = MPL_OPT_LEN_S0;
+    hbho[4] = 0; /* S = 0: the seed ID is the source address */
+    hbho[5] = 0; /* Sequence number */
+    hbho[6] = UIP_EXT_HDR_OPT_PADN;
+    hbho[7] = 0;
+    uip_ext_len = HBHO_LEN;
+
+    UIP_UDP_BUF->srcport = UIP_HTONS(UDP_PORT);
+    UIP_UDP_BUF->destport = UIP_HTONS(UDP_PORT);
+    UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+    UIP_UDP_BUF->udpchksum = 0;
+    memset(UIP_IP_PAYLOAD(HBHO_LEN + UIP_UDPH_LEN), seed, PAYLOAD_LEN);
+    uip_len = DATA_LEN;
+    UIP_UDP_BUF->udpchksum = ~uip_udpchksum();
+    memcpy(messages[seed], uip_buf, DATA_LEN);
+  }
+  uip_ext_len = 0;
+
+  /* The benchmarks go through many wraps of the sequence numbers */
+  for(i = 1; i <= 300; i++) {
+    data_input(0, next_seq[0]++);
+    if(udp_received != i) {
+      fail("data message delivery");
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* New messages from the seeds in turn, which the node buffers and starts
+   forwarding, reclaiming the oldest buffered message once all buffers
+   are in use */
+static void
+input_run(int seeds, uint32_t iterations)
+{
+  static int seed;
+
+  while(iterations--) {
+    seed = (seed + 1) % seeds;
+    data_input(seed, next_seq[seed]++);
+  }
+  bench_sink += udp_received;
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_run_1(uint32_t iterations)
+{
+  input_run(1, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_run_8(uint32_t iterations)
+{
+  input_run(8, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+input_run_32(uint32_t iterations)
+{
+  input_run(32, iterations);
+}
+/*---------------------------------------------------------------------------*/
+static void
+dup_setup(void)
+{
+  uint32_t received;
+
+  mpl_setup();
+  input_run(NUM_SEEDS, NUM_SEEDS);
+  received = udp_received;
+  data_input(0, next_seq[0] - 1);
+  if(udp_received != received) {
+    fail("duplicate suppression");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The last message from each seed again, as the neighbors keep forwarding
+   it, which the node recognises as buffered and drops */
+static void
+dup_run(uint32_t iterations)
+{
+  static int seed;
+
+  while(iterations--) {
+    seed = (seed + 1) % NUM_SEEDS;
+    data_input(seed, next_seq[seed] - 1);
+  }
+  bench_sink += udp_received;
+}
+/*---------------------------------------------------------------------------*/
+static uip_ipaddr_t groups[UIP_MCAST6_ROUTE_CONF_ROUTES];
+static uip_ipaddr_t unrouted_group;
+static uint16_t route_groups;
+
+static void
+group_addr(uip_ipaddr_t *addr, uint16_t id)
+{
+  uip_ip6addr(addr, 0xff1e, 0, 0, 0, 0, 0, 0x89, id);
+}
+/*---------------------------------------------------------------------------*/
+static void
+route_fill(uint16_t count)
+{
+  uint16_t i;
+
+  uip_mcast6_route_init();
+  for(i = 0; i < count; i++) {
+    group_addr(&groups[i], i);
+    if(uip_mcast6_route_add(&groups[i]) == NULL) {
+      fail("multicast route table size");
+    }
+  }
+  group_addr(&unrouted_group, 0x1000);
+  route_groups = count;
+}
+/*---------------------------------------------------------------------------*/
+static void route_setup_1(void) { route_fill(1); }
+static void route_setup_8(void) { route_fill(8); }
+static void route_setup_64(void) { route_fill(64); }
+/*---------------------------------------------------------------------------*/
+/* Forwarding decisions for all groups in turn */
+static void
+route_lookup_run(uint32_t iterations)
+{
+  static uint16_t next;
+
+  while(iterations--) {
+    next = (next + 1) % route_groups;
+    bench_sink += uip_mcast6_route_lookup(&groups[next]) != NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Forwarding decisions for a group there is no route for */
+static void
+route_miss_run(uint32_t iterations)
+{
+  while(iterations--) {
+    bench_sink += uip_mcast6_route_lookup(&unrouted_group) == NULL;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static uint16_t cache_seq;
+
+/* Puts a UDP datagram to a group in uip_buf. The sequence number stands
+   in for the payload and the UDP checksum over it. */
+static void
+cache_datagram(uint16_t seq, uint8_t ttl)
+{
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = ttl;
+  uip_ip6addr(&UIP_IP_BUF->srcipaddr, 0xfd00, 0, 0, 0, 0x0200, 0, 0, 1);
+  group_addr(&UIP_IP_BUF->destipaddr, 0);
+  UIP_UDP_BUF->srcport = UIP_HTONS(UDP_PORT);
+  UIP_UDP_BUF->destport = UIP_HTONS(UDP_PORT);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + 2);
+  UIP_UDP_BUF->udpchksum = UIP_HTONS(~seq);
+  uip_buf[UIP_IPUDPH_LEN] = seq >> 8;
+  uip_buf[UIP_IPUDPH_LEN + 1] = seq & 0xff;
+  uip_len = UIP_IPUDPH_LEN + 2;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+}
+/*---------------------------------------------------------------------------*/
+static void
+cache_setup(void)
+{
+  uip_mcast6_route_init();
+}
+/*---------------------------------------------------------------------------*/
+/* A stream of datagrams, each of which comes in three times: once new,
+   and as copies one and two datagrams later with lower hop limits */
+static void
+cache_run(uint32_t iterations)
+{
+  static uint8_t copy;
+
+  while(iterations--) {
+    if(copy == 0) {
+      cache_seq++;
+    }
+    cache_datagram(cache_seq - copy, 64 - copy);
+    bench_sink += uip_mcast6_route_is_dup();
+    copy = (copy + 1) % 3;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "mpl_data_input/1", 100000, 0, mpl_setup, input_run_1 },
+  { "mpl_data_input/8", 100000, 0, mpl_setup, input_run_8 },
+  { "mpl_data_input/32", 100000, 0, mpl_setup, input_run_32 },
+  { "mpl_data_input_dup/32", 100000, 0, dup_setup, dup_run },
+  { "uip_mcast6_route_lookup/1", 200000, 0, route_setup_1, route_lookup_run },
+  { "uip_mcast6_route_lookup/8", 200000, 0, route_setup_8, route_lookup_run },
+  { "uip_mcast6_route_lookup/64", 200000, 0, route_setup_64, route_lookup_run },
+  { "uip_mcast6_route_lookup_miss/64", 200000, 0, route_setup_64, route_miss_run },
+  { "uip_mcast6_route_is_dup", 200000, 0, cache_setup, cache_run },
+};
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(multicast_benchmarks_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  bench_main(benches, sizeof(benches) / sizeof(benches[0]));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
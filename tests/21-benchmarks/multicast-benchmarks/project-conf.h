@@ -0,0 +1,62 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+#ifndef PROJECT_CONF_H_
+#define PROJECT_CONF_H_
+
+#include "net/ipv6/multicast/uip-mcast6-engines.h"
+
+/* 6LoWPAN over nullmac, so that no tun device is needed */
+#define NETSTACK_CONF_NETWORK                  sicslowpan_driver
+
+/* An MPL forwarder that buffers messages from many seeds */
+#define UIP_MCAST6_CONF_ENGINE                 UIP_MCAST6_ENGINE_MPL
+#define MPL_CONF_PROACTIVE_FORWARDING          1
+#define MPL_CONF_SEED_SET_SIZE                 32
+#define MPL_CONF_BUFFERED_MESSAGE_SET_SIZE     64
+#ifndef MPL_CONF_SEED_SET_HASH_SIZE
+#define MPL_CONF_SEED_SET_HASH_SIZE            32
+#endif
+#ifndef MPL_CONF_BUFFERED_MESSAGE_HASH_SIZE
+#define MPL_CONF_BUFFERED_MESSAGE_HASH_SIZE    64
+#endif
+
+/* SMRF and ESMRF forward by these */
+#define UIP_MCAST6_ROUTE_CONF_ROUTES           64
+#ifndef UIP_MCAST6_ROUTE_CONF_HASH_SIZE
+#define UIP_MCAST6_ROUTE_CONF_HASH_SIZE        16
+#endif
+#ifndef UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE
+#define UIP_MCAST6_ROUTE_CONF_DUP_CACHE_SIZE   8
+#endif
+
+#define LOG_CONF_LEVEL_RPL                     LOG_LEVEL_WARN
+#define LOG_CONF_LEVEL_IPV6                    LOG_LEVEL_WARN
+
+#endif /* PROJECT_CONF_H_ */
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Native benchmarks for the work of an RPL node in a dense
+ *   neighborhood: DIOs from many neighbors whose ranks keep changing,
+ *   and link statistics updates towards them. Packets go through the
+ *   node's real IPv6 and RPL input. See bench_main() for the command
+ *   line.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/random.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6.h"
+#include "net/link-stats.h"
+#include "net/netstack.h"
+#include "net/packetbuf.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+
+#include "bench.h"
+
+#define NUM_NEIGHBORS 60
+#define MIN_RANK      (2 * RPL_MIN_HOPRANKINC)
+#define MAX_RANK      (12 * RPL_MIN_HOPRANKINC)
+#define RANK_STEP     64
+/* One in POISON_RATE DIOs advertises an infinite rank */
+#define POISON_RATE   64
+/* The DIOs are built beforehand, and sent again and again */
+#define NUM_DIOS      256
+#define DIO_MAX_LEN   128
+
+/* DIO base object flags, as in rpl-icmp6.c */
+#define DIO_GROUNDED  0x80
+#define DIO_MOP_SHIFT 3
+
+struct dio {
+  uint8_t id;
+  uint8_t len;
+  uint8_t packet[DIO_MAX_LEN];
+};
+
+static struct dio dios[NUM_DIOS];
+static rpl_rank_t ranks[NUM_NEIGHBORS + 1];
+static uip_ipaddr_t dag_id;
+
+PROCESS(rpl_node_benchmarks_process, "RPL node benchmarks");
+AUTOSTART_PROCESSES(&rpl_node_benchmarks_process);
+/*---------------------------------------------------------------------------*/
+static void
+fail(const char *what)
+{
+  fprintf(stderr, "setup failed: %s\n", what);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_addr(int id, uip_ipaddr_t *addr)
+{
+  uip_ip6addr(addr, 0xfe80, 0, 0, 0, 0x0200, 0, 0, id);
+}
+/*---------------------------------------------------------------------------*/
+static void
+neighbor_lladdr(int id, uip_lladdr_t *lladdr)
+{
+  uip_ipaddr_t addr;
+
+  neighbor_addr(id, &addr);
+  uip_ds6_set_lladdr_from_iid(lladdr, &addr);
+}
+/*---------------------------------------------------------------------------*/
+/* Builds a DIO from neighbor id in uip_buf, ready for tcpip_input() */
+static void
+make_dio(int id, rpl_rank_t rank)
+{
+  uint8_t *buffer;
+  int pos;
+
+  uipbuf_clear();
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = RPL_DEFAULT_INSTANCE;
+  buffer[pos++] = RPL_LOLLIPOP_INIT;
+  buffer[pos++] = rank >> 8;
+  buffer[pos++] = rank & 0xff;
+  buffer[pos++] = DIO_GROUNDED |
+    (RPL_MOP_NO_DOWNWARD_ROUTES << DIO_MOP_SHIFT);
+  buffer[pos++] = 0; /* DTSN */
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  buffer[pos++] = RPL_OPTION_DAG_CONF;
+  buffer[pos++] = 14;
+  buffer[pos++] = 0;
+  buffer[pos++] = RPL_DIO_INTERVAL_DOUBLINGS;
+  buffer[pos++] = RPL_DIO_INTERVAL_MIN;
+  buffer[pos++] = RPL_DIO_REDUNDANCY;
+  buffer[pos++] = RPL_MAX_RANKINC >> 8;
+  buffer[pos++] = RPL_MAX_RANKINC & 0xff;
+  buffer[pos++] = RPL_MIN_HOPRANKINC >> 8;
+  buffer[pos++] = RPL_MIN_HOPRANKINC & 0xff;
+  buffer[pos++] = RPL_OF_OCP >> 8;
+  buffer[pos++] = RPL_OF_OCP & 0xff;
+  buffer[pos++] = 0;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME_UNIT >> 8;
+  buffer[pos++] = RPL_DEFAULT_LIFETIME_UNIT & 0xff;
+
+  buffer[pos++] = RPL_OPTION_PREFIX_INFO;
+  buffer[pos++] = 30;
+  buffer[pos++] = 64;
+  buffer[pos++] = UIP_ND6_RA_FLAG_AUTONOMOUS;
+  memset(buffer + pos, 0xff, 8); /* Infinite lifetimes */
+  pos += 8;
+  memset(buffer + pos, 0, 4);
+  pos += 4;
+  memcpy(buffer + pos, &dag_id, 16);
+  pos += 16;
+
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 255;
+  neighbor_addr(id, &UIP_IP_BUF->srcipaddr);
+  uip_create_linklocal_rplnodes_mcast(&UIP_IP_BUF->destipaddr);
+  UIP_ICMP_BUF->type = ICMP6_RPL;
+  UIP_ICMP_BUF->icode = RPL_CODE_DIO;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + pos;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+}
+/*---------------------------------------------------------------------------*/
+/* Passes a DIO from neighbor id in uip_buf to the node, and runs the
+   state update it schedules */
+static void
+dio_input(int id)
+{
+  uip_lladdr_t lladdr;
+
+  neighbor_lladdr(id, &lladdr);
+  packetbuf_clear();
+  packetbuf_set_addr(PACKETBUF_ADDR_SENDER, (linkaddr_t *)&lladdr);
+  tcpip_input();
+  if(!ctimer_expired(&curr_instance.dag.state_update)) {
+    ctimer_stop(&curr_instance.dag.state_update);
+    rpl_dag_update_state();
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A transmission to neighbor id, as reported by the MAC layer */
+static void
+packet_sent(int id, int status, int numtx)
+{
+  uip_lladdr_t lladdr;
+
+  neighbor_lladdr(id, &lladdr);
+  link_stats_packet_sent((linkaddr_t *)&lladdr, status, numtx);
+  NETSTACK_ROUTING.link_callback((linkaddr_t *)&lladdr, status, numtx);
+}
+/*---------------------------------------------------------------------------*/
+static void
+next_rank(int id)
+{
+  int rank;
+
+  rank = ranks[id] + (int)(random_rand() % (2 * RANK_STEP + 1)) - RANK_STEP;
+  ranks[id] = MAX(MIN_RANK, MIN(rank, MAX_RANK));
+}
+/*---------------------------------------------------------------------------*/
+/* Joins the DODAG through DIOs from all neighbors, with fresh link
+   statistics towards them, and builds the DIOs to send later, from
+   random neighbors and with ranks that drift */
+static void
+node_setup(void)
+{
+  static uint8_t joined;
+  int id;
+  int i;
+
+  if(joined) {
+    return;
+  }
+  joined = 1;
+
+  random_init(1);
+  uip_ip6addr(&dag_id, 0xfd00, 0, 0, 0, 0, 0, 0, 1);
+  for(id = 1; id <= NUM_NEIGHBORS; id++) {
+    ranks[id] = MIN_RANK + random_rand() % (MAX_RANK - MIN_RANK);
+    for(i = 0; i < 4; i++) {
+      packet_sent(id, MAC_TX_OK, 1 + random_rand() % 3);
+    }
+  }
+  for(id = 1; id <= NUM_NEIGHBORS; id++) {
+    make_dio(id, ranks[id]);
+    dio_input(id);
+  }
+  if(curr_instance.dag.preferred_parent == NULL) {
+    fail("join");
+  }
+
+  for(i = 0; i < NUM_DIOS; i++) {
+    id = 1 + random_rand() % NUM_NEIGHBORS;
+    if(random_rand() % POISON_RATE == 0) {
+      make_dio(id, RPL_INFINITE_RANK);
+    } else {
+      next_rank(id);
+      make_dio(id, ranks[id]);
+    }
+    if(uip_len > DIO_MAX_LEN) {
+      fail("DIO length");
+    }
+    dios[i].id = id;
+    dios[i].len = uip_len;
+    memcpy(dios[i].packet, uip_buf, uip_len);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+dio_run(uint32_t iterations)
+{
+  static uint16_t next;
+  const struct dio *dio;
+
+  while(iterations--) {
+    dio = &dios[next];
+    next = (next + 1) % NUM_DIOS;
+    memcpy(uip_buf, dio->packet, dio->len);
+    uip_len = dio->len;
+    dio_input(dio->id);
+  }
+  bench_sink += curr_instance.dag.rank;
+}
+/*---------------------------------------------------------------------------*/
+/* A transmission to a random neighbor, one in eight unacknowledged, and
+   the state update that the link callback schedules */
+static void
+link_run(uint32_t iterations)
+{
+  while(iterations--) {
+    packet_sent(1 + random_rand() % NUM_NEIGHBORS,
+                random_rand() % 8 ? MAC_TX_OK : MAC_TX_NOACK,
+                1 + random_rand() % 3);
+    rpl_dag_update_state();
+  }
+  bench_sink += curr_instance.dag.rank;
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "rpl_dio_input/60", 5000, 0, node_setup, dio_run },
+  { "rpl_link_update/60", 5000, 0, node_setup, link_run },
+};
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rpl_node_benchmarks_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  bench_main(benches, sizeof(benches) / sizeof(benches[0]));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,352 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Native benchmarks for the work of an RPL root in a large network.
+ *   The network is a random tree of simulated nodes, whose packets go
+ *   through the root's real IPv6 and RPL input; what the root sends is
+ *   dropped before 6LoWPAN. See bench_main() for the command line.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lib/random.h"
+#include "net/ipv6/uip.h"
+#include "net/ipv6/uipbuf.h"
+#include "net/ipv6/uip-icmp6.h"
+#include "net/ipv6/uip-ds6-nbr.h"
+#include "net/ipv6/uip-sr.h"
+#include "net/netstack.h"
+#include "net/routing/routing.h"
+#include "net/routing/rpl-lite/rpl.h"
+
+#include "bench.h"
+
+#define NUM_NODES   1000
+#define MAX_HOPS    7
+#define LIFETIME    3600
+#define PAYLOAD_LEN 32
+/* In the churn benchmark, a node changes parents every REPARENT_EVERY
+   packets */
+#define REPARENT_EVERY 50
+
+struct node {
+  uint16_t parent;      /* Node index, 0 for the root */
+  uint8_t hops;         /* At most the node's depth */
+  uint8_t seqno;
+};
+
+/* nodes[0] is the root */
+static struct node nodes[NUM_NODES + 1];
+
+PROCESS(rpl_root_benchmarks_process, "RPL root benchmarks");
+AUTOSTART_PROCESSES(&rpl_root_benchmarks_process);
+/*---------------------------------------------------------------------------*/
+static void
+fail(const char *what)
+{
+  fprintf(stderr, "setup failed: %s\n", what);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+static void
+node_addr(int id, uip_ipaddr_t *addr)
+{
+  const uip_ipaddr_t *dag_id = &curr_instance.dag.dag_id;
+
+  if(id == 0) {
+    uip_ipaddr_copy(addr, dag_id);
+    return;
+  }
+  memcpy(addr, dag_id, 8);
+  memset(addr->u8 + 8, 0, 8);
+  addr->u8[8] = 0x02;
+  addr->u8[14] = id >> 8;
+  addr->u8[15] = id & 0xff;
+}
+/*---------------------------------------------------------------------------*/
+static enum netstack_ip_action
+ip_output(const linkaddr_t *localdest)
+{
+  return NETSTACK_IP_DROP;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor ip_processor = {
+  .process_input = NULL,
+  .process_output = ip_output
+};
+/*---------------------------------------------------------------------------*/
+/* Picks a parent for node id among the nodes before it, so that the
+   graph has no loops and the node is at most 'max_hops' hops away */
+static int
+pick_parent(int id, int max_hops)
+{
+  int parent;
+
+  do {
+    parent = random_rand() % id;
+  } while(nodes[parent].hops >= max_hops);
+  return parent;
+}
+/*---------------------------------------------------------------------------*/
+static void
+update_link(int id)
+{
+  uip_ipaddr_t child;
+  uip_ipaddr_t parent;
+
+  node_addr(id, &child);
+  node_addr(nodes[id].parent, &parent);
+  if(!uip_sr_update_node(NULL, &child, &parent, LIFETIME)) {
+    fail("source routing link");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Starts the root, and builds a random tree below it, in which both
+   fan-out and depth vary. The root's children are its neighbors, as if
+   they had sent DIOs. */
+static void
+root_setup(void)
+{
+  static uint8_t started;
+  uip_ipaddr_t addr;
+  uip_lladdr_t lladdr;
+  int i;
+
+  if(started) {
+    return;
+  }
+  started = 1;
+
+  if(NETSTACK_ROUTING.root_start() < 0) {
+    fail("root start");
+  }
+  netstack_ip_packet_processor_add(&ip_processor);
+
+  random_init(1);
+  for(i = 1; i <= NUM_NODES; i++) {
+    nodes[i].parent = pick_parent(i, MAX_HOPS - 1);
+    nodes[i].hops = nodes[nodes[i].parent].hops + 1;
+    nodes[i].seqno = RPL_LOLLIPOP_INIT;
+    if(nodes[i].parent == 0) {
+      node_addr(i, &addr);
+      uip_create_linklocal_prefix(&addr);
+      uip_ds6_set_lladdr_from_iid(&lladdr, &addr);
+      if(uip_ds6_nbr_add(&addr, &lladdr, 1, NBR_REACHABLE,
+                         NBR_TABLE_REASON_RPL_DIO, NULL) == NULL) {
+        fail("ds6 neighbor");
+      }
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Runs a pending root ctimer right away, instead of from the event loop */
+static void
+run_ctimer(struct ctimer *c)
+{
+  if(!ctimer_expired(c)) {
+    ctimer_stop(c);
+    c->f(c->ptr);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A DAO from node 'i', with a new sequence number, as
+   rpl_icmp6_dao_output() builds it */
+static void
+send_dao(int i)
+{
+  uint8_t *buffer;
+  uip_ipaddr_t parent;
+  int pos;
+
+  RPL_LOLLIPOP_INCREMENT(nodes[i].seqno);
+
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_ICMP6;
+  UIP_IP_BUF->ttl = 64;
+  node_addr(i, &UIP_IP_BUF->srcipaddr);
+  node_addr(0, &UIP_IP_BUF->destipaddr);
+  UIP_ICMP_BUF->type = ICMP6_RPL;
+  UIP_ICMP_BUF->icode = RPL_CODE_DAO;
+
+  buffer = UIP_ICMP_PAYLOAD;
+  pos = 0;
+  buffer[pos++] = curr_instance.instance_id;
+  buffer[pos++] = RPL_DAO_K_FLAG;
+  buffer[pos++] = 0;
+  buffer[pos++] = nodes[i].seqno;
+
+  buffer[pos++] = RPL_OPTION_TARGET;
+  buffer[pos++] = 2 + 16;
+  buffer[pos++] = 0;
+  buffer[pos++] = 128;
+  memcpy(buffer + pos, &UIP_IP_BUF->srcipaddr, 16);
+  pos += 16;
+
+  node_addr(nodes[i].parent, &parent);
+  buffer[pos++] = RPL_OPTION_TRANSIT;
+  buffer[pos++] = 20;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = 0;
+  buffer[pos++] = curr_instance.default_lifetime;
+  memcpy(buffer + pos, &parent, 16);
+  pos += 16;
+
+  uip_len = UIP_IPH_LEN + UIP_ICMPH_LEN + pos;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+  UIP_ICMP_BUF->icmpchksum = 0;
+  UIP_ICMP_BUF->icmpchksum = ~uip_icmp6chksum();
+
+  tcpip_input();
+}
+/*---------------------------------------------------------------------------*/
+/* The nodes send their DAOs in turn. Each DAO is installed and acked as
+   soon as the root would do it: the DAO-ACK timer is run after every DAO,
+   and the batch timer once a batch is full, and at the end. */
+static void
+dao_run(uint32_t iterations)
+{
+  static uint16_t next;
+  uint32_t i;
+
+  for(i = 0; i < iterations; i++) {
+    send_dao(next + 1);
+    next = (next + 1) % NUM_NODES;
+    run_ctimer(&curr_instance.dag.dao_ack_timer);
+#if RPL_DAO_BATCH_SIZE > 0
+    if((i + 1) % RPL_DAO_BATCH_SIZE == 0) {
+      run_ctimer(&curr_instance.dag.dao_batch_timer);
+    }
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+  }
+#if RPL_DAO_BATCH_SIZE > 0
+  run_ctimer(&curr_instance.dag.dao_batch_timer);
+#endif /* RPL_DAO_BATCH_SIZE > 0 */
+  if(uip_sr_num_nodes() != NUM_NODES + 1) {
+    fail("DAO input");
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* The source routing graph, as the root would have it from the DAOs */
+static void
+srh_setup(void)
+{
+  int i;
+
+  root_setup();
+  for(i = 1; i <= NUM_NODES; i++) {
+    update_link(i);
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* A UDP packet from the root to node id */
+static void
+make_packet(int id)
+{
+  uipbuf_clear();
+  UIP_IP_BUF->vtc = 0x60;
+  UIP_IP_BUF->tcflow = 0;
+  UIP_IP_BUF->flow = 0;
+  UIP_IP_BUF->proto = UIP_PROTO_UDP;
+  UIP_IP_BUF->ttl = 64;
+  node_addr(0, &UIP_IP_BUF->srcipaddr);
+  node_addr(id, &UIP_IP_BUF->destipaddr);
+
+  UIP_UDP_BUF->srcport = UIP_HTONS(5683);
+  UIP_UDP_BUF->destport = UIP_HTONS(5683);
+  UIP_UDP_BUF->udplen = UIP_HTONS(UIP_UDPH_LEN + PAYLOAD_LEN);
+  UIP_UDP_BUF->udpchksum = 0;
+  memset(UIP_UDP_PAYLOAD, id & 0xff, PAYLOAD_LEN);
+
+  uip_len = UIP_IPH_LEN + UIP_UDPH_LEN + PAYLOAD_LEN;
+  uipbuf_set_len_field(UIP_IP_BUF, uip_len - UIP_IPH_LEN);
+}
+/*---------------------------------------------------------------------------*/
+/* The root polls all nodes in turn: each packet gets its source routing
+   header inserted. With 'churn', a random node moves to a parent that is
+   no deeper every REPARENT_EVERY packets. */
+static void
+srh(uint32_t iterations, int churn)
+{
+  static uint16_t next;
+  uint32_t i;
+  int id;
+
+  for(i = 0; i < iterations; i++) {
+    if(churn && i % REPARENT_EVERY == 0) {
+      id = 1 + random_rand() % NUM_NODES;
+      nodes[id].parent = pick_parent(id, nodes[nodes[id].parent].hops + 1);
+      nodes[id].hops = nodes[nodes[id].parent].hops + 1;
+      update_link(id);
+    }
+    make_packet(next + 1);
+    next = (next + 1) % NUM_NODES;
+    if(!NETSTACK_ROUTING.ext_header_update()) {
+      fail("extension header");
+    }
+    bench_sink += uip_len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+srh_run(uint32_t iterations)
+{
+  srh(iterations, 0);
+}
+/*---------------------------------------------------------------------------*/
+static void
+srh_churn_run(uint32_t iterations)
+{
+  srh(iterations, 1);
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "rpl_dao_input/1000", 20000, 0, root_setup, dao_run },
+  { "rpl_srh_insert/1000", 200000, 0, srh_setup, srh_run },
+  { "rpl_srh_insert_churn/1000", 200000, 0, srh_setup, srh_churn_run },
+};
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(rpl_root_benchmarks_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  bench_main(benches, sizeof(benches) / sizeof(benches[0]));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
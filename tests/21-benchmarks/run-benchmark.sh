@@ -0,0 +1,25 @@
+#!/bin/sh
+
+# Runs a native benchmark program and keeps its results, as JSON, in
+# <test>.json. The program is built from the directory named as the test
+# without its number. The test fails if a benchmark fails its setup or
+# the output is not valid JSON; the timings themselves are not checked.
+
+TESTNAME=$1
+TEST_CODE_DIR=`echo ${TESTNAME} | sed -e 's/[0-9]*-\(.*\)/\1/'`
+TARGET=${TEST_CODE_DIR}
+
+make -C ${TEST_CODE_DIR} clean
+make -C ${TEST_CODE_DIR} ${TARGET}
+rm -f ${TESTNAME}.json
+${TEST_CODE_DIR}/${TARGET}.native -o ${TESTNAME}.json > ${TESTNAME}.log 2>&1 &&
+  python3 -m json.tool ${TESTNAME}.json >> ${TESTNAME}.log
+
+if [ $? -eq 0 ]; then
+    echo "${TESTNAME} TEST OK" > ${TESTNAME}.testlog
+    make -C ${TEST_CODE_DIR} clean
+    exit 0
+else
+    echo "${TESTNAME} TEST FAIL" > ${TESTNAME}.testlog
+    exit 1
+fi
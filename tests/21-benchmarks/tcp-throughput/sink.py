@@ -0,0 +1,30 @@
+#!/usr/bin/env python3
+"""TCP sink for the throughput test: accepts one connection, reads until
+the peer closes it and checks that byte n of the stream equals n % 251."""
+
+import socket
+import sys
+
+PORT = 5555
+
+server = socket.socket(socket.AF_INET6, socket.SOCK_STREAM)
+server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+server.bind(("::", PORT))
+server.listen(1)
+server.settimeout(60)
+conn, _ = server.accept()
+
+received = bytearray()
+while True:
+    # Let the receiver delay its ACKs, as most hosts do
+    conn.setsockopt(socket.IPPROTO_TCP, socket.TCP_QUICKACK, 0)
+    data = conn.recv(65536)
+    if not data:
+        break
+    received += data
+
+for i, byte in enumerate(received):
+    if byte != i % 251:
+        print("Stream mismatch at byte {}".format(i))
+        sys.exit(1)
+print("Received {} bytes".format(len(received)))
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/*
+ * Sends TOTAL_BYTES over a TCP socket to a sink on the tun host
+ * (fd00::1) and reports the achieved throughput, along with the
+ * longest time the transfer stalled. With LOSS_INTERVAL, every nth
+ * outgoing data segment is dropped.
+ */
+#include "contiki.h"
+#include "contiki-net.h"
+#include "net/ipv6/tcp-socket.h"
+#include "net/ipv6/uiplib.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+/*---------------------------------------------------------------------------*/
+#define SINK_ADDR   "fd00::1"
+#define SINK_PORT   5555
+#define TOTAL_BYTES (256UL * 1024)
+#ifndef LOSS_INTERVAL
+#define LOSS_INTERVAL 0
+#endif
+/*---------------------------------------------------------------------------*/
+static struct tcp_socket socket;
+static uint8_t inputbuf[64];
+static uint8_t outputbuf[4096];
+static unsigned long queued;
+static unsigned long sent;
+static struct timespec start;
+static struct timespec last_sent;
+static double longest_stall;
+static int done;
+#if LOSS_INTERVAL
+static unsigned segments;
+static unsigned dropped;
+#endif /* LOSS_INTERVAL */
+/*---------------------------------------------------------------------------*/
+PROCESS(tcp_throughput_process, "TCP throughput");
+AUTOSTART_PROCESSES(&tcp_throughput_process);
+/*---------------------------------------------------------------------------*/
+#if LOSS_INTERVAL
+static enum netstack_ip_action
+drop_output(const linkaddr_t *localdest)
+{
+  if(UIP_IP_BUF->proto == UIP_PROTO_TCP && uip_len > UIP_IPTCPH_LEN &&
+     ++segments % LOSS_INTERVAL == 0) {
+    dropped++;
+    return NETSTACK_IP_DROP;
+  }
+  return NETSTACK_IP_PROCESS;
+}
+/*---------------------------------------------------------------------------*/
+static struct netstack_ip_packet_processor lossy_link = {
+  .process_output = drop_output
+};
+#endif /* LOSS_INTERVAL */
+/*---------------------------------------------------------------------------*/
+static double
+seconds_since(const struct timespec *t)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (now.tv_sec - t->tv_sec) + (now.tv_nsec - t->tv_nsec) / 1e9;
+}
+/*---------------------------------------------------------------------------*/
+static void
+fill(void)
+{
+  static uint8_t chunk[256];
+  int i, len;
+
+  while(queued < TOTAL_BYTES) {
+    /* Byte n of the stream is n % 251, so that the sink can check for
+       lost, duplicated or reordered data */
+    len = MIN(sizeof(chunk), TOTAL_BYTES - queued);
+    for(i = 0; i < len; i++) {
+      chunk[i] = (queued + i) % 251;
+    }
+    len = tcp_socket_send(&socket, chunk, len);
+    if(len <= 0) {
+      break;
+    }
+    queued += len;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static int
+input(struct tcp_socket *s, void *ptr, const uint8_t *data, int len)
+{
+  return 0;
+}
+/*---------------------------------------------------------------------------*/
+static void
+event(struct tcp_socket *s, void *ptr, tcp_socket_event_t ev)
+{
+  double elapsed;
+
+  switch(ev) {
+  case TCP_SOCKET_CONNECTED:
+    printf("Connected, sliding window %d, ctimer %d, loss interval %d\n",
+           UIP_TCP_SLIDING_WINDOW, UIP_TCP_CTIMER, LOSS_INTERVAL);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    last_sent = start;
+    fill();
+    break;
+  case TCP_SOCKET_DATA_SENT:
+    sent = queued - tcp_socket_queuelen(s);
+    elapsed = seconds_since(&last_sent);
+    if(elapsed > longest_stall) {
+      longest_stall = elapsed;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &last_sent);
+    if(sent == TOTAL_BYTES && !done) {
+      done = 1;
+      elapsed = seconds_since(&start);
+      printf("Sent %lu bytes in %.3f s: %.0f bytes/s\n",
+             sent, elapsed, sent / elapsed);
+      printf("Longest stall %.3f s\n", longest_stall);
+#if LOSS_INTERVAL
+      printf("Dropped %u of %u segments\n", dropped, segments);
+#endif /* LOSS_INTERVAL */
+      tcp_socket_close(s);
+      printf("=check-me= DONE\n");
+    } else {
+      fill();
+    }
+    break;
+  case TCP_SOCKET_CLOSED:
+  case TCP_SOCKET_TIMEDOUT:
+  case TCP_SOCKET_ABORTED:
+    if(!done) {
+      printf("Connection lost (%d) after %lu bytes\n", ev, sent);
+      printf("=check-me= FAILED\n");
+    }
+    break;
+  default:
+    break;
+  }
+  fflush(stdout);
+}
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tcp_throughput_process, ev, data)
+{
+  static struct etimer et;
+  uip_ipaddr_t addr;
+
+  PROCESS_BEGIN();
+
+#if LOSS_INTERVAL
+  netstack_ip_packet_processor_add(&lossy_link);
+#endif /* LOSS_INTERVAL */
+
+  /* Wait for the tun interface and the address to come up */
+  etimer_set(&et, CLOCK_SECOND * 2);
+  PROCESS_WAIT_EVENT_UNTIL(etimer_expired(&et));
+
+  uiplib_ipaddrconv(SINK_ADDR, &addr);
+  tcp_socket_register(&socket, NULL, inputbuf, sizeof(inputbuf),
+                      outputbuf, sizeof(outputbuf), input, event);
+  tcp_socket_connect(&socket, &addr, SINK_PORT);
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
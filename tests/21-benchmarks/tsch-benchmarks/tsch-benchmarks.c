@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+/**
+ * \file
+ *   Native benchmarks for the TSCH schedule and queue, built without the
+ *   rest of TSCH. See bench_main() for the command line.
+ */
+
+#include "contiki.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "net/packetbuf.h"
+#include "net/mac/tsch/tsch.h"
+
+#include "bench.h"
+
+/* A prime slotframe length, so that the links spread over it */
+#define SLOTFRAME_SIZE 397
+
+PROCESS(tsch_benchmarks_process, "TSCH benchmarks");
+AUTOSTART_PROCESSES(&tsch_benchmarks_process);
+/*---------------------------------------------------------------------------*/
+/* The parts of TSCH used by the schedule and queue */
+const linkaddr_t tsch_broadcast_address = { { 0xff, 0xff, 0xff, 0xff,
+                                              0xff, 0xff, 0xff, 0xff } };
+const linkaddr_t tsch_eb_address = { { 0 } };
+struct tsch_link *current_link = NULL;
+int tsch_is_coordinator = 0;
+
+int
+tsch_is_locked(void)
+{
+  return 0;
+}
+int
+tsch_get_lock(void)
+{
+  return 1;
+}
+void
+tsch_release_lock(void)
+{
+}
+void
+tsch_set_ka_timeout(uint32_t timeout)
+{
+}
+/*---------------------------------------------------------------------------*/
+static void
+fail(const char *what)
+{
+  fprintf(stderr, "setup failed: %s\n", what);
+  exit(EXIT_FAILURE);
+}
+/*---------------------------------------------------------------------------*/
+/* A minimal slotframe, and a large unicast slotframe with links at
+   distinct timeslots, as on a root with many children */
+static struct tsch_slotframe *sf_unicast;
+static uint16_t schedule_links;
+
+static void
+schedule_fill(uint16_t links)
+{
+  if(sf_unicast == NULL) {
+    tsch_schedule_init();
+    tsch_schedule_create_minimal();
+    sf_unicast = tsch_schedule_add_slotframe(1, SLOTFRAME_SIZE);
+    schedule_links = 1;
+  }
+  while(schedule_links < links) {
+    if(tsch_schedule_add_link(sf_unicast, LINK_OPTION_TX | LINK_OPTION_RX,
+                              LINK_TYPE_NORMAL, &tsch_broadcast_address,
+                              (schedule_links * 149) % SLOTFRAME_SIZE,
+                              1, 1) == NULL) {
+      fail("tsch link");
+    }
+    schedule_links++;
+  }
+}
+static void schedule_setup_16(void) { schedule_fill(16); }
+static void schedule_setup_64(void) { schedule_fill(64); }
+static void schedule_setup_256(void) { schedule_fill(256); }
+/*---------------------------------------------------------------------------*/
+/* Looks up the next link from every ASN in turn */
+static void
+next_link_run(uint32_t iterations)
+{
+  static uint32_t asn_ls4b;
+  struct tsch_asn_t asn;
+  uint16_t time_offset;
+
+  while(iterations--) {
+    TSCH_ASN_INIT(asn, 0, asn_ls4b++);
+    bench_sink += (uintptr_t)tsch_schedule_get_next_active_link(&asn,
+                                                                &time_offset,
+                                                                NULL);
+    bench_sink += time_offset;
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Many idle neighbors, every eighth with a Tx link and in backoff, and
+   a single packet queued to the most recently added one */
+static struct tsch_link shared_link = {
+  .link_options = LINK_OPTION_TX | LINK_OPTION_SHARED,
+};
+static uint16_t queue_nbrs;
+
+static linkaddr_t *
+nbr_addr(uint16_t id)
+{
+  static linkaddr_t addr;
+
+  memset(&addr, 0, sizeof(addr));
+  addr.u8[0] = 0x02;
+  addr.u8[LINKADDR_SIZE - 2] = id >> 8;
+  addr.u8[LINKADDR_SIZE - 1] = id & 0xff;
+  return &addr;
+}
+static void
+queue_fill(uint16_t nbrs)
+{
+  struct tsch_neighbor *n;
+
+  if(queue_nbrs == 0) {
+    tsch_queue_init();
+  } else {
+    tsch_queue_free_packets_to(nbr_addr(queue_nbrs));
+  }
+  while(queue_nbrs < nbrs) {
+    queue_nbrs++;
+    n = tsch_queue_add_nbr(nbr_addr(queue_nbrs));
+    if(n == NULL) {
+      fail("tsch neighbor");
+    }
+    if(queue_nbrs % 8 == 0) {
+      n->tx_links_count = 1;
+      tsch_queue_backoff_inc(n);
+    }
+  }
+  packetbuf_clear();
+  if(tsch_queue_add_packet(nbr_addr(queue_nbrs), 1, NULL, NULL) == NULL) {
+    fail("tsch packet");
+  }
+}
+static void queue_setup_16(void) { queue_fill(16); }
+static void queue_setup_64(void) { queue_fill(64); }
+static void queue_setup_128(void) { queue_fill(128); }
+/*---------------------------------------------------------------------------*/
+/* Selects a packet for a shared slot, then updates the backoff windows,
+   as done in each shared slot */
+static void
+shared_slot_run(uint32_t iterations)
+{
+  struct tsch_neighbor *n;
+
+  while(iterations--) {
+    bench_sink += (uintptr_t)tsch_queue_get_unicast_packet_for_any(&n,
+                                                                   &shared_link);
+    tsch_queue_update_all_backoff_windows(&tsch_broadcast_address);
+  }
+}
+/*---------------------------------------------------------------------------*/
+static const struct bench benches[] = {
+  { "tsch_schedule_get_next_active_link/16", 200000, 0,
+    schedule_setup_16, next_link_run },
+  { "tsch_schedule_get_next_active_link/64", 200000, 0,
+    schedule_setup_64, next_link_run },
+  { "tsch_schedule_get_next_active_link/256", 200000, 0,
+    schedule_setup_256, next_link_run },
+  { "tsch_queue_get_unicast_packet_for_any/16", 200000, 0,
+    queue_setup_16, shared_slot_run },
+  { "tsch_queue_get_unicast_packet_for_any/64", 200000, 0,
+    queue_setup_64, shared_slot_run },
+  { "tsch_queue_get_unicast_packet_for_any/128", 200000, 0,
+    queue_setup_128, shared_slot_run },
+};
+/*---------------------------------------------------------------------------*/
+PROCESS_THREAD(tsch_benchmarks_process, ev, data)
+{
+  PROCESS_BEGIN();
+
+  bench_main(benches, sizeof(benches) / sizeof(benches[0]));
+
+  PROCESS_END();
+}
+/*---------------------------------------------------------------------------*/
@@ -0,0 +1,545 @@
+/*
+ * Copyright (c) 2026, RISE Research Institutes of Sweden.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ * 3. Neither the name of the Institute nor the names of its contributors
+ *    may be used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE INSTITUTE AND CONTRIBUTORS ``AS IS'' AND
+ * ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ * ARE DISCLAIMED.  IN NO EVENT SHALL THE INSTITUTE OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS
+ * OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY
+ * OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ */
+
+
+/**
+ * \file
+ *         Simulated 802.15.4 medium for native Contiki-NG nodes built with
+ *         NATIVE_SIM (the default for TSCH builds on the native platform).
+ *
+ *         The medium spawns the nodes, or waits for them to connect, and
+ *         then runs them one at a time in virtual time: the node with the
+ *         earliest pending event runs until it waits again. Frames are
+ *         forwarded to all other nodes, each receiver missing a frame with
+ *         the configured per-channel loss probability. A run only depends
+ *         on the nodes and on the seed, not on host load.
+ *
+ *         Usage: native-medium [options] [-- node-binary [args]]
+ */
+
+#include "native-sim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+
+#define MAX_NODES      256
+#define MAX_EVENTS     64
+#define MIN_CHANNEL    11
+#define MAX_CHANNEL    26
+#define NUM_CHANNELS   (MAX_CHANNEL - MIN_CHANNEL + 1)
+#define FRAME_RSSI     -60
+#define CONNECT_TIMEOUT_MS 10000
+
+struct node {
+  int fd;
+  int out;
+  pid_t pid;
+  uint64_t until;
+  /* Frame start and end times, sorted */
+  uint64_t events[MAX_EVENTS];
+  int num_events;
+  char line[1024];
+  size_t line_len;
+  unsigned long tx;
+};
+
+static struct node nodes[MAX_NODES];
+static int num_nodes = 2;
+static uint64_t now;
+static uint64_t prng_state = 1;
+static double loss[NUM_CHANNELS];
+static unsigned long frames[NUM_CHANNELS];
+static unsigned long frames_lost[NUM_CHANNELS];
+/*---------------------------------------------------------------------------*/
+static void
+usage(const char *prog)
+{
+  fprintf(stderr,
+          "usage: %s [options] [-- node-binary [args]]\n"
+          "  -n N        number of nodes, with IDs 1..N (default 2)\n"
+          "  -t SECONDS  stop after SECONDS of virtual time (default: never)\n"
+          "  -s SEED     seed for the loss model (default 1)\n"
+          "  -l LOSS     loss probability on all channels, 0..1 (default 0)\n"
+          "  -c CH:LOSS  loss probability on channel CH\n"
+          "  -S PATH     UNIX socket path (default /tmp/native-medium.PID)\n"
+          "  -d DIR      run node ID in DIR/ID, keeping its files across runs\n"
+          "Each node is started as: node-binary [args] --node-id=ID --medium=PATH\n"
+          "Without a node binary, the medium waits for N nodes to connect.\n",
+          prog);
+  exit(1);
+}
+/*---------------------------------------------------------------------------*/
+/* xorshift64*: a fixed, portable sequence for a given seed */
+static double
+prng_uniform(void)
+{
+  prng_state ^= prng_state >> 12;
+  prng_state ^= prng_state << 25;
+  prng_state ^= prng_state >> 27;
+  return ((prng_state * UINT64_C(2685821657736338717)) >> 11)
+         * (1.0 / (UINT64_C(1) << 53));
+}
+/*---------------------------------------------------------------------------*/
+static void
+print_output(struct node *n, int id)
+{
+  char buf[4096];
+  ssize_t len;
+  ssize_t i;
+
+  if(n->out < 0) {
+    return;
+  }
+  while((len = read(n->out, buf, sizeof(buf))) > 0) {
+    for(i = 0; i < len; i++) {
+      if(buf[i] == '\n' || n->line_len == sizeof(n->line) - 1) {
+        n->line[n->line_len] = '\0';
+        printf("%" PRIu64 ".%06" PRIu64 "\tID:%d\t%s\n",
+               now / NATIVE_SIM_SECOND, now % NATIVE_SIM_SECOND, id, n->line);
+        n->line_len = 0;
+      }
+      if(buf[i] != '\n') {
+        n->line[n->line_len++] = buf[i];
+      }
+    }
+  }
+  if(len == 0) {
+    close(n->out);
+    n->out = -1;
+  }
+}
+/*---------------------------------------------------------------------------*/
+static void
+disconnect(struct node *n)
+{
+  if(n->fd >= 0) {
+    close(n->fd);
+    n->fd = -1;
+  }
+  n->until = NATIVE_SIM_FOREVER;
+  n->num_events = 0;
+}
+/*---------------------------------------------------------------------------*/
+static int
+send_msg(struct node *n, const struct native_sim_msg *msg)
+{
+  const uint8_t *p = (const uint8_t *)msg;
+  size_t left = sizeof(*msg);
+
+  while(left > 0) {
+    ssize_t len = write(n->fd, p, left);
+    if(len < 0 && errno == EINTR) {
+      continue;
+    }
+    if(len <= 0) {
+      disconnect(n);
+      return 0;
+    }
+    p += len;
+    left -= len;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static int
+recv_msg(struct node *n, struct native_sim_msg *msg)
+{
+  uint8_t *p = (uint8_t *)msg;
+  size_t left = sizeof(*msg);
+
+  while(left > 0) {
+    ssize_t len = read(n->fd, p, left);
+    if(len < 0 && errno == EINTR) {
+      continue;
+    }
+    if(len <= 0) {
+      disconnect(n);
+      return 0;
+    }
+    p += len;
+    left -= len;
+  }
+  return 1;
+}
+/*---------------------------------------------------------------------------*/
+static void
+add_event(struct node *n, uint64_t t)
+{
+  int i;
+
+  if(n->num_events == MAX_EVENTS) {
+    fprintf(stderr, "native-medium: too many events pending\n");
+    exit(1);
+  }
+  for(i = n->num_events; i > 0 && n->events[i - 1] > t; i--) {
+    n->events[i] = n->events[i - 1];
+  }
+  n->events[i] = t;
+  n->num_events++;
+}
+/*---------------------------------------------------------------------------*/
+static uint64_t
+next_time(const struct node *n)
+{
+  if(n->num_events > 0 && n->events[0] < n->until) {
+    return n->events[0];
+  }
+  return n->until;
+}
+/*---------------------------------------------------------------------------*/
+static void
+transmit(int sender, struct native_sim_msg *msg)
+{
+  int ch;
+  int i;
+
+  if(msg->channel < MIN_CHANNEL || msg->channel > MAX_CHANNEL
+     || msg->len > NATIVE_SIM_MAX_FRAME_LEN) {
+    return;
+  }
+  ch = msg->channel - MIN_CHANNEL;
+  nodes[sender].tx++;
+  frames[ch]++;
+
+  msg->type = NATIVE_SIM_MSG_FRAME;
+  msg->time = now;
+  msg->rssi = FRAME_RSSI;
+  for(i = 0; i < num_nodes; i++) {
+    if(i == sender || nodes[i].fd < 0) {
+      continue;
+    }
+    msg->flags = 0;
+    if(loss[ch] > 0 && prng_uniform() < loss[ch]) {
+      msg->flags |= NATIVE_SIM_FRAME_LOST;
+      frames_lost[ch]++;
+    }
+    if(send_msg(&nodes[i], msg)) {
+      /* Wake the receiver when the frame starts and when it ends */
+      add_event(&nodes[i], now);
+      add_event(&nodes[i], now + msg->duration);
+    }
+  }
+}
+/*---------------------------------------------------------------------------*/
+/* Let one node run until it waits again */
+static void
+run_node(int i)
+{
+  struct node *n = &nodes[i];
+  struct native_sim_msg msg;
+  struct pollfd fds[2];
+
+  while(n->num_events > 0 && n->events[0] <= now) {
+    n->num_events--;
+    memmove(&n->events[0], &n->events[1], n->num_events * sizeof(uint64_t));
+  }
+
+  memset(&msg, 0, sizeof(msg));
+  msg.type = NATIVE_SIM_MSG_WAKE;
+  msg.time = now;
+  if(!send_msg(n, &msg)) {
+    return;
+  }
+
+  while(n->fd >= 0) {
+    fds[0].fd = n->fd;
+    fds[0].events = POLLIN;
+    fds[1].fd = n->out;
+    fds[1].events = POLLIN;
+    if(poll(fds, n->out >= 0 ? 2 : 1, -1) < 0) {
+      if(errno == EINTR) {
+        continue;
+      }
+      perror("native-medium: poll");
+      exit(1);
+    }
+    /* Keep the node's output pipe from filling up */
+    if(n->out >= 0 && fds[1].revents) {
+      print_output(n, i + 1);
+    }
+    if(fds[0].revents == 0) {
+      continue;
+    }
+    if(!recv_msg(n, &msg)) {
+      break;
+    }
+    if(msg.type == NATIVE_SIM_MSG_TX) {
+      transmit(i, &msg);
+    } else if(msg.type == NATIVE_SIM_MSG_WAIT) {
+      n->until = msg.time > now ? msg.time : now;
+      break;
+    }
+  }
+
+  /* Everything printed before the wait is in the pipe by now */
+  print_output(n, i + 1);
+}
+/*---------------------------------------------------------------------------*/
+static void
+spawn_nodes(char **argv, int argc, const char *path, const char *dir)
+{
+  static char id_arg[32];
+  static char node_dir[PATH_MAX];
+  char *binary = NULL;
+  static char medium_arg[sizeof(((struct sockaddr_un *)0)->sun_path) + 16];
+  char **args;
+  int pipefd[2];
+  int i;
+
+  args = calloc(argc + 3, sizeof(char *));
+  if(args == NULL) {
+    exit(1);
+  }
+  memcpy(args, argv, argc * sizeof(char *));
+  args[argc] = id_arg;
+  args[argc + 1] = medium_arg;
+  snprintf(medium_arg, sizeof(medium_arg), "--medium=%s", path);
+  if(dir != NULL && strchr(args[0], '/') != NULL) {
+    /* The node runs from its own directory */
+    binary = realpath(args[0], NULL);
+    if(binary == NULL) {
+      perror("native-medium: realpath");
+      exit(1);
+    }
+    args[0] = binary;
+  }
+
+  for(i = 0; i < num_nodes; i++) {
+    snprintf(id_arg, sizeof(id_arg), "--node-id=%d", i + 1);
+    if(dir != NULL) {
+      snprintf(node_dir, sizeof(node_dir), "%s/%d", dir, i + 1);
+      mkdir(dir, 0700);
+      mkdir(node_dir, 0700);
+    }
+    if(pipe(pipefd) < 0) {
+      perror("native-medium: pipe");
+      exit(1);
+    }
+    nodes[i].pid = fork();
+    if(nodes[i].pid < 0) {
+      perror("native-medium: fork");
+      exit(1);
+    }
+    if(nodes[i].pid == 0) {
+      dup2(pipefd[1], STDOUT_FILENO);
+      dup2(pipefd[1], STDERR_FILENO);
+      close(pipefd[0]);
+      close(pipefd[1]);
+      if(dir != NULL && chdir(node_dir) < 0) {
+        perror("native-medium: chdir");
+        _exit(1);
+      }
+      execvp(args[0], args);
+      perror("native-medium: exec");
+      _exit(1);
+    }
+    close(pipefd[1]);
+    nodes[i].out = pipefd[0];
+    fcntl(nodes[i].out, F_SETFL, O_NONBLOCK);
+  }
+  free(binary);
+  free(args);
+}
+/*---------------------------------------------------------------------------*/
+static void
+accept_nodes(int listen_fd)
+{
+  struct native_sim_msg msg;
+  struct pollfd pfd;
+  struct node tmp;
+  int connected;
+  int id;
+
+  for(connected = 0; connected < num_nodes; connected++) {
+    pfd.fd = listen_fd;
+    pfd.events = POLLIN;
+    if(poll(&pfd, 1, CONNECT_TIMEOUT_MS) <= 0) {
+      fprintf(stderr, "native-medium: only %d of %d nodes connected\n",
+              connected, num_nodes);
+      exit(1);
+    }
+    memset(&tmp, 0, sizeof(tmp));
+    tmp.fd = accept(listen_fd, NULL, NULL);
+    if(tmp.fd < 0 || !recv_msg(&tmp, &msg)
+       || msg.type != NATIVE_SIM_MSG_HELLO) {
+      fprintf(stderr, "native-medium: bad connection\n");
+      exit(1);
+    }
+    id = msg.node_id;
+    if(id < 1 || id > num_nodes || nodes[id - 1].fd >= 0) {
+      fprintf(stderr, "native-medium: unexpected node ID %d\n", id);
+      exit(1);
+    }
+    nodes[id - 1].fd = tmp.fd;
+    nodes[id - 1].until = 0;
+  }
+}
+/*---------------------------------------------------------------------------*/
+int
+main(int argc, char **argv)
+{
+  char path[sizeof(((struct sockaddr_un *)0)->sun_path)];
+  struct sockaddr_un addr;
+  uint64_t limit = NATIVE_SIM_FOREVER;
+  uint64_t t, best_time;
+  double default_loss = 0;
+  const char *dir = NULL;
+  int listen_fd;
+  int best;
+  int opt;
+  int ch;
+  int i;
+
+  snprintf(path, sizeof(path), "/tmp/native-medium.%d", (int)getpid());
+  for(i = 0; i < NUM_CHANNELS; i++) {
+    loss[i] = -1;
+  }
+
+  while((opt = getopt(argc, argv, "n:t:s:l:c:S:d:h")) != -1) {
+    switch(opt) {
+    case 'n':
+      num_nodes = atoi(optarg);
+      if(num_nodes < 1 || num_nodes > MAX_NODES) {
+        usage(argv[0]);
+      }
+      break;
+    case 't':
+      limit = (uint64_t)(atof(optarg) * NATIVE_SIM_SECOND);
+      break;
+    case 's':
+      prng_state = strtoull(optarg, NULL, 0);
+      if(prng_state == 0) {
+        prng_state = 1;
+      }
+      break;
+    case 'l':
+      default_loss = atof(optarg);
+      break;
+    case 'c':
+      if(sscanf(optarg, "%d:", &ch) != 1 || ch < MIN_CHANNEL
+         || ch > MAX_CHANNEL || strchr(optarg, ':') == NULL) {
+        usage(argv[0]);
+      }
+      loss[ch - MIN_CHANNEL] = atof(strchr(optarg, ':') + 1);
+      break;
+    case 'S':
+      snprintf(path, sizeof(path), "%s", optarg);
+      break;
+    case 'd':
+      dir = optarg;
+      break;
+    default:
+      usage(argv[0]);
+    }
+  }
+  for(i = 0; i < NUM_CHANNELS; i++) {
+    if(loss[i] < 0) {
+      loss[i] = default_loss;
+    }
+  }
+
+  signal(SIGPIPE, SIG_IGN);
+  for(i = 0; i < num_nodes; i++) {
+    nodes[i].fd = -1;
+    nodes[i].out = -1;
+    nodes[i].until = NATIVE_SIM_FOREVER;
+  }
+
+  listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  memcpy(addr.sun_path, path, sizeof(addr.sun_path));
+  unlink(path);
+  if(listen_fd < 0
+     || bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0
+     || listen(listen_fd, num_nodes) < 0) {
+    perror("native-medium: socket");
+    return 1;
+  }
+
+  if(optind < argc) {
+    spawn_nodes(&argv[optind], argc - optind, path, dir);
+  }
+  accept_nodes(listen_fd);
+  close(listen_fd);
+  unlink(path);
+
+  /* Run the node with the earliest event, lowest ID first on ties */
+  while(1) {
+    best = -1;
+    best_time = NATIVE_SIM_FOREVER;
+    for(i = 0; i < num_nodes; i++) {
+      t = next_time(&nodes[i]);
+      if(nodes[i].fd >= 0 && t < best_time) {
+        best = i;
+        best_time = t;
+      }
+    }
+    if(best < 0 || best_time > limit) {
+      break;
+    }
+    now = best_time;
+    run_node(best);
+  }
+
+  for(i = 0; i < num_nodes; i++) {
+    disconnect(&nodes[i]);
+  }
+  for(i = 0; i < num_nodes; i++) {
+    if(nodes[i].pid > 0) {
+      waitpid(nodes[i].pid, NULL, 0);
+      print_output(&nodes[i], i + 1);
+    }
+  }
+
+  printf("Simulation ended at %" PRIu64 ".%06" PRIu64 " s\n",
+         now / NATIVE_SIM_SECOND, now % NATIVE_SIM_SECOND);
+  for(i = 0; i < num_nodes; i++) {
+    printf("Node %d: %lu frames sent\n", i + 1, nodes[i].tx);
+  }
+  for(i = 0; i < NUM_CHANNELS; i++) {
+    if(frames[i] > 0) {
+      printf("Channel %d: %lu frames, %lu receptions lost\n",
+             i + MIN_CHANNEL, frames[i], frames_lost[i]);
+    }
+  }
+  return 0;
+}